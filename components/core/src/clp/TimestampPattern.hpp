@@ -4,6 +4,8 @@
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <string>
+#include <string_view>
 
 #include "Defs.h"
 #include "FileWriter.hpp"
@@ -64,7 +66,8 @@ public:
 
     TimestampPattern(uint8_t num_spaces_before_ts, std::string const& format)
             : m_num_spaces_before_ts(num_spaces_before_ts),
-              m_format(format) {}
+              m_format(format),
+              m_signature(compile_signature(m_format)) {}
 
     // Methods
     /**
@@ -74,7 +77,8 @@ public:
 
     /**
      * Searches for a known timestamp pattern which can parse the timestamp from the given line, and
-     * if found, parses the timestamp
+     * if found, parses the timestamp. Patterns whose signature doesn't match the line are skipped
+     * without being parsed.
      * @param line
      * @param timestamp Parsed timestamp
      * @param timestamp_begin_pos
@@ -148,6 +152,26 @@ public:
     friend bool operator!=(TimestampPattern const& lhs, TimestampPattern const& rhs);
 
 private:
+    // Methods
+    /**
+     * Compiles the signature of the given format string: the character class of each character in
+     * the fixed-width prefix of a timestamp that the format can parse. The prefix ends at the first
+     * variable-width field (e.g., a full month name).
+     * @param format
+     * @return The signature
+     */
+    static std::string compile_signature(std::string_view format);
+
+    /**
+     * Checks whether the characters at the given position in the line match the pattern's
+     * signature. A pattern whose signature doesn't match can't parse the line, but the converse
+     * isn't true.
+     * @param line
+     * @param ts_begin_ix The position where the timestamp would begin in the line
+     * @return true if the signature matches, false otherwise
+     */
+    bool matches_signature(std::string_view line, size_t ts_begin_ix) const;
+
     // Variables
     static std::unique_ptr<TimestampPattern[]> m_known_ts_patterns;
     static size_t m_known_ts_patterns_len;
@@ -157,6 +181,7 @@ private:
     //                   ^ ^ ^
     uint8_t m_num_spaces_before_ts;
     std::string m_format;
+    std::string m_signature;
 };
 }  // namespace clp
 
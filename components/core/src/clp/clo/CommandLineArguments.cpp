@@ -368,6 +368,10 @@ auto CommandLineArguments::parse_search_arguments(
             "job-id",
             po::value<reducer::job_id_t>(&m_job_id)->value_name("ID"),
             "Job ID for the requested aggregation operation"
+    )(
+            "columnar-record-groups",
+            po::bool_switch(&m_use_columnar_record_groups),
+            "Send record groups in the columnar format (the reducer must support it)"
     );
 
     po::options_description options_results_cache_output_handler(
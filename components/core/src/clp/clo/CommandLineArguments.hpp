@@ -91,6 +91,11 @@ public:
 
     reducer::job_id_t get_job_id() const { return m_job_id; }
 
+    reducer::RecordGroupFormat get_record_group_format() const {
+        return m_use_columnar_record_groups ? reducer::RecordGroupFormat::Columnar
+                                            : reducer::RecordGroupFormat::Msgpack;
+    }
+
     bool do_count_results_aggregation() const { return m_do_count_results_aggregation; }
 
     bool do_count_by_time_aggregation() const { return m_do_count_by_time_aggregation; }
@@ -209,6 +214,7 @@ private:
     std::string m_reducer_host;
     int m_reducer_port{-1};
     reducer::job_id_t m_job_id{-1};
+    bool m_use_columnar_record_groups{false};
     bool m_do_count_results_aggregation{false};
     bool m_do_count_by_time_aggregation{false};
     int64_t m_count_by_time_bucket_size{0};  // Milliseconds
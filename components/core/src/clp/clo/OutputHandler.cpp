@@ -151,8 +151,12 @@ ErrorCode ResultsCacheOutputHandler::flush() {
     return ErrorCode::ErrorCode_Success;
 }
 
-CountOutputHandler::CountOutputHandler(int reducer_socket_fd)
+CountOutputHandler::CountOutputHandler(
+        int reducer_socket_fd,
+        reducer::RecordGroupFormat record_group_format
+)
         : m_reducer_socket_fd{reducer_socket_fd},
+          m_record_group_format{record_group_format},
           m_pipeline{reducer::PipelineInputMode::InterStage} {
     m_pipeline.add_pipeline_stage(std::make_shared<reducer::CountOperator>());
 }
@@ -169,7 +173,11 @@ ErrorCode CountOutputHandler::add_result(
 
 ErrorCode CountOutputHandler::flush() {
     if (false
-        == reducer::send_pipeline_results(m_reducer_socket_fd, std::move(m_pipeline.finish())))
+        == reducer::send_pipeline_results(
+                m_reducer_socket_fd,
+                std::move(m_pipeline.finish()),
+                m_record_group_format
+        ))
     {
         return ErrorCode::ErrorCode_Failure_Network;
     }
@@ -183,7 +191,8 @@ ErrorCode CountByTimeOutputHandler::flush() {
                 std::make_unique<reducer::Int64Int64MapRecordGroupIterator>(
                         m_bucket_counts,
                         reducer::CountOperator::cRecordElementKey
-                )
+                ),
+                m_record_group_format
         ))
     {
         return ErrorCode::ErrorCode_Failure_Network;
@@ -13,6 +13,7 @@
 #include <mongocxx/uri.hpp>
 
 #include "../../reducer/Pipeline.hpp"
+#include "../../reducer/types.hpp"
 #include "../Defs.h"
 #include "../streaming_archive/MetadataDB.hpp"
 #include "../streaming_archive/reader/Message.hpp"
@@ -227,7 +228,7 @@ private:
 class CountOutputHandler : public OutputHandler {
 public:
     // Constructor
-    explicit CountOutputHandler(int reducer_socket_fd);
+    CountOutputHandler(int reducer_socket_fd, reducer::RecordGroupFormat record_group_format);
 
     // Methods inherited from OutputHandler
     ErrorCode add_result(
@@ -246,6 +247,7 @@ public:
 
 private:
     int m_reducer_socket_fd;
+    reducer::RecordGroupFormat m_record_group_format;
     reducer::Pipeline m_pipeline;
 };
 
@@ -256,8 +258,13 @@ private:
 class CountByTimeOutputHandler : public OutputHandler {
 public:
     // Constructors
-    CountByTimeOutputHandler(int reducer_socket_fd, int64_t count_by_time_bucket_size)
+    CountByTimeOutputHandler(
+            int reducer_socket_fd,
+            reducer::RecordGroupFormat record_group_format,
+            int64_t count_by_time_bucket_size
+    )
             : m_reducer_socket_fd{reducer_socket_fd},
+              m_record_group_format{record_group_format},
               m_count_by_time_bucket_size{count_by_time_bucket_size} {}
 
     // Methods inherited from OutputHandler
@@ -282,6 +289,7 @@ public:
 
 private:
     int m_reducer_socket_fd;
+    reducer::RecordGroupFormat m_record_group_format;
     std::map<int64_t, int64_t> m_bucket_counts;
     int64_t m_count_by_time_bucket_size;
 };
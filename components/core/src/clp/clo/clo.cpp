@@ -290,10 +290,12 @@ bool search(CommandLineArguments const& command_line_args) {
                 );
                 break;
             case CommandLineArguments::OutputHandlerType::Reducer: {
+                auto const record_group_format{command_line_args.get_record_group_format()};
                 auto const reducer_socket_fd = reducer::connect_to_reducer(
                         command_line_args.get_reducer_host(),
                         command_line_args.get_reducer_port(),
-                        command_line_args.get_job_id()
+                        command_line_args.get_job_id(),
+                        record_group_format
                 );
                 if (-1 == reducer_socket_fd) {
                     SPDLOG_ERROR("Failed to connect to reducer");
@@ -301,10 +303,14 @@ bool search(CommandLineArguments const& command_line_args) {
                 }
 
                 if (command_line_args.do_count_results_aggregation()) {
-                    output_handler = std::make_unique<CountOutputHandler>(reducer_socket_fd);
+                    output_handler = std::make_unique<CountOutputHandler>(
+                            reducer_socket_fd,
+                            record_group_format
+                    );
                 } else if (command_line_args.do_count_by_time_aggregation()) {
                     output_handler = std::make_unique<CountByTimeOutputHandler>(
                             reducer_socket_fd,
+                            record_group_format,
                             command_line_args.get_count_by_time_bucket_size()
                     );
                 } else {
@@ -13,6 +13,7 @@
 
 #include <msgpack.hpp>
 #include <nlohmann/json.hpp>
+#include <simdjson.h>
 #include <ystdlib/error_handling/Result.hpp>
 
 #include "../../ir/types.hpp"
@@ -37,34 +38,34 @@ using clp::ir::four_byte_encoded_variable_t;
 namespace clp::ffi::ir_stream {
 namespace {
 /**
- * Concept that defines the method to serialize a schema tree node identified by the given locator.
- * @param serialization_method
+ * Concept that defines the method to resolve the ID of a schema tree node identified by the given
+ * locator.
+ * @param resolution_method
  * @param locator
- * @return Whether serialization succeeded.
+ * @return The node's ID on success, or std::nullopt on failure.
  */
-template <typename SerializationMethod>
-concept SchemaTreeNodeSerializationMethodReq = requires(
-        SerializationMethod serialization_method,
-        SchemaTree::NodeLocator const& locator
-) {
-    {
-        serialization_method(locator)
-    } -> std::same_as<bool>;
-};
+template <typename ResolutionMethod>
+concept SchemaTreeNodeIdResolutionMethodReq
+        = requires(ResolutionMethod resolution_method, SchemaTree::NodeLocator const& locator) {
+              {
+                  resolution_method(locator)
+              } -> std::same_as<optional<SchemaTree::Node::id_t>>;
+          };
 
 /**
  * Concept that defines the method to serialize a node-ID-value pair.
+ * @tparam Value The type of the values to serialize.
  * @param serialization_method
  * @param node_id
  * @param val
  * @param schema_tree_node_type The type of the schema tree node that corresponds to `val`.
  * @return Whether serialization succeeded.
  */
-template <typename SerializationMethod>
+template <typename SerializationMethod, typename Value>
 concept NodeIdValuePairSerializationMethodReq = requires(
         SerializationMethod serialization_method,
         SchemaTree::Node::id_t id,
-        msgpack::object const& val,
+        Value& val,
         SchemaTree::Node::Type schema_tree_node_type
 ) {
     {
@@ -86,6 +87,25 @@ concept EmptyMapSerializationMethodReq
               } -> std::same_as<bool>;
           };
 
+/**
+ * Gets the schema-tree node type that corresponds with a given MessagePack value.
+ * @param val
+ * @return The corresponding schema-tree node type.
+ * @return std::nullopt if the value doesn't match any of the supported schema-tree node types.
+ */
+[[nodiscard]] auto get_schema_tree_node_type_from_msgpack_val(msgpack::object const& val)
+        -> optional<SchemaTree::Node::Type>;
+
+/**
+ * Gets the schema-tree node type that corresponds with a given JSON value without consuming it.
+ * @param val
+ * @return The corresponding schema-tree node type.
+ * @return std::nullopt if the value doesn't match any of the supported schema-tree node types, or
+ * its type couldn't be determined.
+ */
+[[nodiscard]] auto get_schema_tree_node_type_from_json_val(simdjson::ondemand::value& val)
+        -> optional<SchemaTree::Node::Type>;
+
 /**
  * Class for iterating the kv-pairs of a MessagePack map.
  */
@@ -93,6 +113,7 @@ class MsgpackMapIterator {
 public:
     // Types
     using Child = msgpack::object_kv;
+    using Value = msgpack::object const;
 
     // Constructors
     MsgpackMapIterator(SchemaTree::Node::id_t schema_tree_node_id, span<Child> children)
@@ -101,6 +122,36 @@ public:
               m_curr_child_it{m_children.begin()} {}
 
     // Methods
+    /**
+     * @param val
+     * @return The schema-tree node type that corresponds with `val`, or std::nullopt if there's
+     * none.
+     */
+    [[nodiscard]] static auto get_schema_tree_node_type(Value& val)
+            -> optional<SchemaTree::Node::Type> {
+        return get_schema_tree_node_type_from_msgpack_val(val);
+    }
+
+    /**
+     * Creates an iterator over the kv-pairs of the given value if it's a map.
+     * @param schema_tree_node_id The value's ID in the schema tree.
+     * @param val
+     * @param map_it Returns the iterator if `val` is a map, or std::nullopt otherwise.
+     * @return Whether `val` could be inspected.
+     */
+    [[nodiscard]] static auto create_if_map(
+            SchemaTree::Node::id_t schema_tree_node_id,
+            Value& val,
+            optional<MsgpackMapIterator>& map_it
+    ) -> bool {
+        if (msgpack::type::MAP == val.type) {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-union-access)
+            auto const& map{val.via.map};
+            map_it.emplace(schema_tree_node_id, span<Child>{map.ptr, map.size});
+        }
+        return true;
+    }
+
     /**
      * @return This map's ID in the schema tree.
      */
@@ -117,9 +168,17 @@ public:
 
     /**
      * Gets the next child and advances the underlying child idx.
-     * @return The next child to traverse.
+     * @param key Returns the child's key.
+     * @return A pointer to the child's value, or nullptr if the child's key isn't a string.
      */
-    [[nodiscard]] auto get_next_child() -> Child const& { return *(m_curr_child_it++); }
+    [[nodiscard]] auto get_next_child(string_view& key) -> Value* {
+        auto const& [child_key, child_val]{*(m_curr_child_it++)};
+        if (msgpack::type::STR != child_key.type) {
+            return nullptr;
+        }
+        key = child_key.as<string_view>();
+        return &child_val;
+    }
 
 private:
     SchemaTree::Node::id_t m_schema_tree_node_id;
@@ -128,13 +187,130 @@ private:
 };
 
 /**
- * Gets the schema-tree node type that corresponds with a given MessagePack value.
- * @param val
- * @return The corresponding schema-tree node type.
- * @return std::nullopt if the value doesn't match any of the supported schema-tree node types.
+ * Class for iterating the kv-pairs of a simdjson on-demand JSON object.
+ *
+ * NOTE: On-demand iterators must not be advanced before the current child's value has been fully
+ * consumed (a nested object is only consumed once its own iterator reaches the end). Therefore,
+ * advancing past a child is deferred until the next call to `has_next_child`.
  */
-[[nodiscard]] auto get_schema_tree_node_type_from_msgpack_val(msgpack::object const& val)
-        -> optional<SchemaTree::Node::Type>;
+class JsonObjectIterator {
+public:
+    // Types
+    using Value = simdjson::ondemand::value;
+
+    // Constructors
+    JsonObjectIterator(
+            SchemaTree::Node::id_t schema_tree_node_id,
+            simdjson::ondemand::object_iterator begin,
+            simdjson::ondemand::object_iterator end
+    )
+            : m_schema_tree_node_id{schema_tree_node_id},
+              m_curr_child_it{begin},
+              m_end_it{end} {}
+
+    // Methods
+    /**
+     * @param val
+     * @return The schema-tree node type that corresponds with `val`, or std::nullopt if there's
+     * none or it couldn't be determined.
+     */
+    [[nodiscard]] static auto get_schema_tree_node_type(Value& val)
+            -> optional<SchemaTree::Node::Type> {
+        return get_schema_tree_node_type_from_json_val(val);
+    }
+
+    /**
+     * Creates an iterator over the kv-pairs of the given value if it's an object.
+     * @param schema_tree_node_id The value's ID in the schema tree.
+     * @param val
+     * @param object_it Returns the iterator if `val` is an object, or std::nullopt otherwise.
+     * @return Whether `val` could be inspected.
+     */
+    [[nodiscard]] static auto create_if_map(
+            SchemaTree::Node::id_t schema_tree_node_id,
+            Value& val,
+            optional<JsonObjectIterator>& object_it
+    ) -> bool {
+        simdjson::ondemand::json_type json_type{};
+        if (simdjson::SUCCESS != val.type().get(json_type)) {
+            return false;
+        }
+        if (simdjson::ondemand::json_type::object != json_type) {
+            return true;
+        }
+        simdjson::ondemand::object obj;
+        if (simdjson::SUCCESS != val.get_object().get(obj)) {
+            return false;
+        }
+        return create(schema_tree_node_id, obj, object_it);
+    }
+
+    /**
+     * Creates an iterator over the kv-pairs of the given object.
+     * @param schema_tree_node_id The object's ID in the schema tree.
+     * @param obj
+     * @param object_it Returns the iterator.
+     * @return Whether the iterator could be created.
+     */
+    [[nodiscard]] static auto create(
+            SchemaTree::Node::id_t schema_tree_node_id,
+            simdjson::ondemand::object& obj,
+            optional<JsonObjectIterator>& object_it
+    ) -> bool {
+        simdjson::ondemand::object_iterator begin;
+        simdjson::ondemand::object_iterator end;
+        if (simdjson::SUCCESS != obj.begin().get(begin)
+            || simdjson::SUCCESS != obj.end().get(end))
+        {
+            return false;
+        }
+        object_it.emplace(schema_tree_node_id, begin, end);
+        return true;
+    }
+
+    /**
+     * @return This object's ID in the schema tree.
+     */
+    [[nodiscard]] auto get_schema_tree_node_id() const -> SchemaTree::Node::id_t {
+        return m_schema_tree_node_id;
+    }
+
+    /**
+     * Advances past the previously returned child (if any).
+     * @return Whether there are more children to traverse.
+     */
+    [[nodiscard]] auto has_next_child() -> bool {
+        if (m_is_advance_pending) {
+            ++m_curr_child_it;
+            m_is_advance_pending = false;
+        }
+        return m_curr_child_it != m_end_it;
+    }
+
+    /**
+     * Gets the next child. The underlying iterator is advanced by the next call to
+     * `has_next_child`.
+     * @param key Returns the child's unescaped key.
+     * @return A pointer to the child's value, which remains valid until this iterator is advanced
+     * or moved, or nullptr if the child couldn't be read.
+     */
+    [[nodiscard]] auto get_next_child(string_view& key) -> Value* {
+        m_is_advance_pending = true;
+        if (simdjson::SUCCESS != (*m_curr_child_it).get(m_curr_child)
+            || simdjson::SUCCESS != m_curr_child.unescaped_key().get(key))
+        {
+            return nullptr;
+        }
+        return &m_curr_child.value();
+    }
+
+private:
+    SchemaTree::Node::id_t m_schema_tree_node_id;
+    simdjson::ondemand::object_iterator m_curr_child_it;
+    simdjson::ondemand::object_iterator m_end_it;
+    simdjson::ondemand::field m_curr_child;
+    bool m_is_advance_pending{false};
+};
 
 /**
  * Serializes an empty object.
@@ -212,6 +388,23 @@ template <typename encoded_variable_t>
         vector<int8_t>& output_buf
 ) -> bool;
 
+/**
+ * Serializes the given JSON value into `output_buf`.
+ * @tparam encoded_variable_t
+ * @param val
+ * @param schema_tree_node_type
+ * @param logtype_buf
+ * @param output_buf
+ * @return Whether serialization succeeded.
+ */
+template <typename encoded_variable_t>
+[[nodiscard]] auto serialize_value(
+        simdjson::ondemand::value& val,
+        SchemaTree::Node::Type schema_tree_node_type,
+        string& logtype_buf,
+        vector<int8_t>& output_buf
+) -> bool;
+
 /**
  * Checks whether the given msgpack array can be serialized into the key-value pair IR format.
  * @param array
@@ -223,25 +416,40 @@ template <typename encoded_variable_t>
 [[nodiscard]] auto is_msgpack_array_serializable(msgpack::object const& array) -> bool;
 
 /**
- * Serializes the given msgpack map using a depth-first search (DFS).
- * @tparam SchemaTreeNodeSerializationMethod
+ * Appends the shape of the given msgpack map to `shape_buf`. A map's shape consists of its size
+ * followed by, for each kv-pair in DFS order, the key and either the value's schema-tree node type
+ * or, if the value is a map, its size. Maps with the same shape resolve to the same sequence of
+ * schema-tree nodes when serialized.
+ * @param msgpack_map
+ * @param shape_buf
+ * @return Whether the shape could be computed, i.e., the map has only string keys and supported
+ * value types.
+ */
+[[nodiscard]] auto
+append_msgpack_map_shape(msgpack::object_map const& msgpack_map, string& shape_buf) -> bool;
+
+/**
+ * Serializes the kv-pairs of the given map using a depth-first search (DFS).
+ * @tparam MapIterator The type of the iterator over a map's kv-pairs, i.e., `MsgpackMapIterator`
+ * or `JsonObjectIterator`.
+ * @tparam NodeIdResolutionMethod
  * @tparam NodeIdValuePairSerializationMethod
  * @tparam EmptyMapSerializationMethod
- * @param msgpack_map
- * @param schema_tree
- * @param schema_tree_node_serialization_method
+ * @param map_it An iterator over the kv-pairs of the map to serialize.
+ * @param node_id_resolution_method
  * @param node_id_value_pair_serialization_method
  * @param empty_map_serialization_method
  * @return Whether serialization succeeded.
  */
 template <
-        SchemaTreeNodeSerializationMethodReq SchemaTreeNodeSerializationMethod,
-        NodeIdValuePairSerializationMethodReq NodeIdValuePairSerializationMethod,
+        typename MapIterator,
+        SchemaTreeNodeIdResolutionMethodReq NodeIdResolutionMethod,
+        NodeIdValuePairSerializationMethodReq<typename MapIterator::Value>
+                NodeIdValuePairSerializationMethod,
         EmptyMapSerializationMethodReq EmptyMapSerializationMethod>
-[[nodiscard]] auto serialize_msgpack_map_using_dfs(
-        msgpack::object_map const& msgpack_map,
-        SchemaTree& schema_tree,
-        SchemaTreeNodeSerializationMethod schema_tree_node_serialization_method,
+[[nodiscard]] auto serialize_map_using_dfs(
+        MapIterator map_it,
+        NodeIdResolutionMethod node_id_resolution_method,
         NodeIdValuePairSerializationMethod node_id_value_pair_serialization_method,
         EmptyMapSerializationMethod empty_map_serialization_method
 ) -> bool;
@@ -277,6 +485,52 @@ auto get_schema_tree_node_type_from_msgpack_val(msgpack::object const& val)
     return ret_val;
 }
 
+auto get_schema_tree_node_type_from_json_val(simdjson::ondemand::value& val)
+        -> optional<SchemaTree::Node::Type> {
+    simdjson::ondemand::json_type json_type{};
+    if (simdjson::SUCCESS != val.type().get(json_type)) {
+        return std::nullopt;
+    }
+
+    optional<SchemaTree::Node::Type> ret_val;
+    switch (json_type) {
+        case simdjson::ondemand::json_type::number: {
+            simdjson::ondemand::number_type number_type{};
+            if (simdjson::SUCCESS != val.get_number_type().get(number_type)) {
+                return std::nullopt;
+            }
+            switch (number_type) {
+                case simdjson::ondemand::number_type::signed_integer:
+                case simdjson::ondemand::number_type::unsigned_integer:
+                    ret_val.emplace(SchemaTree::Node::Type::Int);
+                    break;
+                case simdjson::ondemand::number_type::floating_point_number:
+                    ret_val.emplace(SchemaTree::Node::Type::Float);
+                    break;
+                default:
+                    return std::nullopt;
+            }
+            break;
+        }
+        case simdjson::ondemand::json_type::string:
+            ret_val.emplace(SchemaTree::Node::Type::Str);
+            break;
+        case simdjson::ondemand::json_type::boolean:
+            ret_val.emplace(SchemaTree::Node::Type::Bool);
+            break;
+        case simdjson::ondemand::json_type::null:
+        case simdjson::ondemand::json_type::object:
+            ret_val.emplace(SchemaTree::Node::Type::Obj);
+            break;
+        case simdjson::ondemand::json_type::array:
+            ret_val.emplace(SchemaTree::Node::Type::UnstructuredArray);
+            break;
+        default:
+            return std::nullopt;
+    }
+    return ret_val;
+}
+
 auto serialize_value_empty_object(vector<int8_t>& output_buf) -> void {
     output_buf.push_back(cProtocol::Payload::ValueEmpty);
 }
@@ -390,6 +644,86 @@ auto serialize_value(
     return true;
 }
 
+template <typename encoded_variable_t>
+auto serialize_value(
+        simdjson::ondemand::value& val,
+        SchemaTree::Node::Type schema_tree_node_type,
+        string& logtype_buf,
+        vector<int8_t>& output_buf
+) -> bool {
+    switch (schema_tree_node_type) {
+        case SchemaTree::Node::Type::Int: {
+            // Unsigned integers larger than `INT64_MAX` fail with `NUMBER_OUT_OF_RANGE`
+            int64_t int_val{};
+            if (simdjson::SUCCESS != val.get_int64().get(int_val)) {
+                return false;
+            }
+            serialize_value_int(int_val, output_buf);
+            break;
+        }
+
+        case SchemaTree::Node::Type::Float: {
+            double float_val{};
+            if (simdjson::SUCCESS != val.get_double().get(float_val)) {
+                return false;
+            }
+            serialize_value_float(float_val, output_buf);
+            break;
+        }
+
+        case SchemaTree::Node::Type::Bool: {
+            bool bool_val{};
+            if (simdjson::SUCCESS != val.get_bool().get(bool_val)) {
+                return false;
+            }
+            serialize_value_bool(bool_val, output_buf);
+            break;
+        }
+
+        case SchemaTree::Node::Type::Str: {
+            string_view str_val;
+            if (simdjson::SUCCESS != val.get_string().get(str_val)) {
+                return false;
+            }
+            if (false
+                == serialize_value_string<encoded_variable_t>(str_val, logtype_buf, output_buf))
+            {
+                return false;
+            }
+            break;
+        }
+
+        case SchemaTree::Node::Type::Obj: {
+            bool is_null{};
+            if (simdjson::SUCCESS != val.is_null().get(is_null) || false == is_null) {
+                return false;
+            }
+            serialize_value_null(output_buf);
+            break;
+        }
+
+        case SchemaTree::Node::Type::UnstructuredArray: {
+            // Any JSON array is serializable, so we can directly encode its raw JSON text.
+            string_view array_json;
+            if (simdjson::SUCCESS != simdjson::to_json_string(val).get(array_json)) {
+                return false;
+            }
+            logtype_buf.clear();
+            if (false
+                == serialize_clp_string<encoded_variable_t>(array_json, logtype_buf, output_buf))
+            {
+                return false;
+            }
+            break;
+        }
+
+        default:
+            // Unknown schema tree node type
+            return false;
+    }
+    return true;
+}
+
 auto is_msgpack_array_serializable(msgpack::object const& array) -> bool {
     vector<msgpack::object const*> validation_stack{&array};
     while (false == validation_stack.empty()) {
@@ -432,22 +766,82 @@ auto is_msgpack_array_serializable(msgpack::object const& array) -> bool {
     return true;
 }
 
-template <
-        SchemaTreeNodeSerializationMethodReq SchemaTreeNodeSerializationMethod,
-        NodeIdValuePairSerializationMethodReq NodeIdValuePairSerializationMethod,
-        EmptyMapSerializationMethodReq EmptyMapSerializationMethod>
-[[nodiscard]] auto serialize_msgpack_map_using_dfs(
-        msgpack::object_map const& msgpack_map,
-        SchemaTree& schema_tree,
-        SchemaTreeNodeSerializationMethod schema_tree_node_serialization_method,
-        NodeIdValuePairSerializationMethod node_id_value_pair_serialization_method,
-        EmptyMapSerializationMethod empty_map_serialization_method
-) -> bool {
+auto append_msgpack_map_shape(msgpack::object_map const& msgpack_map, string& shape_buf) -> bool {
+    // Tag used in place of a schema-tree node type to mark a map value. It's distinct from all
+    // `SchemaTree::Node::Type` values so that maps can be distinguished from nulls.
+    constexpr char cMapValueTag{static_cast<char>(UINT8_MAX)};
+
+    auto const append_size = [&](uint32_t size) -> void {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        shape_buf.append(reinterpret_cast<char const*>(&size), sizeof(size));
+    };
+
+    append_size(msgpack_map.size);
+    if (0 == msgpack_map.size) {
+        return true;
+    }
+
+    // The node IDs are irrelevant when computing the shape
     vector<MsgpackMapIterator> dfs_stack;
     dfs_stack.emplace_back(
             SchemaTree::cRootId,
             span<MsgpackMapIterator::Child>{msgpack_map.ptr, msgpack_map.size}
     );
+    while (false == dfs_stack.empty()) {
+        auto& curr{dfs_stack.back()};
+        if (false == curr.has_next_child()) {
+            dfs_stack.pop_back();
+            continue;
+        }
+
+        string_view key_name;
+        auto const* val{curr.get_next_child(key_name)};
+        if (nullptr == val) {
+            return false;
+        }
+        append_size(static_cast<uint32_t>(key_name.size()));
+        shape_buf.append(key_name);
+
+        if (msgpack::type::MAP == val->type) {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-union-access)
+            auto const& inner_map{val->via.map};
+            shape_buf.push_back(cMapValueTag);
+            append_size(inner_map.size);
+            if (0 != inner_map.size) {
+                dfs_stack.emplace_back(
+                        SchemaTree::cRootId,
+                        span<MsgpackMapIterator::Child>{inner_map.ptr, inner_map.size}
+                );
+            }
+            continue;
+        }
+
+        auto const opt_schema_tree_node_type{get_schema_tree_node_type_from_msgpack_val(*val)};
+        if (false == opt_schema_tree_node_type.has_value()) {
+            return false;
+        }
+        shape_buf.push_back(
+                static_cast<char>(enum_to_underlying_type(opt_schema_tree_node_type.value()))
+        );
+    }
+
+    return true;
+}
+
+template <
+        typename MapIterator,
+        SchemaTreeNodeIdResolutionMethodReq NodeIdResolutionMethod,
+        NodeIdValuePairSerializationMethodReq<typename MapIterator::Value>
+                NodeIdValuePairSerializationMethod,
+        EmptyMapSerializationMethodReq EmptyMapSerializationMethod>
+[[nodiscard]] auto serialize_map_using_dfs(
+        MapIterator map_it,
+        NodeIdResolutionMethod node_id_resolution_method,
+        NodeIdValuePairSerializationMethod node_id_value_pair_serialization_method,
+        EmptyMapSerializationMethod empty_map_serialization_method
+) -> bool {
+    vector<MapIterator> dfs_stack;
+    dfs_stack.emplace_back(std::move(map_it));
     while (false == dfs_stack.empty()) {
         auto& curr{dfs_stack.back()};
         if (false == curr.has_next_child()) {
@@ -456,14 +850,15 @@ template <
             continue;
         }
 
-        // Convert the current value's type to its corresponding schema-tree node type
-        auto const& [key, val]{curr.get_next_child()};
-        if (msgpack::type::STR != key.type) {
+        string_view key;
+        auto* val{curr.get_next_child(key)};
+        if (nullptr == val) {
             // A map containing non-string keys is not serializable
             return false;
         }
 
-        auto const opt_schema_tree_node_type{get_schema_tree_node_type_from_msgpack_val(val)};
+        // Convert the current value's type to its corresponding schema-tree node type
+        auto const opt_schema_tree_node_type{MapIterator::get_schema_tree_node_type(*val)};
         if (false == opt_schema_tree_node_type.has_value()) {
             return false;
         }
@@ -471,32 +866,26 @@ template <
 
         SchemaTree::NodeLocator const locator{
                 curr.get_schema_tree_node_id(),
-                key.as<string_view>(),
+                key,
                 schema_tree_node_type
         };
 
-        // Get the schema-tree node that corresponds with the current kv-pair, or add it if it
-        // doesn't exist.
-        auto opt_schema_tree_node_id{schema_tree.try_get_node_id(locator)};
+        // Get the schema-tree node that corresponds with the current kv-pair
+        auto const opt_schema_tree_node_id{node_id_resolution_method(locator)};
         if (false == opt_schema_tree_node_id.has_value()) {
-            opt_schema_tree_node_id.emplace(schema_tree.insert_node(locator));
-            if (false == schema_tree_node_serialization_method(locator)) {
-                return false;
-            }
+            return false;
         }
         auto const schema_tree_node_id{opt_schema_tree_node_id.value()};
 
-        if (msgpack::type::MAP == val.type) {
+        optional<MapIterator> inner_map_it;
+        if (false == MapIterator::create_if_map(schema_tree_node_id, *val, inner_map_it)) {
+            return false;
+        }
+        if (inner_map_it.has_value()) {
             // Serialize map
-            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-union-access)
-            auto const& inner_map{val.via.map};
-            auto const inner_map_size(inner_map.size);
-            if (0 != inner_map_size) {
+            if (inner_map_it->has_next_child()) {
                 // Add map for DFS iteration
-                dfs_stack.emplace_back(
-                        schema_tree_node_id,
-                        span<MsgpackMapIterator::Child>{inner_map.ptr, inner_map_size}
-                );
+                dfs_stack.emplace_back(std::move(inner_map_it.value()));
             } else {
                 if (false == empty_map_serialization_method(schema_tree_node_id)) {
                     return false;
@@ -509,7 +898,7 @@ template <
         if (false
             == node_id_value_pair_serialization_method(
                     schema_tree_node_id,
-                    val,
+                    *val,
                     schema_tree_node_type
             ))
         {
@@ -578,6 +967,184 @@ template <typename encoded_variable_t>
 auto Serializer<encoded_variable_t>::serialize_msgpack_map(
         msgpack::object_map const& auto_gen_kv_pairs_map,
         msgpack::object_map const& user_gen_kv_pairs_map
+) -> bool {
+    return serialize_msgpack_map_pair(
+            auto_gen_kv_pairs_map,
+            user_gen_kv_pairs_map,
+            [this](SchemaTree::NodeLocator const& locator) -> optional<SchemaTree::Node::id_t> {
+                return this->get_or_insert_schema_tree_node<true>(locator);
+            },
+            [this](SchemaTree::NodeLocator const& locator) -> optional<SchemaTree::Node::id_t> {
+                return this->get_or_insert_schema_tree_node<false>(locator);
+            }
+    );
+}
+
+template <typename encoded_variable_t>
+auto Serializer<encoded_variable_t>::serialize_msgpack_map_batch(
+        span<MsgpackMapPair const> log_events,
+        BatchStats& stats
+) -> bool {
+    stats = {};
+    auto const orig_ir_buf_size{m_ir_buf.size()};
+
+    bool all_serialized{true};
+    for (auto const& [auto_gen_kv_pairs_map, user_gen_kv_pairs_map] : log_events) {
+        m_shape_buf.clear();
+        if (false == append_msgpack_map_shape(auto_gen_kv_pairs_map, m_shape_buf)
+            || false == append_msgpack_map_shape(user_gen_kv_pairs_map, m_shape_buf))
+        {
+            all_serialized = false;
+            break;
+        }
+
+        if (auto const it{m_shape_cache.find(m_shape_buf)}; m_shape_cache.cend() != it) {
+            ++stats.num_shape_cache_hits;
+
+            // Since the shapes are identical, the DFS visits exactly the cached nodes in order.
+            auto const& cached_shape{it->second};
+            size_t auto_gen_node_idx{0};
+            size_t user_gen_node_idx{0};
+            auto get_cached_auto_gen_node_id
+                    = [&](SchemaTree::NodeLocator const&) -> optional<SchemaTree::Node::id_t> {
+                return cached_shape.auto_gen_node_ids[auto_gen_node_idx++];
+            };
+            auto get_cached_user_gen_node_id
+                    = [&](SchemaTree::NodeLocator const&) -> optional<SchemaTree::Node::id_t> {
+                return cached_shape.user_gen_node_ids[user_gen_node_idx++];
+            };
+            if (false
+                == serialize_msgpack_map_pair(
+                        auto_gen_kv_pairs_map,
+                        user_gen_kv_pairs_map,
+                        get_cached_auto_gen_node_id,
+                        get_cached_user_gen_node_id
+                ))
+            {
+                all_serialized = false;
+                break;
+            }
+        } else {
+            ++stats.num_shape_cache_misses;
+
+            CachedShape new_shape;
+            auto get_and_record_auto_gen_node_id = [&](SchemaTree::NodeLocator const& locator
+                                                   ) -> optional<SchemaTree::Node::id_t> {
+                auto const node_id{this->get_or_insert_schema_tree_node<true>(locator)};
+                if (node_id.has_value()) {
+                    new_shape.auto_gen_node_ids.push_back(node_id.value());
+                }
+                return node_id;
+            };
+            auto get_and_record_user_gen_node_id = [&](SchemaTree::NodeLocator const& locator
+                                                   ) -> optional<SchemaTree::Node::id_t> {
+                auto const node_id{this->get_or_insert_schema_tree_node<false>(locator)};
+                if (node_id.has_value()) {
+                    new_shape.user_gen_node_ids.push_back(node_id.value());
+                }
+                return node_id;
+            };
+            if (false
+                == serialize_msgpack_map_pair(
+                        auto_gen_kv_pairs_map,
+                        user_gen_kv_pairs_map,
+                        get_and_record_auto_gen_node_id,
+                        get_and_record_user_gen_node_id
+                ))
+            {
+                all_serialized = false;
+                break;
+            }
+
+            if (m_shape_cache.size() >= cMaxNumCachedShapes) {
+                // The set of shapes in the stream has changed significantly, so start over.
+                m_shape_cache.clear();
+            }
+            m_shape_cache.emplace(m_shape_buf, std::move(new_shape));
+        }
+        ++stats.num_serialized_log_events;
+    }
+
+    stats.num_serialized_bytes = m_ir_buf.size() - orig_ir_buf_size;
+    return all_serialized;
+}
+
+template <typename encoded_variable_t>
+auto Serializer<encoded_variable_t>::serialize_json_object(
+        simdjson::ondemand::object& auto_gen_kv_pairs_object,
+        simdjson::ondemand::object& user_gen_kv_pairs_object
+) -> bool {
+    optional<JsonObjectIterator> auto_gen_object_it;
+    optional<JsonObjectIterator> user_gen_object_it;
+    if (false
+        == JsonObjectIterator::create(
+                SchemaTree::cRootId,
+                auto_gen_kv_pairs_object,
+                auto_gen_object_it
+        ))
+    {
+        return false;
+    }
+    if (false
+        == JsonObjectIterator::create(
+                SchemaTree::cRootId,
+                user_gen_kv_pairs_object,
+                user_gen_object_it
+        ))
+    {
+        return false;
+    }
+
+    return serialize_map_pair(
+            std::move(auto_gen_object_it.value()),
+            std::move(user_gen_object_it.value()),
+            [this](SchemaTree::NodeLocator const& locator) -> optional<SchemaTree::Node::id_t> {
+                return this->get_or_insert_schema_tree_node<true>(locator);
+            },
+            [this](SchemaTree::NodeLocator const& locator) -> optional<SchemaTree::Node::id_t> {
+                return this->get_or_insert_schema_tree_node<false>(locator);
+            }
+    );
+}
+
+template <typename encoded_variable_t>
+template <typename AutoGenNodeIdResolutionMethod, typename UserGenNodeIdResolutionMethod>
+auto Serializer<encoded_variable_t>::serialize_msgpack_map_pair(
+        msgpack::object_map const& auto_gen_kv_pairs_map,
+        msgpack::object_map const& user_gen_kv_pairs_map,
+        AutoGenNodeIdResolutionMethod auto_gen_node_id_resolution_method,
+        UserGenNodeIdResolutionMethod user_gen_node_id_resolution_method
+) -> bool {
+    return serialize_map_pair(
+            MsgpackMapIterator{
+                    SchemaTree::cRootId,
+                    span<MsgpackMapIterator::Child>{
+                            auto_gen_kv_pairs_map.ptr,
+                            auto_gen_kv_pairs_map.size
+                    }
+            },
+            MsgpackMapIterator{
+                    SchemaTree::cRootId,
+                    span<MsgpackMapIterator::Child>{
+                            user_gen_kv_pairs_map.ptr,
+                            user_gen_kv_pairs_map.size
+                    }
+            },
+            auto_gen_node_id_resolution_method,
+            user_gen_node_id_resolution_method
+    );
+}
+
+template <typename encoded_variable_t>
+template <
+        typename MapIterator,
+        typename AutoGenNodeIdResolutionMethod,
+        typename UserGenNodeIdResolutionMethod>
+auto Serializer<encoded_variable_t>::serialize_map_pair(
+        MapIterator auto_gen_map_it,
+        MapIterator user_gen_map_it,
+        AutoGenNodeIdResolutionMethod auto_gen_node_id_resolution_method,
+        UserGenNodeIdResolutionMethod user_gen_node_id_resolution_method
 ) -> bool {
     m_auto_gen_keys_schema_tree.take_snapshot();
     m_user_gen_keys_schema_tree.take_snapshot();
@@ -594,83 +1161,69 @@ auto Serializer<encoded_variable_t>::serialize_msgpack_map(
     m_user_gen_val_group_buf.clear();
 
     // Serialize auto-generated kv pairs
-    auto auto_gen_schema_tree_node_serialization_method
-            = [this](SchemaTree::NodeLocator const& locator) -> bool {
-        return this->serialize_schema_tree_node<true>(locator);
-    };
+    if (false
+        == serialize_kv_pairs<true>(
+                std::move(auto_gen_map_it),
+                auto_gen_node_id_resolution_method
+        ))
+    {
+        return false;
+    }
 
-    auto auto_gen_node_id_value_pairs_serialization_method
-            = [&](SchemaTree::Node::id_t node_id,
-                  msgpack::object const& val,
-                  SchemaTree::Node::Type schema_tree_node_type) -> bool {
-        if (false
-            == encode_and_serialize_schema_tree_node_id<
-                    true,
-                    cProtocol::Payload::EncodedSchemaTreeNodeIdByte,
-                    cProtocol::Payload::EncodedSchemaTreeNodeIdShort,
-                    cProtocol::Payload::EncodedSchemaTreeNodeIdInt>(
-                    node_id,
-                    m_sequential_serialization_buf
-            ))
-        {
-            return false;
-        }
+    // Serialize user-generated kv pairs
+    if (false == user_gen_map_it.has_next_child()) {
+        serialize_value_empty_object(m_sequential_serialization_buf);
+    } else {
         if (false
-            == serialize_value<encoded_variable_t>(
-                    val,
-                    schema_tree_node_type,
-                    m_logtype_buf,
-                    m_sequential_serialization_buf
+            == serialize_kv_pairs<false>(
+                    std::move(user_gen_map_it),
+                    user_gen_node_id_resolution_method
             ))
         {
             return false;
         }
-        return true;
-    };
+    }
 
-    auto auto_gen_empty_map_serialization_method = [&](SchemaTree::Node::id_t node_id) -> bool {
-        if (false
-            == encode_and_serialize_schema_tree_node_id<
-                    true,
-                    cProtocol::Payload::EncodedSchemaTreeNodeIdByte,
-                    cProtocol::Payload::EncodedSchemaTreeNodeIdShort,
-                    cProtocol::Payload::EncodedSchemaTreeNodeIdInt>(
-                    node_id,
-                    m_sequential_serialization_buf
-            ))
-        {
-            return false;
-        }
-        serialize_value_empty_object(m_sequential_serialization_buf);
-        return true;
-    };
+    // Copy serialized results into `m_ir_buf`
+    m_ir_buf.insert(
+            m_ir_buf.cend(),
+            m_schema_tree_node_buf.cbegin(),
+            m_schema_tree_node_buf.cend()
+    );
+    m_ir_buf.insert(
+            m_ir_buf.cend(),
+            m_sequential_serialization_buf.cbegin(),
+            m_sequential_serialization_buf.cend()
+    );
+    m_ir_buf.insert(
+            m_ir_buf.cend(),
+            m_user_gen_val_group_buf.cbegin(),
+            m_user_gen_val_group_buf.cend()
+    );
 
-    if (0 != auto_gen_kv_pairs_map.size
-        && false
-                   == serialize_msgpack_map_using_dfs(
-                           auto_gen_kv_pairs_map,
-                           m_auto_gen_keys_schema_tree,
-                           auto_gen_schema_tree_node_serialization_method,
-                           auto_gen_node_id_value_pairs_serialization_method,
-                           auto_gen_empty_map_serialization_method
-                   ))
-    {
-        return false;
-    }
+    revert_manager.mark_success();
+    return true;
+}
 
-    // Serialize user-generated kv pairs
-    auto user_gen_schema_tree_node_serialization_method
-            = [this](SchemaTree::NodeLocator const& locator) -> bool {
-        return this->serialize_schema_tree_node<false>(locator);
+template <typename encoded_variable_t>
+template <bool is_auto_generated_node, typename MapIterator, typename NodeIdResolutionMethod>
+auto Serializer<encoded_variable_t>::serialize_kv_pairs(
+        MapIterator map_it,
+        NodeIdResolutionMethod node_id_resolution_method
+) -> bool {
+    // Auto-generated values are serialized inline with their node IDs, whereas user-generated
+    // values are grouped after all the node IDs.
+    auto& val_buf{
+            is_auto_generated_node ? m_sequential_serialization_buf : m_user_gen_val_group_buf
     };
 
-    auto user_gen_node_id_value_pairs_serialization_method
+    auto node_id_value_pair_serialization_method
             = [&](SchemaTree::Node::id_t node_id,
-                  msgpack::object const& val,
+                  typename MapIterator::Value& val,
                   SchemaTree::Node::Type schema_tree_node_type) -> bool {
         if (false
             == encode_and_serialize_schema_tree_node_id<
-                    false,
+                    is_auto_generated_node,
                     cProtocol::Payload::EncodedSchemaTreeNodeIdByte,
                     cProtocol::Payload::EncodedSchemaTreeNodeIdShort,
                     cProtocol::Payload::EncodedSchemaTreeNodeIdInt>(
@@ -680,23 +1233,18 @@ auto Serializer<encoded_variable_t>::serialize_msgpack_map(
         {
             return false;
         }
-        if (false
-            == serialize_value<encoded_variable_t>(
-                    val,
-                    schema_tree_node_type,
-                    m_logtype_buf,
-                    m_user_gen_val_group_buf
-            ))
-        {
-            return false;
-        }
-        return true;
+        return serialize_value<encoded_variable_t>(
+                val,
+                schema_tree_node_type,
+                m_logtype_buf,
+                val_buf
+        );
     };
 
-    auto user_gen_empty_map_serialization_method = [&](SchemaTree::Node::id_t node_id) -> bool {
+    auto empty_map_serialization_method = [&](SchemaTree::Node::id_t node_id) -> bool {
         if (false
             == encode_and_serialize_schema_tree_node_id<
-                    false,
+                    is_auto_generated_node,
                     cProtocol::Payload::EncodedSchemaTreeNodeIdByte,
                     cProtocol::Payload::EncodedSchemaTreeNodeIdShort,
                     cProtocol::Payload::EncodedSchemaTreeNodeIdInt>(
@@ -706,45 +1254,34 @@ auto Serializer<encoded_variable_t>::serialize_msgpack_map(
         {
             return false;
         }
-        serialize_value_empty_object(m_user_gen_val_group_buf);
+        serialize_value_empty_object(val_buf);
         return true;
     };
 
-    if (0 == user_gen_kv_pairs_map.size) {
-        serialize_value_empty_object(m_sequential_serialization_buf);
-    } else {
-        if (false
-            == serialize_msgpack_map_using_dfs(
-                    user_gen_kv_pairs_map,
-                    m_user_gen_keys_schema_tree,
-                    user_gen_schema_tree_node_serialization_method,
-                    user_gen_node_id_value_pairs_serialization_method,
-                    user_gen_empty_map_serialization_method
-            ))
-        {
-            return false;
-        }
-    }
-
-    // Copy serialized results into `m_ir_buf`
-    m_ir_buf.insert(
-            m_ir_buf.cend(),
-            m_schema_tree_node_buf.cbegin(),
-            m_schema_tree_node_buf.cend()
-    );
-    m_ir_buf.insert(
-            m_ir_buf.cend(),
-            m_sequential_serialization_buf.cbegin(),
-            m_sequential_serialization_buf.cend()
-    );
-    m_ir_buf.insert(
-            m_ir_buf.cend(),
-            m_user_gen_val_group_buf.cbegin(),
-            m_user_gen_val_group_buf.cend()
+    return serialize_map_using_dfs(
+            std::move(map_it),
+            node_id_resolution_method,
+            node_id_value_pair_serialization_method,
+            empty_map_serialization_method
     );
+}
 
-    revert_manager.mark_success();
-    return true;
+template <typename encoded_variable_t>
+template <bool is_auto_generated_node>
+auto Serializer<encoded_variable_t>::get_or_insert_schema_tree_node(
+        SchemaTree::NodeLocator const& locator
+) -> optional<SchemaTree::Node::id_t> {
+    auto& schema_tree{
+            is_auto_generated_node ? m_auto_gen_keys_schema_tree : m_user_gen_keys_schema_tree
+    };
+    if (auto const node_id{schema_tree.try_get_node_id(locator)}; node_id.has_value()) {
+        return node_id;
+    }
+    auto const node_id{schema_tree.insert_node(locator)};
+    if (false == serialize_schema_tree_node<is_auto_generated_node>(locator)) {
+        return std::nullopt;
+    }
+    return node_id;
 }
 
 template <typename encoded_variable_t>
@@ -815,6 +1352,37 @@ template auto Serializer<four_byte_encoded_variable_t>::serialize_msgpack_map(
         msgpack::object_map const& user_gen_kv_pairs_map
 ) -> bool;
 
+template auto Serializer<eight_byte_encoded_variable_t>::serialize_msgpack_map_batch(
+        span<MsgpackMapPair const> log_events,
+        BatchStats& stats
+) -> bool;
+template auto Serializer<four_byte_encoded_variable_t>::serialize_msgpack_map_batch(
+        span<MsgpackMapPair const> log_events,
+        BatchStats& stats
+) -> bool;
+
+template auto Serializer<eight_byte_encoded_variable_t>::serialize_json_object(
+        simdjson::ondemand::object& auto_gen_kv_pairs_object,
+        simdjson::ondemand::object& user_gen_kv_pairs_object
+) -> bool;
+template auto Serializer<four_byte_encoded_variable_t>::serialize_json_object(
+        simdjson::ondemand::object& auto_gen_kv_pairs_object,
+        simdjson::ondemand::object& user_gen_kv_pairs_object
+) -> bool;
+
+template auto Serializer<eight_byte_encoded_variable_t>::get_or_insert_schema_tree_node<true>(
+        SchemaTree::NodeLocator const& locator
+) -> optional<SchemaTree::Node::id_t>;
+template auto Serializer<eight_byte_encoded_variable_t>::get_or_insert_schema_tree_node<false>(
+        SchemaTree::NodeLocator const& locator
+) -> optional<SchemaTree::Node::id_t>;
+template auto Serializer<four_byte_encoded_variable_t>::get_or_insert_schema_tree_node<true>(
+        SchemaTree::NodeLocator const& locator
+) -> optional<SchemaTree::Node::id_t>;
+template auto Serializer<four_byte_encoded_variable_t>::get_or_insert_schema_tree_node<false>(
+        SchemaTree::NodeLocator const& locator
+) -> optional<SchemaTree::Node::id_t>;
+
 template auto Serializer<eight_byte_encoded_variable_t>::serialize_schema_tree_node<true>(
         SchemaTree::NodeLocator const& locator
 ) -> bool;
@@ -1,14 +1,18 @@
 #ifndef CLP_FFI_IR_STREAM_SERIALIZER_HPP
 #define CLP_FFI_IR_STREAM_SERIALIZER_HPP
 
+#include <cstddef>
 #include <cstdint>
 #include <optional>
 #include <span>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <msgpack.hpp>
 #include <nlohmann/json.hpp>
+#include <simdjson.h>
 #include <ystdlib/error_handling/Result.hpp>
 
 #include "../../time_types.hpp"
@@ -38,6 +42,22 @@ public:
     using Buffer = std::vector<int8_t>;
     using BufferView = std::span<int8_t const>;
 
+    /**
+     * A log event given as a pair of msgpack maps: the auto-generated and the user-generated
+     * kv-pairs.
+     */
+    using MsgpackMapPair = std::pair<msgpack::object_map, msgpack::object_map>;
+
+    /**
+     * Statistics of a call to `serialize_msgpack_map_batch`.
+     */
+    struct BatchStats {
+        size_t num_serialized_log_events{0};
+        size_t num_serialized_bytes{0};
+        size_t num_shape_cache_hits{0};
+        size_t num_shape_cache_misses{0};
+    };
+
     // Factory functions
     /**
      * Creates an IR serializer and serializes the stream's preamble.
@@ -98,11 +118,130 @@ public:
             msgpack::object_map const& user_gen_kv_pairs_map
     ) -> bool;
 
+    /**
+     * Serializes the given batch of msgpack map pairs as key-value pair log events.
+     *
+     * Log events with the same shape (i.e., the same keys, value types, and nesting structure)
+     * resolve to the same schema-tree nodes. So instead of looking up every key in the schema
+     * trees, this method caches the resolved node IDs of each shape it encounters and reuses them
+     * for subsequent log events with the same shape. The serialized bytes are identical to those
+     * produced by calling `serialize_msgpack_map` on each log event.
+     *
+     * Serialization stops at the first log event that can't be serialized. The log events before it
+     * remain serialized in the IR buffer.
+     * @param log_events
+     * @param stats Returns the statistics of this batch.
+     * @return Whether all log events were serialized.
+     */
+    [[nodiscard]] auto
+    serialize_msgpack_map_batch(std::span<MsgpackMapPair const> log_events, BatchStats& stats)
+            -> bool;
+
+    /**
+     * Serializes the given JSON objects as a key-value pair log event.
+     *
+     * Unlike `serialize_msgpack_map`, this method walks the given simdjson on-demand objects
+     * directly, so callers holding JSON text don't need to convert it into an intermediate
+     * MessagePack object first. The serialized log event is byte-identical to the one produced by
+     * `serialize_msgpack_map` for the equivalent MessagePack maps, except for unstructured arrays,
+     * which are serialized using their original JSON text.
+     *
+     * NOTE: Since on-demand objects can only be iterated once and in document order, the two
+     * objects must come from two different documents (and thus two different parsers).
+     * @param auto_gen_kv_pairs_object
+     * @param user_gen_kv_pairs_object
+     * @return Whether serialization succeeded.
+     */
+    [[nodiscard]] auto serialize_json_object(
+            simdjson::ondemand::object& auto_gen_kv_pairs_object,
+            simdjson::ondemand::object& user_gen_kv_pairs_object
+    ) -> bool;
+
 private:
+    // Types
+    /**
+     * The schema-tree node IDs a log event shape resolves to, in DFS order.
+     */
+    struct CachedShape {
+        std::vector<SchemaTree::Node::id_t> auto_gen_node_ids;
+        std::vector<SchemaTree::Node::id_t> user_gen_node_ids;
+    };
+
+    // Constants
+    static constexpr size_t cMaxNumCachedShapes{4096};
+
     // Constructors
     Serializer() = default;
 
     // Methods
+    /**
+     * Serializes the given msgpack maps as a key-value pair log event, using the given methods to
+     * resolve the IDs of the schema-tree nodes of each kv-pair.
+     * @tparam AutoGenNodeIdResolutionMethod
+     * @tparam UserGenNodeIdResolutionMethod
+     * @param auto_gen_kv_pairs_map
+     * @param user_gen_kv_pairs_map
+     * @param auto_gen_node_id_resolution_method
+     * @param user_gen_node_id_resolution_method
+     * @return Whether serialization succeeded.
+     */
+    template <typename AutoGenNodeIdResolutionMethod, typename UserGenNodeIdResolutionMethod>
+    [[nodiscard]] auto serialize_msgpack_map_pair(
+            msgpack::object_map const& auto_gen_kv_pairs_map,
+            msgpack::object_map const& user_gen_kv_pairs_map,
+            AutoGenNodeIdResolutionMethod auto_gen_node_id_resolution_method,
+            UserGenNodeIdResolutionMethod user_gen_node_id_resolution_method
+    ) -> bool;
+
+    /**
+     * Serializes the kv-pairs of the given maps as a key-value pair log event, using the given
+     * methods to resolve the IDs of the schema-tree nodes of each kv-pair.
+     * @tparam MapIterator The type of the iterator over a map's kv-pairs.
+     * @tparam AutoGenNodeIdResolutionMethod
+     * @tparam UserGenNodeIdResolutionMethod
+     * @param auto_gen_map_it
+     * @param user_gen_map_it
+     * @param auto_gen_node_id_resolution_method
+     * @param user_gen_node_id_resolution_method
+     * @return Whether serialization succeeded.
+     */
+    template <
+            typename MapIterator,
+            typename AutoGenNodeIdResolutionMethod,
+            typename UserGenNodeIdResolutionMethod>
+    [[nodiscard]] auto serialize_map_pair(
+            MapIterator auto_gen_map_it,
+            MapIterator user_gen_map_it,
+            AutoGenNodeIdResolutionMethod auto_gen_node_id_resolution_method,
+            UserGenNodeIdResolutionMethod user_gen_node_id_resolution_method
+    ) -> bool;
+
+    /**
+     * Serializes the kv-pairs of the given map into the buffers of either the auto-generated or
+     * the user-generated kv-pairs.
+     * @tparam is_auto_generated_node
+     * @tparam MapIterator The type of the iterator over a map's kv-pairs.
+     * @tparam NodeIdResolutionMethod
+     * @param map_it
+     * @param node_id_resolution_method
+     * @return Whether serialization succeeded.
+     */
+    template <bool is_auto_generated_node, typename MapIterator, typename NodeIdResolutionMethod>
+    [[nodiscard]] auto
+    serialize_kv_pairs(MapIterator map_it, NodeIdResolutionMethod node_id_resolution_method)
+            -> bool;
+
+    /**
+     * Gets the ID of the schema-tree node identified by the given locator, inserting the node into
+     * the corresponding schema tree and serializing it if it doesn't exist.
+     * @tparam is_auto_generated_node
+     * @param locator
+     * @return The node's ID on success, or std::nullopt if the node couldn't be serialized.
+     */
+    template <bool is_auto_generated_node>
+    [[nodiscard]] auto get_or_insert_schema_tree_node(SchemaTree::NodeLocator const& locator)
+            -> std::optional<SchemaTree::Node::id_t>;
+
     /**
      * Serializes a schema tree node identified by the given locator into `m_schema_tree_node_buf`.
      * @tparam is_auto_generated_node
@@ -121,6 +260,9 @@ private:
     Buffer m_schema_tree_node_buf;
     Buffer m_sequential_serialization_buf;
     Buffer m_user_gen_val_group_buf;
+
+    std::string m_shape_buf;
+    std::unordered_map<std::string, CachedShape> m_shape_cache;
 };
 }  // namespace clp::ffi::ir_stream
 
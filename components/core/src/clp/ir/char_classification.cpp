@@ -0,0 +1,220 @@
+#include "char_classification.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#if CLP_IR_CHAR_CLASSIFICATION_AVX2_SUPPORTED
+    #include <immintrin.h>
+#endif
+
+namespace clp::ir {
+namespace {
+/*
+ * Each character is classified by looking up its low and high nibbles in two 16-entry tables and
+ * AND-ing the results (the technique used by simdjson's structural character classification). Since
+ * AND-ing only works for classes whose characters form a product of a set of high nibbles and a set
+ * of low nibbles, we split the character classes we care about into the following sub-classes:
+ */
+// [0-9] (high nibble 0x3, low nibbles 0x0-0x9)
+constexpr uint8_t cDigitBit{1U << 0U};
+// [A-Oa-o] (high nibbles 0x4 and 0x6, low nibbles 0x1-0xF)
+constexpr uint8_t cAlphabetAToOBit{1U << 1U};
+// [P-Zp-z] (high nibbles 0x5 and 0x7, low nibbles 0x0-0xA)
+constexpr uint8_t cAlphabetPToZBit{1U << 2U};
+// [+\-.] (high nibble 0x2, low nibbles 0xB, 0xD, and 0xE)
+constexpr uint8_t cPlusMinusPeriodBit{1U << 3U};
+// [\\_] (high nibble 0x5, low nibbles 0xC and 0xF)
+constexpr uint8_t cBackslashUnderscoreBit{1U << 4U};
+// [A-Fa-f] (high nibbles 0x4 and 0x6, low nibbles 0x1-0x6)
+constexpr uint8_t cHexAlphabetBit{1U << 5U};
+
+constexpr uint8_t cAlphabetBits{cAlphabetAToOBit | cAlphabetPToZBit};
+constexpr uint8_t cHexDigitBits{cDigitBit | cHexAlphabetBit};
+
+constexpr std::array<uint8_t, 16> cLowNibbleTable{
+        cDigitBit | cAlphabetPToZBit,
+        cDigitBit | cAlphabetAToOBit | cAlphabetPToZBit | cHexAlphabetBit,
+        cDigitBit | cAlphabetAToOBit | cAlphabetPToZBit | cHexAlphabetBit,
+        cDigitBit | cAlphabetAToOBit | cAlphabetPToZBit | cHexAlphabetBit,
+        cDigitBit | cAlphabetAToOBit | cAlphabetPToZBit | cHexAlphabetBit,
+        cDigitBit | cAlphabetAToOBit | cAlphabetPToZBit | cHexAlphabetBit,
+        cDigitBit | cAlphabetAToOBit | cAlphabetPToZBit | cHexAlphabetBit,
+        cDigitBit | cAlphabetAToOBit | cAlphabetPToZBit,
+        cDigitBit | cAlphabetAToOBit | cAlphabetPToZBit,
+        cDigitBit | cAlphabetAToOBit | cAlphabetPToZBit,
+        cAlphabetAToOBit | cAlphabetPToZBit,
+        cAlphabetAToOBit | cPlusMinusPeriodBit,
+        cAlphabetAToOBit | cBackslashUnderscoreBit,
+        cAlphabetAToOBit | cPlusMinusPeriodBit,
+        cAlphabetAToOBit | cPlusMinusPeriodBit,
+        cAlphabetAToOBit | cBackslashUnderscoreBit
+};
+
+// High nibbles 0x8-0xF (i.e., non-ASCII characters) are always delimiters
+constexpr std::array<uint8_t, 16> cHighNibbleTable{
+        0,
+        0,
+        cPlusMinusPeriodBit,
+        cDigitBit,
+        cAlphabetAToOBit | cHexAlphabetBit,
+        cAlphabetPToZBit | cBackslashUnderscoreBit,
+        cAlphabetAToOBit | cHexAlphabetBit,
+        cAlphabetPToZBit,
+        0,
+        0,
+        0,
+        0,
+        0,
+        0,
+        0,
+        0
+};
+
+constexpr uint8_t cLowNibbleMask{0x0F};
+constexpr uint8_t cHighNibbleShift{4};
+
+/**
+ * @param c
+ * @return The sub-class bits of the given character.
+ */
+constexpr auto get_char_class_bits(char c) -> uint8_t {
+    auto const byte{static_cast<uint8_t>(c)};
+    return cLowNibbleTable.at(byte & cLowNibbleMask)
+           & cHighNibbleTable.at(static_cast<uint8_t>(byte >> cHighNibbleShift));
+}
+
+/**
+ * Validates the nibble tables against the scalar definitions of each character class.
+ * @return Whether every character is classified correctly.
+ */
+constexpr auto validate_char_class_tables() -> bool {
+    for (int i{0}; i <= UINT8_MAX; ++i) {
+        auto const c{static_cast<char>(i)};
+        bool const is_decimal_digit{'0' <= c && c <= '9'};
+        bool const is_alphabet{('a' <= c && c <= 'z') || ('A' <= c && c <= 'Z')};
+        bool const is_hex_digit{
+                is_decimal_digit || ('a' <= c && c <= 'f') || ('A' <= c && c <= 'F')
+        };
+        bool const is_non_delim{
+                '+' == c || ('-' <= c && c <= '.') || is_decimal_digit || is_alphabet || '\\' == c
+                || '_' == c
+        };
+
+        auto const class_bits{get_char_class_bits(c)};
+        if (is_non_delim != (0 != class_bits)
+            || is_decimal_digit != (0 != (class_bits & cDigitBit))
+            || is_alphabet != (0 != (class_bits & cAlphabetBits))
+            || is_hex_digit != (0 != (class_bits & cHexDigitBits)))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static_assert(validate_char_class_tables());
+
+#if CLP_IR_CHAR_CLASSIFICATION_AVX2_SUPPORTED
+/**
+ * @param class_bits_vec The sub-class bits of 32 characters.
+ * @param class_bits
+ * @return A bitmask indicating which of the 32 characters have any of the given sub-class bits set.
+ */
+[[gnu::target("avx2")]] auto get_class_mask_avx2(__m256i class_bits_vec, uint8_t class_bits)
+        -> uint32_t {
+    auto const class_bits_mask{_mm256_set1_epi8(static_cast<char>(class_bits))};
+    auto const masked{_mm256_and_si256(class_bits_vec, class_bits_mask)};
+    auto const is_not_in_class{_mm256_cmpeq_epi8(masked, _mm256_setzero_si256())};
+    return ~static_cast<uint32_t>(_mm256_movemask_epi8(is_not_in_class));
+}
+#endif
+}  // namespace
+
+auto classify_chars_portable(std::string_view str, size_t pos) -> CharClassMasks {
+    auto const num_chars{std::min(cCharClassificationBlockSize, str.length() - pos)};
+    CharClassMasks masks;
+    for (size_t i{0}; i < num_chars; ++i) {
+        auto const class_bits{get_char_class_bits(str[pos + i])};
+        uint64_t const bit{1ULL << i};
+        if (0 != class_bits) {
+            masks.non_delim |= bit;
+        }
+        if (0 != (class_bits & cDigitBit)) {
+            masks.decimal_digit |= bit;
+        }
+        if (0 != (class_bits & cAlphabetBits)) {
+            masks.alphabet |= bit;
+        }
+        if (0 != (class_bits & cHexDigitBits)) {
+            masks.hex_digit |= bit;
+        }
+    }
+    return masks;
+}
+
+#if CLP_IR_CHAR_CLASSIFICATION_AVX2_SUPPORTED
+[[gnu::target("avx2")]] auto classify_chars_avx2(std::string_view str, size_t pos)
+        -> CharClassMasks {
+    constexpr size_t cNumCharsPerVector{32};
+
+    // Copy a partial block into a zero-padded buffer so we never read past the end of the string.
+    // NUL characters are delimiters, so the padding doesn't affect any class mask.
+    char const* block{str.data() + pos};
+    auto const num_chars{std::min(cCharClassificationBlockSize, str.length() - pos)};
+    std::array<char, cCharClassificationBlockSize> padded_block;
+    if (num_chars < cCharClassificationBlockSize) {
+        padded_block.fill('\0');
+        std::memcpy(padded_block.data(), block, num_chars);
+        block = padded_block.data();
+    }
+
+    auto const low_nibble_table{_mm256_broadcastsi128_si256(
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+            _mm_loadu_si128(reinterpret_cast<__m128i const*>(cLowNibbleTable.data()))
+    )};
+    auto const high_nibble_table{_mm256_broadcastsi128_si256(
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+            _mm_loadu_si128(reinterpret_cast<__m128i const*>(cHighNibbleTable.data()))
+    )};
+    auto const low_nibble_mask{_mm256_set1_epi8(static_cast<char>(cLowNibbleMask))};
+
+    CharClassMasks masks;
+    for (size_t offset{0}; offset < cCharClassificationBlockSize; offset += cNumCharsPerVector) {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        auto const chars{_mm256_loadu_si256(reinterpret_cast<__m256i const*>(block + offset))};
+        auto const low_nibbles{_mm256_and_si256(chars, low_nibble_mask)};
+        auto const high_nibbles{
+                _mm256_and_si256(_mm256_srli_epi16(chars, cHighNibbleShift), low_nibble_mask)
+        };
+        auto const class_bits_vec{_mm256_and_si256(
+                _mm256_shuffle_epi8(low_nibble_table, low_nibbles),
+                _mm256_shuffle_epi8(high_nibble_table, high_nibbles)
+        )};
+
+        masks.non_delim |= static_cast<uint64_t>(get_class_mask_avx2(class_bits_vec, UINT8_MAX))
+                           << offset;
+        masks.decimal_digit |= static_cast<uint64_t>(get_class_mask_avx2(class_bits_vec, cDigitBit))
+                               << offset;
+        masks.alphabet |= static_cast<uint64_t>(get_class_mask_avx2(class_bits_vec, cAlphabetBits))
+                          << offset;
+        masks.hex_digit |= static_cast<uint64_t>(get_class_mask_avx2(class_bits_vec, cHexDigitBits))
+                           << offset;
+    }
+
+    return masks;
+}
+#endif
+
+auto is_avx2_supported() -> bool {
+#if CLP_IR_CHAR_CLASSIFICATION_AVX2_SUPPORTED
+    static bool const cIsAvx2Supported{0 != __builtin_cpu_supports("avx2")};
+    return cIsAvx2Supported;
+#else
+    return false;
+#endif
+}
+}  // namespace clp::ir
@@ -0,0 +1,64 @@
+#ifndef CLP_IR_CHAR_CLASSIFICATION_HPP
+#define CLP_IR_CHAR_CLASSIFICATION_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// The AVX2 classifier is compiled using function-level target attributes, so it doesn't require
+// building with `-mavx2`; whether it can be used is determined at runtime.
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+    #define CLP_IR_CHAR_CLASSIFICATION_AVX2_SUPPORTED 1
+#else
+    #define CLP_IR_CHAR_CLASSIFICATION_AVX2_SUPPORTED 0
+#endif
+
+namespace clp::ir {
+/**
+ * Number of characters classified at a time.
+ */
+constexpr size_t cCharClassificationBlockSize{64};
+
+/**
+ * Bitmasks describing the classes of a block of up to `cCharClassificationBlockSize` characters.
+ * Bit `i` of each mask corresponds to the `i`-th character of the block. Bits corresponding to
+ * positions past the end of the classified string are always unset.
+ */
+struct CharClassMasks {
+    // Characters that aren't delimiters (see `is_delim`)
+    uint64_t non_delim{0};
+    // [0-9]
+    uint64_t decimal_digit{0};
+    // [a-zA-Z]
+    uint64_t alphabet{0};
+    // [0-9a-fA-F]
+    uint64_t hex_digit{0};
+};
+
+/**
+ * Classifies the block of characters starting at `pos` in `str` one character at a time.
+ * @param str
+ * @param pos Must be less than `str.length()`.
+ * @return The classes of the characters in the block.
+ */
+[[nodiscard]] auto classify_chars_portable(std::string_view str, size_t pos) -> CharClassMasks;
+
+#if CLP_IR_CHAR_CLASSIFICATION_AVX2_SUPPORTED
+/**
+ * Classifies the block of characters starting at `pos` in `str` using AVX2 instructions.
+ *
+ * NOTE: This method must only be called if `is_avx2_supported` returns true.
+ * @param str
+ * @param pos Must be less than `str.length()`.
+ * @return The classes of the characters in the block.
+ */
+[[nodiscard]] auto classify_chars_avx2(std::string_view str, size_t pos) -> CharClassMasks;
+#endif
+
+/**
+ * @return Whether the current CPU supports the AVX2 classifier.
+ */
+[[nodiscard]] auto is_avx2_supported() -> bool;
+}  // namespace clp::ir
+
+#endif  // CLP_IR_CHAR_CLASSIFICATION_HPP
@@ -7,6 +7,7 @@
 #include <string_utils/string_utils.hpp>
 
 #include "../type_utils.hpp"
+#include "char_classification.hpp"
 #include "types.hpp"
 
 using std::string;
@@ -41,6 +42,22 @@ bool is_var(std::string_view value) {
 }
 
 bool get_bounds_of_next_var(string_view const str, size_t& begin_pos, size_t& end_pos) {
+#if CLP_IR_CHAR_CLASSIFICATION_AVX2_SUPPORTED
+    if (is_avx2_supported()) {
+        return get_bounds_of_next_var_using_char_classes(
+                str,
+                begin_pos,
+                end_pos,
+                [](string_view str, size_t pos) -> CharClassMasks {
+                    return classify_chars_avx2(str, pos);
+                }
+        );
+    }
+#endif
+    return get_bounds_of_next_var_scalar(str, begin_pos, end_pos);
+}
+
+bool get_bounds_of_next_var_scalar(string_view const str, size_t& begin_pos, size_t& end_pos) {
     auto const msg_length = str.length();
     if (msg_length <= end_pos) {
         return false;
@@ -61,6 +61,10 @@ bool is_var(std::string_view value);
  * - ".*[0-9].*"
  * - "=(.*[a-zA-Z].*)" (the variable is within the capturing group)
  * - "[a-fA-F0-9]{2,}"
+ *
+ * NOTE: If the CPU supports AVX2, this method uses `get_bounds_of_next_var_using_char_classes` with
+ * the AVX2 classifier; otherwise, it uses `get_bounds_of_next_var_scalar`. Both produce identical
+ * results.
  * @param str String to search within
  * @param begin_pos Begin position of last variable, changes to begin position of next variable
  * @param end_pos End position of last variable, changes to end position of next variable
@@ -68,6 +72,36 @@ bool is_var(std::string_view value);
  */
 bool get_bounds_of_next_var(std::string_view str, size_t& begin_pos, size_t& end_pos);
 
+/**
+ * Implementation of `get_bounds_of_next_var` that scans the string one character at a time.
+ * @param str
+ * @param begin_pos
+ * @param end_pos
+ * @return Same as `get_bounds_of_next_var`
+ */
+bool get_bounds_of_next_var_scalar(std::string_view str, size_t& begin_pos, size_t& end_pos);
+
+/**
+ * Implementation of `get_bounds_of_next_var` that classifies blocks of characters at a time and
+ * finds token boundaries and variable candidates using the resulting bitmasks.
+ * @tparam CharClassifier Method to classify a block of characters. Signature: (
+ *         std::string_view str,
+ *         size_t pos
+ * ) -> CharClassMasks
+ * @param str
+ * @param begin_pos
+ * @param end_pos
+ * @param classify_chars
+ * @return Same as `get_bounds_of_next_var`
+ */
+template <typename CharClassifier>
+bool get_bounds_of_next_var_using_char_classes(
+        std::string_view str,
+        size_t& begin_pos,
+        size_t& end_pos,
+        CharClassifier classify_chars
+);
+
 /**
  * Appends a constant to the logtype, escaping any variable placeholders.
  * @param constant
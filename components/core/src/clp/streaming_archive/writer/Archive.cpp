@@ -322,12 +322,21 @@ void Archive::write_msg_using_schema(LogEventView const& log_view) {
     if (log_output_buffer->has_timestamp()) {
         size_t start;
         size_t end;
-        timestamp_pattern = (TimestampPattern*)TimestampPattern::search_known_ts_patterns(
-                log_output_buffer->get_mutable_token(0).to_string(),
-                timestamp,
-                start,
-                end
-        );
+        auto const timestamp_str = log_output_buffer->get_mutable_token(0).to_string();
+        // Try the previous message's pattern first since consecutive messages almost always share
+        // a pattern
+        if (nullptr != m_old_ts_pattern
+            && m_old_ts_pattern->parse_timestamp(timestamp_str, timestamp, start, end))
+        {
+            timestamp_pattern = m_old_ts_pattern;
+        } else {
+            timestamp_pattern = (TimestampPattern*)TimestampPattern::search_known_ts_patterns(
+                    timestamp_str,
+                    timestamp,
+                    start,
+                    end
+            );
+        }
         if (m_old_ts_pattern != timestamp_pattern) {
             change_ts_pattern(timestamp_pattern);
             m_old_ts_pattern = timestamp_pattern;
@@ -1,17 +1,30 @@
 #include "ArchiveReader.hpp"
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <filesystem>
+#include <memory>
 #include <string_view>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include "archive_constants.hpp"
 #include "ArchiveReaderAdaptor.hpp"
 #include "InputConfig.hpp"
 #include "ReaderUtils.hpp"
+#include "SingleFileArchiveDefs.hpp"
 
 using std::string_view;
 
 namespace clp_s {
-void ArchiveReader::open(Path const& archive_path, NetworkAuthOption const& network_auth) {
+void ArchiveReader::open(
+        Path const& archive_path,
+        NetworkAuthOption const& network_auth,
+        std::filesystem::path const& network_cache_dir,
+        size_t network_cache_size
+) {
     if (m_is_open) {
         throw OperationFailed(ErrorCodeNotReady, __FILENAME__, __LINE__);
     }
@@ -21,7 +34,12 @@ void ArchiveReader::open(Path const& archive_path, NetworkAuthOption const& netw
         throw OperationFailed(ErrorCodeBadParam, __FILENAME__, __LINE__);
     }
 
-    m_archive_reader_adaptor = std::make_shared<ArchiveReaderAdaptor>(archive_path, network_auth);
+    m_archive_reader_adaptor = std::make_shared<ArchiveReaderAdaptor>(
+            archive_path,
+            network_auth,
+            network_cache_dir,
+            network_cache_size
+    );
 
     if (auto const rc = m_archive_reader_adaptor->load_archive_metadata(); ErrorCodeSuccess != rc) {
         throw OperationFailed(rc, __FILENAME__, __LINE__);
@@ -127,6 +145,67 @@ void ArchiveReader::read_metadata() {
     m_table_metadata_decompressor.close();
 
     m_archive_reader_adaptor->checkin_reader_for_section(constants::cArchiveTableMetadataFile);
+
+    read_compacted_table_metadata();
+}
+
+void ArchiveReader::read_compacted_table_metadata() {
+    auto const& compacted_tables = m_archive_reader_adaptor->get_compacted_tables();
+    m_compacted_table_metadata.reserve(compacted_tables.size());
+    for (size_t table_idx = 0; table_idx < compacted_tables.size(); ++table_idx) {
+        auto const& schema_ids = compacted_tables[table_idx];
+        SchemaReader::SchemaMetadata table_metadata{};
+        for (size_t i = 0; i < schema_ids.size(); ++i) {
+            auto const schema_id = schema_ids[i];
+            auto const metadata_it = m_id_to_schema_metadata.find(schema_id);
+            auto const schema_it = m_schema_map->find(schema_id);
+            if (m_id_to_schema_metadata.end() == metadata_it || m_schema_map->end() == schema_it
+                || schema_it->second.get_num_ordered() != schema_it->second.size()
+                || m_schema_id_to_compacted_table.contains(schema_id))
+            {
+                throw OperationFailed(ErrorCodeCorrupt, __FILENAME__, __LINE__);
+            }
+
+            // Every schema in the table shares the table's offset, with the schemas' records
+            // stored in the order they're listed
+            auto const& schema_metadata = metadata_it->second;
+            if (0 == i) {
+                table_metadata.stream_id = schema_metadata.stream_id;
+                table_metadata.stream_offset = schema_metadata.stream_offset;
+            } else if (table_metadata.stream_id != schema_metadata.stream_id
+                       || table_metadata.stream_offset != schema_metadata.stream_offset)
+            {
+                throw OperationFailed(ErrorCodeCorrupt, __FILENAME__, __LINE__);
+            }
+            m_schema_id_to_compacted_table.emplace(
+                    schema_id,
+                    CompactedTableLocation{table_idx, table_metadata.num_messages}
+            );
+            table_metadata.num_messages += schema_metadata.num_messages;
+            table_metadata.uncompressed_size += schema_metadata.uncompressed_size;
+        }
+
+        // Each schema is attributed a share of the table's size proportional to its number of
+        // records, so that the sizes used to plan reads still sum to the table's size
+        auto remaining_size = table_metadata.uncompressed_size;
+        for (size_t i = 0; i < schema_ids.size(); ++i) {
+            auto& schema_metadata = m_id_to_schema_metadata[schema_ids[i]];
+            if (schema_ids.size() - 1 == i || 0 == table_metadata.num_messages) {
+                schema_metadata.uncompressed_size = remaining_size;
+            } else {
+                schema_metadata.uncompressed_size = std::min(
+                        remaining_size,
+                        static_cast<uint64_t>(
+                                static_cast<double>(table_metadata.uncompressed_size)
+                                * static_cast<double>(schema_metadata.num_messages)
+                                / static_cast<double>(table_metadata.num_messages)
+                        )
+                );
+            }
+            remaining_size -= schema_metadata.uncompressed_size;
+        }
+        m_compacted_table_metadata.push_back(table_metadata);
+    }
 }
 
 void ArchiveReader::read_dictionaries_and_metadata() {
@@ -153,8 +232,12 @@ SchemaReader& ArchiveReader::read_schema_table(
             m_schema_reader,
             schema_id,
             should_extract_timestamp,
-            should_marshal_records
+            should_marshal_records,
+            true
     );
+    if (m_schema_id_to_compacted_table.contains(schema_id)) {
+        return m_schema_reader;
+    }
 
     auto& schema_metadata = m_id_to_schema_metadata[schema_id];
     auto stream_buffer = read_stream(schema_metadata.stream_id, true);
@@ -163,12 +246,36 @@ SchemaReader& ArchiveReader::read_schema_table(
     return m_schema_reader;
 }
 
+void ArchiveReader::set_planned_table_order(std::vector<int32_t> const& schema_ids) {
+    std::vector<size_t> stream_ids;
+    for (auto const schema_id : schema_ids) {
+        auto const stream_id = m_id_to_schema_metadata.at(schema_id).stream_id;
+        if (stream_ids.empty() || stream_ids.back() != stream_id) {
+            stream_ids.push_back(stream_id);
+        }
+    }
+    m_stream_reader.set_planned_stream_order(std::move(stream_ids));
+}
+
+void ArchiveReader::rewind_packed_streams() {
+    m_stream_reader.rewind();
+    // The cached buffer may be overwritten, so it can't be returned for the same stream_id
+    m_stream_buffer.reset();
+    m_stream_buffer_size = 0ULL;
+    m_cur_stream_id = 0ULL;
+    m_compacted_table.reset();
+}
+
 std::vector<std::shared_ptr<SchemaReader>> ArchiveReader::read_all_tables() {
     std::vector<std::shared_ptr<SchemaReader>> readers;
     readers.reserve(m_id_to_schema_metadata.size());
     for (auto schema_id : m_schema_ids) {
         auto schema_reader = std::make_shared<SchemaReader>();
-        initialize_schema_reader(*schema_reader, schema_id, true, true);
+        initialize_schema_reader(*schema_reader, schema_id, true, true, false);
+        if (m_schema_id_to_compacted_table.contains(schema_id)) {
+            readers.push_back(std::move(schema_reader));
+            continue;
+        }
         auto& schema_metadata = m_id_to_schema_metadata[schema_id];
         auto stream_buffer = read_stream(schema_metadata.stream_id, false);
         schema_reader->load(
@@ -181,18 +288,56 @@ std::vector<std::shared_ptr<SchemaReader>> ArchiveReader::read_all_tables() {
     return readers;
 }
 
-BaseColumnReader* ArchiveReader::append_reader_column(SchemaReader& reader, int32_t column_id) {
+std::shared_ptr<CompactedTableReader>
+ArchiveReader::read_compacted_table(size_t table_idx, bool reuse_buffer) {
+    auto const& table_metadata = m_compacted_table_metadata[table_idx];
+    auto stream_buffer = read_stream(table_metadata.stream_id, reuse_buffer);
+    if (nullptr != m_compacted_table && m_compacted_table_idx == table_idx) {
+        return m_compacted_table;
+    }
+
+    // The table's columns are the union of its schemas' columns, in the order they first appear
+    auto compacted_table = std::make_shared<CompactedTableReader>();
+    std::unordered_set<int32_t> column_ids;
+    for (auto const schema_id : m_archive_reader_adaptor->get_compacted_tables()[table_idx]) {
+        for (auto const column_id : (*m_schema_map)[schema_id]) {
+            if (false == column_ids.insert(column_id).second) {
+                continue;
+            }
+            if (auto* column_reader = create_column_reader(column_id); nullptr != column_reader) {
+                compacted_table->append_column(column_reader);
+            }
+        }
+    }
+    compacted_table->load(
+            stream_buffer,
+            table_metadata.stream_offset,
+            table_metadata.uncompressed_size,
+            table_metadata.num_messages
+    );
+    m_compacted_table = compacted_table;
+    m_compacted_table_idx = table_idx;
+    return compacted_table;
+}
+
+BaseColumnReader* ArchiveReader::create_column_reader(int32_t column_id) {
     BaseColumnReader* column_reader = nullptr;
     auto const& node = m_schema_tree->get_node(column_id);
     switch (node.get_type()) {
         case NodeType::Integer:
-            column_reader = new Int64ColumnReader(column_id);
+            column_reader = new Int64ColumnReader(
+                    column_id,
+                    get_archive_version() >= cColumnEncodingArchiveVersion
+            );
             break;
         case NodeType::DeltaInteger:
             column_reader = new DeltaEncodedInt64ColumnReader(column_id);
             break;
         case NodeType::Float:
-            column_reader = new FloatColumnReader(column_id);
+            column_reader = new FloatColumnReader(
+                    column_id,
+                    get_archive_version() >= cColumnEncodingArchiveVersion
+            );
             break;
         case NodeType::ClpString:
             column_reader = new ClpStringColumnReader(column_id, m_var_dict, m_log_dict);
@@ -204,7 +349,12 @@ BaseColumnReader* ArchiveReader::append_reader_column(SchemaReader& reader, int3
             column_reader = new BooleanColumnReader(column_id);
             break;
         case NodeType::UnstructuredArray:
-            column_reader = new ClpStringColumnReader(column_id, m_var_dict, m_array_dict, true);
+            column_reader = new UnstructuredArrayColumnReader(
+                    column_id,
+                    m_var_dict,
+                    m_array_dict,
+                    get_archive_version() >= cColumnEncodingArchiveVersion
+            );
             break;
         case NodeType::DateString:
             column_reader = new DateStringColumnReader(column_id, get_timestamp_dictionary());
@@ -217,7 +367,11 @@ BaseColumnReader* ArchiveReader::append_reader_column(SchemaReader& reader, int3
         case NodeType::Unknown:
             break;
     }
+    return column_reader;
+}
 
+BaseColumnReader* ArchiveReader::append_reader_column(SchemaReader& reader, int32_t column_id) {
+    BaseColumnReader* column_reader = create_column_reader(column_id);
     if (column_reader) {
         reader.append_column(column_reader);
     }
@@ -239,13 +393,19 @@ void ArchiveReader::append_unordered_reader_columns(
         auto const& node = m_schema_tree->get_node(column_id);
         switch (node.get_type()) {
             case NodeType::Integer:
-                column_reader = new Int64ColumnReader(column_id);
+                column_reader = new Int64ColumnReader(
+                        column_id,
+                        get_archive_version() >= cColumnEncodingArchiveVersion
+                );
                 break;
             case NodeType::DeltaInteger:
                 column_reader = new DeltaEncodedInt64ColumnReader(column_id);
                 break;
             case NodeType::Float:
-                column_reader = new FloatColumnReader(column_id);
+                column_reader = new FloatColumnReader(
+                        column_id,
+                        get_archive_version() >= cColumnEncodingArchiveVersion
+                );
                 break;
             case NodeType::ClpString:
                 column_reader = new ClpStringColumnReader(column_id, m_var_dict, m_log_dict);
@@ -283,7 +443,8 @@ void ArchiveReader::initialize_schema_reader(
         SchemaReader& reader,
         int32_t schema_id,
         bool should_extract_timestamp,
-        bool should_marshal_records
+        bool should_marshal_records,
+        bool reuse_buffer
 ) {
     auto& schema = (*m_schema_map)[schema_id];
     reader.reset(
@@ -294,6 +455,13 @@ void ArchiveReader::initialize_schema_reader(
             m_id_to_schema_metadata[schema_id].num_messages,
             should_marshal_records
     );
+    std::shared_ptr<CompactedTableReader> compacted_table;
+    if (auto const it = m_schema_id_to_compacted_table.find(schema_id);
+        m_schema_id_to_compacted_table.end() != it)
+    {
+        compacted_table = read_compacted_table(it->second.table_idx, reuse_buffer);
+        reader.use_compacted_table(compacted_table, it->second.first_message);
+    }
     auto timestamp_column_ids
             = get_timestamp_dictionary()->get_authoritative_timestamp_column_ids();
     for (size_t i = 0; i < schema.size(); ++i) {
@@ -328,7 +496,15 @@ void ArchiveReader::initialize_schema_reader(
             );
             continue;
         }
-        BaseColumnReader* column_reader = append_reader_column(reader, column_id);
+        BaseColumnReader* column_reader = nullptr;
+        if (nullptr != compacted_table) {
+            column_reader = compacted_table->get_column(column_id);
+            if (nullptr != column_reader) {
+                reader.append_column(column_reader);
+            }
+        } else {
+            column_reader = append_reader_column(reader, column_id);
+        }
 
         if (column_id == m_log_event_idx_column_id) {
             reader.mark_column_as_log_event_idx(column_reader);
@@ -357,17 +533,30 @@ void ArchiveReader::close() {
     }
     m_is_open = false;
 
-    m_var_dict->close();
-    m_log_dict->close();
-    m_array_dict->close();
+    // The dictionaries are only opened once `open` succeeds
+    if (nullptr != m_var_dict) {
+        m_var_dict->close();
+        m_var_dict.reset();
+    }
+    if (nullptr != m_log_dict) {
+        m_log_dict->close();
+        m_log_dict.reset();
+    }
+    if (nullptr != m_array_dict) {
+        m_array_dict->close();
+        m_array_dict.reset();
+    }
 
     m_stream_reader.close();
     m_archive_reader_adaptor.reset();
 
     m_id_to_schema_metadata.clear();
+    m_compacted_table_metadata.clear();
+    m_schema_id_to_compacted_table.clear();
     m_schema_ids.clear();
     m_cur_stream_id = 0;
     m_stream_buffer.reset();
+    m_compacted_table.reset();
     m_stream_buffer_size = 0ULL;
     m_log_event_idx_column_id = -1;
 }
@@ -382,6 +571,8 @@ std::shared_ptr<char[]> ArchiveReader::read_stream(size_t stream_id, bool reuse_
         m_stream_buffer_size = 0;
     }
 
+    // The buffer holding the last compacted table may be overwritten
+    m_compacted_table.reset();
     m_stream_reader.read_stream(stream_id, m_stream_buffer, m_stream_buffer_size);
     m_cur_stream_id = stream_id;
     return m_stream_buffer;
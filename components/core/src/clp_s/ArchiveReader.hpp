@@ -1,16 +1,24 @@
 #ifndef CLP_S_ARCHIVEREADER_HPP
 #define CLP_S_ARCHIVEREADER_HPP
 
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
 #include <map>
+#include <memory>
+#include <optional>
 #include <set>
 #include <span>
 #include <string_view>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "ArchiveReaderAdaptor.hpp"
 #include "DictionaryReader.hpp"
 #include "InputConfig.hpp"
 #include "PackedStreamReader.hpp"
+#include "PrefetchingRangeReader.hpp"
 #include "ReaderUtils.hpp"
 #include "SchemaReader.hpp"
 #include "search/Projection.hpp"
@@ -34,8 +42,16 @@ public:
      * Opens an archive for reading.
      * @param archive_path
      * @param network_auth
+     * @param network_cache_dir The directory in which to cache ranges of archives read from the
+     * network, or an empty path to disable caching.
+     * @param network_cache_size The maximum size of the network cache directory.
      */
-    void open(Path const& archive_path, NetworkAuthOption const& network_auth);
+    void open(
+            Path const& archive_path,
+            NetworkAuthOption const& network_auth,
+            std::filesystem::path const& network_cache_dir = {},
+            size_t network_cache_size = PrefetchingRangeReader::cDefaultMaxCacheSize
+    );
 
     /**
      * Reads the dictionaries and metadata.
@@ -95,6 +111,20 @@ public:
             bool should_marshal_records
     );
 
+    /**
+     * Allows tables to be read again (using `read_schema_table`) from the beginning of the
+     * archive. This requires the archive to be seekable (i.e., not read from the network).
+     */
+    void rewind_packed_streams();
+
+    /**
+     * Sets the order in which tables are expected to be read (using `read_schema_table`), so that
+     * the archive can be read ahead in that order where possible. Must be invoked after
+     * `open_packed_streams`.
+     * @param schema_ids
+     */
+    void set_planned_table_order(std::vector<int32_t> const& schema_ids);
+
     /**
      * Loads all of the tables in the archive and returns SchemaReaders for them.
      * @return the schema readers for every table in the archive
@@ -109,6 +139,13 @@ public:
 
     std::shared_ptr<LogTypeDictionaryReader> get_array_dictionary() { return m_array_dict; }
 
+    /**
+     * @return The version of the archive's format
+     */
+    [[nodiscard]] auto get_archive_version() const -> uint32_t {
+        return m_archive_reader_adaptor->get_header().version;
+    }
+
     std::shared_ptr<TimestampDictionaryReader> get_timestamp_dictionary() {
         return m_archive_reader_adaptor->get_timestamp_dictionary();
     }
@@ -117,10 +154,59 @@ public:
 
     std::shared_ptr<ReaderUtils::SchemaMap> get_schema_map() { return m_schema_map; }
 
+    /**
+     * @return A map from schema ID to the metadata of the schema's table.
+     */
+    [[nodiscard]] auto get_schema_metadata() const
+            -> std::map<int32_t, SchemaReader::SchemaMetadata> const& {
+        return m_id_to_schema_metadata;
+    }
+
     auto get_range_index() const -> std::vector<RangeIndexEntry> const& {
         return m_archive_reader_adaptor->get_range_index();
     }
 
+    /**
+     * @param schema_id
+     * @return The range of log event indices, [begin, end), stored in the given schema's table, or
+     * std::nullopt if the archive doesn't record it.
+     */
+    [[nodiscard]] auto get_table_log_event_idx_range(int32_t schema_id) const
+            -> std::optional<std::pair<int64_t, int64_t>> {
+        auto const& ranges = m_archive_reader_adaptor->get_table_log_event_idx_ranges();
+        if (auto const it = ranges.find(schema_id); ranges.end() != it) {
+            return it->second;
+        }
+        return std::nullopt;
+    }
+
+    /**
+     * @param schema_id
+     * @return The range of timestamps, [begin, end], of the records in the given schema's table, or
+     * std::nullopt if the archive doesn't record it. Records in tables without a timestamp column
+     * are read with a timestamp of 0.
+     */
+    [[nodiscard]] auto get_table_timestamp_range(int32_t schema_id) const
+            -> std::optional<std::pair<epochtime_t, epochtime_t>> {
+        if (false == m_archive_reader_adaptor->has_table_timestamp_ranges()) {
+            return std::nullopt;
+        }
+        auto const& ranges = m_archive_reader_adaptor->get_table_timestamp_ranges();
+        if (auto const it = ranges.find(schema_id); ranges.end() != it) {
+            return it->second;
+        }
+        return std::make_pair(epochtime_t{0}, epochtime_t{0});
+    }
+
+    /**
+     * @return Whether `rewind_packed_streams` can be used to read tables again, which requires the
+     * archive to be seekable (i.e., not read from the network as a stream).
+     */
+    [[nodiscard]] auto can_rewind_packed_streams() const -> bool {
+        return nullptr != m_archive_reader_adaptor
+               && m_archive_reader_adaptor->can_read_sections_in_any_order();
+    }
+
     /**
      * Writes decoded messages to a file.
      * @param writer
@@ -128,7 +214,7 @@ public:
     void store(FileWriter& writer);
 
     /**
-     * Closes the archive.
+     * Closes the archive, including one which was only partially opened because `open` failed.
      */
     void close();
 
@@ -148,20 +234,53 @@ public:
     bool has_log_order() { return m_log_event_idx_column_id >= 0; }
 
 private:
+    // Types
+    /**
+     * The location of a schema's records within a table shared with other schemas.
+     */
+    struct CompactedTableLocation {
+        size_t table_idx;
+        uint64_t first_message;
+    };
+
+    /**
+     * Reads the metadata of the tables which several schemas' tables were compacted into.
+     * @throw OperationFailed if the metadata is inconsistent with the tables' metadata
+     */
+    void read_compacted_table_metadata();
+
     /**
      * Initializes a schema reader passed by reference to become a reader for a given schema.
      * @param reader
      * @param schema_id
      * @param should_extract_timestamp
      * @param should_marshal_records
+     * @param reuse_buffer Whether the stream buffer may be reused, as described for `read_stream`
      */
     void initialize_schema_reader(
             SchemaReader& reader,
             int32_t schema_id,
             bool should_extract_timestamp,
-            bool should_marshal_records
+            bool should_marshal_records,
+            bool reuse_buffer
     );
 
+    /**
+     * Reads and loads a table which several schemas' tables were compacted into. If it's called
+     * multiple times in a row for the same table, the loaded table is returned again.
+     * @param table_idx
+     * @param reuse_buffer Whether the stream buffer may be reused, as described for `read_stream`
+     * @return the loaded table
+     */
+    std::shared_ptr<CompactedTableReader> read_compacted_table(size_t table_idx, bool reuse_buffer);
+
+    /**
+     * Creates a reader for a column in an ordered schema.
+     * @param column_id
+     * @return the column reader, or nullptr if the column's values aren't stored in a column
+     */
+    BaseColumnReader* create_column_reader(int32_t column_id);
+
     /**
      * Appends a column to the schema reader.
      * @param reader
@@ -208,6 +327,8 @@ private:
     std::shared_ptr<ReaderUtils::SchemaMap> m_schema_map;
     std::vector<int32_t> m_schema_ids;
     std::map<int32_t, SchemaReader::SchemaMetadata> m_id_to_schema_metadata;
+    std::vector<SchemaReader::SchemaMetadata> m_compacted_table_metadata;
+    std::unordered_map<int32_t, CompactedTableLocation> m_schema_id_to_compacted_table;
     std::shared_ptr<search::Projection> m_projection{
             std::make_shared<search::Projection>(search::ProjectionMode::ReturnAllColumns)
     };
@@ -218,6 +339,9 @@ private:
     std::shared_ptr<char[]> m_stream_buffer{};
     size_t m_stream_buffer_size{0ULL};
     size_t m_cur_stream_id{0ULL};
+    // The last compacted table that was loaded, which is only valid while its stream is cached
+    std::shared_ptr<CompactedTableReader> m_compacted_table;
+    size_t m_compacted_table_idx{0ULL};
     int32_t m_log_event_idx_column_id{-1};
 };
 }  // namespace clp_s
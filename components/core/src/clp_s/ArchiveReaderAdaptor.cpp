@@ -1,32 +1,47 @@
 #include "ArchiveReaderAdaptor.hpp"
 
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstddef>
 #include <cstring>
 #include <filesystem>
+#include <functional>
 #include <memory>
 #include <optional>
+#include <span>
 #include <string>
 #include <string_view>
 #include <utility>
 #include <vector>
 
+#include <fmt/core.h>
 #include <msgpack.hpp>
 #include <nlohmann/json.hpp>
 #include <spdlog/spdlog.h>
 
 #include "../clp/BoundedReader.hpp"
+#include "../clp/BufferReader.hpp"
 #include "../clp/FileReader.hpp"
+#include "../clp/ReadOnlyMemoryMappedFile.hpp"
 #include "archive_constants.hpp"
 #include "InputConfig.hpp"
+#include "PrefetchingRangeReader.hpp"
 #include "RangeIndexWriter.hpp"
 #include "SingleFileArchiveDefs.hpp"
 
 namespace clp_s {
 ArchiveReaderAdaptor::ArchiveReaderAdaptor(
         Path const& archive_path,
-        NetworkAuthOption const& network_auth
+        NetworkAuthOption const& network_auth,
+        std::filesystem::path network_cache_dir,
+        size_t network_cache_size
 )
         : m_archive_path{archive_path},
           m_network_auth{network_auth},
+          m_network_cache_dir{std::move(network_cache_dir)},
+          m_network_cache_size{network_cache_size},
           m_single_file_archive{false},
           m_timestamp_dictionary{std::make_shared<TimestampDictionaryReader>()} {
     if (InputSource::Filesystem != archive_path.source
@@ -99,6 +114,78 @@ ErrorCode ArchiveReaderAdaptor::try_read_archive_info(ZstdDecompressor& decompre
     return ErrorCodeSuccess;
 }
 
+auto ArchiveReaderAdaptor::try_read_table_log_event_idx_ranges(
+        ZstdDecompressor& decompressor,
+        size_t size
+) -> ErrorCode {
+    std::vector<char> buffer(size);
+    auto rc = decompressor.try_read_exact_length(buffer.data(), buffer.size());
+    if (ErrorCodeSuccess != rc) {
+        return rc;
+    }
+
+    TableLogEventIdxRangesPacket packet;
+    try {
+        auto obj_handle = msgpack::unpack(buffer.data(), buffer.size());
+        auto obj = obj_handle.get();
+        packet = obj.as<TableLogEventIdxRangesPacket>();
+    } catch (std::exception const& e) {
+        return ErrorCodeCorrupt;
+    }
+
+    auto const num_tables = packet.schema_ids.size();
+    if (packet.begin_log_event_idxs.size() != num_tables
+        || packet.end_log_event_idxs.size() != num_tables)
+    {
+        return ErrorCodeCorrupt;
+    }
+    for (size_t i = 0; i < num_tables; ++i) {
+        auto const begin = packet.begin_log_event_idxs[i];
+        auto const end = packet.end_log_event_idxs[i];
+        if (begin > end) {
+            return ErrorCodeCorrupt;
+        }
+        m_table_log_event_idx_ranges.emplace(packet.schema_ids[i], std::make_pair(begin, end));
+    }
+    return ErrorCodeSuccess;
+}
+
+auto ArchiveReaderAdaptor::try_read_table_timestamp_ranges(
+        ZstdDecompressor& decompressor,
+        size_t size
+) -> ErrorCode {
+    std::vector<char> buffer(size);
+    auto rc = decompressor.try_read_exact_length(buffer.data(), buffer.size());
+    if (ErrorCodeSuccess != rc) {
+        return rc;
+    }
+
+    TableTimestampRangesPacket packet;
+    try {
+        auto obj_handle = msgpack::unpack(buffer.data(), buffer.size());
+        auto obj = obj_handle.get();
+        packet = obj.as<TableTimestampRangesPacket>();
+    } catch (std::exception const& e) {
+        return ErrorCodeCorrupt;
+    }
+
+    auto const num_tables = packet.schema_ids.size();
+    if (packet.begin_timestamps.size() != num_tables || packet.end_timestamps.size() != num_tables)
+    {
+        return ErrorCodeCorrupt;
+    }
+    for (size_t i = 0; i < num_tables; ++i) {
+        auto const begin = packet.begin_timestamps[i];
+        auto const end = packet.end_timestamps[i];
+        if (begin > end) {
+            return ErrorCodeCorrupt;
+        }
+        m_table_timestamp_ranges.emplace(packet.schema_ids[i], std::make_pair(begin, end));
+    }
+    m_has_table_timestamp_ranges = true;
+    return ErrorCodeSuccess;
+}
+
 auto ArchiveReaderAdaptor::try_read_range_index(ZstdDecompressor& decompressor, size_t size)
         -> ErrorCode {
     std::vector<char> buffer(size);
@@ -151,6 +238,52 @@ auto ArchiveReaderAdaptor::try_read_range_index(ZstdDecompressor& decompressor,
     return ErrorCodeSuccess;
 }
 
+auto ArchiveReaderAdaptor::try_read_compression_dictionary(
+        ZstdDecompressor& decompressor,
+        size_t size
+) -> ErrorCode {
+    std::string dictionary(size, '\0');
+    if (auto const rc = decompressor.try_read_exact_length(dictionary.data(), dictionary.size());
+        ErrorCodeSuccess != rc)
+    {
+        return rc;
+    }
+
+    try {
+        m_decompression_dictionary = std::make_unique<ZstdDecompressionDictionary>(dictionary);
+    } catch (ZstdDecompressionDictionary::OperationFailed const& e) {
+        return ErrorCodeCorrupt;
+    }
+    return ErrorCodeSuccess;
+}
+
+auto ArchiveReaderAdaptor::try_read_compacted_tables(ZstdDecompressor& decompressor, size_t size)
+        -> ErrorCode {
+    std::vector<char> buffer(size);
+    if (auto const rc = decompressor.try_read_exact_length(buffer.data(), buffer.size());
+        ErrorCodeSuccess != rc)
+    {
+        return rc;
+    }
+
+    CompactedTablesPacket packet;
+    try {
+        auto obj_handle = msgpack::unpack(buffer.data(), buffer.size());
+        auto obj = obj_handle.get();
+        packet = obj.as<CompactedTablesPacket>();
+    } catch (std::exception const& e) {
+        return ErrorCodeCorrupt;
+    }
+
+    for (auto const& schema_ids : packet.schema_ids) {
+        if (schema_ids.empty()) {
+            return ErrorCodeCorrupt;
+        }
+    }
+    m_compacted_tables = std::move(packet.schema_ids);
+    return ErrorCodeSuccess;
+}
+
 auto
 ArchiveReaderAdaptor::try_read_unknown_metadata_packet(ZstdDecompressor& decompressor, size_t size)
         -> ErrorCode {
@@ -160,7 +293,12 @@ ArchiveReaderAdaptor::try_read_unknown_metadata_packet(ZstdDecompressor& decompr
 
 ErrorCode ArchiveReaderAdaptor::load_archive_metadata() {
     constexpr size_t cDecompressorFileReadBufferCapacity = 64 * 1024;
-    m_reader = try_create_reader_at_header();
+    if (try_memory_map_archive()) {
+        auto const archive = get_memory_mapped_archive();
+        m_reader = std::make_shared<clp::BufferReader>(archive.data(), archive.size());
+    } else {
+        m_reader = try_create_reader_at_header();
+    }
     if (nullptr == m_reader) {
         return ErrorCodeFileNotFound;
     }
@@ -170,12 +308,67 @@ ErrorCode ArchiveReaderAdaptor::load_archive_metadata() {
     }
 
     m_files_section_offset = sizeof(m_archive_header) + m_archive_header.metadata_section_size;
-    clp::BoundedReader bounded_reader{m_reader.get(), m_files_section_offset};
     ZstdDecompressor decompressor;
+    if (nullptr != m_memory_mapped_archive) {
+        auto const archive = get_memory_mapped_archive();
+        if (m_files_section_offset > archive.size()) {
+            return ErrorCodeMetadataCorrupted;
+        }
+        decompressor.open(
+                archive.data() + sizeof(m_archive_header),
+                m_archive_header.metadata_section_size
+        );
+        auto const rc = try_read_archive_metadata(decompressor);
+        decompressor.close();
+        return rc;
+    }
+
+    clp::BoundedReader bounded_reader{m_reader.get(), m_files_section_offset};
     decompressor.open(bounded_reader, cDecompressorFileReadBufferCapacity);
     auto const rc = try_read_archive_metadata(decompressor);
     decompressor.close();
-    return rc;
+    if (ErrorCodeSuccess != rc) {
+        return rc;
+    }
+
+    if (InputSource::Network == m_archive_path.source) {
+        switch_to_range_reader();
+    }
+    return ErrorCodeSuccess;
+}
+
+void ArchiveReaderAdaptor::switch_to_range_reader() {
+    auto create_reader = [archive_path = m_archive_path,
+                          network_auth = m_network_auth](size_t offset) {
+        return try_create_reader(archive_path, network_auth, offset);
+    };
+    // The archive's size is part of the key so that a modified archive at the same URL doesn't
+    // reuse stale ranges
+    auto cache_key = fmt::format(
+            "{:016x}-{}",
+            std::hash<std::string>{}(m_archive_path.path),
+            m_archive_header.compressed_size
+    );
+    m_range_reader = std::make_shared<PrefetchingRangeReader>(
+            std::move(create_reader),
+            m_archive_header.compressed_size,
+            m_network_cache_dir,
+            std::move(cache_key),
+            m_network_cache_size
+    );
+    m_reader = m_range_reader;
+
+    std::vector<ByteRange> ranges;
+    auto const& files = m_archive_file_info.files;
+    for (size_t i = 0; i < files.size(); ++i) {
+        if (files[i].n == constants::cArchiveTablesFile) {
+            continue;
+        }
+        size_t const end = (i + 1) < files.size() ? m_files_section_offset + files[i + 1].o
+                                                  : m_archive_header.compressed_size;
+        ranges.push_back({m_files_section_offset + files[i].o, end});
+    }
+    m_range_reader->prefetch(ranges);
 }
 
 ErrorCode ArchiveReaderAdaptor::try_read_header(clp::ReaderInterface& reader) {
@@ -197,6 +390,13 @@ ErrorCode ArchiveReaderAdaptor::try_read_header(clp::ReaderInterface& reader) {
         return ErrorCodeMetadataCorrupted;
     }
 
+    // Archives from older versions can be read, but the layout of newer major or minor versions is
+    // unknown
+    constexpr uint32_t cPatchVersionMask{0xFFFF};
+    if ((m_archive_header.version & ~cPatchVersionMask) > (cArchiveVersion & ~cPatchVersionMask)) {
+        return ErrorCodeUnsupported;
+    }
+
     switch (static_cast<ArchiveCompressionType>(m_archive_header.compression_type)) {
         case ArchiveCompressionType::Zstd:
             break;
@@ -238,6 +438,18 @@ ErrorCode ArchiveReaderAdaptor::try_read_archive_metadata(ZstdDecompressor& deco
             case ArchiveMetadataPacketType::RangeIndex:
                 rc = try_read_range_index(decompressor, packet_size);
                 break;
+            case ArchiveMetadataPacketType::TableLogEventIdxRanges:
+                rc = try_read_table_log_event_idx_ranges(decompressor, packet_size);
+                break;
+            case ArchiveMetadataPacketType::TableTimestampRanges:
+                rc = try_read_table_timestamp_ranges(decompressor, packet_size);
+                break;
+            case ArchiveMetadataPacketType::CompressionDictionary:
+                rc = try_read_compression_dictionary(decompressor, packet_size);
+                break;
+            case ArchiveMetadataPacketType::CompactedTables:
+                rc = try_read_compacted_tables(decompressor, packet_size);
+                break;
             default:
                 rc = try_read_unknown_metadata_packet(decompressor, packet_size);
                 break;
@@ -264,6 +476,51 @@ std::shared_ptr<clp::ReaderInterface> ArchiveReaderAdaptor::try_create_reader_at
     }
 }
 
+auto ArchiveReaderAdaptor::try_memory_map_archive() -> bool {
+    if (InputSource::Filesystem != m_archive_path.source || false == m_single_file_archive) {
+        return false;
+    }
+
+    try {
+        m_memory_mapped_archive
+                = std::make_unique<clp::ReadOnlyMemoryMappedFile>(m_archive_path.path);
+    } catch (std::exception const& e) {
+        SPDLOG_WARN("Failed to memory-map archive, falling back to reading it - {}", e.what());
+        return false;
+    }
+
+    // Empty files aren't mapped
+    if (m_memory_mapped_archive->get_view().empty()) {
+        m_memory_mapped_archive.reset();
+        return false;
+    }
+    return true;
+}
+
+void ArchiveReaderAdaptor::prefetch_ranges(std::vector<ByteRange> const& ranges) const {
+    if (nullptr != m_range_reader) {
+        m_range_reader->prefetch(ranges);
+    }
+}
+
+void ArchiveReaderAdaptor::advise_will_need(size_t begin_offset, size_t end_offset) const {
+    auto const archive = get_memory_mapped_archive();
+    end_offset = std::min(end_offset, archive.size());
+    if (begin_offset >= end_offset) {
+        return;
+    }
+
+    // `madvise` requires a page-aligned address, and the mapping itself is page-aligned
+    static auto const cPageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    auto const aligned_begin_offset = begin_offset - (begin_offset % cPageSize);
+    // We skip error checking since the hint is only advisory
+    madvise(
+            const_cast<char*>(archive.data()) + aligned_begin_offset,
+            end_offset - aligned_begin_offset,
+            MADV_WILLNEED
+    );
+}
+
 std::unique_ptr<clp::ReaderInterface> ArchiveReaderAdaptor::checkout_reader_for_section(
         std::string_view section
 ) {
@@ -291,11 +548,6 @@ std::unique_ptr<clp::ReaderInterface> ArchiveReaderAdaptor::checkout_reader_for_
         throw OperationFailed(ErrorCodeBadParam, __FILENAME__, __LINE__);
     }
 
-    size_t curr_pos{};
-    if (auto rc = m_reader->try_get_pos(curr_pos); clp::ErrorCode::ErrorCode_Success != rc) {
-        throw OperationFailed(ErrorCodeFailure, __FILENAME__, __LINE__);
-    }
-
     size_t file_offset = m_files_section_offset + it->o;
     ++it;
     size_t next_file_offset{m_archive_header.compressed_size};
@@ -303,7 +555,23 @@ std::unique_ptr<clp::ReaderInterface> ArchiveReaderAdaptor::checkout_reader_for_
         next_file_offset = m_files_section_offset + it->o;
     }
 
-    if (curr_pos > file_offset) {
+    // Sections of a memory-mapped archive can be read in any order without seeking the shared
+    // reader
+    if (nullptr != m_memory_mapped_archive) {
+        auto const archive = get_memory_mapped_archive();
+        if (file_offset > next_file_offset || next_file_offset > archive.size()) {
+            throw OperationFailed(ErrorCodeCorrupt, __FILENAME__, __LINE__);
+        }
+        return std::make_unique<clp::BufferReader>(archive.data(), next_file_offset, file_offset);
+    }
+
+    size_t curr_pos{};
+    if (auto rc = m_reader->try_get_pos(curr_pos); clp::ErrorCode::ErrorCode_Success != rc) {
+        throw OperationFailed(ErrorCodeFailure, __FILENAME__, __LINE__);
+    }
+
+    // Only a streaming reader can't seek backwards
+    if (curr_pos > file_offset && nullptr == m_range_reader) {
         throw OperationFailed(ErrorCodeCorrupt, __FILENAME__, __LINE__);
     }
 
@@ -2,8 +2,12 @@
 #define CLP_S_ARCHIVEREADERADAPTOR_HPP
 
 #include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <map>
 #include <memory>
 #include <optional>
+#include <span>
 #include <string>
 #include <string_view>
 #include <utility>
@@ -18,11 +22,15 @@
 
 #include "../clp/BoundedReader.hpp"
 #include "../clp/ReaderInterface.hpp"
+#include "../clp/ReadOnlyMemoryMappedFile.hpp"
+#include "Defs.hpp"
 #include "InputConfig.hpp"
+#include "PrefetchingRangeReader.hpp"
 #include "SingleFileArchiveDefs.hpp"
 #include "TimestampDictionaryReader.hpp"
 #include "TraceableException.hpp"
 #include "ZstdDecompressor.hpp"
+#include "ZstdDictionary.hpp"
 
 namespace clp_s {
 /**
@@ -43,6 +51,13 @@ struct RangeIndexEntry {
 /**
  * ArchiveReaderAdaptor is an adaptor class which helps with reading single and multi-file archives
  * which exist on either S3 or a locally mounted file system.
+ *
+ * Single-file archives on a local file system are memory-mapped, so that sections can be read
+ * without system calls and compressed data can be decompressed straight from the mapping.
+ *
+ * Once the metadata of a single-file archive on the network has been read, the rest of the archive
+ * is read using range requests, so that the sections which will be needed can be prefetched
+ * concurrently and read in any order.
  */
 class ArchiveReaderAdaptor {
 public:
@@ -53,7 +68,19 @@ public:
                 : TraceableException(error_code, filename, line_number) {}
     };
 
-    explicit ArchiveReaderAdaptor(Path const& archive_path, NetworkAuthOption const& network_auth);
+    /**
+     * @param archive_path
+     * @param network_auth
+     * @param network_cache_dir The directory in which to cache ranges of archives read from the
+     * network, or an empty path to disable caching.
+     * @param network_cache_size The maximum size of the network cache directory.
+     */
+    explicit ArchiveReaderAdaptor(
+            Path const& archive_path,
+            NetworkAuthOption const& network_auth,
+            std::filesystem::path network_cache_dir = {},
+            size_t network_cache_size = PrefetchingRangeReader::cDefaultMaxCacheSize
+    );
 
     /**
      * Loads metadata for an archive including the header and metadata section. This method must be
@@ -81,6 +108,39 @@ public:
      */
     void checkin_reader_for_section(std::string_view section);
 
+    /**
+     * @return A view of the whole archive if it's memory-mapped, or an empty view otherwise.
+     */
+    [[nodiscard]] auto get_memory_mapped_archive() const -> std::span<char const> {
+        if (nullptr == m_memory_mapped_archive) {
+            return {};
+        }
+        return m_memory_mapped_archive->get_view();
+    }
+
+    /**
+     * Hints that the given range of the memory-mapped archive will be read soon, so that it can be
+     * read ahead of time. Does nothing if the archive isn't memory-mapped.
+     * @param begin_offset
+     * @param end_offset
+     */
+    void advise_will_need(size_t begin_offset, size_t end_offset) const;
+
+    /**
+     * Starts fetching the given ranges of the archive in the background if it's read using range
+     * requests. Does nothing otherwise.
+     * @param ranges
+     */
+    void prefetch_ranges(std::vector<ByteRange> const& ranges) const;
+
+    /**
+     * @return Whether sections of the archive can be checked out in any order.
+     */
+    [[nodiscard]] auto can_read_sections_in_any_order() const -> bool {
+        return false == m_single_file_archive || nullptr != m_memory_mapped_archive
+               || nullptr != m_range_reader;
+    }
+
     std::shared_ptr<TimestampDictionaryReader> get_timestamp_dictionary() {
         return m_timestamp_dictionary;
     }
@@ -89,6 +149,47 @@ public:
 
     std::vector<RangeIndexEntry> const& get_range_index() const { return m_range_index; }
 
+    /**
+     * @return A map from each table's schema ID to the range of log event indices, [begin, end),
+     * stored in the table. Empty for archives written before these ranges were recorded.
+     */
+    auto get_table_log_event_idx_ranges() const
+            -> std::map<int32_t, std::pair<int64_t, int64_t>> const& {
+        return m_table_log_event_idx_ranges;
+    }
+
+    /**
+     * @return Whether the archive records the range of timestamps in each table.
+     */
+    [[nodiscard]] auto has_table_timestamp_ranges() const -> bool {
+        return m_has_table_timestamp_ranges;
+    }
+
+    /**
+     * @return A map from the schema ID of each table with a timestamp column to the range of
+     * timestamps, [begin, end], of the records in the table.
+     */
+    auto get_table_timestamp_ranges() const
+            -> std::map<int32_t, std::pair<epochtime_t, epochtime_t>> const& {
+        return m_table_timestamp_ranges;
+    }
+
+    /**
+     * @return The dictionary which the tables and the variable, log type, and array dictionaries
+     * were compressed with, or nullptr if they were compressed without one.
+     */
+    [[nodiscard]] auto get_decompression_dictionary() const -> ZstdDecompressionDictionary const* {
+        return m_decompression_dictionary.get();
+    }
+
+    /**
+     * @return The schemas whose tables were compacted into each table shared by several schemas,
+     * in the order that their records are stored in the shared table.
+     */
+    [[nodiscard]] auto get_compacted_tables() const -> std::vector<std::vector<int32_t>> const& {
+        return m_compacted_tables;
+    }
+
 private:
     /**
      * Tries to read an ArchiveFileInfo packet from the archive metadata.
@@ -125,6 +226,41 @@ private:
      */
     auto try_read_range_index(ZstdDecompressor& decompressor, size_t size) -> ErrorCode;
 
+    /**
+     * Tries to read a TableLogEventIdxRanges packet from the archive metadata.
+     * @param decompressor
+     * @param size The number of decompressed bytes making up the packet.
+     * @return ErrorCodeSuccess on success or the relevant ErrorCode on failure.
+     */
+    auto try_read_table_log_event_idx_ranges(ZstdDecompressor& decompressor, size_t size)
+            -> ErrorCode;
+
+    /**
+     * Tries to read a TableTimestampRanges packet from the archive metadata.
+     * @param decompressor
+     * @param size The number of decompressed bytes making up the packet.
+     * @return ErrorCodeSuccess on success or the relevant ErrorCode on failure.
+     */
+    auto try_read_table_timestamp_ranges(ZstdDecompressor& decompressor, size_t size)
+            -> ErrorCode;
+
+    /**
+     * Tries to read a CompressionDictionary packet from the archive metadata.
+     * @param decompressor
+     * @param size The number of decompressed bytes making up the packet.
+     * @return ErrorCodeSuccess on success or the relevant ErrorCode on failure.
+     */
+    auto try_read_compression_dictionary(ZstdDecompressor& decompressor, size_t size)
+            -> ErrorCode;
+
+    /**
+     * Tries to read a CompactedTables packet from the archive metadata.
+     * @param decompressor
+     * @param size The number of decompressed bytes making up the packet.
+     * @return ErrorCodeSuccess on success or the relevant ErrorCode on failure.
+     */
+    auto try_read_compacted_tables(ZstdDecompressor& decompressor, size_t size) -> ErrorCode;
+
     /**
      * Tries to read an unknown metadata packet from the archive metadata.
      * @param decompressor
@@ -140,6 +276,19 @@ private:
      */
     std::shared_ptr<clp::ReaderInterface> try_create_reader_at_header();
 
+    /**
+     * Tries to memory-map the archive if it's a single-file archive on a local file system.
+     * @return Whether the archive was memory-mapped.
+     */
+    auto try_memory_map_archive() -> bool;
+
+    /**
+     * Switches to reading the rest of a single-file archive on the network using range requests,
+     * and starts prefetching every section except the tables, which are prefetched once it's known
+     * which of them will be read.
+     */
+    void switch_to_range_reader();
+
     /**
      * Checks out a reader for a given section of the single file archive.
      * @param section
@@ -167,6 +316,8 @@ private:
 
     Path m_archive_path{};
     NetworkAuthOption m_network_auth{};
+    std::filesystem::path m_network_cache_dir;
+    size_t m_network_cache_size{PrefetchingRangeReader::cDefaultMaxCacheSize};
     bool m_single_file_archive{false};
     ArchiveFileInfoPacket m_archive_file_info{};
     ArchiveHeader m_archive_header{};
@@ -175,7 +326,15 @@ private:
     std::optional<std::string> m_current_reader_holder;
     std::shared_ptr<TimestampDictionaryReader> m_timestamp_dictionary;
     std::shared_ptr<clp::ReaderInterface> m_reader;
+    std::unique_ptr<clp::ReadOnlyMemoryMappedFile> m_memory_mapped_archive;
+    // Aliases `m_reader` when the archive is read using range requests
+    std::shared_ptr<PrefetchingRangeReader> m_range_reader;
     std::vector<RangeIndexEntry> m_range_index;
+    std::map<int32_t, std::pair<int64_t, int64_t>> m_table_log_event_idx_ranges;
+    bool m_has_table_timestamp_ranges{false};
+    std::map<int32_t, std::pair<epochtime_t, epochtime_t>> m_table_timestamp_ranges;
+    std::unique_ptr<ZstdDecompressionDictionary> m_decompression_dictionary;
+    std::vector<std::vector<int32_t>> m_compacted_tables;
 };
 }  // namespace clp_s
 #endif  // CLP_S_ARCHIVEREADERADAPTOR_HPP
@@ -1,23 +1,94 @@
 #include "ArchiveWriter.hpp"
 
 #include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <filesystem>
 #include <sstream>
+#include <string>
+#include <system_error>
+#include <tuple>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include <nlohmann/json.hpp>
 #include <spdlog/spdlog.h>
 
 #include "archive_constants.hpp"
 #include "Defs.hpp"
+#include "FileReader.hpp"
+#include "SchemaCompactor.hpp"
 #include "SchemaTree.hpp"
+#include "ZstdDecompressor.hpp"
+#include "ZstdDictionary.hpp"
 
 namespace clp_s {
+namespace {
+constexpr size_t cDecompressorFileReadBufferCapacity{64 * 1024};  // 64 KB
+
+/**
+ * Decompresses the rest of a file, starting from the reader's current position.
+ * @param reader
+ * @return The decompressed data
+ * @throw ArchiveWriter::OperationFailed if the data can't be decompressed
+ */
+auto decompress_to_end(FileReader& reader) -> std::string {
+    ZstdDecompressor decompressor;
+    decompressor.open(reader, cDecompressorFileReadBufferCapacity);
+    std::string data;
+    while (true) {
+        auto const prev_size = data.size();
+        data.resize(prev_size + cDecompressorFileReadBufferCapacity);
+        size_t num_bytes_read{0};
+        auto const rc = decompressor.try_read(
+                data.data() + prev_size,
+                cDecompressorFileReadBufferCapacity,
+                num_bytes_read
+        );
+        data.resize(prev_size + num_bytes_read);
+        if (ErrorCodeEndOfFile == rc) {
+            break;
+        }
+        if (ErrorCodeSuccess != rc) {
+            throw ArchiveWriter::OperationFailed(rc, __FILENAME__, __LINE__);
+        }
+    }
+    decompressor.close();
+    return data;
+}
+
+/**
+ * Replaces a file with its temporary replacement, or removes the replacement.
+ * @param path
+ * @param should_replace
+ * @throw ArchiveWriter::OperationFailed if the file can't be replaced or removed
+ */
+void replace_file(std::string const& path, bool should_replace) {
+    auto const replacement_path = path + constants::cTmpPostfix;
+    std::error_code ec;
+    if (should_replace) {
+        std::filesystem::rename(replacement_path, path, ec);
+    } else {
+        std::filesystem::remove(replacement_path, ec);
+    }
+    if (ec) {
+        SPDLOG_ERROR("Failed to replace \"{}\" - ({}) {}", path, ec.value(), ec.message());
+        throw ArchiveWriter::OperationFailed(ErrorCodeFailure, __FILENAME__, __LINE__);
+    }
+}
+}  // namespace
+
 void ArchiveWriter::open(ArchiveWriterOption const& option) {
     m_id = boost::uuids::to_string(option.id);
     m_compression_level = option.compression_level;
     m_print_archive_stats = option.print_archive_stats;
     m_single_file_archive = option.single_file_archive;
     m_min_table_size = option.min_table_size;
+    m_float_encoding = option.float_encoding;
+    m_array_encoding = option.array_encoding;
+    m_zstd_dictionary_size = option.zstd_dictionary_size;
+    m_schema_compaction_threshold = option.schema_compaction_threshold;
     m_archives_dir = option.archives_dir;
     m_authoritative_timestamp = option.authoritative_timestamp;
     m_authoritative_timestamp_namespace = option.authoritative_timestamp_namespace;
@@ -68,17 +139,28 @@ auto ArchiveWriter::close(bool is_split) -> ArchiveStats {
     auto array_dict_compressed_size = m_array_dict->close();
     auto schema_tree_compressed_size = m_schema_tree.store(m_archive_path, m_compression_level);
     auto schema_map_compressed_size = m_schema_map.store(m_archive_path, m_compression_level);
-    auto [table_metadata_compressed_size, table_compressed_size] = store_tables();
+    auto [stream_metadata, schema_metadata, table_compressed_size] = store_tables();
 
     std::vector<ArchiveFileInfo> files{
             {constants::cArchiveSchemaTreeFile, schema_tree_compressed_size},
             {constants::cArchiveSchemaMapFile, schema_map_compressed_size},
-            {constants::cArchiveTableMetadataFile, table_metadata_compressed_size},
+            {constants::cArchiveTableMetadataFile, 0},
             {constants::cArchiveVarDictFile, var_dict_compressed_size},
             {constants::cArchiveLogDictFile, log_dict_compressed_size},
             {constants::cArchiveArrayDictFile, array_dict_compressed_size},
             {constants::cArchiveTablesFile, table_compressed_size}
     };
+    if (0 != m_zstd_dictionary_size) {
+        compress_with_trained_dictionary(files, stream_metadata);
+    }
+    // The table metadata records the offsets of the packed streams, so it's stored once the tables
+    // won't be recompressed
+    for (auto& file : files) {
+        if (constants::cArchiveTableMetadataFile == file.n) {
+            file.o = store_table_metadata(stream_metadata, schema_metadata);
+        }
+    }
+
     uint64_t offset = 0;
     for (auto& file : files) {
         uint64_t original_size = file.o;
@@ -98,10 +180,8 @@ auto ArchiveWriter::close(bool is_split) -> ArchiveStats {
         archive_range_index = write_archive_metadata(header_and_metadata_writer, files);
         size_t metadata_size = header_and_metadata_writer.get_pos() - sizeof(ArchiveHeader);
 
-        m_compressed_size
-                = var_dict_compressed_size + log_dict_compressed_size + array_dict_compressed_size
-                  + metadata_size + schema_tree_compressed_size + schema_map_compressed_size
-                  + table_metadata_compressed_size + table_compressed_size + sizeof(ArchiveHeader);
+        // After the loop above, `offset` is the total size of the archive's files
+        m_compressed_size = offset + metadata_size + sizeof(ArchiveHeader);
 
         write_archive_header(header_and_metadata_writer, metadata_size);
         header_and_metadata_writer.close();
@@ -122,9 +202,14 @@ auto ArchiveWriter::close(bool is_split) -> ArchiveStats {
     }
 
     m_id_to_schema_writer.clear();
+    m_schema_id_to_log_event_idx_range.clear();
+    m_schema_id_to_timestamp_range.clear();
+    m_cur_message_timestamp.reset();
     m_schema_tree.clear();
     m_schema_map.clear();
     m_timestamp_dict.clear();
+    m_zstd_dictionary.clear();
+    m_compacted_tables.clear();
     m_encoded_message_size = 0UL;
     m_uncompressed_size = 0UL;
     m_compressed_size = 0UL;
@@ -169,7 +254,13 @@ auto ArchiveWriter::write_archive_metadata(
     if (false == m_range_index_writer.empty()) {
         ++num_optional_packets;
     }
-    uint8_t const num_constant_packets{3U};
+    if (false == m_zstd_dictionary.empty()) {
+        ++num_optional_packets;
+    }
+    if (false == m_compacted_tables.empty()) {
+        ++num_optional_packets;
+    }
+    uint8_t const num_constant_packets{5U};
     compressor.write_numeric_value<uint8_t>(num_constant_packets + num_optional_packets);
 
     // Write archive info
@@ -189,6 +280,32 @@ auto ArchiveWriter::write_archive_metadata(
     compressor.write_numeric_value(static_cast<uint32_t>(archive_file_info_str.size()));
     compressor.write_string(archive_file_info_str);
 
+    TableLogEventIdxRangesPacket table_log_event_idx_ranges;
+    for (auto const& [schema_id, range] : m_schema_id_to_log_event_idx_range) {
+        table_log_event_idx_ranges.schema_ids.push_back(schema_id);
+        table_log_event_idx_ranges.begin_log_event_idxs.push_back(range.first);
+        table_log_event_idx_ranges.end_log_event_idxs.push_back(range.second);
+    }
+    msgpack_buffer = std::stringstream{};
+    msgpack::pack(msgpack_buffer, table_log_event_idx_ranges);
+    std::string table_log_event_idx_ranges_str = msgpack_buffer.str();
+    compressor.write_numeric_value(ArchiveMetadataPacketType::TableLogEventIdxRanges);
+    compressor.write_numeric_value(static_cast<uint32_t>(table_log_event_idx_ranges_str.size()));
+    compressor.write_string(table_log_event_idx_ranges_str);
+
+    TableTimestampRangesPacket table_timestamp_ranges;
+    for (auto const& [schema_id, range] : m_schema_id_to_timestamp_range) {
+        table_timestamp_ranges.schema_ids.push_back(schema_id);
+        table_timestamp_ranges.begin_timestamps.push_back(range.first);
+        table_timestamp_ranges.end_timestamps.push_back(range.second);
+    }
+    msgpack_buffer = std::stringstream{};
+    msgpack::pack(msgpack_buffer, table_timestamp_ranges);
+    std::string table_timestamp_ranges_str = msgpack_buffer.str();
+    compressor.write_numeric_value(ArchiveMetadataPacketType::TableTimestampRanges);
+    compressor.write_numeric_value(static_cast<uint32_t>(table_timestamp_ranges_str.size()));
+    compressor.write_string(table_timestamp_ranges_str);
+
     // Write timestamp dictionary
     compressor.write_numeric_value(ArchiveMetadataPacketType::TimestampDictionary);
     std::stringstream timestamp_dict_stream;
@@ -205,6 +322,24 @@ auto ArchiveWriter::write_archive_metadata(
         throw OperationFailed(rc, __FILENAME__, __LINE__);
     }
 
+    // Write the zstd dictionary
+    if (false == m_zstd_dictionary.empty()) {
+        compressor.write_numeric_value(ArchiveMetadataPacketType::CompressionDictionary);
+        compressor.write_numeric_value(static_cast<uint32_t>(m_zstd_dictionary.size()));
+        compressor.write_string(m_zstd_dictionary);
+    }
+
+    // Write the schemas of compacted tables
+    if (false == m_compacted_tables.empty()) {
+        CompactedTablesPacket compacted_tables{.schema_ids{m_compacted_tables}};
+        msgpack_buffer = std::stringstream{};
+        msgpack::pack(msgpack_buffer, compacted_tables);
+        std::string compacted_tables_str = msgpack_buffer.str();
+        compressor.write_numeric_value(ArchiveMetadataPacketType::CompactedTables);
+        compressor.write_numeric_value(static_cast<uint32_t>(compacted_tables_str.size()));
+        compressor.write_string(compacted_tables_str);
+    }
+
     compressor.close();
     return archive_range_index;
 }
@@ -239,8 +374,7 @@ void ArchiveWriter::write_archive_files(
 void ArchiveWriter::write_archive_header(FileWriter& archive_writer, size_t metadata_section_size) {
     ArchiveHeader header{
             .magic_number{0},
-            .version
-            = (cArchiveMajorVersion << 24) | (cArchiveMinorVersion << 16) | cArchivePatchVersion,
+            .version = cArchiveVersion,
             .uncompressed_size = m_uncompressed_size,
             .compressed_size = m_compressed_size,
             .reserved_padding{0},
@@ -266,7 +400,22 @@ ArchiveWriter::append_message(int32_t schema_id, Schema const& schema, ParsedMes
     }
 
     m_encoded_message_size += schema_writer->append_message(message);
+    auto& log_event_idx_range = m_schema_id_to_log_event_idx_range
+                                        .try_emplace(schema_id, m_next_log_event_id, 0)
+                                        .first->second;
     ++m_next_log_event_id;
+    log_event_idx_range.second = m_next_log_event_id;
+
+    if (m_cur_message_timestamp.has_value()) {
+        auto const timestamp{m_cur_message_timestamp.value()};
+        auto const [it, inserted]
+                = m_schema_id_to_timestamp_range.try_emplace(schema_id, timestamp, timestamp);
+        if (false == inserted) {
+            it->second.first = std::min(it->second.first, timestamp);
+            it->second.second = std::max(it->second.second, timestamp);
+        }
+        m_cur_message_timestamp.reset();
+    }
 }
 
 int32_t ArchiveWriter::add_node(int parent_node_id, NodeType type, std::string_view key) {
@@ -287,17 +436,6 @@ int32_t ArchiveWriter::add_node(int parent_node_id, NodeType type, std::string_v
     return node_id;
 }
 
-bool ArchiveWriter::matches_timestamp(int parent_node_id, std::string_view key) {
-    if (m_matched_timestamp_prefix_node_id == parent_node_id) {
-        if (1 == (m_authoritative_timestamp.size() - m_matched_timestamp_prefix_length)
-            && m_authoritative_timestamp.back() == key)
-        {
-            return true;
-        }
-    }
-    return false;
-}
-
 size_t ArchiveWriter::get_data_size() {
     return m_log_dict->get_data_size() + m_var_dict->get_data_size() + m_array_dict->get_data_size()
            + m_encoded_message_size;
@@ -308,52 +446,146 @@ void ArchiveWriter::initialize_schema_writer(SchemaWriter* writer, Schema const&
         if (Schema::schema_entry_is_unordered_object(id)) {
             continue;
         }
-        auto const& node = m_schema_tree.get_node(id);
-        switch (node.get_type()) {
-            case NodeType::Integer:
-                writer->append_column(new Int64ColumnWriter(id));
-                break;
-            case NodeType::Float:
-                writer->append_column(new FloatColumnWriter(id));
-                break;
-            case NodeType::ClpString:
-                writer->append_column(new ClpStringColumnWriter(id, m_var_dict, m_log_dict));
-                break;
-            case NodeType::VarString:
-                writer->append_column(new VariableStringColumnWriter(id, m_var_dict));
-                break;
-            case NodeType::Boolean:
-                writer->append_column(new BooleanColumnWriter(id));
-                break;
-            case NodeType::UnstructuredArray:
-                writer->append_column(new ClpStringColumnWriter(id, m_var_dict, m_array_dict));
-                break;
-            case NodeType::DateString:
-                writer->append_column(new DateStringColumnWriter(id));
-                break;
-            case NodeType::DeltaInteger:
-                writer->append_column(new DeltaEncodedInt64ColumnWriter(id));
-                break;
-            case NodeType::Metadata:
-            case NodeType::NullValue:
-            case NodeType::Object:
-            case NodeType::StructuredArray:
-            case NodeType::Unknown:
-                break;
+        if (auto* column = create_column_writer(id); nullptr != column) {
+            writer->append_column(column);
         }
     }
 }
 
-std::pair<size_t, size_t> ArchiveWriter::store_tables() {
+auto ArchiveWriter::create_column_writer(int32_t id) -> BaseColumnWriter* {
+    auto const& node = m_schema_tree.get_node(id);
+    switch (node.get_type()) {
+        case NodeType::Integer:
+            return new Int64ColumnWriter(id);
+        case NodeType::Float:
+            return new FloatColumnWriter(id, m_float_encoding);
+        case NodeType::ClpString:
+            return new ClpStringColumnWriter(id, m_var_dict, m_log_dict);
+        case NodeType::VarString:
+            return new VariableStringColumnWriter(id, m_var_dict);
+        case NodeType::Boolean:
+            return new BooleanColumnWriter(id);
+        case NodeType::UnstructuredArray:
+            return new UnstructuredArrayColumnWriter(
+                    id,
+                    m_array_encoding,
+                    m_var_dict,
+                    m_array_dict
+            );
+        case NodeType::DateString:
+            return new DateStringColumnWriter(id);
+        case NodeType::DeltaInteger:
+            return new DeltaEncodedInt64ColumnWriter(id);
+        case NodeType::Metadata:
+        case NodeType::NullValue:
+        case NodeType::Object:
+        case NodeType::StructuredArray:
+        case NodeType::Unknown:
+            break;
+    }
+    return nullptr;
+}
+
+auto ArchiveWriter::get_tables_to_store() -> std::vector<Table> {
+    std::vector<Table> tables;
+    tables.reserve(m_id_to_schema_writer.size());
+    bool const is_compaction_enabled{m_schema_compaction_threshold > 0.0};
+
+    // Columns within unordered objects are positional rather than identified by their node, so
+    // only schemas without unordered objects are compacted
+    std::unordered_set<int32_t> schemas_with_unordered_objects;
+    if (is_compaction_enabled) {
+        for (auto it = m_schema_map.schema_map_begin(); it != m_schema_map.schema_map_end(); ++it) {
+            if (it->first.get_num_ordered() != it->first.size()) {
+                schemas_with_unordered_objects.insert(it->second);
+            }
+        }
+    }
+
+    std::vector<std::pair<int32_t, SchemaWriter*>> candidates;
+    std::vector<int32_t> column_ids;
+    std::unordered_set<int32_t> unique_column_ids;
+    for (auto const& [schema_id, writer] : m_id_to_schema_writer) {
+        auto const& columns = writer->get_columns();
+        bool is_candidate{
+                is_compaction_enabled && false == columns.empty()
+                && writer->get_total_uncompressed_size() < m_min_table_size
+                && false == schemas_with_unordered_objects.contains(schema_id)
+        };
+        if (is_candidate) {
+            unique_column_ids.clear();
+            for (auto const* column : columns) {
+                unique_column_ids.insert(column->get_id());
+            }
+            is_candidate = unique_column_ids.size() == columns.size();
+        }
+        if (is_candidate) {
+            candidates.emplace_back(schema_id, writer);
+        } else {
+            tables.push_back(
+                    {writer,
+                     {{schema_id, writer->get_num_messages()}},
+                     writer->get_total_uncompressed_size()}
+            );
+        }
+    }
+
+    // Larger schemas are added to the compactor first, so that smaller schemas join the groups of
+    // the larger schemas that they're similar to
+    std::sort(candidates.begin(), candidates.end(), [](auto const& lhs, auto const& rhs) -> bool {
+        return lhs.second->get_total_uncompressed_size()
+               > rhs.second->get_total_uncompressed_size();
+    });
+    SchemaCompactor compactor{m_schema_compaction_threshold};
+    std::vector<std::vector<std::pair<int32_t, SchemaWriter*>>> groups;
+    for (auto const& candidate : candidates) {
+        column_ids.clear();
+        for (auto const* column : candidate.second->get_columns()) {
+            column_ids.push_back(column->get_id());
+        }
+        auto const group_idx = compactor.add_schema(column_ids);
+        if (groups.size() == group_idx) {
+            groups.emplace_back();
+        }
+        groups[group_idx].push_back(candidate);
+    }
+
+    for (size_t group_idx{0}; group_idx < groups.size(); ++group_idx) {
+        auto const& group = groups[group_idx];
+        if (1 == group.size()) {
+            auto const& [schema_id, writer] = group.front();
+            tables.push_back(
+                    {writer,
+                     {{schema_id, writer->get_num_messages()}},
+                     writer->get_total_uncompressed_size()}
+            );
+            continue;
+        }
+
+        auto* table_writer = new SchemaWriter();
+        for (auto const column_id : compactor.get_group_columns(group_idx)) {
+            table_writer->append_column(create_column_writer(column_id));
+        }
+        Table table{table_writer, {}, 0};
+        auto& compacted_table = m_compacted_tables.emplace_back();
+        for (auto const& [schema_id, writer] : group) {
+            table_writer->append_messages(*writer);
+            table.schemas.emplace_back(schema_id, writer->get_num_messages());
+            compacted_table.push_back(schema_id);
+            delete writer;
+        }
+        table.uncompressed_size = table_writer->get_total_uncompressed_size();
+        tables.push_back(std::move(table));
+    }
+    return tables;
+}
+
+auto ArchiveWriter::store_tables()
+        -> std::tuple<std::vector<StreamMetadata>, std::vector<SchemaMetadata>, size_t> {
     m_tables_file_writer.open(
             m_archive_path + constants::cArchiveTablesFile,
             FileWriter::OpenMode::CreateForWriting
     );
-    m_table_metadata_file_writer.open(
-            m_archive_path + constants::cArchiveTableMetadataFile,
-            FileWriter::OpenMode::CreateForWriting
-    );
-    m_table_metadata_compressor.open(m_table_metadata_file_writer, m_compression_level);
 
     /**
      * Packed stream metadata schema
@@ -385,57 +617,75 @@ std::pair<size_t, size_t> ArchiveWriter::store_tables() {
      *     - Offset into the stream: <64-bit integer>
      *     - Schema ID: <32-bit integer>
      *     - Number of messages: <64-bit integer>
+     *   Schemas whose tables were compacted into a shared table all have the shared table's offset,
+     *   and their records are stored in the table in the order the schemas are listed.
      *
      * We buffer the first half of the metadata in the "stream_metadata" vector, and the second half
      * of the metadata in the "schema_metadata" vector as we compress the tables. The metadata is
-     * flushed once all of the schema tables have been compressed.
+     * flushed by `store_table_metadata` once all of the schema tables have been compressed.
      */
-    using schema_map_it = decltype(m_id_to_schema_writer)::iterator;
-    std::vector<schema_map_it> schemas;
+    auto tables = get_tables_to_store();
     std::vector<StreamMetadata> stream_metadata;
     std::vector<SchemaMetadata> schema_metadata;
 
     schema_metadata.reserve(m_id_to_schema_writer.size());
-    schemas.reserve(m_id_to_schema_writer.size());
-    for (auto it = m_id_to_schema_writer.begin(); it != m_id_to_schema_writer.end(); ++it) {
-        schemas.push_back(it);
-    }
-    auto comp = [](schema_map_it const& lhs, schema_map_it const& rhs) -> bool {
-        return lhs->second->get_total_uncompressed_size()
-               > rhs->second->get_total_uncompressed_size();
-    };
-    std::sort(schemas.begin(), schemas.end(), comp);
+    std::sort(tables.begin(), tables.end(), [](Table const& lhs, Table const& rhs) -> bool {
+        return lhs.uncompressed_size > rhs.uncompressed_size;
+    });
 
     uint64_t current_stream_offset = 0;
     uint64_t current_stream_id = 0;
     uint64_t current_table_file_offset = 0;
+    size_t num_tables_stored{0};
     m_tables_compressor.open(m_tables_file_writer, m_compression_level);
-    for (auto it : schemas) {
-        it->second->store(m_tables_compressor);
-        schema_metadata.emplace_back(
-                current_stream_id,
-                current_stream_offset,
-                it->first,
-                it->second->get_num_messages()
-        );
-        current_stream_offset += it->second->get_total_uncompressed_size();
-        delete it->second;
+    for (auto& table : tables) {
+        table.writer->store(m_tables_compressor);
+        // Every schema in a compacted table shares the table's offset, with the schemas' records
+        // stored in the order they're listed
+        for (auto const& [schema_id, num_messages] : table.schemas) {
+            schema_metadata.emplace_back(
+                    current_stream_id,
+                    current_stream_offset,
+                    schema_id,
+                    num_messages
+            );
+        }
+        // Columns may re-encode their values when they're stored, so the table's size is only
+        // known once it's been written
+        current_stream_offset = m_tables_compressor.get_pos();
+        delete table.writer;
+        ++num_tables_stored;
 
-        if (current_stream_offset > m_min_table_size || schemas.size() == schema_metadata.size()) {
+        if (current_stream_offset > m_min_table_size || tables.size() == num_tables_stored) {
             stream_metadata.emplace_back(current_table_file_offset, current_stream_offset);
             m_tables_compressor.close();
             current_stream_offset = 0;
             ++current_stream_id;
             current_table_file_offset = m_tables_file_writer.get_pos();
 
-            if (schemas.size() != schema_metadata.size()) {
+            if (tables.size() != num_tables_stored) {
                 m_tables_compressor.open(m_tables_file_writer, m_compression_level);
             }
         }
     }
 
+    auto const table_compressed_size = m_tables_file_writer.get_pos();
+    m_tables_file_writer.close();
+    return {std::move(stream_metadata), std::move(schema_metadata), table_compressed_size};
+}
+
+auto ArchiveWriter::store_table_metadata(
+        std::vector<StreamMetadata> const& stream_metadata,
+        std::vector<SchemaMetadata> const& schema_metadata
+) -> size_t {
+    m_table_metadata_file_writer.open(
+            m_archive_path + constants::cArchiveTableMetadataFile,
+            FileWriter::OpenMode::CreateForWriting
+    );
+    m_table_metadata_compressor.open(m_table_metadata_file_writer, m_compression_level);
+
     m_table_metadata_compressor.write_numeric_value(stream_metadata.size());
-    for (auto& stream : stream_metadata) {
+    for (auto const& stream : stream_metadata) {
         m_table_metadata_compressor.write_numeric_value(stream.file_offset);
         m_table_metadata_compressor.write_numeric_value(stream.uncompressed_size);
     }
@@ -446,7 +696,7 @@ std::pair<size_t, size_t> ArchiveWriter::store_tables() {
     m_table_metadata_compressor.write_numeric_value(num_separate_column_schemas);
 
     m_table_metadata_compressor.write_numeric_value(schema_metadata.size());
-    for (auto& schema : schema_metadata) {
+    for (auto const& schema : schema_metadata) {
         m_table_metadata_compressor.write_numeric_value(schema.stream_id);
         m_table_metadata_compressor.write_numeric_value(schema.stream_offset);
         m_table_metadata_compressor.write_numeric_value(schema.schema_id);
@@ -454,12 +704,136 @@ std::pair<size_t, size_t> ArchiveWriter::store_tables() {
     }
     m_table_metadata_compressor.close();
 
-    auto table_metadata_compressed_size = m_table_metadata_file_writer.get_pos();
-    auto table_compressed_size = m_tables_file_writer.get_pos();
-
+    auto const table_metadata_compressed_size = m_table_metadata_file_writer.get_pos();
     m_table_metadata_file_writer.close();
-    m_tables_file_writer.close();
+    return table_metadata_compressed_size;
+}
 
-    return {table_metadata_compressed_size, table_compressed_size};
+void ArchiveWriter::compress_with_trained_dictionary(
+        std::vector<ArchiveFileInfo>& files,
+        std::vector<StreamMetadata>& stream_metadata
+) {
+    // The variable, log type, and array dictionaries each consist of their number of entries
+    // followed by their compressed entries
+    struct DictionaryFile {
+        ArchiveFileInfo* file;
+        uint64_t num_entries;
+        std::string entries;
+    };
+
+    std::vector<DictionaryFile> dictionary_files;
+    ArchiveFileInfo* tables_file{nullptr};
+    size_t total_data_size{0};
+    FileReader reader;
+    for (auto& file : files) {
+        if (constants::cArchiveTablesFile == file.n) {
+            tables_file = &file;
+            continue;
+        }
+        if (constants::cArchiveVarDictFile != file.n && constants::cArchiveLogDictFile != file.n
+            && constants::cArchiveArrayDictFile != file.n)
+        {
+            continue;
+        }
+        reader.open(m_archive_path + file.n);
+        uint64_t num_entries{};
+        reader.read_numeric_value(num_entries, false);
+        auto entries = decompress_to_end(reader);
+        reader.close();
+        total_data_size += entries.size();
+        dictionary_files.push_back({&file, num_entries, std::move(entries)});
+    }
+    if (nullptr == tables_file) {
+        throw OperationFailed(ErrorCodeBadParam, __FILENAME__, __LINE__);
+    }
+    for (auto const& stream : stream_metadata) {
+        total_data_size += stream.uncompressed_size;
+    }
+
+    // Decompresses each of the tables' packed streams in turn, passing it to the given callback
+    auto const tables_path = m_archive_path + constants::cArchiveTablesFile;
+    std::string stream;
+    auto const for_each_stream = [&](auto callback) {
+        ZstdDecompressor decompressor;
+        reader.open(tables_path);
+        for (auto const& metadata : stream_metadata) {
+            reader.seek_from_begin(metadata.file_offset);
+            decompressor.open(reader, cDecompressorFileReadBufferCapacity);
+            stream.resize(metadata.uncompressed_size);
+            if (auto const rc = decompressor.try_read_exact_length(stream.data(), stream.size());
+                ErrorCodeSuccess != rc)
+            {
+                throw OperationFailed(rc, __FILENAME__, __LINE__);
+            }
+            decompressor.close_for_reuse();
+            callback(stream);
+        }
+        decompressor.close();
+        reader.close();
+    };
+
+    ZstdDictionaryTrainer trainer{m_zstd_dictionary_size, total_data_size};
+    for (auto const& dictionary_file : dictionary_files) {
+        trainer.add_data(dictionary_file.entries.data(), dictionary_file.entries.size());
+    }
+    for_each_stream([&](std::string const& data) { trainer.add_data(data.data(), data.size()); });
+    auto dictionary = trainer.train();
+    if (dictionary.empty()) {
+        return;
+    }
+
+    // Recompress into temporary files, so that the original files can be kept if the dictionary
+    // doesn't make them smaller
+    ZstdCompressionDictionary const compression_dictionary{dictionary, m_compression_level};
+    ZstdCompressor compressor;
+    FileWriter writer;
+    size_t original_size{0};
+    size_t recompressed_size{dictionary.size()};
+
+    std::vector<size_t> recompressed_dictionary_file_sizes;
+    for (auto const& dictionary_file : dictionary_files) {
+        writer.open(
+                m_archive_path + dictionary_file.file->n + constants::cTmpPostfix,
+                FileWriter::OpenMode::CreateForWriting
+        );
+        writer.write_numeric_value(dictionary_file.num_entries);
+        compressor.open(writer, m_compression_level, &compression_dictionary);
+        compressor.write(dictionary_file.entries.data(), dictionary_file.entries.size());
+        compressor.close();
+        recompressed_dictionary_file_sizes.push_back(writer.get_pos());
+        writer.close();
+        original_size += dictionary_file.file->o;
+        recompressed_size += recompressed_dictionary_file_sizes.back();
+    }
+
+    std::vector<uint64_t> recompressed_stream_offsets;
+    writer.open(tables_path + constants::cTmpPostfix, FileWriter::OpenMode::CreateForWriting);
+    for_each_stream([&](std::string const& data) {
+        recompressed_stream_offsets.push_back(writer.get_pos());
+        compressor.open(writer, m_compression_level, &compression_dictionary);
+        compressor.write(data.data(), data.size());
+        compressor.close();
+    });
+    auto const recompressed_tables_size = writer.get_pos();
+    writer.close();
+    original_size += tables_file->o;
+    recompressed_size += recompressed_tables_size;
+
+    bool const should_replace{recompressed_size < original_size};
+    for (size_t i{0}; i < dictionary_files.size(); ++i) {
+        auto& file = *dictionary_files[i].file;
+        replace_file(m_archive_path + file.n, should_replace);
+        if (should_replace) {
+            file.o = recompressed_dictionary_file_sizes[i];
+        }
+    }
+    replace_file(tables_path, should_replace);
+    if (should_replace) {
+        tables_file->o = recompressed_tables_size;
+        for (size_t i{0}; i < stream_metadata.size(); ++i) {
+            stream_metadata[i].file_offset = recompressed_stream_offsets[i];
+        }
+        m_zstd_dictionary = std::move(dictionary);
+    }
 }
 }  // namespace clp_s
@@ -4,7 +4,9 @@
 #include <optional>
 #include <string>
 #include <string_view>
+#include <tuple>
 #include <utility>
+#include <vector>
 
 #include <boost/uuid/uuid.hpp>
 #include <boost/uuid/uuid_io.hpp>
@@ -12,7 +14,9 @@
 
 #include "../clp/streaming_archive/Constants.hpp"
 #include "archive_constants.hpp"
+#include "ArrayTape.hpp"
 #include "DictionaryWriter.hpp"
+#include "FloatEncoding.hpp"
 #include "RangeIndexWriter.hpp"
 #include "Schema.hpp"
 #include "SchemaMap.hpp"
@@ -29,6 +33,13 @@ struct ArchiveWriterOption {
     bool print_archive_stats;
     bool single_file_archive;
     size_t min_table_size;
+    FloatEncoding float_encoding{FloatEncoding::Raw};
+    ArrayEncoding array_encoding{ArrayEncoding::ClpString};
+    // The maximum size of the zstd dictionary to train for the archive, or 0 to not train one
+    size_t zstd_dictionary_size{0};
+    // The minimum similarity of the columns of schemas whose tables are compacted into a shared
+    // table, or 0 to not compact tables
+    double schema_compaction_threshold{0.0};
     std::vector<std::string> authoritative_timestamp;
     std::string authoritative_timestamp_namespace;
 };
@@ -176,7 +187,11 @@ public:
      * @param key
      * @return true if this leaf node would match the authoritative timestamp and false otherwise
      */
-    bool matches_timestamp(int parent_node_id, std::string_view key);
+    bool matches_timestamp(int parent_node_id, std::string_view key) const {
+        return m_matched_timestamp_prefix_node_id == parent_node_id
+               && 1 == (m_authoritative_timestamp.size() - m_matched_timestamp_prefix_length)
+               && m_authoritative_timestamp.back() == key;
+    }
 
     /**
      * @return The Id that will be assigned to the next log event when appended to the archive.
@@ -205,7 +220,10 @@ public:
             std::string_view timestamp,
             uint64_t& pattern_id
     ) {
-        return m_timestamp_dict.ingest_entry(key, node_id, timestamp, pattern_id);
+        auto const epoch_timestamp
+                = m_timestamp_dict.ingest_entry(key, node_id, timestamp, pattern_id);
+        m_cur_message_timestamp = epoch_timestamp;
+        return epoch_timestamp;
     }
 
     /**
@@ -216,10 +234,13 @@ public:
      */
     void ingest_timestamp_entry(std::string_view key, int32_t node_id, double timestamp) {
         m_timestamp_dict.ingest_entry(key, node_id, timestamp);
+        // Matches how SchemaReader extracts timestamps from float columns
+        m_cur_message_timestamp = static_cast<epochtime_t>(timestamp);
     }
 
     void ingest_timestamp_entry(std::string_view key, int32_t node_id, int64_t timestamp) {
         m_timestamp_dict.ingest_entry(key, node_id, timestamp);
+        m_cur_message_timestamp = timestamp;
     }
 
     /**
@@ -270,6 +291,18 @@ public:
     }
 
 private:
+    /**
+     * A table to store, containing the records of one schema, or of several schemas whose tables
+     * were compacted.
+     */
+    struct Table {
+        SchemaWriter* writer;
+        // The ID and number of records of each schema whose records the table contains, in the
+        // order the records are stored
+        std::vector<std::pair<int32_t, uint64_t>> schemas;
+        size_t uncompressed_size;
+    };
+
     /**
      * Initializes the schema writer
      * @param writer
@@ -277,13 +310,56 @@ private:
      */
     void initialize_schema_writer(SchemaWriter* writer, Schema const& schema);
 
+    /**
+     * Creates a column writer for a node in the schema tree.
+     * @param id
+     * @return The column writer, or nullptr if the node's values aren't stored in a column
+     */
+    [[nodiscard]] auto create_column_writer(int32_t id) -> BaseColumnWriter*;
+
+    /**
+     * Gets the tables to store, compacting the tables of schemas with similar columns into shared
+     * tables if enabled. Small tables of schemas without unordered objects are compacted into a
+     * shared table which stores the union of their columns, with placeholder values for records
+     * which don't contain a column.
+     * @return The tables to store, which take ownership of the schema writers
+     */
+    [[nodiscard]] auto get_tables_to_store() -> std::vector<Table>;
+
     /**
      * Compresses and stores the tables.
-     * @return A pair containing:
-     *         - The size of the compressed table metadata in bytes.
+     * @return A tuple containing:
+     *         - The metadata of the packed streams the tables were compressed into.
+     *         - The metadata of the tables.
      *         - The size of the compressed tables in bytes.
      */
-    [[nodiscard]] std::pair<size_t, size_t> store_tables();
+    [[nodiscard]] auto store_tables()
+            -> std::tuple<std::vector<StreamMetadata>, std::vector<SchemaMetadata>, size_t>;
+
+    /**
+     * Compresses and stores the metadata of the tables.
+     * @param stream_metadata
+     * @param schema_metadata
+     * @return The size of the compressed table metadata in bytes.
+     */
+    [[nodiscard]] auto store_table_metadata(
+            std::vector<StreamMetadata> const& stream_metadata,
+            std::vector<SchemaMetadata> const& schema_metadata
+    ) -> size_t;
+
+    /**
+     * Trains a zstd dictionary on samples of the tables and the variable, log type, and array
+     * dictionaries, and recompresses them with it if that makes them smaller, including the size of
+     * the zstd dictionary itself, which is then stored in the archive's metadata.
+     * @param files The archive's files and their compressed sizes, which are updated for the files
+     * that are recompressed.
+     * @param stream_metadata The metadata of the tables' packed streams, whose file offsets are
+     * updated if the tables are recompressed.
+     */
+    void compress_with_trained_dictionary(
+            std::vector<ArchiveFileInfo>& files,
+            std::vector<StreamMetadata>& stream_metadata
+    );
 
     /**
      * Writes the archive to a single file
@@ -338,6 +414,15 @@ private:
     bool m_print_archive_stats{};
     bool m_single_file_archive{};
     size_t m_min_table_size{};
+    FloatEncoding m_float_encoding{FloatEncoding::Raw};
+    ArrayEncoding m_array_encoding{ArrayEncoding::ClpString};
+    size_t m_zstd_dictionary_size{0};
+    // The zstd dictionary trained for the archive, or empty if the archive doesn't use one
+    std::string m_zstd_dictionary;
+    double m_schema_compaction_threshold{0.0};
+    // The schemas whose tables were compacted into each shared table, in the order their records
+    // are stored
+    std::vector<std::vector<int32_t>> m_compacted_tables;
 
     std::vector<std::string> m_authoritative_timestamp;
     std::string m_authoritative_timestamp_namespace;
@@ -348,6 +433,12 @@ private:
     SchemaTree m_schema_tree;
 
     std::map<int32_t, SchemaWriter*> m_id_to_schema_writer;
+    // The range of log event indices, [begin, end), appended to each schema's table
+    std::map<int32_t, std::pair<int64_t, int64_t>> m_schema_id_to_log_event_idx_range;
+    // The range of timestamps, [begin, end], appended to each schema's table that has a timestamp
+    std::map<int32_t, std::pair<epochtime_t, epochtime_t>> m_schema_id_to_timestamp_range;
+    // The timestamp ingested for the message currently being parsed, if any
+    std::optional<epochtime_t> m_cur_message_timestamp;
 
     FileWriter m_tables_file_writer;
     FileWriter m_table_metadata_file_writer;
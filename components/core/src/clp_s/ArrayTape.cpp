@@ -0,0 +1,168 @@
+#include "ArrayTape.hpp"
+
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+#include "ErrorCode.hpp"
+#include "Utils.hpp"
+
+namespace clp_s {
+namespace {
+using tape_size_t = uint32_t;
+
+// The maximum number of characters needed to print a double so that it round-trips
+constexpr size_t cMaxDoubleLength{32};
+}  // namespace
+
+void ArrayTapeWriter::end_container() {
+    if (m_container_size_positions.empty()) {
+        throw OperationFailed(ErrorCodeNotReady, __FILENAME__, __LINE__);
+    }
+    auto const size_pos = m_container_size_positions.back();
+    m_container_size_positions.pop_back();
+    auto const contents_size = m_tape.size() - size_pos - sizeof(tape_size_t);
+    if (contents_size > std::numeric_limits<tape_size_t>::max()) {
+        throw OperationFailed(ErrorCodeTooLong, __FILENAME__, __LINE__);
+    }
+    auto const size = static_cast<tape_size_t>(contents_size);
+    std::memcpy(m_tape.data() + size_pos, &size, sizeof(size));
+}
+
+void ArrayTapeWriter::add_string_with_length(std::string_view value) {
+    if (value.size() > std::numeric_limits<tape_size_t>::max()) {
+        throw OperationFailed(ErrorCodeTooLong, __FILENAME__, __LINE__);
+    }
+    add_numeric_value(static_cast<tape_size_t>(value.size()));
+    m_tape.append(value);
+}
+
+void ArrayTapeWriter::begin_container(ArrayTapeValueType type) {
+    add_type(type);
+    m_container_size_positions.push_back(m_tape.size());
+    // The size is filled in when the container ends
+    add_numeric_value(tape_size_t{0});
+}
+
+auto ArrayTapeIterator::next_key() -> std::string_view {
+    return read_with_length();
+}
+
+auto ArrayTapeIterator::next_value() -> ArrayTapeValue {
+    auto const type = static_cast<ArrayTapeValueType>(read(sizeof(ArrayTapeValueType)).front());
+    switch (type) {
+        case ArrayTapeValueType::Null:
+        case ArrayTapeValueType::False:
+        case ArrayTapeValueType::True:
+            return {type, {}};
+        case ArrayTapeValueType::Int64:
+            return {type, read(sizeof(int64_t))};
+        case ArrayTapeValueType::UInt64:
+            return {type, read(sizeof(uint64_t))};
+        case ArrayTapeValueType::Double:
+            return {type, read(sizeof(double))};
+        case ArrayTapeValueType::String:
+        case ArrayTapeValueType::Array:
+        case ArrayTapeValueType::Object:
+            return {type, read_with_length()};
+        default:
+            throw OperationFailed(ErrorCodeCorrupt, __FILENAME__, __LINE__);
+    }
+}
+
+void ArrayTapeIterator::append_array_as_json(std::string_view tape, std::string& buffer) {
+    append_value_as_json({ArrayTapeValueType::Array, tape}, buffer);
+}
+
+auto ArrayTapeIterator::read(size_t size) -> std::string_view {
+    if (m_remaining.size() < size) {
+        throw OperationFailed(ErrorCodeCorrupt, __FILENAME__, __LINE__);
+    }
+    auto const bytes = m_remaining.substr(0, size);
+    m_remaining.remove_prefix(size);
+    return bytes;
+}
+
+auto ArrayTapeIterator::read_with_length() -> std::string_view {
+    tape_size_t size{};
+    std::memcpy(&size, read(sizeof(size)).data(), sizeof(size));
+    return read(size);
+}
+
+void ArrayTapeIterator::append_value_as_json(ArrayTapeValue const& value, std::string& buffer) {
+    switch (value.get_type()) {
+        case ArrayTapeValueType::Null:
+            buffer.append("null");
+            break;
+        case ArrayTapeValueType::False:
+            buffer.append("false");
+            break;
+        case ArrayTapeValueType::True:
+            buffer.append("true");
+            break;
+        case ArrayTapeValueType::Int64:
+            buffer.append(std::to_string(value.get_int64()));
+            break;
+        case ArrayTapeValueType::UInt64:
+            buffer.append(std::to_string(value.get_uint64()));
+            break;
+        case ArrayTapeValueType::Double: {
+            std::array<char, cMaxDoubleLength> chars{};
+            auto const [end, ec] = std::to_chars(chars.begin(), chars.end(), value.get_double());
+            if (std::errc{} != ec) {
+                throw OperationFailed(ErrorCodeCorrupt, __FILENAME__, __LINE__);
+            }
+            std::string_view const double_str{
+                    chars.data(),
+                    static_cast<size_t>(end - chars.data())
+            };
+            buffer.append(double_str);
+            // Keep the value a float if it's parsed again
+            if (std::string_view::npos == double_str.find_first_of(".e")) {
+                buffer.append(".0");
+            }
+            break;
+        }
+        case ArrayTapeValueType::String:
+            buffer.push_back('"');
+            StringUtils::escape_json_string(buffer, value.get_string());
+            buffer.push_back('"');
+            break;
+        case ArrayTapeValueType::Array: {
+            buffer.push_back('[');
+            ArrayTapeIterator it{value.get_contents()};
+            for (bool is_first{true}; it.has_next(); is_first = false) {
+                if (false == is_first) {
+                    buffer.push_back(',');
+                }
+                append_value_as_json(it.next_value(), buffer);
+            }
+            buffer.push_back(']');
+            break;
+        }
+        case ArrayTapeValueType::Object: {
+            buffer.push_back('{');
+            ArrayTapeIterator it{value.get_contents()};
+            for (bool is_first{true}; it.has_next(); is_first = false) {
+                if (false == is_first) {
+                    buffer.push_back(',');
+                }
+                buffer.push_back('"');
+                StringUtils::escape_json_string(buffer, it.next_key());
+                buffer.append("\":");
+                append_value_as_json(it.next_value(), buffer);
+            }
+            buffer.push_back('}');
+            break;
+        }
+        default:
+            throw OperationFailed(ErrorCodeCorrupt, __FILENAME__, __LINE__);
+    }
+}
+}  // namespace clp_s
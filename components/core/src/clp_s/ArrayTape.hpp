@@ -0,0 +1,256 @@
+#ifndef CLP_S_ARRAYTAPE_HPP
+#define CLP_S_ARRAYTAPE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ErrorCode.hpp"
+#include "TraceableException.hpp"
+
+namespace clp_s {
+/**
+ * The encodings of unstructured array columns. Each unstructured array column starts with the
+ * encoding of its values.
+ */
+enum class ArrayEncoding : uint8_t {
+    // Each array is stored as its JSON text, encoded as a CLP string
+    ClpString = 0,
+    // Each array is stored as an array tape (see `ArrayTapeWriter`)
+    Tape
+};
+
+/**
+ * The types of the values in an array tape.
+ */
+enum class ArrayTapeValueType : uint8_t {
+    Null = 0,
+    False,
+    True,
+    Int64,
+    // Integers which are larger than the maximum int64_t
+    UInt64,
+    Double,
+    String,
+    Array,
+    Object
+};
+
+/**
+ * Writes the tape of an array: a compact, pre-parsed binary representation of the array which can
+ * be searched and serialized without being parsed again.
+ *
+ * The tape of an array is the sequence of its values, where each value is its type followed by:
+ * - the value, for int64_ts, uint64_ts, and doubles;
+ * - the value's length (as a uint32_t) and its unescaped characters, for strings;
+ * - the size of the container's contents in bytes (as a uint32_t) and its contents, for arrays and
+ *   objects. The contents of an array are the sequence of its values, and the contents of an object
+ *   are the sequence of its fields, where each field is the key's length (as a uint32_t), the key's
+ *   unescaped characters, and the field's value.
+ *
+ * Containers are prefixed with their size so that readers can skip them without reading their
+ * contents.
+ */
+class ArrayTapeWriter {
+public:
+    // Types
+    class OperationFailed : public TraceableException {
+    public:
+        // Constructors
+        OperationFailed(ErrorCode error_code, char const* const filename, int line_number)
+                : TraceableException(error_code, filename, line_number) {}
+    };
+
+    // Methods
+    /**
+     * Clears the tape so that another array can be written.
+     */
+    void clear() {
+        m_tape.clear();
+        m_container_size_positions.clear();
+    }
+
+    /**
+     * @return The tape of the array written since the tape was last cleared.
+     */
+    [[nodiscard]] auto get_tape() const -> std::string_view { return m_tape; }
+
+    void add_null() { add_type(ArrayTapeValueType::Null); }
+
+    void add_bool(bool value) {
+        add_type(value ? ArrayTapeValueType::True : ArrayTapeValueType::False);
+    }
+
+    void add_int64(int64_t value) {
+        add_type(ArrayTapeValueType::Int64);
+        add_numeric_value(value);
+    }
+
+    void add_uint64(uint64_t value) {
+        add_type(ArrayTapeValueType::UInt64);
+        add_numeric_value(value);
+    }
+
+    void add_double(double value) {
+        add_type(ArrayTapeValueType::Double);
+        add_numeric_value(value);
+    }
+
+    /**
+     * @param value The unescaped string
+     * @throw OperationFailed if the string is too long
+     */
+    void add_string(std::string_view value) {
+        add_type(ArrayTapeValueType::String);
+        add_string_with_length(value);
+    }
+
+    /**
+     * Adds the key of the next field of the current object.
+     * @param key The unescaped key
+     * @throw OperationFailed if the key is too long
+     */
+    void add_key(std::string_view key) { add_string_with_length(key); }
+
+    void begin_array() { begin_container(ArrayTapeValueType::Array); }
+
+    void begin_object() { begin_container(ArrayTapeValueType::Object); }
+
+    /**
+     * Ends the current array or object.
+     * @throw OperationFailed if there's no current container or its contents are too large
+     */
+    void end_container();
+
+private:
+    // Methods
+    void add_type(ArrayTapeValueType type) { m_tape.push_back(static_cast<char>(type)); }
+
+    template <typename T>
+    void add_numeric_value(T value) {
+        m_tape.append(reinterpret_cast<char const*>(&value), sizeof(value));
+    }
+
+    void add_string_with_length(std::string_view value);
+
+    void begin_container(ArrayTapeValueType type);
+
+    // Variables
+    std::string m_tape;
+    // The positions of the sizes of the containers which haven't been ended yet
+    std::vector<size_t> m_container_size_positions;
+};
+
+/**
+ * A value read from an array tape.
+ */
+class ArrayTapeValue {
+public:
+    // Constructors
+    ArrayTapeValue(ArrayTapeValueType type, std::string_view data) : m_type(type), m_data(data) {}
+
+    // Methods
+    [[nodiscard]] auto get_type() const -> ArrayTapeValueType { return m_type; }
+
+    [[nodiscard]] auto get_int64() const -> int64_t { return get_numeric_value<int64_t>(); }
+
+    [[nodiscard]] auto get_uint64() const -> uint64_t { return get_numeric_value<uint64_t>(); }
+
+    [[nodiscard]] auto get_double() const -> double { return get_numeric_value<double>(); }
+
+    /**
+     * @return The unescaped characters of a string.
+     */
+    [[nodiscard]] auto get_string() const -> std::string_view { return m_data; }
+
+    /**
+     * @return The contents of an array or object, which can be read with an `ArrayTapeIterator`.
+     */
+    [[nodiscard]] auto get_contents() const -> std::string_view { return m_data; }
+
+private:
+    template <typename T>
+    [[nodiscard]] auto get_numeric_value() const -> T {
+        T value{};
+        std::memcpy(&value, m_data.data(), sizeof(T));
+        return value;
+    }
+
+    ArrayTapeValueType m_type;
+    // The value's bytes, the string's characters, or the container's contents
+    std::string_view m_data;
+};
+
+/**
+ * Iterates over the values of an array tape, or the contents of an array or object within one.
+ */
+class ArrayTapeIterator {
+public:
+    // Types
+    class OperationFailed : public TraceableException {
+    public:
+        // Constructors
+        OperationFailed(ErrorCode error_code, char const* const filename, int line_number)
+                : TraceableException(error_code, filename, line_number) {}
+    };
+
+    // Constructors
+    explicit ArrayTapeIterator(std::string_view contents) : m_remaining(contents) {}
+
+    // Methods
+    [[nodiscard]] auto has_next() const -> bool { return false == m_remaining.empty(); }
+
+    /**
+     * Reads the key of the next field of an object's contents.
+     * @return The unescaped key
+     * @throw OperationFailed if the tape is corrupt
+     */
+    auto next_key() -> std::string_view;
+
+    /**
+     * Reads the next value, skipping over its contents if it's a container.
+     * @return The value
+     * @throw OperationFailed if the tape is corrupt
+     */
+    auto next_value() -> ArrayTapeValue;
+
+    /**
+     * Appends the JSON text of the array with the given tape to a buffer.
+     * @param tape
+     * @param buffer
+     * @throw OperationFailed if the tape is corrupt
+     */
+    static void append_array_as_json(std::string_view tape, std::string& buffer);
+
+private:
+    /**
+     * Reads the given number of bytes.
+     * @param size
+     * @return The bytes
+     * @throw OperationFailed if fewer bytes remain
+     */
+    auto read(size_t size) -> std::string_view;
+
+    /**
+     * Reads a length-prefixed sequence of bytes.
+     * @return The bytes
+     * @throw OperationFailed if the tape is corrupt
+     */
+    auto read_with_length() -> std::string_view;
+
+    /**
+     * Appends the JSON text of the given value to a buffer.
+     * @param value
+     * @param buffer
+     * @throw OperationFailed if the tape is corrupt
+     */
+    static void append_value_as_json(ArrayTapeValue const& value, std::string& buffer);
+
+    std::string_view m_remaining;
+};
+}  // namespace clp_s
+
+#endif  // CLP_S_ARRAYTAPE_HPP
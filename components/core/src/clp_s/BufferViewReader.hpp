@@ -1,6 +1,8 @@
 #ifndef CLP_S_BUFFER_VIEW_READER_HPP
 #define CLP_S_BUFFER_VIEW_READER_HPP
 
+#include <string_view>
+
 #include "TraceableException.hpp"
 #include "Utils.hpp"
 
@@ -48,6 +50,16 @@ public:
         return tmp;
     }
 
+    std::string_view read_string_view(size_t length) {
+        if (m_remaining_size < length) {
+            throw OperationFailed(ErrorCodeOutOfBounds, __FILENAME__, __LINE__);
+        }
+        std::string_view tmp{m_buffer, length};
+        m_buffer += length;
+        m_remaining_size -= length;
+        return tmp;
+    }
+
     size_t get_remaining_size() { return m_remaining_size; }
 
 private:
@@ -7,7 +7,70 @@
 
 namespace clp_s {
 void Int64ColumnReader::load(BufferViewReader& reader, uint64_t num_messages) {
-    m_values = reader.read_unaligned_span<int64_t>(num_messages);
+    auto const encoding
+            = m_is_encoding_stored ? reader.read_value<IntegerEncoding>() : IntegerEncoding::Raw;
+    bool is_valid{false};
+    switch (encoding) {
+        case IntegerEncoding::Raw:
+            m_values = reader.read_unaligned_span<int64_t>(num_messages);
+            return;
+        case IntegerEncoding::FrameOfReference: {
+            auto const base = reader.read_value<int64_t>();
+            auto const bit_width = reader.read_value<uint8_t>();
+            auto const packed_values = reader.read_unaligned_span<uint64_t>(
+                    IntegerEncoder::get_num_packed_words(num_messages, bit_width)
+            );
+            is_valid = IntegerEncoder::decode_frame_of_reference(
+                    base,
+                    bit_width,
+                    packed_values,
+                    num_messages,
+                    m_decoded_values
+            );
+            break;
+        }
+        case IntegerEncoding::Delta: {
+            auto const first_value = reader.read_value<int64_t>();
+            auto const deltas_base = reader.read_value<int64_t>();
+            auto const bit_width = reader.read_value<uint8_t>();
+            auto const packed_deltas = reader.read_unaligned_span<uint64_t>(
+                    IntegerEncoder::get_num_packed_words(
+                            num_messages > 0 ? num_messages - 1 : 0,
+                            bit_width
+                    )
+            );
+            is_valid = IntegerEncoder::decode_delta(
+                    first_value,
+                    deltas_base,
+                    bit_width,
+                    packed_deltas,
+                    num_messages,
+                    m_decoded_values
+            );
+            break;
+        }
+        case IntegerEncoding::RunLength: {
+            auto const num_runs = reader.read_value<size_t>();
+            auto const run_values = reader.read_unaligned_span<int64_t>(num_runs);
+            auto const run_lengths = reader.read_unaligned_span<uint64_t>(num_runs);
+            is_valid = IntegerEncoder::decode_run_length(
+                    run_values,
+                    run_lengths,
+                    num_messages,
+                    m_decoded_values
+            );
+            break;
+        }
+        default:
+            break;
+    }
+    if (false == is_valid) {
+        throw OperationFailed(ErrorCodeCorrupt, __FILENAME__, __LINE__);
+    }
+    m_values = UnalignedMemSpan<int64_t>{
+            reinterpret_cast<char*>(m_decoded_values.data()),
+            m_decoded_values.size()
+    };
 }
 
 std::variant<int64_t, double, std::string, uint8_t> Int64ColumnReader::extract_value(
@@ -47,7 +110,38 @@ std::variant<int64_t, double, std::string, uint8_t> DeltaEncodedInt64ColumnReade
 }
 
 void FloatColumnReader::load(BufferViewReader& reader, uint64_t num_messages) {
-    m_values = reader.read_unaligned_span<double>(num_messages);
+    auto const encoding
+            = m_is_encoding_stored ? reader.read_value<FloatEncoding>() : FloatEncoding::Raw;
+    if (FloatEncoding::Raw == encoding) {
+        m_values = reader.read_unaligned_span<double>(num_messages);
+        return;
+    }
+    if (FloatEncoding::Alp != encoding) {
+        throw OperationFailed(ErrorCodeCorrupt, __FILENAME__, __LINE__);
+    }
+
+    auto const exponent = reader.read_value<uint8_t>();
+    auto const factor = reader.read_value<uint8_t>();
+    auto const digits = reader.read_unaligned_span<int64_t>(num_messages);
+    auto const num_exceptions = reader.read_value<size_t>();
+    auto const exception_positions = reader.read_unaligned_span<uint64_t>(num_exceptions);
+    auto const exception_values = reader.read_unaligned_span<double>(num_exceptions);
+    if (false
+        == AlpEncoder::decode(
+                exponent,
+                factor,
+                digits,
+                exception_positions,
+                exception_values,
+                m_decoded_values
+        ))
+    {
+        throw OperationFailed(ErrorCodeCorrupt, __FILENAME__, __LINE__);
+    }
+    m_values = UnalignedMemSpan<double>{
+            reinterpret_cast<char*>(m_decoded_values.data()),
+            m_decoded_values.size()
+    };
 }
 
 void
@@ -152,6 +246,53 @@ UnalignedMemSpan<int64_t> ClpStringColumnReader::get_encoded_vars(uint64_t cur_m
     return m_encoded_vars.sub_span(encoded_vars_offset, entry.get_num_vars());
 }
 
+void UnstructuredArrayColumnReader::load(BufferViewReader& reader, uint64_t num_messages) {
+    m_encoding = m_is_encoding_stored ? reader.read_value<ArrayEncoding>()
+                                      : ArrayEncoding::ClpString;
+    if (ArrayEncoding::ClpString == m_encoding) {
+        m_clp_string_reader.load(reader, num_messages);
+        return;
+    }
+    if (ArrayEncoding::Tape != m_encoding) {
+        throw OperationFailed(ErrorCodeCorrupt, __FILENAME__, __LINE__);
+    }
+
+    m_tape_end_offsets = reader.read_unaligned_span<uint64_t>(num_messages);
+    auto const tapes_size = reader.read_value<size_t>();
+    m_tapes = reader.read_string_view(tapes_size);
+    if (num_messages > 0 && m_tape_end_offsets[num_messages - 1] != tapes_size) {
+        throw OperationFailed(ErrorCodeCorrupt, __FILENAME__, __LINE__);
+    }
+}
+
+std::variant<int64_t, double, std::string, uint8_t> UnstructuredArrayColumnReader::extract_value(
+        uint64_t cur_message
+) {
+    std::string array;
+    extract_string_value_into_buffer(cur_message, array);
+    return array;
+}
+
+void UnstructuredArrayColumnReader::extract_string_value_into_buffer(
+        uint64_t cur_message,
+        std::string& buffer
+) {
+    if (ArrayEncoding::ClpString == m_encoding) {
+        m_clp_string_reader.extract_string_value_into_buffer(cur_message, buffer);
+    } else {
+        ArrayTapeIterator::append_array_as_json(get_tape(cur_message), buffer);
+    }
+}
+
+std::string_view UnstructuredArrayColumnReader::get_tape(uint64_t cur_message) {
+    uint64_t const begin_offset = 0 == cur_message ? 0 : m_tape_end_offsets[cur_message - 1];
+    uint64_t const end_offset = m_tape_end_offsets[cur_message];
+    if (begin_offset > end_offset || end_offset > m_tapes.size()) {
+        throw OperationFailed(ErrorCodeCorrupt, __FILENAME__, __LINE__);
+    }
+    return m_tapes.substr(begin_offset, end_offset - begin_offset);
+}
+
 void VariableStringColumnReader::load(BufferViewReader& reader, uint64_t num_messages) {
     m_variables = reader.read_unaligned_span<uint64_t>(num_messages);
 }
@@ -2,10 +2,15 @@
 #define CLP_S_COLUMNREADER_HPP
 
 #include <string>
+#include <string_view>
 #include <variant>
+#include <vector>
 
+#include "ArrayTape.hpp"
 #include "BufferViewReader.hpp"
 #include "DictionaryReader.hpp"
+#include "FloatEncoding.hpp"
+#include "IntegerEncoding.hpp"
 #include "SchemaTree.hpp"
 #include "TimestampDictionaryReader.hpp"
 #include "Utils.hpp"
@@ -71,7 +76,14 @@ private:
 class Int64ColumnReader : public BaseColumnReader {
 public:
     // Constructor
-    explicit Int64ColumnReader(int32_t id) : BaseColumnReader(id) {}
+    /**
+     * @param id
+     * @param is_encoding_stored Whether the column is prefixed by its `IntegerEncoding`, which
+     * archives older than `cColumnEncodingArchiveVersion` don't store (their columns are raw).
+     */
+    Int64ColumnReader(int32_t id, bool is_encoding_stored)
+            : BaseColumnReader(id),
+              m_is_encoding_stored{is_encoding_stored} {}
 
     // Destructor
     ~Int64ColumnReader() override = default;
@@ -88,7 +100,10 @@ public:
     void extract_string_value_into_buffer(uint64_t cur_message, std::string& buffer) override;
 
 private:
+    bool m_is_encoding_stored;
     UnalignedMemSpan<int64_t> m_values;
+    // The decoded values of an encoded column, which `m_values` views
+    std::vector<int64_t> m_decoded_values;
 };
 
 class DeltaEncodedInt64ColumnReader : public BaseColumnReader {
@@ -127,7 +142,14 @@ private:
 class FloatColumnReader : public BaseColumnReader {
 public:
     // Constructor
-    explicit FloatColumnReader(int32_t id) : BaseColumnReader(id) {}
+    /**
+     * @param id
+     * @param is_encoding_stored Whether the column is prefixed by its `FloatEncoding`, which
+     * archives older than `cColumnEncodingArchiveVersion` don't store (their columns are raw).
+     */
+    FloatColumnReader(int32_t id, bool is_encoding_stored)
+            : BaseColumnReader(id),
+              m_is_encoding_stored{is_encoding_stored} {}
 
     // Destructor
     ~FloatColumnReader() override = default;
@@ -144,7 +166,10 @@ public:
     void extract_string_value_into_buffer(uint64_t cur_message, std::string& buffer) override;
 
 private:
+    bool m_is_encoding_stored;
     UnalignedMemSpan<double> m_values;
+    // The decoded values of an encoded column, which `m_values` views
+    std::vector<double> m_decoded_values;
 };
 
 class BooleanColumnReader : public BaseColumnReader {
@@ -227,6 +252,66 @@ private:
     bool m_is_array;
 };
 
+/**
+ * Reads unstructured array columns, which may be encoded as CLP strings or as tapes (see
+ * `ArrayEncoding`).
+ */
+class UnstructuredArrayColumnReader : public BaseColumnReader {
+public:
+    // Constructor
+    /**
+     * @param id
+     * @param var_dict
+     * @param array_dict
+     * @param is_encoding_stored Whether the column is prefixed by its `ArrayEncoding`, which
+     * archives older than `cColumnEncodingArchiveVersion` don't store (their columns are CLP
+     * strings).
+     */
+    UnstructuredArrayColumnReader(
+            int32_t id,
+            std::shared_ptr<VariableDictionaryReader> var_dict,
+            std::shared_ptr<LogTypeDictionaryReader> array_dict,
+            bool is_encoding_stored
+    )
+            : BaseColumnReader(id),
+              m_is_encoding_stored{is_encoding_stored},
+              m_clp_string_reader(id, std::move(var_dict), std::move(array_dict), true) {}
+
+    // Destructor
+    ~UnstructuredArrayColumnReader() override = default;
+
+    // Methods inherited from BaseColumnReader
+    void load(BufferViewReader& reader, uint64_t num_messages) override;
+
+    NodeType get_type() override { return NodeType::UnstructuredArray; }
+
+    std::variant<int64_t, double, std::string, uint8_t> extract_value(
+            uint64_t cur_message
+    ) override;
+
+    void extract_string_value_into_buffer(uint64_t cur_message, std::string& buffer) override;
+
+    /**
+     * @return The encoding of the loaded column
+     */
+    ArrayEncoding get_encoding() const { return m_encoding; }
+
+    /**
+     * Gets the tape of an array. Only valid when the column is encoded as tapes.
+     * @param cur_message
+     * @return The array's tape, which can be read with an `ArrayTapeIterator`
+     */
+    std::string_view get_tape(uint64_t cur_message);
+
+private:
+    bool m_is_encoding_stored;
+    ArrayEncoding m_encoding{ArrayEncoding::ClpString};
+    ClpStringColumnReader m_clp_string_reader;
+
+    UnalignedMemSpan<uint64_t> m_tape_end_offsets;
+    std::string_view m_tapes;
+};
+
 class VariableStringColumnReader : public BaseColumnReader {
 public:
     // Constructor
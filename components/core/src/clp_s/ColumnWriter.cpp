@@ -1,14 +1,83 @@
 #include "ColumnWriter.hpp"
 
 namespace clp_s {
+namespace {
+/**
+ * Writes bit-packed integers to the compressor.
+ * @param compressor
+ * @param packed_values
+ */
+void write_bit_packed_integers(ZstdCompressor& compressor, BitPackedIntegers const& packed_values) {
+    compressor.write_numeric_value(packed_values.base);
+    compressor.write_numeric_value(packed_values.bit_width);
+    compressor.write(
+            reinterpret_cast<char const*>(packed_values.packed_values.data()),
+            packed_values.packed_values.size() * sizeof(uint64_t)
+    );
+}
+}  // namespace
+
 size_t Int64ColumnWriter::add_value(ParsedMessage::variable_t& value) {
-    m_values.push_back(std::get<int64_t>(value));
+    auto const int_value = std::get<int64_t>(value);
+    m_values.push_back(int_value);
+    m_statistics.add_value(int_value);
     return sizeof(int64_t);
 }
 
 void Int64ColumnWriter::store(ZstdCompressor& compressor) {
-    size_t size = m_values.size() * sizeof(int64_t);
-    compressor.write(reinterpret_cast<char const*>(m_values.data()), size);
+    auto const encoding = m_statistics.get_best_encoding();
+    compressor.write_numeric_value(encoding);
+    switch (encoding) {
+        case IntegerEncoding::FrameOfReference:
+            write_bit_packed_integers(
+                    compressor,
+                    IntegerEncoder::encode_frame_of_reference(m_values)
+            );
+            break;
+        case IntegerEncoding::Delta: {
+            auto const encoded_values = IntegerEncoder::encode_delta(m_values);
+            compressor.write_numeric_value(encoded_values.first_value);
+            write_bit_packed_integers(compressor, encoded_values.deltas);
+            break;
+        }
+        case IntegerEncoding::RunLength: {
+            auto const encoded_values = IntegerEncoder::encode_run_length(m_values);
+            auto const num_runs = encoded_values.run_values.size();
+            compressor.write_numeric_value(num_runs);
+            compressor.write(
+                    reinterpret_cast<char const*>(encoded_values.run_values.data()),
+                    num_runs * sizeof(int64_t)
+            );
+            compressor.write(
+                    reinterpret_cast<char const*>(encoded_values.run_lengths.data()),
+                    num_runs * sizeof(uint64_t)
+            );
+            break;
+        }
+        case IntegerEncoding::Raw:
+        default:
+            compressor.write(
+                    reinterpret_cast<char const*>(m_values.data()),
+                    m_values.size() * sizeof(int64_t)
+            );
+            break;
+    }
+}
+
+void Int64ColumnWriter::merge(BaseColumnWriter& column) {
+    for (auto const value : static_cast<Int64ColumnWriter&>(column).m_values) {
+        m_values.push_back(value);
+        m_statistics.add_value(value);
+    }
+}
+
+void Int64ColumnWriter::add_placeholders(size_t num_values) {
+    // Repeating the previous value extends its run without widening the range of values or deltas
+    auto const value = m_values.empty() ? 0 : m_values.back();
+    for (size_t i{0}; i < num_values; ++i) {
+        m_values.push_back(value);
+        m_statistics.add_value(value);
+    }
 }
 
 size_t DeltaEncodedInt64ColumnWriter::add_value(ParsedMessage::variable_t& value) {
@@ -28,16 +97,66 @@ void DeltaEncodedInt64ColumnWriter::store(ZstdCompressor& compressor) {
     compressor.write(reinterpret_cast<char const*>(m_values.data()), size);
 }
 
+void DeltaEncodedInt64ColumnWriter::merge(BaseColumnWriter& column) {
+    auto const& other = static_cast<DeltaEncodedInt64ColumnWriter&>(column);
+    if (other.m_values.empty()) {
+        return;
+    }
+    // The other column's first value isn't stored as a delta
+    auto const first_value = other.m_values.front();
+    m_values.push_back(m_values.empty() ? first_value : first_value - m_cur);
+    m_values.insert(m_values.end(), other.m_values.begin() + 1, other.m_values.end());
+    m_cur = other.m_cur;
+}
+
+void DeltaEncodedInt64ColumnWriter::add_placeholders(size_t num_values) {
+    // Repeating the previous value (or zero, for the first value) stores deltas of zero
+    m_values.insert(m_values.end(), num_values, 0);
+}
+
 size_t FloatColumnWriter::add_value(ParsedMessage::variable_t& value) {
     m_values.push_back(std::get<double>(value));
     return sizeof(double);
 }
 
 void FloatColumnWriter::store(ZstdCompressor& compressor) {
+    if (FloatEncoding::Alp == m_encoding) {
+        if (auto const encoded_values = AlpEncoder::encode(m_values); encoded_values.has_value()) {
+            compressor.write_numeric_value(FloatEncoding::Alp);
+            compressor.write_numeric_value(encoded_values->exponent);
+            compressor.write_numeric_value(encoded_values->factor);
+            compressor.write(
+                    reinterpret_cast<char const*>(encoded_values->digits.data()),
+                    encoded_values->digits.size() * sizeof(int64_t)
+            );
+            auto const num_exceptions = encoded_values->exception_positions.size();
+            compressor.write_numeric_value(num_exceptions);
+            compressor.write(
+                    reinterpret_cast<char const*>(encoded_values->exception_positions.data()),
+                    num_exceptions * sizeof(uint64_t)
+            );
+            compressor.write(
+                    reinterpret_cast<char const*>(encoded_values->exception_values.data()),
+                    num_exceptions * sizeof(double)
+            );
+            return;
+        }
+    }
+
+    compressor.write_numeric_value(FloatEncoding::Raw);
     size_t size = m_values.size() * sizeof(double);
     compressor.write(reinterpret_cast<char const*>(m_values.data()), size);
 }
 
+void FloatColumnWriter::merge(BaseColumnWriter& column) {
+    auto const& other = static_cast<FloatColumnWriter&>(column);
+    m_values.insert(m_values.end(), other.m_values.begin(), other.m_values.end());
+}
+
+void FloatColumnWriter::add_placeholders(size_t num_values) {
+    m_values.insert(m_values.end(), num_values, m_values.empty() ? 0.0 : m_values.back());
+}
+
 size_t BooleanColumnWriter::add_value(ParsedMessage::variable_t& value) {
     m_values.push_back(std::get<bool>(value) ? 1 : 0);
     return sizeof(uint8_t);
@@ -48,8 +167,17 @@ void BooleanColumnWriter::store(ZstdCompressor& compressor) {
     compressor.write(reinterpret_cast<char const*>(m_values.data()), size);
 }
 
+void BooleanColumnWriter::merge(BaseColumnWriter& column) {
+    auto const& other = static_cast<BooleanColumnWriter&>(column);
+    m_values.insert(m_values.end(), other.m_values.begin(), other.m_values.end());
+}
+
+void BooleanColumnWriter::add_placeholders(size_t num_values) {
+    m_values.insert(m_values.end(), num_values, 0);
+}
+
 size_t ClpStringColumnWriter::add_value(ParsedMessage::variable_t& value) {
-    std::string string_var = std::get<std::string>(value);
+    auto const string_var = std::get<std::string_view>(value);
     uint64_t id;
     uint64_t offset = m_encoded_vars.size();
     VariableEncoder::encode_and_add_to_dictionary(
@@ -73,8 +201,80 @@ void ClpStringColumnWriter::store(ZstdCompressor& compressor) {
     compressor.write(reinterpret_cast<char const*>(m_encoded_vars.data()), encoded_vars_size);
 }
 
+void ClpStringColumnWriter::merge(BaseColumnWriter& column) {
+    auto const& other = static_cast<ClpStringColumnWriter&>(column);
+    // Each log type records the offset of its encoded variables, which are appended after this
+    // column's encoded variables
+    uint64_t const encoded_vars_offset = m_encoded_vars.size();
+    for (auto const encoded_id : other.m_logtypes) {
+        m_logtypes.push_back(encode_log_dict_id(
+                get_encoded_log_dict_id(encoded_id),
+                get_encoded_offset(encoded_id) + encoded_vars_offset
+        ));
+    }
+    m_encoded_vars.insert(
+            m_encoded_vars.end(),
+            other.m_encoded_vars.begin(),
+            other.m_encoded_vars.end()
+    );
+}
+
+void ClpStringColumnWriter::add_placeholders(size_t num_values) {
+    m_logtypes.insert(
+            m_logtypes.end(),
+            num_values,
+            m_logtypes.empty() ? encode_log_dict_id(0, 0) : m_logtypes.back()
+    );
+}
+
+size_t UnstructuredArrayColumnWriter::add_value(ParsedMessage::variable_t& value) {
+    if (ArrayEncoding::ClpString == m_encoding) {
+        return m_clp_string_writer.add_value(value);
+    }
+    auto const tape = std::get<std::string_view>(value);
+    m_tapes.append(tape);
+    m_tape_end_offsets.push_back(m_tapes.size());
+    return sizeof(uint64_t) + tape.size();
+}
+
+void UnstructuredArrayColumnWriter::store(ZstdCompressor& compressor) {
+    compressor.write_numeric_value(m_encoding);
+    if (ArrayEncoding::ClpString == m_encoding) {
+        m_clp_string_writer.store(compressor);
+        return;
+    }
+    compressor.write(
+            reinterpret_cast<char const*>(m_tape_end_offsets.data()),
+            m_tape_end_offsets.size() * sizeof(uint64_t)
+    );
+    compressor.write_numeric_value(m_tapes.size());
+    compressor.write(m_tapes.data(), m_tapes.size());
+}
+
+void UnstructuredArrayColumnWriter::merge(BaseColumnWriter& column) {
+    auto& other = static_cast<UnstructuredArrayColumnWriter&>(column);
+    if (ArrayEncoding::ClpString == m_encoding) {
+        m_clp_string_writer.merge(other.m_clp_string_writer);
+        return;
+    }
+    uint64_t const tapes_offset = m_tapes.size();
+    for (auto const end_offset : other.m_tape_end_offsets) {
+        m_tape_end_offsets.push_back(end_offset + tapes_offset);
+    }
+    m_tapes.append(other.m_tapes);
+}
+
+void UnstructuredArrayColumnWriter::add_placeholders(size_t num_values) {
+    if (ArrayEncoding::ClpString == m_encoding) {
+        m_clp_string_writer.add_placeholders(num_values);
+        return;
+    }
+    // Placeholders are empty tapes
+    m_tape_end_offsets.insert(m_tape_end_offsets.end(), num_values, m_tapes.size());
+}
+
 size_t VariableStringColumnWriter::add_value(ParsedMessage::variable_t& value) {
-    std::string string_var = std::get<std::string>(value);
+    auto const string_var = std::get<std::string_view>(value);
     uint64_t id;
     m_var_dict->add_entry(string_var, id);
     m_variables.push_back(id);
@@ -86,6 +286,15 @@ void VariableStringColumnWriter::store(ZstdCompressor& compressor) {
     compressor.write(reinterpret_cast<char const*>(m_variables.data()), size);
 }
 
+void VariableStringColumnWriter::merge(BaseColumnWriter& column) {
+    auto const& other = static_cast<VariableStringColumnWriter&>(column);
+    m_variables.insert(m_variables.end(), other.m_variables.begin(), other.m_variables.end());
+}
+
+void VariableStringColumnWriter::add_placeholders(size_t num_values) {
+    m_variables.insert(m_variables.end(), num_values, m_variables.empty() ? 0 : m_variables.back());
+}
+
 size_t DateStringColumnWriter::add_value(ParsedMessage::variable_t& value) {
     auto encoded_timestamp = std::get<std::pair<uint64_t, epochtime_t>>(value);
     m_timestamps.push_back(encoded_timestamp.second);
@@ -100,4 +309,27 @@ void DateStringColumnWriter::store(ZstdCompressor& compressor) {
     size_t encodings_size = m_timestamp_encodings.size() * sizeof(int64_t);
     compressor.write(reinterpret_cast<char const*>(m_timestamp_encodings.data()), encodings_size);
 }
+
+void DateStringColumnWriter::merge(BaseColumnWriter& column) {
+    auto const& other = static_cast<DateStringColumnWriter&>(column);
+    m_timestamps.insert(m_timestamps.end(), other.m_timestamps.begin(), other.m_timestamps.end());
+    m_timestamp_encodings.insert(
+            m_timestamp_encodings.end(),
+            other.m_timestamp_encodings.begin(),
+            other.m_timestamp_encodings.end()
+    );
+}
+
+void DateStringColumnWriter::add_placeholders(size_t num_values) {
+    m_timestamps.insert(
+            m_timestamps.end(),
+            num_values,
+            m_timestamps.empty() ? 0 : m_timestamps.back()
+    );
+    m_timestamp_encodings.insert(
+            m_timestamp_encodings.end(),
+            num_values,
+            m_timestamp_encodings.empty() ? 0 : m_timestamp_encodings.back()
+    );
+}
 }  // namespace clp_s
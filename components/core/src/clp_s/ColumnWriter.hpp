@@ -1,11 +1,16 @@
 #ifndef CLP_S_COLUMNWRITER_HPP
 #define CLP_S_COLUMNWRITER_HPP
 
+#include <string>
 #include <utility>
 #include <variant>
+#include <vector>
 
+#include "ArrayTape.hpp"
 #include "DictionaryWriter.hpp"
 #include "FileWriter.hpp"
+#include "FloatEncoding.hpp"
+#include "IntegerEncoding.hpp"
 #include "ParsedMessage.hpp"
 #include "TimestampDictionaryWriter.hpp"
 #include "VariableEncoder.hpp"
@@ -33,10 +38,27 @@ public:
      */
     virtual void store(ZstdCompressor& compressor) = 0;
 
+    /**
+     * Appends the values of another column of the same type to this column.
+     * @param column
+     */
+    virtual void merge(BaseColumnWriter& column) = 0;
+
+    /**
+     * Adds placeholder values to the column for records which don't contain it, so that the column
+     * can be stored in a table shared with schemas which don't contain it. Placeholders are never
+     * read, so each column picks the values which encode and compress best.
+     * @param num_values
+     */
+    virtual void add_placeholders(size_t num_values) = 0;
+
+    int32_t get_id() const { return m_id; }
+
     /**
      * Returns the total size of the header data that will be written to the compressor. This header
      * size plus the sum of sizes returned by add_value is equal to the total size of data that will
-     * be written to the compressor in bytes.
+     * be written to the compressor in bytes, unless the column re-encodes its values when it's
+     * stored, in which case it's an estimate.
      *
      * @return the total size of header data that will be written to the compressor in bytes
      */
@@ -46,6 +68,10 @@ protected:
     int32_t m_id;
 };
 
+/**
+ * Writes integer columns with the `IntegerEncoding` which stores each column's values in the fewest
+ * bytes, based on statistics gathered as the values are added.
+ */
 class Int64ColumnWriter : public BaseColumnWriter {
 public:
     // Constructor
@@ -59,8 +85,15 @@ public:
 
     void store(ZstdCompressor& compressor) override;
 
+    void merge(BaseColumnWriter& column) override;
+
+    void add_placeholders(size_t num_values) override;
+
+    size_t get_total_header_size() const override { return sizeof(IntegerEncoding); }
+
 private:
     std::vector<int64_t> m_values;
+    IntegerColumnStatistics m_statistics;
 };
 
 class DeltaEncodedInt64ColumnWriter : public BaseColumnWriter {
@@ -76,6 +109,10 @@ public:
 
     void store(ZstdCompressor& compressor) override;
 
+    void merge(BaseColumnWriter& column) override;
+
+    void add_placeholders(size_t num_values) override;
+
 private:
     std::vector<int64_t> m_values;
     int64_t m_cur{};
@@ -84,7 +121,14 @@ private:
 class FloatColumnWriter : public BaseColumnWriter {
 public:
     // Constructor
-    explicit FloatColumnWriter(int32_t id) : BaseColumnWriter(id) {}
+    /**
+     * @param id
+     * @param encoding The encoding to store the column with. If the values can't be stored with
+     * the given encoding, they're stored raw.
+     */
+    explicit FloatColumnWriter(int32_t id, FloatEncoding encoding = FloatEncoding::Raw)
+            : BaseColumnWriter(id),
+              m_encoding(encoding) {}
 
     // Destructor
     ~FloatColumnWriter() override = default;
@@ -94,7 +138,14 @@ public:
 
     void store(ZstdCompressor& compressor) override;
 
+    void merge(BaseColumnWriter& column) override;
+
+    void add_placeholders(size_t num_values) override;
+
+    size_t get_total_header_size() const override { return sizeof(FloatEncoding); }
+
 private:
+    FloatEncoding m_encoding;
     std::vector<double> m_values;
 };
 
@@ -111,6 +162,10 @@ public:
 
     void store(ZstdCompressor& compressor) override;
 
+    void merge(BaseColumnWriter& column) override;
+
+    void add_placeholders(size_t num_values) override;
+
 private:
     std::vector<uint8_t> m_values;
 };
@@ -135,6 +190,10 @@ public:
 
     void store(ZstdCompressor& compressor) override;
 
+    void merge(BaseColumnWriter& column) override;
+
+    void add_placeholders(size_t num_values) override;
+
     size_t get_total_header_size() const override { return sizeof(size_t); }
 
     /**
@@ -176,6 +235,48 @@ private:
     std::vector<int64_t> m_encoded_vars;
 };
 
+/**
+ * Writes unstructured array columns with the given `ArrayEncoding`. Arrays are added as their JSON
+ * text when they're encoded as CLP strings, and as their tapes when they're encoded as tapes.
+ */
+class UnstructuredArrayColumnWriter : public BaseColumnWriter {
+public:
+    // Constructor
+    UnstructuredArrayColumnWriter(
+            int32_t id,
+            ArrayEncoding encoding,
+            std::shared_ptr<VariableDictionaryWriter> var_dict,
+            std::shared_ptr<LogTypeDictionaryWriter> array_dict
+    )
+            : BaseColumnWriter(id),
+              m_encoding(encoding),
+              m_clp_string_writer(id, std::move(var_dict), std::move(array_dict)) {}
+
+    // Destructor
+    ~UnstructuredArrayColumnWriter() override = default;
+
+    // Methods inherited from BaseColumnWriter
+    size_t add_value(ParsedMessage::variable_t& value) override;
+
+    void store(ZstdCompressor& compressor) override;
+
+    void merge(BaseColumnWriter& column) override;
+
+    void add_placeholders(size_t num_values) override;
+
+    size_t get_total_header_size() const override {
+        return sizeof(ArrayEncoding)
+               + (ArrayEncoding::Tape == m_encoding ? sizeof(size_t)
+                                                     : m_clp_string_writer.get_total_header_size());
+    }
+
+private:
+    ArrayEncoding m_encoding;
+    ClpStringColumnWriter m_clp_string_writer;
+    std::vector<uint64_t> m_tape_end_offsets;
+    std::string m_tapes;
+};
+
 class VariableStringColumnWriter : public BaseColumnWriter {
 public:
     // Constructor
@@ -191,6 +292,10 @@ public:
 
     void store(ZstdCompressor& compressor) override;
 
+    void merge(BaseColumnWriter& column) override;
+
+    void add_placeholders(size_t num_values) override;
+
 private:
     std::shared_ptr<VariableDictionaryWriter> m_var_dict;
     std::vector<int64_t> m_variables;
@@ -209,6 +314,10 @@ public:
 
     void store(ZstdCompressor& compressor) override;
 
+    void merge(BaseColumnWriter& column) override;
+
+    void add_placeholders(size_t num_values) override;
+
 private:
     std::vector<int64_t> m_timestamps;
     std::vector<int64_t> m_timestamp_encodings;
@@ -80,31 +80,35 @@ void validate_network_auth(std::string_view auth_method, NetworkAuthOption& auth
 /**
  * Validates and populates archive paths.
  * @param archive_path
- * @param archive_id
+ * @param archive_ids The IDs of archives in subdirectories of `archive_path` to limit the paths to,
+ * or empty to use every archive in `archive_path`.
  * @param archive_paths
  * @throws std::invalid_argument on any error
  */
 void validate_archive_paths(
         std::string_view archive_path,
-        std::string_view archive_id,
+        std::vector<std::string> const& archive_ids,
         std::vector<Path>& archive_paths
 ) {
     if (archive_path.empty()) {
         throw std::invalid_argument("No archive path specified");
     }
 
-    if (false == archive_id.empty()) {
-        auto archive_fs_path = std::filesystem::path(archive_path) / archive_id;
-        std::error_code ec;
-        if (false == std::filesystem::exists(archive_fs_path, ec) || ec) {
-            throw std::invalid_argument("Requested archive does not exist");
+    if (false == archive_ids.empty()) {
+        for (auto const& archive_id : archive_ids) {
+            auto archive_fs_path = std::filesystem::path(archive_path) / archive_id;
+            std::error_code ec;
+            if (archive_id.empty() || false == std::filesystem::exists(archive_fs_path, ec) || ec)
+            {
+                throw std::invalid_argument("Requested archive does not exist");
+            }
+            archive_paths.emplace_back(
+                    clp_s::Path{
+                            .source = clp_s::InputSource::Filesystem,
+                            .path = archive_fs_path.string()
+                    }
+            );
         }
-        archive_paths.emplace_back(
-                clp_s::Path{
-                        .source = clp_s::InputSource::Filesystem,
-                        .path = archive_fs_path.string()
-                }
-        );
     } else if (false == get_input_archives_for_raw_path(archive_path, archive_paths)) {
         throw std::invalid_argument("Invalid archive path");
     }
@@ -209,6 +213,12 @@ CommandLineArguments::parse_arguments(int argc, char const** argv) {
             constexpr std::string_view cJsonFileType{"json"};
             constexpr std::string_view cKeyValueIrFileType{"kv-ir"};
             std::string file_type{cJsonFileType};
+            constexpr std::string_view cRawFloatEncoding{"raw"};
+            constexpr std::string_view cAlpFloatEncoding{"alp"};
+            std::string float_encoding{cRawFloatEncoding};
+            constexpr std::string_view cClpStringArrayEncoding{"clp-string"};
+            constexpr std::string_view cTapeArrayEncoding{"tape"};
+            std::string array_encoding{cClpStringArrayEncoding};
             std::string auth{cNoAuth};
             // clang-format off
             compression_options.add_options()(
@@ -222,11 +232,29 @@ CommandLineArguments::parse_arguments(int argc, char const** argv) {
                         default_value(m_target_encoded_size),
                     "Target size (B) for the dictionaries and encoded messages before a new "
                     "archive is created."
+            )(
+                    "flush-interval",
+                    po::value<uint64_t>(&m_flush_interval_ms)->value_name("MS")->
+                        default_value(m_flush_interval_ms),
+                    "Maximum time (ms) an archive stays open before it's closed, making its records"
+                    " searchable, and a new archive is created (0 to disable)."
             )(
                     "min-table-size",
                     po::value<size_t>(&m_minimum_table_size)->value_name("MIN_TABLE_SIZE")->
                         default_value(m_minimum_table_size),
                     "Minimum size (B) for a packed table before it gets compressed."
+            )(
+                    "zstd-dictionary-size",
+                    po::value<size_t>(&m_zstd_dictionary_size)->value_name("DICT_SIZE")->
+                        default_value(m_zstd_dictionary_size),
+                    "Maximum size (B) of a zstd dictionary to train for each archive and compress"
+                    " its tables and dictionaries with (0 to disable)."
+            )(
+                    "schema-compaction-threshold",
+                    po::value<double>(&m_schema_compaction_threshold)->value_name("SIMILARITY")->
+                        default_value(m_schema_compaction_threshold),
+                    "Minimum similarity, in (0, 1], of the columns of schemas whose small tables"
+                    " are compacted into a shared table (0 to disable)."
             )(
                     "max-document-size",
                     po::value<size_t>(&m_max_document_size)->value_name("DOC_SIZE")->
@@ -255,6 +283,20 @@ CommandLineArguments::parse_arguments(int argc, char const** argv) {
                     "structurize-arrays",
                     po::bool_switch(&m_structurize_arrays),
                     "Structurize arrays instead of compressing them as clp strings."
+            )(
+                    "array-encoding",
+                    po::value<std::string>(&array_encoding)
+                        ->value_name("ARRAY_ENCODING")
+                        ->default_value(array_encoding),
+                    "Encoding for arrays which aren't structurized (clp-string | tape). tape stores"
+                    " arrays pre-parsed, so that they can be searched without being parsed again."
+            )(
+                    "float-encoding",
+                    po::value<std::string>(&float_encoding)
+                        ->value_name("FLOAT_ENCODING")
+                        ->default_value(float_encoding),
+                    "Encoding for float columns (raw | alp). alp losslessly stores decimal floats"
+                    " (e.g., metrics) as integers, which compress better than raw doubles."
             )(
                     "disable-log-order",
                     po::bool_switch(&m_disable_log_order),
@@ -347,6 +389,28 @@ CommandLineArguments::parse_arguments(int argc, char const** argv) {
                 throw std::invalid_argument("Unknown FILE_TYPE: " + file_type);
             }
 
+            if (cRawFloatEncoding == float_encoding) {
+                m_float_encoding = FloatEncoding::Raw;
+            } else if (cAlpFloatEncoding == float_encoding) {
+                m_float_encoding = FloatEncoding::Alp;
+            } else {
+                throw std::invalid_argument("Unknown FLOAT_ENCODING: " + float_encoding);
+            }
+
+            if (cClpStringArrayEncoding == array_encoding) {
+                m_array_encoding = ArrayEncoding::ClpString;
+            } else if (cTapeArrayEncoding == array_encoding) {
+                m_array_encoding = ArrayEncoding::Tape;
+            } else {
+                throw std::invalid_argument("Unknown ARRAY_ENCODING: " + array_encoding);
+            }
+
+            if (m_schema_compaction_threshold < 0.0 || m_schema_compaction_threshold > 1.0) {
+                throw std::invalid_argument(
+                        "SIMILARITY must be between 0 and 1 for --schema-compaction-threshold."
+                );
+            }
+
             validate_network_auth(auth, m_network_auth);
         } else if ((char)Command::Extract == command_input) {
             po::options_description extraction_options;
@@ -365,7 +429,7 @@ CommandLineArguments::parse_arguments(int argc, char const** argv) {
 
             po::options_description decompression_options("Decompression Options");
             std::string auth{cNoAuth};
-            std::string archive_id;
+            std::vector<std::string> archive_ids;
             // clang-format off
             decompression_options.add_options()(
                     "ordered",
@@ -378,15 +442,33 @@ CommandLineArguments::parse_arguments(int argc, char const** argv) {
                             ->value_name("SIZE"),
                     "Chunk size (B) for each output file when decompressing records in log order."
                     " When set to 0, no chunking is performed."
+            )(
+                    "ordered-memory-budget",
+                    po::value<size_t>(&m_ordered_decompression_memory_budget)
+                            ->default_value(m_ordered_decompression_memory_budget)
+                            ->value_name("SIZE"),
+                    "Approximate memory budget (B) for decompressing records in log order. Archives"
+                    " whose tables don't fit in the budget are decompressed in multiple passes"
+                    " over the tables. When set to 0, all tables are loaded into memory at once."
+            )(
+                    "begin-log-event-idx",
+                    po::value<int64_t>(&m_begin_log_event_idx)->value_name("IDX"),
+                    "Only decompress records with a log event index of at least IDX. Requires"
+                    " --ordered."
+            )(
+                    "end-log-event-idx",
+                    po::value<int64_t>(&m_end_log_event_idx)->value_name("IDX"),
+                    "Only decompress records with a log event index less than IDX. Requires"
+                    " --ordered."
             )(
                     "print-ordered-chunk-stats",
                     po::bool_switch(&m_print_ordered_chunk_stats),
                     "Print statistics (ndjson) about each chunk file after it's extracted."
             )(
                     "archive-id",
-                    po::value<std::string>(&archive_id)->value_name("ID"),
+                    po::value<std::vector<std::string>>(&archive_ids)->value_name("ID"),
                     "Limit decompression to the archive with the given ID in a subdirectory of"
-                    " archive-path"
+                    " archive-path. Can be specified multiple times."
             )(
                     "auth",
                     po::value<std::string>(&auth)
@@ -448,7 +530,7 @@ CommandLineArguments::parse_arguments(int argc, char const** argv) {
                 return ParsingResult::InfoCommand;
             }
 
-            validate_archive_paths(archive_path, archive_id, m_input_paths);
+            validate_archive_paths(archive_path, archive_ids, m_input_paths);
 
             validate_network_auth(auth, m_network_auth);
 
@@ -469,6 +551,12 @@ CommandLineArguments::parse_arguments(int argc, char const** argv) {
                     );
                 }
 
+                if (0 != m_ordered_decompression_memory_budget) {
+                    throw std::invalid_argument(
+                            "ordered-memory-budget must be used with ordered argument"
+                    );
+                }
+
                 if (false == m_mongodb_uri.empty()) {
                     throw std::invalid_argument(
                             "Recording decompression metadata only supported for ordered"
@@ -477,6 +565,24 @@ CommandLineArguments::parse_arguments(int argc, char const** argv) {
                 }
             }
 
+            m_has_log_event_idx_range
+                    = 0 != parsed_command_line_options.count("begin-log-event-idx")
+                      || 0 != parsed_command_line_options.count("end-log-event-idx");
+            if (m_has_log_event_idx_range) {
+                if (false == m_ordered_decompression) {
+                    throw std::invalid_argument(
+                            "begin-log-event-idx and end-log-event-idx must be used with ordered"
+                            " argument"
+                    );
+                }
+                if (m_begin_log_event_idx < 0 || m_end_log_event_idx < m_begin_log_event_idx) {
+                    throw std::invalid_argument(
+                            "end-log-event-idx must be at least begin-log-event-idx, which must be"
+                            " non-negative"
+                    );
+                }
+            }
+
             // We use xor to check that these arguments are either both specified or both
             // unspecified.
             if (m_mongodb_uri.empty() ^ m_mongodb_collection.empty()) {
@@ -517,7 +623,7 @@ CommandLineArguments::parse_arguments(int argc, char const** argv) {
 
             po::options_description match_options("Match Controls");
             std::string auth{cNoAuth};
-            std::string archive_id;
+            std::vector<std::string> archive_ids;
             // clang-format off
             match_options.add_options()(
                 "tge",
@@ -531,10 +637,22 @@ CommandLineArguments::parse_arguments(int argc, char const** argv) {
                 "ignore-case,i",
                 po::bool_switch(&m_ignore_case),
                 "Ignore case distinctions between values in the query and the compressed data"
+            )(
+                "limit",
+                po::value<uint64_t>(&m_limit)->value_name("N"),
+                "Stop searching once N results have been output (stdout and network output"
+                " handlers only)"
             )(
                 "archive-id",
-                po::value<std::string>(&archive_id)->value_name("ID"),
-                "Limit search to the archive with the given ID in a subdirectory of archive-path"
+                po::value<std::vector<std::string>>(&archive_ids)->value_name("ID"),
+                "Limit search to the archive with the given ID in a subdirectory of archive-path."
+                " Can be specified multiple times."
+            )(
+                "num-threads",
+                po::value<size_t>(&m_num_search_threads)
+                    ->value_name("N")
+                    ->default_value(m_num_search_threads),
+                "Search up to N archives concurrently"
             )(
                 "projection",
                 po::value<std::vector<std::string>>(&m_projection_columns)
@@ -551,10 +669,27 @@ CommandLineArguments::parse_arguments(int argc, char const** argv) {
                 "Type of authentication required for network requests (s3 | none). Authentication"
                 " with s3 requires the AWS_ACCESS_KEY_ID and AWS_SECRET_ACCESS_KEY environment"
                 " variables, and optionally the AWS_SESSION_TOKEN environment variable."
+            )(
+                "network-cache-dir",
+                po::value<std::string>(&m_network_cache_dir)->value_name("DIR"),
+                "Cache the ranges of archives fetched from the network in a subdirectory of DIR"
+                " (clp-s-range-cache), so that later searches of the same archives don't fetch"
+                " them again. Cached ranges in the subdirectory are evicted once they exceed the"
+                " network cache size."
+            )(
+                "network-cache-size",
+                po::value<size_t>(&m_network_cache_size)
+                    ->value_name("SIZE")
+                    ->default_value(m_network_cache_size),
+                "Maximum size (in bytes) of the ranges cached in the network cache directory; the"
+                " least recently used ranges are evicted once it's exceeded"
             );
             // clang-format on
             search_options.add(match_options);
 
+            std::string numeric_aggregation_column;
+            std::string distinct_count_column;
+            std::string percentile_column;
             po::options_description aggregation_options("Aggregation Options");
             // clang-format off
             aggregation_options.add_options()(
@@ -565,6 +700,23 @@ CommandLineArguments::parse_arguments(int argc, char const** argv) {
                     "count-by-time",
                     po::value<int64_t>(&m_count_by_time_bucket_size)->value_name("SIZE"),
                     "Count the number of results in each time span of the given size (ms)"
+            )(
+                    "aggregate",
+                    po::value<std::string>(&numeric_aggregation_column)->value_name("COLUMN"),
+                    "Compute the count, sum, min, max, and average of the given numeric column"
+            )(
+                    "count-distinct",
+                    po::value<std::string>(&distinct_count_column)->value_name("COLUMN"),
+                    "Estimate the number of distinct values in the given column"
+            )(
+                    "percentiles",
+                    po::value<std::string>(&percentile_column)->value_name("COLUMN"),
+                    "Estimate percentiles of the given numeric column"
+            )(
+                    "percentile-values",
+                    po::value<std::vector<double>>(&m_percentiles)->value_name("P")->multitoken()
+                            ->default_value(m_percentiles, "50 90 99"),
+                    "The percentiles (in [0, 100]) to estimate with --percentiles"
             );
             // clang-format on
             search_options.add(aggregation_options);
@@ -600,6 +752,10 @@ CommandLineArguments::parse_arguments(int argc, char const** argv) {
                     "job-id",
                     po::value<reducer::job_id_t>(&m_job_id)->value_name("ID"),
                     "Job ID for the requested aggregation operation"
+            )(
+                    "columnar-record-groups",
+                    po::bool_switch(&m_use_columnar_record_groups),
+                    "Send record groups in the columnar format (the reducer must support it)"
             );
             // clang-format on
 
@@ -704,7 +860,7 @@ CommandLineArguments::parse_arguments(int argc, char const** argv) {
                 return ParsingResult::InfoCommand;
             }
 
-            validate_archive_paths(archive_path, archive_id, m_input_paths);
+            validate_archive_paths(archive_path, archive_ids, m_input_paths);
 
             validate_network_auth(auth, m_network_auth);
 
@@ -712,6 +868,10 @@ CommandLineArguments::parse_arguments(int argc, char const** argv) {
                 throw std::invalid_argument("No query specified");
             }
 
+            if (0 == m_num_search_threads) {
+                throw std::invalid_argument("num-threads must be greater than 0.");
+            }
+
             if (parsed_command_line_options.count("tge")) {
                 m_search_begin_ts = parsed_command_line_options["tge"].as<epochtime_t>();
             }
@@ -737,6 +897,33 @@ CommandLineArguments::parse_arguments(int argc, char const** argv) {
                 }
             }
 
+            size_t num_column_aggregations{0};
+            if (parsed_command_line_options.count("aggregate") > 0) {
+                m_column_aggregation_type = ColumnAggregationType::Numeric;
+                m_aggregation_column = numeric_aggregation_column;
+                ++num_column_aggregations;
+            }
+            if (parsed_command_line_options.count("count-distinct") > 0) {
+                m_column_aggregation_type = ColumnAggregationType::DistinctCount;
+                m_aggregation_column = distinct_count_column;
+                ++num_column_aggregations;
+            }
+            if (parsed_command_line_options.count("percentiles") > 0) {
+                m_column_aggregation_type = ColumnAggregationType::Percentile;
+                m_aggregation_column = percentile_column;
+                ++num_column_aggregations;
+                for (auto const percentile : m_percentiles) {
+                    if (false == (percentile >= 0 && percentile <= 100)) {
+                        throw std::invalid_argument(
+                                "Values for percentile-values must be in [0, 100]."
+                        );
+                    }
+                }
+            }
+            if (num_column_aggregations > 0 && m_aggregation_column.empty()) {
+                throw std::invalid_argument("Aggregation COLUMN cannot be an empty string.");
+            }
+
             if (parsed_command_line_options.count("output-handler") > 0) {
                 if (static_cast<char const*>(cNetworkOutputHandlerName) == output_handler_name) {
                     m_output_handler_type = OutputHandlerType::Network;
@@ -784,8 +971,22 @@ CommandLineArguments::parse_arguments(int argc, char const** argv) {
                 );
             }
 
-            bool aggregation_was_specified
-                    = m_do_count_by_time_aggregation || m_do_count_results_aggregation;
+            if (parsed_command_line_options.count("limit") > 0) {
+                if (0 == m_limit) {
+                    throw std::invalid_argument("limit cannot be 0.");
+                }
+                if (OutputHandlerType::Stdout != m_output_handler_type
+                    && OutputHandlerType::Network != m_output_handler_type)
+                {
+                    throw std::invalid_argument(
+                            "limit is only supported by the stdout and network output handlers."
+                    );
+                }
+            }
+
+            bool aggregation_was_specified = m_do_count_by_time_aggregation
+                                             || m_do_count_results_aggregation
+                                             || num_column_aggregations > 0;
             if (aggregation_was_specified && OutputHandlerType::Reducer != m_output_handler_type) {
                 throw std::invalid_argument(
                         "Aggregations are only supported with the reducer output handler."
@@ -794,14 +995,18 @@ CommandLineArguments::parse_arguments(int argc, char const** argv) {
                         && OutputHandlerType::Reducer == m_output_handler_type))
             {
                 throw std::invalid_argument(
-                        "The reducer output handler currently only supports count and"
-                        " count-by-time aggregations."
+                        "The reducer output handler currently only supports count,"
+                        " count-by-time, aggregate, count-distinct, and percentiles aggregations."
                 );
             }
 
-            if (m_do_count_by_time_aggregation && m_do_count_results_aggregation) {
+            size_t const num_aggregations = static_cast<size_t>(m_do_count_by_time_aggregation)
+                                            + static_cast<size_t>(m_do_count_results_aggregation)
+                                            + num_column_aggregations;
+            if (num_aggregations > 1) {
                 throw std::invalid_argument(
-                        "The --count-by-time and --count options are mutually exclusive."
+                        "The --count-by-time, --count, --aggregate, --count-distinct, and"
+                        " --percentiles options are mutually exclusive."
                 );
             }
         }
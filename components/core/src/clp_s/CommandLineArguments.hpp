@@ -1,8 +1,11 @@
 #ifndef CLP_S_COMMANDLINEARGUMENTS_HPP
 #define CLP_S_COMMANDLINEARGUMENTS_HPP
 
+#include <cstdint>
+#include <limits>
 #include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <boost/program_options/option.hpp>
@@ -10,7 +13,9 @@
 #include <boost/program_options/variables_map.hpp>
 
 #include "../reducer/types.hpp"
+#include "ArrayTape.hpp"
 #include "Defs.hpp"
+#include "FloatEncoding.hpp"
 #include "InputConfig.hpp"
 
 namespace clp_s {
@@ -36,6 +41,13 @@ public:
         Stdout,
     };
 
+    enum class ColumnAggregationType : uint8_t {
+        None = 0,
+        Numeric,
+        DistinctCount,
+        Percentile,
+    };
+
     // Constructors
     explicit CommandLineArguments(std::string const& program_name) : m_program_name(program_name) {}
 
@@ -50,6 +62,10 @@ public:
 
     NetworkAuthOption const& get_network_auth() const { return m_network_auth; }
 
+    std::string const& get_network_cache_dir() const { return m_network_cache_dir; }
+
+    size_t get_network_cache_size() const { return m_network_cache_size; }
+
     std::string const& get_archives_dir() const { return m_archives_dir; }
 
     std::string const& get_output_dir() const { return m_output_dir; }
@@ -88,18 +104,38 @@ public:
 
     bool get_ignore_case() const { return m_ignore_case; }
 
+    /**
+     * @return The number of results after which the search stops, or 0 for no limit.
+     */
+    uint64_t get_limit() const { return m_limit; }
+
+    size_t get_num_search_threads() const { return m_num_search_threads; }
+
     std::string const& get_reducer_host() const { return m_reducer_host; }
 
     int get_reducer_port() const { return m_reducer_port; }
 
     reducer::job_id_t get_job_id() const { return m_job_id; }
 
+    reducer::RecordGroupFormat get_record_group_format() const {
+        return m_use_columnar_record_groups ? reducer::RecordGroupFormat::Columnar
+                                            : reducer::RecordGroupFormat::Msgpack;
+    }
+
     bool do_count_results_aggregation() const { return m_do_count_results_aggregation; }
 
     bool do_count_by_time_aggregation() const { return m_do_count_by_time_aggregation; }
 
     int64_t get_count_by_time_bucket_size() const { return m_count_by_time_bucket_size; }
 
+    ColumnAggregationType get_column_aggregation_type() const {
+        return m_column_aggregation_type;
+    }
+
+    std::string const& get_aggregation_column() const { return m_aggregation_column; }
+
+    std::vector<double> const& get_percentiles() const { return m_percentiles; }
+
     OutputHandlerType get_output_handler_type() const { return m_output_handler_type; }
 
     bool get_single_file_archive() const { return m_single_file_archive; }
@@ -110,14 +146,41 @@ public:
 
     size_t get_target_ordered_chunk_size() const { return m_target_ordered_chunk_size; }
 
+    size_t get_ordered_decompression_memory_budget() const {
+        return m_ordered_decompression_memory_budget;
+    }
+
+    /**
+     * @return The range of log event indices, [begin, end), to decompress, or std::nullopt if all
+     * records should be decompressed.
+     */
+    std::optional<std::pair<int64_t, int64_t>> get_log_event_idx_range() const {
+        if (false == m_has_log_event_idx_range) {
+            return std::nullopt;
+        }
+        return std::make_pair(m_begin_log_event_idx, m_end_log_event_idx);
+    }
+
     size_t get_minimum_table_size() const { return m_minimum_table_size; }
 
+    [[nodiscard]] auto get_flush_interval_ms() const -> uint64_t { return m_flush_interval_ms; }
+
+    [[nodiscard]] auto get_zstd_dictionary_size() const -> size_t { return m_zstd_dictionary_size; }
+
+    [[nodiscard]] auto get_schema_compaction_threshold() const -> double {
+        return m_schema_compaction_threshold;
+    }
+
     std::vector<std::string> const& get_projection_columns() const { return m_projection_columns; }
 
     bool get_record_log_order() const { return false == m_disable_log_order; }
 
     [[nodiscard]] auto get_file_type() const -> FileType { return m_file_type; }
 
+    [[nodiscard]] auto get_float_encoding() const -> FloatEncoding { return m_float_encoding; }
+
+    [[nodiscard]] auto get_array_encoding() const -> ArrayEncoding { return m_array_encoding; }
+
 private:
     // Methods
     /**
@@ -174,6 +237,8 @@ private:
     // Compression and decompression variables
     std::vector<Path> m_input_paths;
     NetworkAuthOption m_network_auth{};
+    std::string m_network_cache_dir;
+    size_t m_network_cache_size{10ULL * 1024 * 1024 * 1024};  // 10 GiB
     std::string m_archives_dir;
     std::string m_output_dir;
     std::string m_timestamp_key;
@@ -185,10 +250,19 @@ private:
     bool m_structurize_arrays{false};
     bool m_ordered_decompression{false};
     size_t m_target_ordered_chunk_size{};
+    size_t m_ordered_decompression_memory_budget{};
+    bool m_has_log_event_idx_range{false};
+    int64_t m_begin_log_event_idx{0};
+    int64_t m_end_log_event_idx{std::numeric_limits<int64_t>::max()};
     bool m_print_ordered_chunk_stats{false};
     size_t m_minimum_table_size{1ULL * 1024 * 1024};  // 1 MB
+    uint64_t m_flush_interval_ms{0};
+    size_t m_zstd_dictionary_size{0};
+    double m_schema_compaction_threshold{0.0};
     bool m_disable_log_order{false};
     FileType m_file_type{FileType::Json};
+    FloatEncoding m_float_encoding{FloatEncoding::Raw};
+    ArrayEncoding m_array_encoding{ArrayEncoding::ClpString};
 
     // MongoDB configuration variables
     std::string m_mongodb_uri;
@@ -205,15 +279,21 @@ private:
     std::optional<epochtime_t> m_search_begin_ts;
     std::optional<epochtime_t> m_search_end_ts;
     bool m_ignore_case{false};
+    uint64_t m_limit{0};
+    size_t m_num_search_threads{1};
     std::vector<std::string> m_projection_columns;
 
     // Search aggregation variables
     std::string m_reducer_host;
     int m_reducer_port{-1};
     reducer::job_id_t m_job_id{-1};
+    bool m_use_columnar_record_groups{false};
     bool m_do_count_results_aggregation{false};
     bool m_do_count_by_time_aggregation{false};
     int64_t m_count_by_time_bucket_size{0};  // Milliseconds
+    ColumnAggregationType m_column_aggregation_type{ColumnAggregationType::None};
+    std::string m_aggregation_column;
+    std::vector<double> m_percentiles{50, 90, 99};
 
     OutputHandlerType m_output_handler_type{OutputHandlerType::Stdout};
 };
@@ -5,6 +5,7 @@
 #include "Utils.hpp"
 
 using std::string;
+using std::string_view;
 
 namespace clp_s {
 size_t LogTypeDictionaryEntry::get_var_info(size_t var_ix, VarDelim& var_delim) const {
@@ -47,11 +48,11 @@ size_t LogTypeDictionaryEntry::get_data_size() const {
 }
 
 void LogTypeDictionaryEntry::add_constant(
-        string const& value_containing_constant,
+        string_view value_containing_constant,
         size_t begin_pos,
         size_t length
 ) {
-    m_value.append(value_containing_constant, begin_pos, length);
+    m_value.append(value_containing_constant.substr(begin_pos, length));
 }
 
 void LogTypeDictionaryEntry::add_non_double_var() {
@@ -65,7 +66,7 @@ void LogTypeDictionaryEntry::add_double_var() {
 }
 
 bool LogTypeDictionaryEntry::parse_next_var(
-        string const& msg,
+        string_view msg,
         size_t& var_begin_pos,
         size_t& var_end_pos,
         string& var
@@ -4,6 +4,7 @@
 #define CLP_S_DICTIONARYENTRY_HPP
 
 #include <string>
+#include <string_view>
 #include <utility>
 
 #include "TraceableException.hpp"
@@ -120,8 +121,7 @@ public:
      * @param begin_pos Start of the constant in value_containing_constant
      * @param length
      */
-    void
-    add_constant(std::string const& value_containing_constant, size_t begin_pos, size_t length);
+    void add_constant(std::string_view value_containing_constant, size_t begin_pos, size_t length);
 
     /**
      * Adds a non-double variable delimiter
@@ -145,7 +145,7 @@ public:
      * @return true if another variable was found, false otherwise
      */
     bool parse_next_var(
-            std::string const& msg,
+            std::string_view msg,
             size_t& var_begin_pos,
             size_t& var_end_pos,
             std::string& var
@@ -121,6 +121,7 @@ void DictionaryReader<DictionaryIdType, EntryType>::read_entries(bool lazy) {
 
     uint64_t num_dictionary_entries;
     dictionary_reader->read_numeric_value(num_dictionary_entries, false);
+    m_dictionary_decompressor.set_dictionary(m_adaptor.get_decompression_dictionary());
     m_dictionary_decompressor.open(*dictionary_reader, cDecompressorFileReadBufferCapacity);
 
     // Read dictionary entries
@@ -5,7 +5,7 @@
 #include <spdlog/spdlog.h>
 
 namespace clp_s {
-bool VariableDictionaryWriter::add_entry(std::string const& value, uint64_t& id) {
+bool VariableDictionaryWriter::add_entry(std::string_view value, uint64_t& id) {
     bool new_entry = false;
 
     auto const ix = m_value_to_id.find(value);
@@ -24,8 +24,8 @@ bool VariableDictionaryWriter::add_entry(std::string const& value, uint64_t& id)
         ++m_next_id;
 
         // Insert the ID obtained from the database into the dictionary
-        auto entry = VariableDictionaryEntry(value, id);
-        m_value_to_id[value] = id;
+        auto entry = VariableDictionaryEntry(std::string{value}, id);
+        m_value_to_id.emplace(entry.get_value(), id);
 
         new_entry = true;
 
@@ -3,6 +3,12 @@
 #ifndef CLP_S_DICTIONARYWRITER_HPP
 #define CLP_S_DICTIONARYWRITER_HPP
 
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
 #include "DictionaryEntry.hpp"
 
 namespace clp_s {
@@ -50,7 +56,20 @@ public:
 
 protected:
     // Types
-    using value_to_id_t = std::unordered_map<std::string, DictionaryIdType>;
+    /**
+     * Hashes strings and string views alike so that the dictionary can be probed with a view
+     * without constructing a string.
+     */
+    struct StringHash {
+        using is_transparent = void;
+
+        size_t operator()(std::string_view value) const {
+            return std::hash<std::string_view>{}(value);
+        }
+    };
+
+    using value_to_id_t
+            = std::unordered_map<std::string, DictionaryIdType, StringHash, std::equal_to<>>;
 
     // Variables
     bool m_is_open;
@@ -81,7 +100,7 @@ public:
      * @param value
      * @param id ID of the variable matching the given entry
      */
-    bool add_entry(std::string const& value, uint64_t& id);
+    bool add_entry(std::string_view value, uint64_t& id);
 };
 
 class LogTypeDictionaryWriter : public DictionaryWriter<uint64_t, LogTypeDictionaryEntry> {
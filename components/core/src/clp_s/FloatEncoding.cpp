@@ -0,0 +1,206 @@
+#include "FloatEncoding.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+
+#include "Utils.hpp"
+
+namespace clp_s {
+namespace {
+constexpr std::array<double, AlpEncoder::cMaxExponent + 1> cPowersOf10{
+        1e0,
+        1e1,
+        1e2,
+        1e3,
+        1e4,
+        1e5,
+        1e6,
+        1e7,
+        1e8,
+        1e9,
+        1e10,
+        1e11,
+        1e12,
+        1e13,
+        1e14,
+        1e15,
+        1e16,
+        1e17,
+        1e18
+};
+constexpr std::array<double, AlpEncoder::cMaxExponent + 1> cInversePowersOf10{
+        1e0,
+        1e-1,
+        1e-2,
+        1e-3,
+        1e-4,
+        1e-5,
+        1e-6,
+        1e-7,
+        1e-8,
+        1e-9,
+        1e-10,
+        1e-11,
+        1e-12,
+        1e-13,
+        1e-14,
+        1e-15,
+        1e-16,
+        1e-17,
+        1e-18
+};
+
+// Digits must be exactly representable as doubles
+constexpr double cMaxDigitsMagnitude{static_cast<double>(1ULL << 52)};
+
+// The number of digits copied out of the (unaligned) encoded column at a time while decoding
+constexpr size_t cDecodeBlockSize{1024};
+
+/**
+ * @param digits
+ * @param exponent
+ * @param factor
+ * @return The value encoded as the given digits.
+ */
+auto decode_value(int64_t digits, uint8_t exponent, uint8_t factor) -> double {
+    return static_cast<double>(digits) * cPowersOf10[factor] * cInversePowersOf10[exponent];
+}
+
+/**
+ * Encodes a value.
+ * @param value
+ * @param exponent
+ * @param factor
+ * @param digits Returns the encoded value.
+ * @return Whether the value can be encoded losslessly.
+ */
+auto encode_value(double value, uint8_t exponent, uint8_t factor, int64_t& digits) -> bool {
+    auto const scaled_value = value * cPowersOf10[exponent] * cInversePowersOf10[factor];
+    // NOTE: This also rejects NaNs
+    if (false == (std::abs(scaled_value) < cMaxDigitsMagnitude)) {
+        return false;
+    }
+    digits = static_cast<int64_t>(std::round(scaled_value));
+    return std::bit_cast<uint64_t>(decode_value(digits, exponent, factor))
+           == std::bit_cast<uint64_t>(value);
+}
+}  // namespace
+
+auto AlpEncoder::encode(std::vector<double> const& values) -> std::optional<AlpEncodedValues> {
+    if (values.empty()) {
+        return std::nullopt;
+    }
+
+    // Choose the exponent and factor which minimize the estimated size of a sample of the values,
+    // counting the bit width of the range of the digits and the size of the exceptions
+    auto const num_samples = std::min(values.size(), cMaxNumSamples);
+    std::vector<double> samples;
+    samples.reserve(num_samples);
+    for (size_t i{0}; i < num_samples; ++i) {
+        samples.push_back(values[i * values.size() / num_samples]);
+    }
+
+    uint8_t best_exponent{0};
+    uint8_t best_factor{0};
+    size_t best_num_exceptions{num_samples};
+    size_t best_cost{std::numeric_limits<size_t>::max()};
+    for (uint8_t exponent{0}; exponent <= cMaxExponent; ++exponent) {
+        for (uint8_t factor{0}; factor <= exponent; ++factor) {
+            size_t num_exceptions{0};
+            auto min_digits{std::numeric_limits<int64_t>::max()};
+            auto max_digits{std::numeric_limits<int64_t>::min()};
+            for (auto const sample : samples) {
+                int64_t digits{};
+                if (false == encode_value(sample, exponent, factor, digits)) {
+                    ++num_exceptions;
+                    continue;
+                }
+                min_digits = std::min(min_digits, digits);
+                max_digits = std::max(max_digits, digits);
+            }
+
+            size_t const digits_width
+                    = num_exceptions == num_samples
+                              ? 0
+                              : std::bit_width(static_cast<uint64_t>(max_digits - min_digits));
+            size_t const cost = (num_samples - num_exceptions) * digits_width
+                                + num_exceptions * (sizeof(uint64_t) + sizeof(double)) * 8;
+            if (cost < best_cost) {
+                best_exponent = exponent;
+                best_factor = factor;
+                best_num_exceptions = num_exceptions;
+                best_cost = cost;
+            }
+        }
+    }
+    auto const max_num_exceptions = static_cast<size_t>(cMaxExceptionRatio * values.size());
+    if (static_cast<double>(best_num_exceptions) > cMaxExceptionRatio * num_samples) {
+        return std::nullopt;
+    }
+
+    AlpEncodedValues encoded_values{.exponent = best_exponent, .factor = best_factor};
+    encoded_values.digits.reserve(values.size());
+    int64_t prev_digits{0};
+    for (size_t i{0}; i < values.size(); ++i) {
+        int64_t digits{};
+        if (encode_value(values[i], best_exponent, best_factor, digits)) {
+            prev_digits = digits;
+        } else {
+            // Repeat the previous digits so that exceptions don't disrupt the digits' compression
+            digits = prev_digits;
+            encoded_values.exception_positions.push_back(i);
+            encoded_values.exception_values.push_back(values[i]);
+            if (encoded_values.exception_positions.size() > max_num_exceptions) {
+                return std::nullopt;
+            }
+        }
+        encoded_values.digits.push_back(digits);
+    }
+    return encoded_values;
+}
+
+auto AlpEncoder::decode(
+        uint8_t exponent,
+        uint8_t factor,
+        UnalignedMemSpan<int64_t> digits,
+        UnalignedMemSpan<uint64_t> exception_positions,
+        UnalignedMemSpan<double> exception_values,
+        std::vector<double>& values
+) -> bool {
+    if (exponent > cMaxExponent || factor > exponent
+        || exception_positions.size() != exception_values.size())
+    {
+        return false;
+    }
+
+    auto const num_values = digits.size();
+    values.resize(num_values);
+    std::array<int64_t, cDecodeBlockSize> block{};
+    for (size_t begin{0}; begin < num_values; begin += cDecodeBlockSize) {
+        auto const block_size = std::min(cDecodeBlockSize, num_values - begin);
+        digits.copy_to(begin, block_size, block.data());
+        // The iterations are independent and the buffers are contiguous, so the compiler can
+        // vectorize this loop
+        auto* const block_values = values.data() + begin;
+        for (size_t i{0}; i < block_size; ++i) {
+            block_values[i] = decode_value(block[i], exponent, factor);
+        }
+    }
+
+    for (size_t i{0}; i < exception_positions.size(); ++i) {
+        auto const position = exception_positions[i];
+        if (position >= num_values) {
+            return false;
+        }
+        values[position] = exception_values[i];
+    }
+    return true;
+}
+}  // namespace clp_s
@@ -0,0 +1,86 @@
+#ifndef CLP_S_FLOATENCODING_HPP
+#define CLP_S_FLOATENCODING_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "Utils.hpp"
+
+namespace clp_s {
+/**
+ * The encodings of float columns. Each float column starts with the encoding of its values.
+ */
+enum class FloatEncoding : uint8_t {
+    // The values are stored as raw doubles
+    Raw = 0,
+    // The values are stored using `AlpEncoder`
+    Alp
+};
+
+/**
+ * Values encoded by `AlpEncoder`. Stored (in order) as the exponent, the factor, the digits, the
+ * number of exceptions, the exceptions' positions, and the exceptions' values.
+ */
+struct AlpEncodedValues {
+    uint8_t exponent{};
+    uint8_t factor{};
+    std::vector<int64_t> digits;
+    std::vector<uint64_t> exception_positions;
+    std::vector<double> exception_values;
+};
+
+/**
+ * Losslessly encodes doubles using the decimal encoding of ALP (Adaptive Lossless floating-Point
+ * compression; Afroozeh et al., SIGMOD 2024).
+ *
+ * Metric-like values (latencies, percentages, rates, etc.) are usually decimals with few
+ * significant digits, whose raw bits compress poorly. ALP instead stores each value `v` as the
+ * integer `d = round(v * 10^e * 10^-f)`, for an exponent `e` and factor `f` chosen per column by
+ * sampling, such that `d * 10^f * 10^-e` reproduces `v` exactly. Values which don't round-trip
+ * (e.g., NaNs, infinities, -0.0, or values with too many significant digits) are stored separately
+ * as exceptions, and their digits are replaced by the preceding value's digits.
+ *
+ * Unlike ALP, the digits aren't bit-packed, since the packed stream's zstd compression already
+ * removes their unused high-order bytes.
+ */
+class AlpEncoder {
+public:
+    // Constants
+    static constexpr uint8_t cMaxExponent{18};
+    static constexpr size_t cMaxNumSamples{1024};
+    // The maximum fraction of sampled values which may be exceptions for ALP to be used
+    static constexpr double cMaxExceptionRatio{0.125};
+
+    // Methods
+    /**
+     * Encodes the given values.
+     * @param values
+     * @return The encoded values, or std::nullopt if too many of the values can't be encoded.
+     */
+    [[nodiscard]] static auto encode(std::vector<double> const& values)
+            -> std::optional<AlpEncodedValues>;
+
+    /**
+     * Decodes values encoded by `encode`.
+     * @param exponent
+     * @param factor
+     * @param digits
+     * @param exception_positions
+     * @param exception_values
+     * @param values Returns the decoded values.
+     * @return Whether the encoded values were valid.
+     */
+    [[nodiscard]] static auto decode(
+            uint8_t exponent,
+            uint8_t factor,
+            UnalignedMemSpan<int64_t> digits,
+            UnalignedMemSpan<uint64_t> exception_positions,
+            UnalignedMemSpan<double> exception_values,
+            std::vector<double>& values
+    ) -> bool;
+};
+}  // namespace clp_s
+
+#endif  // CLP_S_FLOATENCODING_HPP
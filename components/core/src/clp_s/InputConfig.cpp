@@ -1,5 +1,6 @@
 #include "InputConfig.hpp"
 
+#include <cstddef>
 #include <cstdlib>
 #include <exception>
 #include <filesystem>
@@ -95,14 +96,24 @@ auto get_archive_id_from_path(Path const& archive_path, std::string& archive_id)
 }
 
 namespace {
-auto try_create_file_reader(std::string_view const file_path)
+auto try_create_file_reader(std::string_view const file_path, size_t offset)
         -> std::shared_ptr<clp::ReaderInterface> {
+    std::shared_ptr<clp::ReaderInterface> reader;
     try {
-        return std::make_shared<clp::FileReader>(std::string{file_path});
+        reader = std::make_shared<clp::FileReader>(std::string{file_path});
     } catch (clp::FileReader::OperationFailed const& e) {
         SPDLOG_ERROR("Failed to open file for reading - {} - {}", file_path, e.what());
         return nullptr;
     }
+    if (0 != offset) {
+        if (auto const rc = reader->try_seek_from_begin(offset);
+            clp::ErrorCode::ErrorCode_Success != rc)
+        {
+            SPDLOG_ERROR("Failed to seek to offset {} in file - {}", offset, file_path);
+            return nullptr;
+        }
+    }
+    return reader;
 }
 
 auto try_sign_url(std::string& url) -> bool {
@@ -141,7 +152,8 @@ auto try_sign_url(std::string& url) -> bool {
     return true;
 }
 
-auto try_create_network_reader(std::string_view const url, NetworkAuthOption const& auth)
+auto
+try_create_network_reader(std::string_view const url, NetworkAuthOption const& auth, size_t offset)
         -> std::shared_ptr<clp::ReaderInterface> {
     std::string request_url{url};
     switch (auth.method) {
@@ -157,7 +169,7 @@ auto try_create_network_reader(std::string_view const url, NetworkAuthOption con
     }
 
     try {
-        return std::make_shared<clp::NetworkReader>(request_url);
+        return std::make_shared<clp::NetworkReader>(request_url, offset);
     } catch (clp::NetworkReader::OperationFailed const& e) {
         SPDLOG_ERROR("Failed to open url for reading - {}", e.what());
         return nullptr;
@@ -165,12 +177,12 @@ auto try_create_network_reader(std::string_view const url, NetworkAuthOption con
 }
 }  // namespace
 
-auto try_create_reader(Path const& path, NetworkAuthOption const& network_auth)
+auto try_create_reader(Path const& path, NetworkAuthOption const& network_auth, size_t offset)
         -> std::shared_ptr<clp::ReaderInterface> {
     if (InputSource::Filesystem == path.source) {
-        return try_create_file_reader(path.path);
+        return try_create_file_reader(path.path, offset);
     } else if (InputSource::Network == path.source) {
-        return try_create_network_reader(path.path, network_auth);
+        return try_create_network_reader(path.path, network_auth, offset);
     } else {
         return nullptr;
     }
@@ -1,6 +1,7 @@
 #ifndef CLP_S_INPUTCONFIG_HPP
 #define CLP_S_INPUTCONFIG_HPP
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -117,10 +118,14 @@ get_input_archives_for_raw_path(std::string_view const path, std::vector<Path>&
  * Tries to open a clp::ReaderInterface using the given Path and NetworkAuthOption.
  * @param path
  * @param network_auth
+ * @param offset The offset of the byte at which the reader should start
  * @return the opened clp::ReaderInterface or nullptr on error
  */
-[[nodiscard]] auto try_create_reader(Path const& path, NetworkAuthOption const& network_auth)
-        -> std::shared_ptr<clp::ReaderInterface>;
+[[nodiscard]] auto try_create_reader(
+        Path const& path,
+        NetworkAuthOption const& network_auth,
+        size_t offset = 0
+) -> std::shared_ptr<clp::ReaderInterface>;
 }  // namespace clp_s
 
 #endif  // CLP_S_INPUTCONFIG_HPP
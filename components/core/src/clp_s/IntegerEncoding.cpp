@@ -0,0 +1,353 @@
+#include "IntegerEncoding.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "Utils.hpp"
+
+namespace clp_s {
+namespace {
+constexpr size_t cBitsPerWord{64};
+
+using UnpackBlockFunction = void (*)(uint64_t const* packed_block, uint64_t* block);
+
+/**
+ * @param value
+ * @return The value reinterpreted as an unsigned integer, so that arithmetic on it wraps.
+ */
+constexpr auto to_unsigned(int64_t value) -> uint64_t {
+    return static_cast<uint64_t>(value);
+}
+
+/**
+ * @param min_value
+ * @param max_value
+ * @return The number of bits needed to store the offset of any value in [min_value, max_value]
+ * from min_value.
+ */
+constexpr auto get_range_bit_width(int64_t min_value, int64_t max_value) -> uint8_t {
+    return static_cast<uint8_t>(std::bit_width(to_unsigned(max_value) - to_unsigned(min_value)));
+}
+
+/**
+ * @param num_values
+ * @param bit_width
+ * @return The number of bytes which the given number of values occupy when bit-packed.
+ */
+constexpr auto get_packed_size(size_t num_values, uint8_t bit_width) -> size_t {
+    return IntegerEncoder::get_num_packed_words(num_values, bit_width) * sizeof(uint64_t);
+}
+
+/**
+ * Unpacks a block of values packed with the given bit width.
+ * @tparam cBitWidth
+ * @param packed_block `cBitWidth` words containing the packed values.
+ * @param block Returns the `IntegerEncoder::cBlockSize` unpacked values.
+ */
+template <size_t cBitWidth>
+void unpack_block(uint64_t const* packed_block, uint64_t* block) {
+    if constexpr (0 == cBitWidth) {
+        std::fill_n(block, IntegerEncoder::cBlockSize, 0);
+    } else if constexpr (cBitsPerWord == cBitWidth) {
+        std::copy_n(packed_block, IntegerEncoder::cBlockSize, block);
+    } else {
+        constexpr uint64_t cMask{(1ULL << cBitWidth) - 1};
+        // The shifts and offsets below are constants for each iteration, so the compiler can fully
+        // unroll the loop
+        for (size_t i{0}; i < IntegerEncoder::cBlockSize; ++i) {
+            auto const bit_pos = i * cBitWidth;
+            auto const word_idx = bit_pos / cBitsPerWord;
+            auto const offset = bit_pos % cBitsPerWord;
+            auto value = packed_block[word_idx] >> offset;
+            if (offset + cBitWidth > cBitsPerWord) {
+                value |= packed_block[word_idx + 1] << (cBitsPerWord - offset);
+            }
+            block[i] = value & cMask;
+        }
+    }
+}
+
+template <size_t... cBitWidths>
+constexpr auto create_unpack_block_functions(std::index_sequence<cBitWidths...>)
+        -> std::array<UnpackBlockFunction, sizeof...(cBitWidths)> {
+    return {&unpack_block<cBitWidths>...};
+}
+
+constexpr auto cUnpackBlockFunctions = create_unpack_block_functions(
+        std::make_index_sequence<IntegerEncoder::cMaxBitWidth + 1>{}
+);
+
+/**
+ * Bit-packs the offsets of the given values from the given base.
+ * @param values
+ * @param base
+ * @param bit_width The bit width of the largest offset.
+ * @return The packed offsets
+ */
+auto pack(std::vector<uint64_t> const& values, uint64_t base, uint8_t bit_width)
+        -> std::vector<uint64_t> {
+    std::vector<uint64_t> packed_values(
+            IntegerEncoder::get_num_packed_words(values.size(), bit_width),
+            0
+    );
+    if (0 == bit_width) {
+        return packed_values;
+    }
+    for (size_t i{0}; i < values.size(); ++i) {
+        auto const offset_value = values[i] - base;
+        auto* const packed_block
+                = packed_values.data() + (i / IntegerEncoder::cBlockSize) * bit_width;
+        auto const bit_pos = (i % IntegerEncoder::cBlockSize) * bit_width;
+        auto const word_idx = bit_pos / cBitsPerWord;
+        auto const offset = bit_pos % cBitsPerWord;
+        packed_block[word_idx] |= offset_value << offset;
+        if (offset + bit_width > cBitsPerWord) {
+            packed_block[word_idx + 1] |= offset_value >> (cBitsPerWord - offset);
+        }
+    }
+    return packed_values;
+}
+
+/**
+ * Bit-packs the offsets of the given values from their minimum.
+ * @param values
+ * @return The packed values
+ */
+auto pack(std::vector<uint64_t> const& values) -> BitPackedIntegers {
+    BitPackedIntegers packed_values;
+    if (values.empty()) {
+        return packed_values;
+    }
+    auto const [min_it, max_it] = std::minmax_element(
+            values.cbegin(),
+            values.cend(),
+            [](uint64_t lhs, uint64_t rhs) -> bool {
+                return static_cast<int64_t>(lhs) < static_cast<int64_t>(rhs);
+            }
+    );
+    packed_values.base = static_cast<int64_t>(*min_it);
+    packed_values.bit_width
+            = get_range_bit_width(packed_values.base, static_cast<int64_t>(*max_it));
+    packed_values.packed_values = pack(values, *min_it, packed_values.bit_width);
+    return packed_values;
+}
+
+/**
+ * Unpacks values packed by `pack`, passing each block of unpacked offsets to the given callback.
+ * @tparam BlockCallback Signature: (size_t begin, uint64_t const* block, size_t block_size) -> void
+ * @param bit_width
+ * @param packed_values
+ * @param num_values
+ * @param callback
+ * @return Whether the packed values were valid.
+ */
+template <typename BlockCallback>
+auto unpack(
+        uint8_t bit_width,
+        UnalignedMemSpan<uint64_t> packed_values,
+        size_t num_values,
+        BlockCallback callback
+) -> bool {
+    if (bit_width > IntegerEncoder::cMaxBitWidth
+        || packed_values.size() != IntegerEncoder::get_num_packed_words(num_values, bit_width))
+    {
+        return false;
+    }
+
+    auto const unpack_block_function = cUnpackBlockFunctions[bit_width];
+    std::array<uint64_t, IntegerEncoder::cMaxBitWidth> packed_block{};
+    std::array<uint64_t, IntegerEncoder::cBlockSize> block{};
+    for (size_t begin{0}, block_idx{0}; begin < num_values;
+         begin += IntegerEncoder::cBlockSize, ++block_idx)
+    {
+        packed_values.copy_to(block_idx * bit_width, bit_width, packed_block.data());
+        unpack_block_function(packed_block.data(), block.data());
+        callback(begin, block.data(), std::min(IntegerEncoder::cBlockSize, num_values - begin));
+    }
+    return true;
+}
+}  // namespace
+
+void IntegerColumnStatistics::add_value(int64_t value) {
+    if (0 == m_num_values) {
+        m_min_value = value;
+        m_max_value = value;
+        m_num_runs = 1;
+    } else {
+        m_min_value = std::min(m_min_value, value);
+        m_max_value = std::max(m_max_value, value);
+        auto const delta = static_cast<int64_t>(to_unsigned(value) - to_unsigned(m_prev_value));
+        if (1 == m_num_values) {
+            m_min_delta = delta;
+            m_max_delta = delta;
+        } else {
+            m_min_delta = std::min(m_min_delta, delta);
+            m_max_delta = std::max(m_max_delta, delta);
+        }
+        if (value != m_prev_value) {
+            ++m_num_runs;
+        }
+    }
+    m_prev_value = value;
+    ++m_num_values;
+}
+
+auto IntegerColumnStatistics::get_best_encoding() const -> IntegerEncoding {
+    auto best_encoding{IntegerEncoding::Raw};
+    auto best_size{m_num_values * sizeof(int64_t)};
+    auto const consider_encoding = [&](IntegerEncoding encoding, size_t size) {
+        if (size < best_size) {
+            best_encoding = encoding;
+            best_size = size;
+        }
+    };
+
+    if (m_num_values > 0) {
+        consider_encoding(
+                IntegerEncoding::FrameOfReference,
+                sizeof(int64_t) + sizeof(uint8_t)
+                        + get_packed_size(
+                                m_num_values,
+                                get_range_bit_width(m_min_value, m_max_value)
+                        )
+        );
+    }
+    if (m_num_values > 1) {
+        consider_encoding(
+                IntegerEncoding::Delta,
+                2 * sizeof(int64_t) + sizeof(uint8_t)
+                        + get_packed_size(
+                                m_num_values - 1,
+                                get_range_bit_width(m_min_delta, m_max_delta)
+                        )
+        );
+    }
+    consider_encoding(
+            IntegerEncoding::RunLength,
+            sizeof(size_t) + m_num_runs * (sizeof(int64_t) + sizeof(uint64_t))
+    );
+    return best_encoding;
+}
+
+auto IntegerEncoder::encode_frame_of_reference(std::vector<int64_t> const& values)
+        -> BitPackedIntegers {
+    std::vector<uint64_t> unsigned_values;
+    unsigned_values.reserve(values.size());
+    for (auto const value : values) {
+        unsigned_values.push_back(to_unsigned(value));
+    }
+    return pack(unsigned_values);
+}
+
+auto IntegerEncoder::encode_delta(std::vector<int64_t> const& values) -> DeltaEncodedIntegers {
+    DeltaEncodedIntegers encoded_values;
+    if (values.empty()) {
+        return encoded_values;
+    }
+    encoded_values.first_value = values.front();
+    std::vector<uint64_t> deltas;
+    deltas.reserve(values.size() - 1);
+    for (size_t i{1}; i < values.size(); ++i) {
+        deltas.push_back(to_unsigned(values[i]) - to_unsigned(values[i - 1]));
+    }
+    encoded_values.deltas = pack(deltas);
+    return encoded_values;
+}
+
+auto IntegerEncoder::encode_run_length(std::vector<int64_t> const& values)
+        -> RunLengthEncodedIntegers {
+    RunLengthEncodedIntegers encoded_values;
+    for (auto const value : values) {
+        if (encoded_values.run_values.empty() || encoded_values.run_values.back() != value) {
+            encoded_values.run_values.push_back(value);
+            encoded_values.run_lengths.push_back(1);
+        } else {
+            ++encoded_values.run_lengths.back();
+        }
+    }
+    return encoded_values;
+}
+
+auto IntegerEncoder::decode_frame_of_reference(
+        int64_t base,
+        uint8_t bit_width,
+        UnalignedMemSpan<uint64_t> packed_values,
+        size_t num_values,
+        std::vector<int64_t>& values
+) -> bool {
+    values.resize(num_values);
+    auto const unsigned_base = to_unsigned(base);
+    return unpack(
+            bit_width,
+            packed_values,
+            num_values,
+            [&](size_t begin, uint64_t const* block, size_t block_size) {
+                // The iterations are independent and the buffers are contiguous, so the compiler
+                // can vectorize this loop
+                auto* const block_values = values.data() + begin;
+                for (size_t i{0}; i < block_size; ++i) {
+                    block_values[i] = static_cast<int64_t>(unsigned_base + block[i]);
+                }
+            }
+    );
+}
+
+auto IntegerEncoder::decode_delta(
+        int64_t first_value,
+        int64_t deltas_base,
+        uint8_t bit_width,
+        UnalignedMemSpan<uint64_t> packed_deltas,
+        size_t num_values,
+        std::vector<int64_t>& values
+) -> bool {
+    if (0 == num_values) {
+        values.clear();
+        return 0 == packed_deltas.size();
+    }
+
+    values.resize(num_values);
+    values.front() = first_value;
+    auto const unsigned_deltas_base = to_unsigned(deltas_base);
+    auto cur_value = to_unsigned(first_value);
+    return unpack(
+            bit_width,
+            packed_deltas,
+            num_values - 1,
+            [&](size_t begin, uint64_t const* block, size_t block_size) {
+                auto* const block_values = values.data() + begin + 1;
+                for (size_t i{0}; i < block_size; ++i) {
+                    cur_value += unsigned_deltas_base + block[i];
+                    block_values[i] = static_cast<int64_t>(cur_value);
+                }
+            }
+    );
+}
+
+auto IntegerEncoder::decode_run_length(
+        UnalignedMemSpan<int64_t> run_values,
+        UnalignedMemSpan<uint64_t> run_lengths,
+        size_t num_values,
+        std::vector<int64_t>& values
+) -> bool {
+    if (run_values.size() != run_lengths.size()) {
+        return false;
+    }
+
+    values.resize(num_values);
+    size_t num_decoded_values{0};
+    for (size_t i{0}; i < run_values.size(); ++i) {
+        auto const run_length = run_lengths[i];
+        if (run_length > num_values - num_decoded_values) {
+            return false;
+        }
+        std::fill_n(values.data() + num_decoded_values, run_length, run_values[i]);
+        num_decoded_values += run_length;
+    }
+    return num_decoded_values == num_values;
+}
+}  // namespace clp_s
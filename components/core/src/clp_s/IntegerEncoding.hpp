@@ -0,0 +1,186 @@
+#ifndef CLP_S_INTEGERENCODING_HPP
+#define CLP_S_INTEGERENCODING_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Utils.hpp"
+
+namespace clp_s {
+/**
+ * The encodings of integer columns. Each integer column starts with the encoding of its values.
+ */
+enum class IntegerEncoding : uint8_t {
+    // The values are stored as raw int64_ts
+    Raw = 0,
+    // The values are stored as bit-packed offsets from their minimum (frame of reference)
+    FrameOfReference,
+    // The first value is stored raw, followed by the bit-packed offsets of the differences between
+    // consecutive values from their minimum
+    Delta,
+    // The values are stored as the value and length of each run of equal values
+    RunLength
+};
+
+/**
+ * Integers bit-packed as offsets from a base. Stored (in order) as the base, the bit width, and the
+ * packed values.
+ */
+struct BitPackedIntegers {
+    int64_t base{};
+    uint8_t bit_width{};
+    std::vector<uint64_t> packed_values;
+};
+
+/**
+ * Integers encoded as the differences between consecutive values. Stored (in order) as the first
+ * value and the bit-packed differences.
+ */
+struct DeltaEncodedIntegers {
+    int64_t first_value{};
+    BitPackedIntegers deltas;
+};
+
+/**
+ * Integers encoded as runs of equal values. Stored (in order) as the number of runs, the runs'
+ * values, and the runs' lengths.
+ */
+struct RunLengthEncodedIntegers {
+    std::vector<int64_t> run_values;
+    std::vector<uint64_t> run_lengths;
+};
+
+/**
+ * Statistics about the values of an integer column, gathered as the values are added, which are
+ * used to choose the encoding that stores the column in the fewest bytes.
+ */
+class IntegerColumnStatistics {
+public:
+    // Methods
+    /**
+     * Updates the statistics with the next value of the column.
+     * @param value
+     */
+    void add_value(int64_t value);
+
+    /**
+     * @return The encoding which stores the column's values in the fewest bytes, preferring the
+     * encodings which are cheaper to decode when there's a tie.
+     */
+    [[nodiscard]] auto get_best_encoding() const -> IntegerEncoding;
+
+private:
+    size_t m_num_values{0};
+    int64_t m_min_value{};
+    int64_t m_max_value{};
+    int64_t m_prev_value{};
+    int64_t m_min_delta{};
+    int64_t m_max_delta{};
+    size_t m_num_runs{0};
+};
+
+/**
+ * Encodes integer columns using the lightweight encodings in `IntegerEncoding`.
+ *
+ * Values are bit-packed in blocks of `cBlockSize` values, where each block of values with a bit
+ * width of `w` occupies exactly `w` 64-bit words. Blocks are unpacked by a function specialized for
+ * each bit width, so that the shifts and masks are constants which the compiler can unroll and
+ * vectorize.
+ */
+class IntegerEncoder {
+public:
+    // Constants
+    static constexpr size_t cBlockSize{64};
+    static constexpr uint8_t cMaxBitWidth{64};
+
+    // Methods
+    /**
+     * @param num_values
+     * @param bit_width
+     * @return The number of 64-bit words which the given number of values occupy when bit-packed
+     * with the given bit width.
+     */
+    [[nodiscard]] static constexpr auto
+    get_num_packed_words(size_t num_values, uint8_t bit_width) -> size_t {
+        return (num_values + cBlockSize - 1) / cBlockSize * bit_width;
+    }
+
+    /**
+     * Encodes the given values as bit-packed offsets from their minimum.
+     * @param values
+     * @return The encoded values
+     */
+    [[nodiscard]] static auto encode_frame_of_reference(std::vector<int64_t> const& values)
+            -> BitPackedIntegers;
+
+    /**
+     * Encodes the given values as bit-packed differences between consecutive values.
+     * @param values
+     * @return The encoded values
+     */
+    [[nodiscard]] static auto encode_delta(std::vector<int64_t> const& values)
+            -> DeltaEncodedIntegers;
+
+    /**
+     * Encodes the given values as runs of equal values.
+     * @param values
+     * @return The encoded values
+     */
+    [[nodiscard]] static auto encode_run_length(std::vector<int64_t> const& values)
+            -> RunLengthEncodedIntegers;
+
+    /**
+     * Decodes values encoded by `encode_frame_of_reference`.
+     * @param base
+     * @param bit_width
+     * @param packed_values
+     * @param num_values
+     * @param values Returns the decoded values.
+     * @return Whether the encoded values were valid.
+     */
+    [[nodiscard]] static auto decode_frame_of_reference(
+            int64_t base,
+            uint8_t bit_width,
+            UnalignedMemSpan<uint64_t> packed_values,
+            size_t num_values,
+            std::vector<int64_t>& values
+    ) -> bool;
+
+    /**
+     * Decodes values encoded by `encode_delta`.
+     * @param first_value
+     * @param deltas_base
+     * @param bit_width
+     * @param packed_deltas
+     * @param num_values
+     * @param values Returns the decoded values.
+     * @return Whether the encoded values were valid.
+     */
+    [[nodiscard]] static auto decode_delta(
+            int64_t first_value,
+            int64_t deltas_base,
+            uint8_t bit_width,
+            UnalignedMemSpan<uint64_t> packed_deltas,
+            size_t num_values,
+            std::vector<int64_t>& values
+    ) -> bool;
+
+    /**
+     * Decodes values encoded by `encode_run_length`.
+     * @param run_values
+     * @param run_lengths
+     * @param num_values
+     * @param values Returns the decoded values.
+     * @return Whether the encoded values were valid.
+     */
+    [[nodiscard]] static auto decode_run_length(
+            UnalignedMemSpan<int64_t> run_values,
+            UnalignedMemSpan<uint64_t> run_lengths,
+            size_t num_values,
+            std::vector<int64_t>& values
+    ) -> bool;
+};
+}  // namespace clp_s
+
+#endif  // CLP_S_INTEGERENCODING_HPP
@@ -1,8 +1,13 @@
 #include "JsonConstructor.hpp"
 
+#include <algorithm>
+#include <cstdint>
 #include <filesystem>
+#include <limits>
 #include <queue>
+#include <string>
 #include <system_error>
+#include <vector>
 
 #include <fmt/core.h>
 #include <mongocxx/client.hpp>
@@ -62,17 +67,6 @@ void JsonConstructor::store() {
 }
 
 void JsonConstructor::construct_in_order() {
-    std::string buffer;
-    auto tables = m_archive_reader->read_all_tables();
-    using ReaderPointer = std::shared_ptr<SchemaReader>;
-    auto cmp = [](ReaderPointer& left, ReaderPointer& right) {
-        return left->get_next_log_event_idx() > right->get_next_log_event_idx();
-    };
-    std::priority_queue record_queue(tables.begin(), tables.end(), cmp);
-    // Clear tables vector so that memory gets deallocated after we have marshalled all records for
-    // a given table
-    tables.clear();
-
     int64_t first_idx{};
     int64_t last_idx{};
     size_t chunk_size{};
@@ -148,19 +142,13 @@ void JsonConstructor::construct_in_order() {
         }
     };
 
-    while (false == record_queue.empty()) {
-        ReaderPointer next = record_queue.top();
-        record_queue.pop();
-        last_idx = next->get_next_log_event_idx();
+    auto handle_record = [&](std::string const& record, int64_t log_event_idx) {
+        last_idx = log_event_idx;
         if (0 == chunk_size) {
             first_idx = last_idx;
         }
-        next->get_next_message(buffer);
-        if (false == next->done()) {
-            record_queue.emplace(std::move(next));
-        }
-        writer.write(buffer.c_str(), buffer.length());
-        chunk_size += buffer.length();
+        writer.write(record.c_str(), record.length());
+        chunk_size += record.length();
 
         if (0 != m_option.target_ordered_chunk_size
             && chunk_size >= m_option.target_ordered_chunk_size)
@@ -168,6 +156,15 @@ void JsonConstructor::construct_in_order() {
             finalize_chunk(true);
             chunk_size = 0;
         }
+    };
+
+    if (m_option.log_event_idx_range.has_value()) {
+        auto const [begin, end] = m_option.log_event_idx_range.value();
+        merge_tables_in_windows(handle_record, begin, end);
+    } else if (should_merge_tables_in_memory()) {
+        merge_tables_in_memory(handle_record);
+    } else {
+        merge_tables_in_windows(handle_record, 0, std::numeric_limits<int64_t>::max());
     }
 
     if (chunk_size > 0) {
@@ -189,4 +186,200 @@ void JsonConstructor::construct_in_order() {
         }
     }
 }
+
+bool JsonConstructor::should_merge_tables_in_memory() const {
+    if (0 == m_option.ordered_memory_budget) {
+        return true;
+    }
+
+    size_t tables_size{0};
+    for (auto const& [schema_id, metadata] : m_archive_reader->get_schema_metadata()) {
+        tables_size += metadata.uncompressed_size;
+    }
+    if (tables_size <= m_option.ordered_memory_budget) {
+        return true;
+    }
+
+    if (false == m_archive_reader->can_rewind_packed_streams()) {
+        SPDLOG_WARN(
+                "Archive tables ({}B) exceed the ordered decompression memory budget ({}B), but"
+                " the archive can only be decompressed in a single pass.",
+                tables_size,
+                m_option.ordered_memory_budget
+        );
+        return true;
+    }
+    return false;
+}
+
+void JsonConstructor::merge_tables_in_memory(RecordHandler const& handle_record) {
+    std::string buffer;
+    auto tables = m_archive_reader->read_all_tables();
+    using ReaderPointer = std::shared_ptr<SchemaReader>;
+    auto cmp = [](ReaderPointer& left, ReaderPointer& right) {
+        return left->get_next_log_event_idx() > right->get_next_log_event_idx();
+    };
+    std::priority_queue record_queue(tables.begin(), tables.end(), cmp);
+    // Clear tables vector so that memory gets deallocated after we have marshalled all records for
+    // a given table
+    tables.clear();
+
+    while (false == record_queue.empty()) {
+        ReaderPointer next = record_queue.top();
+        record_queue.pop();
+        auto const log_event_idx = next->get_next_log_event_idx();
+        next->get_next_message(buffer);
+        if (false == next->done()) {
+            record_queue.emplace(std::move(next));
+        }
+        handle_record(buffer, log_event_idx);
+    }
+}
+
+void JsonConstructor::merge_tables_in_windows(
+        RecordHandler const& handle_record,
+        int64_t begin_log_event_idx,
+        int64_t end_log_event_idx
+) {
+    struct TableCursor {
+        int32_t schema_id;
+        uint64_t next_message_idx{0};
+        // A lower bound until the table is first loaded
+        int64_t next_log_event_idx{0};
+        bool done{false};
+    };
+
+    auto const& schema_metadata = m_archive_reader->get_schema_metadata();
+    uint64_t num_records{0};
+    uint64_t tables_size{0};
+    std::vector<TableCursor> cursors;
+    for (auto schema_id : m_archive_reader->get_schema_ids()) {
+        auto const& metadata = schema_metadata.at(schema_id);
+        num_records += metadata.num_messages;
+        tables_size += metadata.uncompressed_size;
+        if (0 == metadata.num_messages) {
+            continue;
+        }
+
+        TableCursor cursor{.schema_id = schema_id};
+        // Tables whose log event index range is known and doesn't overlap the requested range
+        // don't need to be read at all
+        auto const table_range = m_archive_reader->get_table_log_event_idx_range(schema_id);
+        if (table_range.has_value()) {
+            auto const [table_begin, table_end] = table_range.value();
+            if (table_end <= begin_log_event_idx || table_begin >= end_log_event_idx) {
+                continue;
+            }
+            cursor.next_log_event_idx = table_begin;
+        }
+        cursors.emplace_back(cursor);
+    }
+
+    // Log event indices are dense, so no record has an index beyond the number of records
+    end_log_event_idx = std::min(end_log_event_idx, static_cast<int64_t>(num_records));
+    if (begin_log_event_idx >= end_log_event_idx) {
+        return;
+    }
+    auto const num_requested_records = end_log_event_idx - begin_log_event_idx;
+
+    // Half of the budget is reserved for the table being read, and the other half for the records
+    // buffered in the window. We estimate a marshalled record's size as the average size of a row
+    // in the tables. Archives whose packed streams can't be rewound must be read in a single pass,
+    // so the window then covers the whole range.
+    int64_t window_size{num_requested_records};
+    bool const is_single_pass{false == m_archive_reader->can_rewind_packed_streams()};
+    if (0 != m_option.ordered_memory_budget && is_single_pass) {
+        SPDLOG_WARN(
+                "The archive can only be decompressed in a single pass, so all requested log"
+                " events are buffered regardless of the ordered decompression memory budget ({}B).",
+                m_option.ordered_memory_budget
+        );
+    } else if (0 != m_option.ordered_memory_budget) {
+        uint64_t const estimated_record_size
+                = tables_size / std::max<uint64_t>(num_records, 1) + sizeof(std::string);
+        window_size = std::min(
+                window_size,
+                static_cast<int64_t>(std::max<uint64_t>(
+                        m_option.ordered_memory_budget / 2 / estimated_record_size,
+                        1
+                ))
+        );
+    }
+    std::vector<std::string> window(window_size);
+
+    int64_t window_begin{begin_log_event_idx};
+    bool is_first_pass{true};
+    while (false == cursors.empty() && window_begin < end_log_event_idx) {
+        // Skip any log event indices that no remaining table contains
+        auto const min_cursor_it = std::min_element(
+                cursors.cbegin(),
+                cursors.cend(),
+                [](TableCursor const& lhs, TableCursor const& rhs) {
+                    return lhs.next_log_event_idx < rhs.next_log_event_idx;
+                }
+        );
+        window_begin = std::max(window_begin, min_cursor_it->next_log_event_idx);
+        if (window_begin >= end_log_event_idx) {
+            break;
+        }
+        auto const window_end = std::min(window_begin + window_size, end_log_event_idx);
+
+        if (false == is_first_pass) {
+            m_archive_reader->rewind_packed_streams();
+        }
+        is_first_pass = false;
+
+        for (auto& cursor : cursors) {
+            if (cursor.next_log_event_idx >= window_end) {
+                continue;
+            }
+
+            auto& reader = m_archive_reader->read_schema_table(cursor.schema_id, false, true);
+            reader.seek_to_message(cursor.next_message_idx);
+            while (false == reader.done()) {
+                auto const log_event_idx = reader.get_next_log_event_idx();
+                if (log_event_idx >= window_end) {
+                    break;
+                }
+                if (log_event_idx < begin_log_event_idx) {
+                    // Skip records before the requested range without marshalling them
+                    reader.seek_to_message(reader.get_next_message_idx() + 1);
+                    continue;
+                }
+                if (log_event_idx < window_begin) {
+                    throw OperationFailed(
+                            ErrorCodeCorrupt,
+                            __FILENAME__,
+                            __LINE__,
+                            fmt::format(
+                                    "Records in table for schema {} aren't sorted by log event"
+                                    " index.",
+                                    cursor.schema_id
+                            )
+                    );
+                }
+                reader.get_next_message(window[static_cast<size_t>(log_event_idx - window_begin)]);
+            }
+
+            cursor.next_message_idx = reader.get_next_message_idx();
+            cursor.done = reader.done();
+            if (false == cursor.done) {
+                cursor.next_log_event_idx = reader.get_next_log_event_idx();
+                cursor.done = cursor.next_log_event_idx >= end_log_event_idx;
+            }
+        }
+        std::erase_if(cursors, [](TableCursor const& cursor) { return cursor.done; });
+
+        for (int64_t i = 0; i < window_end - window_begin; ++i) {
+            auto& record = window[static_cast<size_t>(i)];
+            if (record.empty()) {
+                // No table contains this log event index
+                continue;
+            }
+            handle_record(record, window_begin + i);
+            record.clear();
+        }
+        window_begin = window_end;
+    }
+}
 }  // namespace clp_s
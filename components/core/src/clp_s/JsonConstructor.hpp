@@ -1,6 +1,9 @@
 #ifndef CLP_S_JSONCONSTRUCTOR_HPP
 #define CLP_S_JSONCONSTRUCTOR_HPP
 
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <optional>
 #include <set>
 #include <string>
@@ -28,6 +31,10 @@ struct JsonConstructorOption {
     bool ordered{false};
     bool print_ordered_chunk_stats{false};
     size_t target_ordered_chunk_size{};
+    // Approximate memory budget (B) for ordered decompression; 0 means unlimited
+    size_t ordered_memory_budget{};
+    // Range of log event indices, [begin, end), to extract; std::nullopt means all of them
+    std::optional<std::pair<int64_t, int64_t>> log_event_idx_range{std::nullopt};
     std::optional<MetadataDbOption> metadata_db{std::nullopt};
 };
 
@@ -61,12 +68,52 @@ public:
     void store();
 
 private:
+    /**
+     * Callback invoked with each marshalled record and its log event index, in log order.
+     */
+    using RecordHandler = std::function<void(std::string const&, int64_t)>;
+
     /**
      * Reads all of the tables from m_archive_reader and writes all of the records
      * they contain to writer in log order.
      */
     void construct_in_order();
 
+    /**
+     * @return Whether all of the archive's tables can be loaded into memory at once without
+     * exceeding the ordered decompression memory budget (or if the archive's packed streams can't
+     * be rewound to read the tables in multiple passes).
+     */
+    [[nodiscard]] bool should_merge_tables_in_memory() const;
+
+    /**
+     * Loads all of the tables from m_archive_reader and merges their records in log order.
+     * @param handle_record
+     */
+    void merge_tables_in_memory(RecordHandler const& handle_record);
+
+    /**
+     * Merges the records of all tables from m_archive_reader with log event indices in
+     * [begin_log_event_idx, end_log_event_idx) in log order using multiple passes over the tables.
+     * Each pass loads one table at a time and buffers the records in a window of log event indices
+     * sized to fit the memory budget (or the whole range if there's no budget). Tables are only
+     * loaded in a pass if they may contain records in the pass' window, and tables whose recorded
+     * log event index range doesn't overlap the requested range are never loaded. If the archive's
+     * packed streams can't be rewound, the window covers the whole range so that only one pass is
+     * needed.
+     *
+     * This relies on each table's records being sorted by log event index.
+     * @param handle_record
+     * @param begin_log_event_idx
+     * @param end_log_event_idx
+     * @throw OperationFailed if a table's records aren't sorted by log event index
+     */
+    void merge_tables_in_windows(
+            RecordHandler const& handle_record,
+            int64_t begin_log_event_idx,
+            int64_t end_log_event_idx
+    );
+
     JsonConstructorOption m_option{};
     std::unique_ptr<ArchiveReader> m_archive_reader;
 };
@@ -1,5 +1,6 @@
 #include "JsonParser.hpp"
 
+#include <chrono>
 #include <cstdint>
 #include <iostream>
 #include <memory>
@@ -87,9 +88,11 @@ private:
 JsonParser::JsonParser(JsonParserOption const& option)
         : m_num_messages(0),
           m_target_encoded_size(option.target_encoded_size),
+          m_flush_interval(option.flush_interval_ms),
           m_max_document_size(option.max_document_size),
           m_timestamp_key(option.timestamp_key),
           m_structurize_arrays(option.structurize_arrays),
+          m_array_encoding(option.array_encoding),
           m_record_log_order(option.record_log_order),
           m_input_paths(option.input_paths),
           m_network_auth(option.network_auth) {
@@ -126,12 +129,17 @@ JsonParser::JsonParser(JsonParserOption const& option)
     m_archive_options.print_archive_stats = option.print_archive_stats;
     m_archive_options.single_file_archive = option.single_file_archive;
     m_archive_options.min_table_size = option.min_table_size;
+    m_archive_options.float_encoding = option.float_encoding;
+    m_archive_options.array_encoding = option.array_encoding;
+    m_archive_options.zstd_dictionary_size = option.zstd_dictionary_size;
+    m_archive_options.schema_compaction_threshold = option.schema_compaction_threshold;
     m_archive_options.id = m_generator();
     m_archive_options.authoritative_timestamp = m_timestamp_column;
     m_archive_options.authoritative_timestamp_namespace = m_timestamp_namespace;
 
     m_archive_writer = std::make_unique<ArchiveWriter>();
     m_archive_writer->open(m_archive_options);
+    m_archive_open_time = std::chrono::steady_clock::now();
 }
 
 void JsonParser::parse_obj_in_array(ondemand::object line, int32_t parent_node_id) {
@@ -228,7 +236,7 @@ void JsonParser::parse_obj_in_array(ondemand::object line, int32_t parent_node_i
                     node_id = m_archive_writer
                                       ->add_node(node_id_stack.top(), NodeType::VarString, cur_key);
                 }
-                m_current_parsed_message.add_unordered_value(value);
+                m_current_parsed_message.add_unordered_unowned_value(value);
                 m_current_schema.insert_unordered(node_id);
                 break;
             }
@@ -302,7 +310,7 @@ void JsonParser::parse_array(ondemand::array array, int32_t parent_node_id) {
                 } else {
                     node_id = m_archive_writer->add_node(parent_node_id, NodeType::VarString, "");
                 }
-                m_current_parsed_message.add_unordered_value(value);
+                m_current_parsed_message.add_unordered_unowned_value(value);
                 m_current_schema.insert_unordered(node_id);
                 break;
             }
@@ -323,6 +331,54 @@ void JsonParser::parse_array(ondemand::array array, int32_t parent_node_id) {
     m_current_schema.end_unordered_object(array_start);
 }
 
+void JsonParser::write_array_tape(ondemand::array array) {
+    for (ondemand::value item : array) {
+        write_array_tape_value(item);
+    }
+}
+
+void JsonParser::write_array_tape_value(ondemand::value value) {
+    switch (value.type()) {
+        case ondemand::json_type::array:
+            m_array_tape_writer.begin_array();
+            write_array_tape(value.get_array());
+            m_array_tape_writer.end_container();
+            break;
+        case ondemand::json_type::object:
+            m_array_tape_writer.begin_object();
+            for (auto field : value.get_object()) {
+                m_array_tape_writer.add_key(field.unescaped_key(true).value());
+                write_array_tape_value(field.value());
+            }
+            m_array_tape_writer.end_container();
+            break;
+        case ondemand::json_type::string:
+            m_array_tape_writer.add_string(value.get_string(true).value());
+            break;
+        case ondemand::json_type::number:
+            switch (value.get_number_type().value()) {
+                case ondemand::number_type::signed_integer:
+                    m_array_tape_writer.add_int64(value.get_int64());
+                    break;
+                case ondemand::number_type::unsigned_integer:
+                    m_array_tape_writer.add_uint64(value.get_uint64());
+                    break;
+                default:
+                    // Integers too large for a uint64_t are stored as doubles
+                    m_array_tape_writer.add_double(value.get_double());
+                    break;
+            }
+            break;
+        case ondemand::json_type::boolean:
+            m_array_tape_writer.add_bool(value.get_bool());
+            break;
+        case ondemand::json_type::null:
+        default:
+            m_array_tape_writer.add_null();
+            break;
+    }
+}
+
 void JsonParser::parse_line(ondemand::value line, int32_t parent_node_id, std::string const& key) {
     int32_t node_id;
     std::stack<ondemand::object> object_stack;
@@ -343,13 +399,16 @@ void JsonParser::parse_line(ondemand::value line, int32_t parent_node_id, std::s
 
         switch (line.type()) {
             case ondemand::json_type::object: {
-                node_id = m_archive_writer
-                                  ->add_node(node_id_stack.top(), NodeType::Object, cur_key);
+                node_id = add_node_for_current_record(
+                        node_id_stack.top(),
+                        NodeType::Object,
+                        cur_key
+                );
                 object_stack.push(std::move(line.get_object()));
                 auto objref = object_stack.top();
                 auto it = ondemand::object_iterator(objref.begin());
                 if (it == objref.end()) {
-                    m_current_schema.insert_ordered(node_id);
+                    m_current_ordered_node_ids.push_back(node_id);
                     object_stack.pop();
                     break;
                 } else {
@@ -360,22 +419,34 @@ void JsonParser::parse_line(ondemand::value line, int32_t parent_node_id, std::s
             }
             case ondemand::json_type::array: {
                 if (m_structurize_arrays) {
-                    node_id = m_archive_writer->add_node(
+                    node_id = add_node_for_current_record(
                             node_id_stack.top(),
                             NodeType::StructuredArray,
                             cur_key
                     );
+                    // The shape cache doesn't track the contents of structured arrays
+                    m_current_shape_state_id.reset();
                     parse_array(std::move(line.get_array()), node_id);
+                } else if (ArrayEncoding::Tape == m_array_encoding) {
+                    m_array_tape_writer.clear();
+                    write_array_tape(line.get_array());
+                    node_id = add_node_for_current_record(
+                            node_id_stack.top(),
+                            NodeType::UnstructuredArray,
+                            cur_key
+                    );
+                    m_current_parsed_message.add_value(node_id, m_array_tape_writer.get_tape());
+                    m_current_ordered_node_ids.push_back(node_id);
                 } else {
                     std::string value
                             = std::string(std::string_view(simdjson::to_json_string(line)));
-                    node_id = m_archive_writer->add_node(
+                    node_id = add_node_for_current_record(
                             node_id_stack.top(),
                             NodeType::UnstructuredArray,
                             cur_key
                     );
                     m_current_parsed_message.add_value(node_id, value);
-                    m_current_schema.insert_ordered(node_id);
+                    m_current_ordered_node_ids.push_back(node_id);
                 }
                 break;
             }
@@ -391,7 +462,7 @@ void JsonParser::parse_line(ondemand::value line, int32_t parent_node_id, std::s
                 } else {
                     type = NodeType::Float;
                 }
-                node_id = m_archive_writer->add_node(node_id_stack.top(), type, cur_key);
+                node_id = add_node_for_current_record(node_id_stack.top(), type, cur_key);
 
                 if (type == NodeType::Integer) {
                     int64_t i64_value;
@@ -414,15 +485,18 @@ void JsonParser::parse_line(ondemand::value line, int32_t parent_node_id, std::s
                                 ->ingest_timestamp_entry(m_timestamp_key, node_id, double_value);
                     }
                 }
-                m_current_schema.insert_ordered(node_id);
+                m_current_ordered_node_ids.push_back(node_id);
                 break;
             }
             case ondemand::json_type::string: {
                 std::string_view value = line.get_string(true);
+                // The field's node type depends on whether it's the timestamp, so this check has
+                // to precede the shape cache lookup. It's inlined and usually a single integer
+                // comparison, which is cheaper than searching the cache's transitions for it.
                 auto const matches_timestamp
                         = m_archive_writer->matches_timestamp(node_id_stack.top(), cur_key);
                 if (matches_timestamp) {
-                    node_id = m_archive_writer->add_node(
+                    node_id = add_node_for_current_record(
                             node_id_stack.top(),
                             NodeType::DateString,
                             cur_key
@@ -436,30 +510,42 @@ void JsonParser::parse_line(ondemand::value line, int32_t parent_node_id, std::s
                     );
                     m_current_parsed_message.add_value(node_id, encoding_id, timestamp);
                 } else if (value.find(' ') != std::string::npos) {
-                    node_id = m_archive_writer
-                                      ->add_node(node_id_stack.top(), NodeType::ClpString, cur_key);
-                    m_current_parsed_message.add_value(node_id, value);
+                    node_id = add_node_for_current_record(
+                            node_id_stack.top(),
+                            NodeType::ClpString,
+                            cur_key
+                    );
+                    m_current_parsed_message.add_unowned_value(node_id, value);
                 } else {
-                    node_id = m_archive_writer
-                                      ->add_node(node_id_stack.top(), NodeType::VarString, cur_key);
-                    m_current_parsed_message.add_value(node_id, value);
+                    node_id = add_node_for_current_record(
+                            node_id_stack.top(),
+                            NodeType::VarString,
+                            cur_key
+                    );
+                    m_current_parsed_message.add_unowned_value(node_id, value);
                 }
 
-                m_current_schema.insert_ordered(node_id);
+                m_current_ordered_node_ids.push_back(node_id);
                 break;
             }
             case ondemand::json_type::boolean: {
                 bool value = line.get_bool();
-                node_id = m_archive_writer
-                                  ->add_node(node_id_stack.top(), NodeType::Boolean, cur_key);
+                node_id = add_node_for_current_record(
+                        node_id_stack.top(),
+                        NodeType::Boolean,
+                        cur_key
+                );
                 m_current_parsed_message.add_value(node_id, value);
-                m_current_schema.insert_ordered(node_id);
+                m_current_ordered_node_ids.push_back(node_id);
                 break;
             }
             case ondemand::json_type::null: {
-                node_id = m_archive_writer
-                                  ->add_node(node_id_stack.top(), NodeType::NullValue, cur_key);
-                m_current_schema.insert_ordered(node_id);
+                node_id = add_node_for_current_record(
+                        node_id_stack.top(),
+                        NodeType::NullValue,
+                        cur_key
+                );
+                m_current_ordered_node_ids.push_back(node_id);
                 break;
             }
         }
@@ -482,6 +568,61 @@ void JsonParser::parse_line(ondemand::value line, int32_t parent_node_id, std::s
     } while (false == object_stack.empty());
 }
 
+int32_t JsonParser::add_node_for_current_record(
+        int32_t parent_node_id,
+        NodeType type,
+        std::string_view key
+) {
+    if (false == m_current_shape_state_id.has_value()) {
+        return m_archive_writer->add_node(parent_node_id, type, key);
+    }
+
+    auto const next_field = m_record_shape_cache.find_next_field(
+            *m_current_shape_state_id,
+            parent_node_id,
+            type,
+            key
+    );
+    if (next_field.has_value()) {
+        auto const [node_id, next_state_id] = next_field.value();
+        m_current_shape_state_id = next_state_id;
+        return node_id;
+    }
+
+    auto const node_id = m_archive_writer->add_node(parent_node_id, type, key);
+    m_current_shape_state_id = m_record_shape_cache.add_next_field(
+            *m_current_shape_state_id,
+            parent_node_id,
+            type,
+            key,
+            node_id
+    );
+    return node_id;
+}
+
+void JsonParser::append_current_record() {
+    if (m_current_shape_state_id.has_value()) {
+        if (auto const& cached_schema = m_record_shape_cache.get_schema(*m_current_shape_state_id);
+            cached_schema.has_value())
+        {
+            auto const& [schema_id, schema] = cached_schema.value();
+            m_current_parsed_message.set_id(schema_id);
+            m_archive_writer->append_message(schema_id, schema, m_current_parsed_message);
+            return;
+        }
+    }
+
+    for (auto const node_id : m_current_ordered_node_ids) {
+        m_current_schema.insert_ordered(node_id);
+    }
+    int32_t const schema_id = m_archive_writer->add_schema(m_current_schema);
+    m_current_parsed_message.set_id(schema_id);
+    m_archive_writer->append_message(schema_id, m_current_schema, m_current_parsed_message);
+    if (m_current_shape_state_id.has_value()) {
+        m_record_shape_cache.set_schema(*m_current_shape_state_id, schema_id, m_current_schema);
+    }
+}
+
 bool JsonParser::parse() {
     auto archive_creator_id = boost::uuids::to_string(m_generator());
     for (auto const& path : m_input_paths) {
@@ -565,6 +706,8 @@ bool JsonParser::parse() {
 
         while (json_file_iterator.get_json(json_it)) {
             m_current_schema.clear();
+            m_current_ordered_node_ids.clear();
+            m_current_shape_state_id = RecordShapeCache::cEmptyShapeStateId;
 
             auto ref = *json_it;
             auto is_scalar_result = ref.is_scalar();
@@ -609,13 +752,10 @@ bool JsonParser::parse() {
             }
             m_num_messages++;
 
-            int32_t current_schema_id = m_archive_writer->add_schema(m_current_schema);
-            m_current_parsed_message.set_id(current_schema_id);
-            m_archive_writer
-                    ->append_message(current_schema_id, m_current_schema, m_current_parsed_message);
+            append_current_record();
 
             bytes_consumed_up_to_prev_record = json_file_iterator.get_num_bytes_consumed();
-            if (m_archive_writer->get_data_size() >= m_target_encoded_size) {
+            if (should_split_archive()) {
                 m_archive_writer->increment_uncompressed_size(
                         bytes_consumed_up_to_prev_record - bytes_consumed_up_to_prev_archive
                 );
@@ -865,7 +1005,7 @@ void JsonParser::parse_kv_log_event_subtree(
                 m_current_parsed_message.add_value(node_id, b_value);
             } break;
             case NodeType::VarString: {
-                auto const var_value{pair.second.value().get_immutable_view<std::string>()};
+                auto const& var_value{pair.second.value().get_immutable_view<std::string>()};
                 if (matches_timestamp) {
                     uint64_t encoding_id{};
                     auto const timestamp = m_archive_writer->ingest_timestamp_entry(
@@ -876,7 +1016,7 @@ void JsonParser::parse_kv_log_event_subtree(
                     );
                     m_current_parsed_message.add_value(node_id, encoding_id, timestamp);
                 } else {
-                    m_current_parsed_message.add_value(node_id, var_value);
+                    m_current_parsed_message.add_unowned_value(node_id, var_value);
                 }
             } break;
             case NodeType::ClpString: {
@@ -919,7 +1059,16 @@ void JsonParser::parse_kv_log_event_subtree(
                                         .decode_and_unparse()
                                         .value();
                 }
-                m_current_parsed_message.add_value(node_id, array_str);
+                if (ArrayEncoding::Tape == m_array_encoding) {
+                    array_str.reserve(array_str.size() + simdjson::SIMDJSON_PADDING);
+                    auto array_doc = m_array_parser.iterate(array_str);
+                    ondemand::array array = array_doc.get_array();
+                    m_array_tape_writer.clear();
+                    write_array_tape(array);
+                    m_current_parsed_message.add_value(node_id, m_array_tape_writer.get_tape());
+                } else {
+                    m_current_parsed_message.add_value(node_id, array_str);
+                }
                 break;
             }
             default:
@@ -1105,7 +1254,7 @@ auto JsonParser::parse_from_ir() -> bool {
                     return false;
                 }
 
-                if (m_archive_writer->get_data_size() >= m_target_encoded_size) {
+                if (should_split_archive()) {
                     m_ir_node_to_archive_node_id_mapping.clear();
                     m_autogen_ir_node_to_archive_node_id_mapping.clear();
                     curr_pos = decompressor.get_pos();
@@ -1159,10 +1308,23 @@ auto JsonParser::store() -> std::vector<ArchiveStats> {
     return std::move(m_archive_stats);
 }
 
+auto JsonParser::should_split_archive() const -> bool {
+    if (m_archive_writer->get_data_size() >= m_target_encoded_size) {
+        return true;
+    }
+    // Archives are only searchable once they're closed, so when ingesting a stream, they're closed
+    // periodically to bound the delay before records become searchable (and the number of records
+    // lost if compression is interrupted)
+    return m_flush_interval.count() > 0
+           && std::chrono::steady_clock::now() - m_archive_open_time >= m_flush_interval;
+}
+
 void JsonParser::split_archive() {
     m_archive_stats.emplace_back(m_archive_writer->close(true));
+    m_record_shape_cache.clear();
     m_archive_options.id = m_generator();
     m_archive_writer->open(m_archive_options);
+    m_archive_open_time = std::chrono::steady_clock::now();
 }
 
 bool JsonParser::check_and_log_curl_error(
@@ -1,6 +1,7 @@
 #ifndef CLP_S_JSONPARSER_HPP
 #define CLP_S_JSONPARSER_HPP
 
+#include <chrono>
 #include <cstdint>
 #include <map>
 #include <optional>
@@ -19,11 +20,14 @@
 #include "../clp/ffi/Value.hpp"
 #include "../clp/ReaderInterface.hpp"
 #include "ArchiveWriter.hpp"
+#include "ArrayTape.hpp"
 #include "DictionaryWriter.hpp"
 #include "FileReader.hpp"
 #include "FileWriter.hpp"
+#include "FloatEncoding.hpp"
 #include "InputConfig.hpp"
 #include "ParsedMessage.hpp"
+#include "RecordShapeCache.hpp"
 #include "Schema.hpp"
 #include "SchemaTree.hpp"
 #include "SchemaWriter.hpp"
@@ -40,6 +44,7 @@ struct JsonParserOption {
     std::string timestamp_key;
     std::string archives_dir;
     size_t target_encoded_size{};
+    uint64_t flush_interval_ms{0};
     size_t max_document_size{};
     size_t min_table_size{};
     int compression_level{};
@@ -47,6 +52,10 @@ struct JsonParserOption {
     bool structurize_arrays{};
     bool record_log_order{true};
     bool single_file_archive{false};
+    FloatEncoding float_encoding{FloatEncoding::Raw};
+    ArrayEncoding array_encoding{ArrayEncoding::ClpString};
+    size_t zstd_dictionary_size{0};
+    double schema_compaction_threshold{0.0};
     NetworkAuthOption network_auth{};
 };
 
@@ -93,6 +102,24 @@ private:
      */
     void parse_line(ondemand::value line, int32_t parent_node_id, std::string const& key);
 
+    /**
+     * Adds a field of the current record to the MPT, following the record's shape through the shape
+     * cache so that the MPT is only searched for fields which haven't followed the same fields
+     * before.
+     * @param parent_node_id
+     * @param type
+     * @param key
+     * @return the ID of the field's node in the MPT
+     */
+    int32_t
+    add_node_for_current_record(int32_t parent_node_id, NodeType type, std::string_view key);
+
+    /**
+     * Appends the current record to the archive, reusing the schema cached for the record's shape
+     * if there is one.
+     */
+    void append_current_record();
+
     /**
      * Determines the archive node type based on the IR node type and value.
      * @param ir_node_type schema node type from the IR stream
@@ -176,6 +203,20 @@ private:
      */
     void parse_array(ondemand::array line, int32_t parent_node_id);
 
+    /**
+     * Writes the tape of an unstructured array to `m_array_tape_writer`.
+     * @param array
+     * @throw simdjson::simdjson_error when encountering invalid values in the array
+     */
+    void write_array_tape(ondemand::array array);
+
+    /**
+     * Writes a value within an unstructured array to `m_array_tape_writer`.
+     * @param value
+     * @throw simdjson::simdjson_error when encountering an invalid value
+     */
+    void write_array_tape_value(ondemand::value value);
+
     /**
      * Parses an object within an array in a JSON line
      * @param line the JSON object
@@ -183,6 +224,12 @@ private:
      */
     void parse_obj_in_array(ondemand::object line, int32_t parent_node_id);
 
+    /**
+     * @return Whether the current archive should be split, i.e., if it has reached the target
+     * encoded size, or if it has been open for longer than the flush interval
+     */
+    [[nodiscard]] auto should_split_archive() const -> bool;
+
     /**
      * Splits the archive if the size of the archive exceeds the maximum size
      */
@@ -213,6 +260,13 @@ private:
     Schema m_current_schema;
     ParsedMessage m_current_parsed_message;
 
+    RecordShapeCache m_record_shape_cache;
+    // The current record's state in the shape cache, or std::nullopt if its shape isn't cacheable
+    std::optional<RecordShapeCache::state_id_t> m_current_shape_state_id;
+    // The nodes to insert into the ordered region of the current record's schema if its shape
+    // doesn't have a cached schema
+    std::vector<int32_t> m_current_ordered_node_ids;
+
     std::string m_timestamp_key;
     std::vector<std::string> m_timestamp_column;
     std::string m_timestamp_namespace;
@@ -221,8 +275,14 @@ private:
     std::unique_ptr<ArchiveWriter> m_archive_writer;
     ArchiveWriterOption m_archive_options{};
     size_t m_target_encoded_size;
+    std::chrono::milliseconds m_flush_interval{0};
+    std::chrono::steady_clock::time_point m_archive_open_time;
     size_t m_max_document_size;
     bool m_structurize_arrays{false};
+    ArrayEncoding m_array_encoding{ArrayEncoding::ClpString};
+    ArrayTapeWriter m_array_tape_writer;
+    // Parses the arrays of IR streams when they're encoded as tapes
+    ondemand::parser m_array_parser;
     bool m_record_log_order{true};
 
     absl::flat_hash_map<std::pair<uint32_t, NodeType>, std::pair<int32_t, bool>>
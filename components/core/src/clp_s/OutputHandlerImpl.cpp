@@ -1,8 +1,13 @@
 #include "OutputHandlerImpl.hpp"
 
+#include <cstdint>
+#include <map>
+#include <memory>
 #include <sstream>
 #include <string>
 #include <string_view>
+#include <variant>
+#include <vector>
 
 #include <mongocxx/client.hpp>
 #include <mongocxx/collection.hpp>
@@ -10,25 +15,79 @@
 #include <mongocxx/instance.hpp>
 #include <mongocxx/uri.hpp>
 #include <msgpack.hpp>
+#include <simdjson.h>
 #include <spdlog/spdlog.h>
 
 #include "../clp/networking/socket_utils.hpp"
 #include "../reducer/CountOperator.hpp"
+#include "../reducer/GroupTags.hpp"
 #include "../reducer/network_utils.hpp"
 #include "../reducer/Record.hpp"
+#include "../reducer/RecordGroupIterator.hpp"
 #include "archive_constants.hpp"
+#include "ColumnReader.hpp"
 #include "search/OutputHandler.hpp"
 
 using std::string;
 using std::string_view;
 
 namespace clp_s {
+namespace {
+/**
+ * @param column A dot-separated path of keys.
+ * @return The JSON pointer (RFC 6901) for the given column.
+ */
+auto column_to_json_pointer(string const& column) -> string;
+
+/**
+ * @param column A dot-separated path of keys.
+ * @return The keys in the given column.
+ */
+auto split_column(string const& column) -> std::vector<string>;
+
+auto column_to_json_pointer(string const& column) -> string {
+    string json_pointer{"/"};
+    for (auto const c : column) {
+        switch (c) {
+            case '.':
+                json_pointer += '/';
+                break;
+            case '~':
+                json_pointer += "~0";
+                break;
+            case '/':
+                json_pointer += "~1";
+                break;
+            default:
+                json_pointer += c;
+                break;
+        }
+    }
+    return json_pointer;
+}
+
+auto split_column(string const& column) -> std::vector<string> {
+    std::vector<string> keys;
+    size_t key_begin{0};
+    for (auto key_end = column.find('.'); string::npos != key_end;
+         key_end = column.find('.', key_begin))
+    {
+        keys.emplace_back(column.substr(key_begin, key_end - key_begin));
+        key_begin = key_end + 1;
+    }
+    keys.emplace_back(column.substr(key_begin));
+    return keys;
+}
+}  // namespace
+
 NetworkOutputHandler::NetworkOutputHandler(
         string const& host,
         int port,
-        bool should_output_timestamp
+        bool should_output_timestamp,
+        uint64_t max_num_results
 )
-        : ::clp_s::search::OutputHandler(should_output_timestamp, true) {
+        : ::clp_s::search::OutputHandler(should_output_timestamp, true),
+          m_max_num_results{max_num_results} {
     m_socket_fd = clp::networking::connect_to_server(host, std::to_string(port));
     if (-1 == m_socket_fd) {
         SPDLOG_ERROR("Failed to connect to the server, errno={}", errno);
@@ -51,6 +110,7 @@ void NetworkOutputHandler::write(
     if (-1 == send(m_socket_fd, m.data(), m.size(), 0)) {
         throw OperationFailed(ErrorCode::ErrorCodeFailureNetwork, __FILE__, __LINE__);
     }
+    ++m_num_results;
 }
 
 ResultsCacheOutputHandler::ResultsCacheOutputHandler(
@@ -73,7 +133,7 @@ ResultsCacheOutputHandler::ResultsCacheOutputHandler(
     }
 }
 
-ErrorCode ResultsCacheOutputHandler::flush() {
+ErrorCode ResultsCacheOutputHandler::finish() {
     size_t count = 0;
     while (false == m_latest_results.empty()) {
         auto result = std::move(*m_latest_results.top());
@@ -149,20 +209,29 @@ void ResultsCacheOutputHandler::write(
     }
 }
 
-CountOutputHandler::CountOutputHandler(int reducer_socket_fd)
+CountOutputHandler::CountOutputHandler(
+        int reducer_socket_fd,
+        reducer::RecordGroupFormat record_group_format
+)
         : ::clp_s::search::OutputHandler(false, false),
           m_reducer_socket_fd(reducer_socket_fd),
-          m_pipeline(reducer::PipelineInputMode::InterStage) {
-    m_pipeline.add_pipeline_stage(std::make_shared<reducer::CountOperator>());
-}
-
-void CountOutputHandler::write(string_view message) {
-    m_pipeline.push_record(reducer::EmptyRecord{});
-}
+          m_record_group_format(record_group_format) {}
 
 ErrorCode CountOutputHandler::finish() {
+    // Like the count operator, send no record group if nothing matched
+    std::map<reducer::GroupTags, int64_t> group_counts;
+    if (m_count > 0) {
+        group_counts.emplace(reducer::GroupTags{}, m_count);
+    }
     if (false
-        == reducer::send_pipeline_results(m_reducer_socket_fd, std::move(m_pipeline.finish())))
+        == reducer::send_pipeline_results(
+                m_reducer_socket_fd,
+                std::make_unique<reducer::Int64MapRecordGroupIterator>(
+                        group_counts,
+                        reducer::CountOperator::cRecordElementKey
+                ),
+                m_record_group_format
+        ))
     {
         return ErrorCode::ErrorCodeFailureNetwork;
     }
@@ -176,7 +245,102 @@ ErrorCode CountByTimeOutputHandler::finish() {
                 std::make_unique<reducer::Int64Int64MapRecordGroupIterator>(
                         m_bucket_counts,
                         reducer::CountOperator::cRecordElementKey
-                )
+                ),
+                m_record_group_format
+        ))
+    {
+        return ErrorCode::ErrorCodeFailureNetwork;
+    }
+    return ErrorCode::ErrorCodeSuccess;
+}
+
+ColumnAggregationOutputHandler::ColumnAggregationOutputHandler(
+        int reducer_socket_fd,
+        reducer::RecordGroupFormat record_group_format,
+        string const& column,
+        std::shared_ptr<reducer::Operator> const& op,
+        bool is_numeric_aggregation
+)
+        // Only string aggregations need to marshal records, for values that aren't stored in a
+        // column reader (e.g., objects and nulls)
+        : ::clp_s::search::OutputHandler(false, false == is_numeric_aggregation),
+          m_reducer_socket_fd(reducer_socket_fd),
+          m_record_group_format(record_group_format),
+          m_column_keys(split_column(column)),
+          m_column_json_pointer(column_to_json_pointer(column)),
+          m_is_numeric_aggregation(is_numeric_aggregation),
+          m_double_record(column),
+          m_string_record(column),
+          m_pipeline(reducer::PipelineInputMode::InterStage) {
+    m_pipeline.add_pipeline_stage(op);
+}
+
+void ColumnAggregationOutputHandler::write(string_view message) {
+    simdjson::dom::element value;
+    auto const error = m_parser.parse(message.data(), message.size())
+                               .at_pointer(m_column_json_pointer)
+                               .get(value);
+    if (simdjson::SUCCESS != error) {
+        return;
+    }
+
+    if (m_is_numeric_aggregation) {
+        double number{};
+        // NOTE: `get_double` also converts integers
+        if (simdjson::SUCCESS != value.get_double().get(number)) {
+            return;
+        }
+        m_double_record.set_record_value(number);
+        m_pipeline.push_record(m_double_record);
+        return;
+    }
+
+    string_view str;
+    if (simdjson::SUCCESS == value.get_string().get(str)) {
+        m_string_record.set_record_value(str);
+    } else {
+        m_string_value = simdjson::minify(value);
+        m_string_record.set_record_value(m_string_value);
+    }
+    m_pipeline.push_record(m_string_record);
+}
+
+void ColumnAggregationOutputHandler::write_column_value(
+        BaseColumnReader& column_reader,
+        uint64_t message_idx
+) {
+    if (m_is_numeric_aggregation) {
+        double number{};
+        switch (column_reader.get_type()) {
+            case NodeType::Integer:
+            case NodeType::DeltaInteger:
+                number = static_cast<double>(
+                        std::get<int64_t>(column_reader.extract_value(message_idx))
+                );
+                break;
+            case NodeType::Float:
+                number = std::get<double>(column_reader.extract_value(message_idx));
+                break;
+            default:
+                return;
+        }
+        m_double_record.set_record_value(number);
+        m_pipeline.push_record(m_double_record);
+        return;
+    }
+
+    m_string_value.clear();
+    column_reader.extract_string_value_into_buffer(message_idx, m_string_value);
+    m_string_record.set_record_value(m_string_value);
+    m_pipeline.push_record(m_string_record);
+}
+
+ErrorCode ColumnAggregationOutputHandler::finish() {
+    if (false
+        == reducer::send_pipeline_results(
+                m_reducer_socket_fd,
+                m_pipeline.finish(),
+                m_record_group_format
         ))
     {
         return ErrorCode::ErrorCodeFailureNetwork;
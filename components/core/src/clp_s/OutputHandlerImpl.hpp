@@ -5,17 +5,27 @@
 #include <sys/socket.h>
 #include <unistd.h>
 
+#include <cstdint>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <optional>
 #include <queue>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <vector>
 
 #include <mongocxx/client.hpp>
 #include <mongocxx/collection.hpp>
+#include <simdjson.h>
 
+#include "../reducer/Operator.hpp"
 #include "../reducer/Pipeline.hpp"
+#include "../reducer/Record.hpp"
 #include "../reducer/RecordGroupIterator.hpp"
+#include "../reducer/types.hpp"
+#include "ColumnReader.hpp"
 #include "Defs.hpp"
 #include "search/OutputHandler.hpp"
 #include "TraceableException.hpp"
@@ -27,8 +37,17 @@ namespace clp_s {
 class StandardOutputHandler : public ::clp_s::search::OutputHandler {
 public:
     // Constructors
-    explicit StandardOutputHandler(bool should_output_metadata = false)
-            : ::clp_s::search::OutputHandler(should_output_metadata, true) {}
+    /**
+     * @param should_output_metadata
+     * @param max_num_results The number of results after which the search can stop, or 0 for no
+     * limit.
+     */
+    explicit StandardOutputHandler(
+            bool should_output_metadata = false,
+            uint64_t max_num_results = 0
+    )
+            : ::clp_s::search::OutputHandler(should_output_metadata, true),
+              m_max_num_results{max_num_results} {}
 
     // Methods inherited from OutputHandler
     void write(
@@ -38,9 +57,24 @@ public:
             int64_t log_event_idx
     ) override {
         std::cout << archive_id << ": " << log_event_idx << ": " << timestamp << " " << message;
+        ++m_num_results;
+    }
+
+    void write(std::string_view message) override {
+        std::cout << message;
+        ++m_num_results;
     }
 
-    void write(std::string_view message) override { std::cout << message; }
+    [[nodiscard]] auto may_stop_early() const -> bool override { return 0 != m_max_num_results; }
+
+protected:
+    [[nodiscard]] auto is_done() const -> bool override {
+        return 0 != m_max_num_results && m_num_results >= m_max_num_results;
+    }
+
+private:
+    uint64_t m_max_num_results{0};
+    uint64_t m_num_results{0};
 };
 
 /**
@@ -57,10 +91,18 @@ public:
     };
 
     // Constructors
+    /**
+     * @param host
+     * @param port
+     * @param should_output_metadata
+     * @param max_num_results The number of results after which the search can stop, or 0 for no
+     * limit.
+     */
     explicit NetworkOutputHandler(
             std::string const& host,
             int port,
-            bool should_output_metadata = false
+            bool should_output_metadata = false,
+            uint64_t max_num_results = 0
     );
 
     // Destructor
@@ -80,10 +122,19 @@ public:
 
     void write(std::string_view message) override { write(message, 0, {}, 0); }
 
+    [[nodiscard]] auto may_stop_early() const -> bool override { return 0 != m_max_num_results; }
+
+protected:
+    [[nodiscard]] auto is_done() const -> bool override {
+        return 0 != m_max_num_results && m_num_results >= m_max_num_results;
+    }
+
 private:
     std::string m_host;
     std::string m_port;
     int m_socket_fd;
+    uint64_t m_max_num_results{0};
+    uint64_t m_num_results{0};
 };
 
 /**
@@ -141,11 +192,11 @@ public:
 
     // Methods inherited from OutputHandler
     /**
-     * Flushes the output handler after each table that gets searched.
+     * Writes the latest results to the results cache after all tables have been searched.
      * @return ErrorCodeSuccess on success
      * @return ErrorCodeFailureDbBulkWrite on failure to write results to the results cache
      */
-    ErrorCode flush() override;
+    ErrorCode finish() override;
 
     void write(
             std::string_view message,
@@ -156,6 +207,19 @@ public:
 
     void write(std::string_view message) override { write(message, 0, {}, 0); }
 
+    [[nodiscard]] auto keeps_latest_log_events() const -> bool override { return true; }
+
+    /**
+     * @return The timestamp of the oldest result kept once `max_num_results` results have been
+     * kept, or std::nullopt before then.
+     */
+    [[nodiscard]] auto get_min_exclusive_timestamp() const -> std::optional<epochtime_t> override {
+        if (m_latest_results.size() < m_max_num_results) {
+            return std::nullopt;
+        }
+        return m_latest_results.top()->timestamp;
+    }
+
 private:
     mongocxx::client m_client;
     mongocxx::collection m_collection;
@@ -175,7 +239,7 @@ private:
 class CountOutputHandler : public ::clp_s::search::OutputHandler {
 public:
     // Constructors
-    CountOutputHandler(int reducer_socket_fd);
+    CountOutputHandler(int reducer_socket_fd, reducer::RecordGroupFormat record_group_format);
 
     // Methods inherited from OutputHandler
     void write(
@@ -185,7 +249,16 @@ public:
             int64_t log_event_idx
     ) override {}
 
-    void write(std::string_view message) override;
+    void write(std::string_view message) override { ++m_count; }
+
+    [[nodiscard]] auto write_count(
+            uint64_t count,
+            [[maybe_unused]] std::optional<std::pair<epochtime_t, epochtime_t>> const&
+                    timestamp_range
+    ) -> bool override {
+        m_count += static_cast<int64_t>(count);
+        return true;
+    }
 
     /**
      * Flushes the count.
@@ -196,7 +269,8 @@ public:
 
 private:
     int m_reducer_socket_fd;
-    reducer::Pipeline m_pipeline;
+    reducer::RecordGroupFormat m_record_group_format;
+    int64_t m_count{0};
 };
 
 /**
@@ -206,9 +280,14 @@ private:
 class CountByTimeOutputHandler : public ::clp_s::search::OutputHandler {
 public:
     // Constructors
-    CountByTimeOutputHandler(int reducer_socket_fd, int64_t count_by_time_bucket_size)
+    CountByTimeOutputHandler(
+            int reducer_socket_fd,
+            reducer::RecordGroupFormat record_group_format,
+            int64_t count_by_time_bucket_size
+    )
             : search::OutputHandler{true, false},
               m_reducer_socket_fd{reducer_socket_fd},
+              m_record_group_format{record_group_format},
               m_count_by_time_bucket_size{count_by_time_bucket_size} {}
 
     // Methods inherited from OutputHandler
@@ -218,12 +297,32 @@ public:
             std::string_view archive_id,
             int64_t log_event_idx
     ) override {
-        int64_t bucket = (timestamp / m_count_by_time_bucket_size) * m_count_by_time_bucket_size;
-        m_bucket_counts[bucket] += 1;
+        m_bucket_counts[get_bucket(timestamp)] += 1;
     }
 
     void write(std::string_view message) override {}
 
+    /**
+     * Accepts the count if every log event falls into the same bucket.
+     * @param count
+     * @param timestamp_range
+     * @return Whether the count was accepted
+     */
+    [[nodiscard]] auto write_count(
+            uint64_t count,
+            std::optional<std::pair<epochtime_t, epochtime_t>> const& timestamp_range
+    ) -> bool override {
+        if (false == timestamp_range.has_value()) {
+            return false;
+        }
+        auto const bucket = get_bucket(timestamp_range->first);
+        if (get_bucket(timestamp_range->second) != bucket) {
+            return false;
+        }
+        m_bucket_counts[bucket] += static_cast<int64_t>(count);
+        return true;
+    }
+
     /**
      * Flushes the counts.
      * @return ErrorCodeSuccess on success
@@ -232,11 +331,85 @@ public:
     ErrorCode finish() override;
 
 private:
+    [[nodiscard]] auto get_bucket(epochtime_t timestamp) const -> int64_t {
+        return (timestamp / m_count_by_time_bucket_size) * m_count_by_time_bucket_size;
+    }
+
     int m_reducer_socket_fd;
+    reducer::RecordGroupFormat m_record_group_format;
     std::map<int64_t, int64_t> m_bucket_counts;
     int64_t m_count_by_time_bucket_size;
 };
 
+/**
+ * Output handler that computes a partial aggregate of a single column (e.g., its sum, number of
+ * distinct values, or percentiles) and sends it to a reducer, which merges the partial aggregates
+ * of every search worker.
+ *
+ * The column's value in each result is read directly from the column's reader and pushed into the
+ * given operator. Only results whose column value isn't stored in a column reader (e.g., objects
+ * and nulls) are marshalled and parsed. Results which don't contain the column (or for numeric
+ * aggregations, contain a non-numeric value) are skipped.
+ */
+class ColumnAggregationOutputHandler : public ::clp_s::search::OutputHandler {
+public:
+    // Constructors
+    /**
+     * @param reducer_socket_fd
+     * @param record_group_format
+     * @param column The column to aggregate, as a dot-separated path of keys. The operator must
+     * read values from inter-stage records using this as the element key.
+     * @param op
+     * @param is_numeric_aggregation Whether the operator reads numeric (double) values, or string
+     * values. Non-string values are passed to string aggregations as minified JSON.
+     */
+    ColumnAggregationOutputHandler(
+            int reducer_socket_fd,
+            reducer::RecordGroupFormat record_group_format,
+            std::string const& column,
+            std::shared_ptr<reducer::Operator> const& op,
+            bool is_numeric_aggregation
+    );
+
+    // Methods inherited from OutputHandler
+    void write(
+            std::string_view message,
+            epochtime_t timestamp,
+            std::string_view archive_id,
+            int64_t log_event_idx
+    ) override {
+        write(message);
+    }
+
+    void write(std::string_view message) override;
+
+    [[nodiscard]] auto get_aggregated_column() const
+            -> std::optional<std::vector<std::string>> override {
+        return m_column_keys;
+    }
+
+    void write_column_value(BaseColumnReader& column_reader, uint64_t message_idx) override;
+
+    /**
+     * Flushes the partial aggregate.
+     * @return ErrorCodeSuccess on success
+     * @return ErrorCodeFailureNetwork on network error
+     */
+    ErrorCode finish() override;
+
+private:
+    int m_reducer_socket_fd;
+    reducer::RecordGroupFormat m_record_group_format;
+    std::vector<std::string> m_column_keys;
+    std::string m_column_json_pointer;
+    bool m_is_numeric_aggregation;
+    simdjson::dom::parser m_parser;
+    reducer::SingleDoubleRecordAdapter m_double_record;
+    reducer::SingleStringRecordAdapter m_string_record;
+    std::string m_string_value;
+    reducer::Pipeline m_pipeline;
+};
+
 /**
  * Output handler that records all results in a provided vector.
  */
@@ -263,9 +436,15 @@ public:
     };
 
     // Constructors
-    VectorOutputHandler(std::vector<QueryResult>& output)
+    /**
+     * @param output
+     * @param max_num_results The number of results after which the search can stop, or 0 for no
+     * limit.
+     */
+    VectorOutputHandler(std::vector<QueryResult>& output, uint64_t max_num_results = 0)
             : search::OutputHandler{true, true},
-              m_output(output) {}
+              m_output(output),
+              m_max_num_results{max_num_results} {}
 
     // Methods inherited from OutputHandler
     void write(
@@ -275,14 +454,25 @@ public:
             int64_t log_event_idx
     ) override {
         m_output.emplace_back(message, timestamp, archive_id, log_event_idx);
+        ++m_num_results;
     }
 
     void write(std::string_view message) override {
         m_output.emplace_back(message, epochtime_t{}, std::string_view{}, int64_t{});
+        ++m_num_results;
+    }
+
+    [[nodiscard]] auto may_stop_early() const -> bool override { return 0 != m_max_num_results; }
+
+protected:
+    [[nodiscard]] auto is_done() const -> bool override {
+        return 0 != m_max_num_results && m_num_results >= m_max_num_results;
     }
 
 private:
     std::vector<QueryResult>& m_output;
+    uint64_t m_max_num_results{0};
+    uint64_t m_num_results{0};
 };
 }  // namespace clp_s
 
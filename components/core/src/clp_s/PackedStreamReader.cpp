@@ -1,8 +1,15 @@
 #include "PackedStreamReader.hpp"
 
+#include <algorithm>
+#include <cstddef>
+#include <optional>
+#include <utility>
+#include <vector>
+
 #include "../clp/BoundedReader.hpp"
 #include "archive_constants.hpp"
 #include "ArchiveReaderAdaptor.hpp"
+#include "PrefetchingRangeReader.hpp"
 
 namespace clp_s {
 void PackedStreamReader::read_metadata(ZstdDecompressor& decompressor) {
@@ -50,6 +57,7 @@ void PackedStreamReader::open_packed_streams(std::shared_ptr<ArchiveReaderAdapto
             throw OperationFailed(ErrorCodeNotReady, __FILE__, __LINE__);
     }
     m_adaptor = adaptor;
+    m_packed_stream_decompressor.set_dictionary(m_adaptor->get_decompression_dictionary());
     m_packed_stream_reader = m_adaptor->checkout_reader_for_section(constants::cArchiveTablesFile);
     if (auto rc = m_packed_stream_reader->try_get_pos(m_begin_offset);
         clp::ErrorCode::ErrorCode_Success != rc)
@@ -73,6 +81,9 @@ void PackedStreamReader::close() {
         m_adaptor->checkin_reader_for_section(constants::cArchiveTablesFile);
     }
     m_adaptor.reset();
+    m_packed_stream_decompressor.set_dictionary(nullptr);
+    m_planned_stream_ids.clear();
+    m_next_planned_stream_idx = 0ULL;
     m_prev_stream_id = 0ULL;
     m_begin_offset = 0ULL;
     m_stream_metadata.clear();
@@ -100,21 +111,30 @@ PackedStreamReader::read_stream(size_t stream_id, std::shared_ptr<char[]>& buf,
     }
     m_prev_stream_id = stream_id;
 
-    auto& [file_offset, uncompressed_size] = m_stream_metadata[stream_id];
-    size_t adjusted_file_offset = m_begin_offset + file_offset;
-    if (auto error = m_packed_stream_reader->try_seek_from_begin(adjusted_file_offset);
-        clp::ErrorCode::ErrorCode_Success != error)
-    {
-        throw OperationFailed(static_cast<ErrorCode>(error), __FILE__, __LINE__);
-    }
-
-    size_t end_pos = m_adaptor->get_header().compressed_size;
-    if ((stream_id + 1) < m_stream_metadata.size()) {
-        end_pos = m_begin_offset + m_stream_metadata[stream_id + 1].file_offset;
+    auto const uncompressed_size = m_stream_metadata[stream_id].uncompressed_size;
+    auto const [begin_pos, end_pos] = get_stream_offsets(stream_id);
+    auto const memory_mapped_archive = m_adaptor->get_memory_mapped_archive();
+    // Declared outside of the branch since the decompressor reads from it until it's closed
+    std::optional<clp::BoundedReader> bounded_reader;
+    if (false == memory_mapped_archive.empty()) {
+        if (begin_pos > end_pos || end_pos > memory_mapped_archive.size()) {
+            throw OperationFailed(ErrorCodeCorrupt, __FILE__, __LINE__);
+        }
+        advise_next_planned_stream(stream_id);
+        m_packed_stream_decompressor.open(
+                memory_mapped_archive.data() + begin_pos,
+                end_pos - begin_pos
+        );
+    } else {
+        if (auto error = m_packed_stream_reader->try_seek_from_begin(begin_pos);
+            clp::ErrorCode::ErrorCode_Success != error)
+        {
+            throw OperationFailed(static_cast<ErrorCode>(error), __FILE__, __LINE__);
+        }
+        bounded_reader.emplace(m_packed_stream_reader.get(), end_pos);
+        m_packed_stream_decompressor.open(*bounded_reader, cDecompressorFileReadBufferCapacity);
     }
-    clp::BoundedReader bounded_reader{m_packed_stream_reader.get(), end_pos};
 
-    m_packed_stream_decompressor.open(bounded_reader, cDecompressorFileReadBufferCapacity);
     if (buf_size < uncompressed_size) {
         // make_shared is supposed to work here for c++20, but it seems like the compiler version
         // we use doesn't support it, so we convert a unique_ptr to a shared_ptr instead.
@@ -129,4 +149,73 @@ PackedStreamReader::read_stream(size_t stream_id, std::shared_ptr<char[]>& buf,
     }
     m_packed_stream_decompressor.close_for_reuse();
 }
+
+void PackedStreamReader::rewind() {
+    switch (m_state) {
+        case PackedStreamReaderState::PackedStreamsOpened:
+            return;
+        case PackedStreamReaderState::ReadingPackedStreams:
+            m_state = PackedStreamReaderState::PackedStreamsOpened;
+            break;
+        default:
+            throw OperationFailed(ErrorCodeNotReady, __FILE__, __LINE__);
+    }
+    m_prev_stream_id = 0ULL;
+}
+
+void PackedStreamReader::set_planned_stream_order(std::vector<size_t> stream_ids) {
+    switch (m_state) {
+        case PackedStreamReaderState::PackedStreamsOpened:
+        case PackedStreamReaderState::ReadingPackedStreams:
+            break;
+        default:
+            throw OperationFailed(ErrorCodeNotReady, __FILE__, __LINE__);
+    }
+    for (auto const stream_id : stream_ids) {
+        if (stream_id >= m_stream_metadata.size()) {
+            throw OperationFailed(ErrorCodeBadParam, __FILE__, __LINE__);
+        }
+    }
+
+    m_planned_stream_ids = std::move(stream_ids);
+    m_next_planned_stream_idx = 0ULL;
+    if (false == m_planned_stream_ids.empty()) {
+        auto const [begin_pos, end_pos] = get_stream_offsets(m_planned_stream_ids.front());
+        m_adaptor->advise_will_need(begin_pos, end_pos);
+    }
+
+    std::vector<ByteRange> planned_ranges;
+    planned_ranges.reserve(m_planned_stream_ids.size());
+    for (auto const stream_id : m_planned_stream_ids) {
+        auto const [begin_pos, end_pos] = get_stream_offsets(stream_id);
+        planned_ranges.push_back({begin_pos, end_pos});
+    }
+    m_adaptor->prefetch_ranges(planned_ranges);
+}
+
+auto PackedStreamReader::get_stream_offsets(size_t stream_id) const -> std::pair<size_t, size_t> {
+    size_t const begin_pos = m_begin_offset + m_stream_metadata[stream_id].file_offset;
+    size_t end_pos = m_adaptor->get_header().compressed_size;
+    if ((stream_id + 1) < m_stream_metadata.size()) {
+        end_pos = m_begin_offset + m_stream_metadata[stream_id + 1].file_offset;
+    }
+    return {begin_pos, end_pos};
+}
+
+void PackedStreamReader::advise_next_planned_stream(size_t stream_id) {
+    auto const planned_it = std::find(
+            m_planned_stream_ids.cbegin() + static_cast<std::ptrdiff_t>(m_next_planned_stream_idx),
+            m_planned_stream_ids.cend(),
+            stream_id
+    );
+    if (m_planned_stream_ids.cend() == planned_it) {
+        return;
+    }
+    m_next_planned_stream_idx = std::distance(m_planned_stream_ids.cbegin(), planned_it) + 1;
+    if (m_next_planned_stream_idx < m_planned_stream_ids.size()) {
+        auto const [begin_pos, end_pos]
+                = get_stream_offsets(m_planned_stream_ids[m_next_planned_stream_idx]);
+        m_adaptor->advise_will_need(begin_pos, end_pos);
+    }
+}
 }  // namespace clp_s
@@ -4,6 +4,7 @@
 #include <cstddef>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "../clp/ReaderInterface.hpp"
@@ -59,6 +60,8 @@ public:
      * or if a stream with lower id is requested after a stream with higher id then an error is
      * thrown.
      *
+     * If the archive is memory-mapped, the stream is decompressed straight from the mapping.
+     *
      * Note: the buffer and buffer size are returned by reference. This is to support the use case
      * where the caller wants to re-use the same buffer for multiple streams to avoid allocations
      * when they already have a sufficiently large buffer. If no buffer is provided or the provided
@@ -73,6 +76,21 @@ public:
      */
     void read_stream(size_t stream_id, std::shared_ptr<char[]>& buf, size_t& buf_size);
 
+    /**
+     * Allows streams to be read again from the beginning, in ascending stream_id order. This
+     * requires the underlying reader to support seeking backwards.
+     */
+    void rewind();
+
+    /**
+     * Sets the order in which streams are expected to be read, so that each stream can be read
+     * ahead while the one before it is decompressed. If the archive is read using range requests,
+     * all of the planned streams start being fetched concurrently. Must be invoked after
+     * `open_packed_streams`.
+     * @param stream_ids
+     */
+    void set_planned_stream_order(std::vector<size_t> stream_ids);
+
     [[nodiscard]] size_t get_uncompressed_stream_size(size_t stream_id) const {
         return m_stream_metadata.at(stream_id).uncompressed_size;
     }
@@ -85,6 +103,19 @@ private:
         ReadingPackedStreams
     };
 
+    /**
+     * @param stream_id
+     * @return The range of offsets, [begin, end), of the stream's compressed data in the tables
+     * section's reader.
+     */
+    [[nodiscard]] auto get_stream_offsets(size_t stream_id) const -> std::pair<size_t, size_t>;
+
+    /**
+     * Hints that the stream planned to be read after the given stream will be read soon.
+     * @param stream_id
+     */
+    void advise_next_planned_stream(size_t stream_id);
+
     std::vector<PackedStreamMetadata> m_stream_metadata;
     std::shared_ptr<ArchiveReaderAdaptor> m_adaptor;
     std::unique_ptr<clp::ReaderInterface> m_packed_stream_reader;
@@ -92,6 +123,8 @@ private:
     PackedStreamReaderState m_state{PackedStreamReaderState::Uninitialized};
     size_t m_begin_offset{};
     size_t m_prev_stream_id{0ULL};
+    std::vector<size_t> m_planned_stream_ids;
+    size_t m_next_planned_stream_idx{0ULL};
 };
 }  // namespace clp_s
 
@@ -1,21 +1,32 @@
 #ifndef CLP_S_PARSEDMESSAGE_HPP
 #define CLP_S_PARSEDMESSAGE_HPP
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
-#include <map>
-#include <string>
+#include <memory>
 #include <string_view>
+#include <type_traits>
 #include <utility>
 #include <variant>
+#include <vector>
 
 #include "Defs.hpp"
 
 namespace clp_s {
+/**
+ * A parsed record waiting to be appended to its schema's table.
+ *
+ * The message is reused for every record in a batch, so after the first few records, adding values
+ * doesn't allocate: values are stored in flat vectors whose capacity is kept when the message is
+ * cleared, and string values are views, either into a buffer which outlives the message's use
+ * (e.g., the JSON document being parsed) or into an arena owned by the message.
+ */
 class ParsedMessage {
 public:
     // Types
-    using variable_t
-            = std::variant<int64_t, double, std::string, bool, std::pair<uint64_t, epochtime_t>>;
+    using variable_t = std::
+            variant<int64_t, double, std::string_view, bool, std::pair<uint64_t, epochtime_t>>;
 
     // Constructor
     ParsedMessage() : m_schema_id(-1) {}
@@ -23,6 +34,14 @@ public:
     // Destructor
     ~ParsedMessage() = default;
 
+    // Delete copy constructor and assignment operator since values may view the arena
+    ParsedMessage(ParsedMessage const&) = delete;
+    auto operator=(ParsedMessage const&) -> ParsedMessage& = delete;
+
+    // Move constructor and assignment operator
+    ParsedMessage(ParsedMessage&&) = default;
+    auto operator=(ParsedMessage&&) -> ParsedMessage& = default;
+
     void set_id(int32_t schema_id) { m_schema_id = schema_id; }
 
     /**
@@ -32,12 +51,28 @@ public:
      * @param value
      */
     template <typename T>
+    requires(false == std::is_convertible_v<T const&, std::string_view>)
     inline void add_value(int32_t node_id, T const& value) {
-        m_message.emplace(node_id, value);
+        m_message.emplace_back(node_id, value);
     }
 
+    /**
+     * Adds a string value to the message for a given MST node ID, copying it into the message's
+     * arena.
+     * @param node_id
+     * @param value
+     */
     inline void add_value(int32_t node_id, std::string_view value) {
-        m_message.emplace(node_id, std::string{value});
+        m_message.emplace_back(node_id, copy_to_arena(value));
+    }
+
+    /**
+     * Adds a string value to the message for a given MST node ID without copying it.
+     * @param node_id
+     * @param value A view which must remain valid until the message is cleared.
+     */
+    inline void add_unowned_value(int32_t node_id, std::string_view value) {
+        m_message.emplace_back(node_id, value);
     }
 
     /**
@@ -47,7 +82,7 @@ public:
      * @param value
      */
     inline void add_value(int32_t node_id, uint64_t encoding_id, epochtime_t value) {
-        m_message.emplace(node_id, std::make_pair(encoding_id, value));
+        m_message.emplace_back(node_id, std::make_pair(encoding_id, value));
     }
 
     /**
@@ -57,27 +92,58 @@ public:
      * @param value
      */
     template <typename T>
+    requires(false == std::is_convertible_v<T const&, std::string_view>)
     inline void add_unordered_value(T const& value) {
         m_unordered_message.emplace_back(value);
     }
 
     inline void add_unordered_value(std::string_view value) {
-        m_unordered_message.emplace_back(std::string{value});
+        m_unordered_message.emplace_back(copy_to_arena(value));
     }
 
     /**
-     * Clears the message
+     * Adds a string value to the unordered region of the message without copying it.
+     * @param value A view which must remain valid until the message is cleared.
+     */
+    inline void add_unordered_unowned_value(std::string_view value) {
+        m_unordered_message.emplace_back(value);
+    }
+
+    /**
+     * Clears the message, keeping its allocated memory for reuse.
      */
     void clear() {
         m_schema_id = -1;
         m_message.clear();
         m_unordered_message.clear();
+        m_cur_arena_block_idx = 0;
+        m_cur_arena_block_offset = 0;
     }
 
     /**
-     * @return The content of the message
+     * @return The content of the message, as pairs of MST node IDs and values ordered by node ID
+     * (i.e., the order of the ordered region of the message's schema). If a node ID was added more
+     * than once, only its first value is kept.
      */
-    std::map<int32_t, variable_t>& get_content() { return m_message; }
+    std::vector<std::pair<int32_t, variable_t>>& get_content() {
+        // Values are usually added in ascending node ID order, so check before sorting
+        auto const not_ascending
+                = [](auto const& lhs, auto const& rhs) { return lhs.first >= rhs.first; };
+        auto const unordered_it
+                = std::adjacent_find(m_message.begin(), m_message.end(), not_ascending);
+        if (m_message.end() != unordered_it) {
+            auto const by_node_id
+                    = [](auto const& lhs, auto const& rhs) { return lhs.first < rhs.first; };
+            auto const same_node_id
+                    = [](auto const& lhs, auto const& rhs) { return lhs.first == rhs.first; };
+            std::stable_sort(m_message.begin(), m_message.end(), by_node_id);
+            m_message.erase(
+                    std::unique(m_message.begin(), m_message.end(), same_node_id),
+                    m_message.end()
+            );
+        }
+        return m_message;
+    }
 
     /**
      * @return the unordered content of the message
@@ -85,9 +151,49 @@ public:
     std::vector<variable_t>& get_unordered_content() { return m_unordered_message; }
 
 private:
+    // Types
+    struct ArenaBlock {
+        std::unique_ptr<char[]> data;
+        size_t size;
+    };
+
+    // Constants
+    static constexpr size_t cMinArenaBlockSize{64ULL * 1024};
+
+    // Methods
+    /**
+     * Copies a string into the arena.
+     * @param value
+     * @return A view of the copy, which remains valid until the message is cleared.
+     */
+    auto copy_to_arena(std::string_view value) -> std::string_view {
+        if (value.empty()) {
+            return {};
+        }
+        while (m_cur_arena_block_idx < m_arena_blocks.size()
+               && m_arena_blocks[m_cur_arena_block_idx].size - m_cur_arena_block_offset
+                          < value.size())
+        {
+            ++m_cur_arena_block_idx;
+            m_cur_arena_block_offset = 0;
+        }
+        if (m_cur_arena_block_idx == m_arena_blocks.size()) {
+            auto const block_size = std::max(cMinArenaBlockSize, value.size());
+            m_arena_blocks.push_back({std::make_unique<char[]>(block_size), block_size});
+        }
+
+        char* copy = m_arena_blocks[m_cur_arena_block_idx].data.get() + m_cur_arena_block_offset;
+        std::copy(value.begin(), value.end(), copy);
+        m_cur_arena_block_offset += value.size();
+        return {copy, value.size()};
+    }
+
     int32_t m_schema_id;
-    std::map<int32_t, variable_t> m_message;
+    std::vector<std::pair<int32_t, variable_t>> m_message;
     std::vector<variable_t> m_unordered_message;
+    std::vector<ArenaBlock> m_arena_blocks;
+    size_t m_cur_arena_block_idx{0};
+    size_t m_cur_arena_block_offset{0};
 };
 }  // namespace clp_s
 
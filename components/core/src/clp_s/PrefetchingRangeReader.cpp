@@ -0,0 +1,440 @@
+#include "PrefetchingRangeReader.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <fmt/core.h>
+#include <spdlog/spdlog.h>
+
+#include "../clp/ErrorCode.hpp"
+#include "../clp/FileReader.hpp"
+#include "../clp/ReaderInterface.hpp"
+#include "ErrorCode.hpp"
+#include "FileWriter.hpp"
+
+namespace clp_s {
+namespace {
+constexpr std::string_view cTempFileExtension{".tmp"};
+}  // namespace
+
+auto coalesce_byte_ranges(
+        std::vector<ByteRange> ranges,
+        size_t max_gap_size,
+        size_t max_range_size
+) -> std::vector<ByteRange> {
+    std::erase_if(ranges, [](ByteRange const& range) { return range.begin >= range.end; });
+    std::sort(ranges.begin(), ranges.end(), [](ByteRange const& lhs, ByteRange const& rhs) {
+        return lhs.begin < rhs.begin;
+    });
+
+    std::vector<ByteRange> coalesced_ranges;
+    for (auto range : ranges) {
+        if (false == coalesced_ranges.empty()) {
+            auto& prev_range = coalesced_ranges.back();
+            // Bytes in the previous range don't need to be in this range as well
+            range.begin = std::max(range.begin, prev_range.end);
+            if (range.begin >= range.end) {
+                continue;
+            }
+            if (range.begin <= prev_range.end + max_gap_size
+                && range.end - prev_range.begin <= max_range_size)
+            {
+                prev_range.end = range.end;
+                continue;
+            }
+        }
+
+        for (; range.end - range.begin > max_range_size; range.begin += max_range_size) {
+            coalesced_ranges.push_back({range.begin, range.begin + max_range_size});
+        }
+        coalesced_ranges.push_back(range);
+    }
+    return coalesced_ranges;
+}
+
+PrefetchingRangeReader::PrefetchingRangeReader(
+        RangeReaderFactory create_reader,
+        size_t size,
+        std::filesystem::path cache_dir,
+        std::string cache_key,
+        size_t max_cache_size,
+        size_t max_read_ahead_size
+)
+        : m_fetch_context{std::make_shared<FetchContext>(
+                  std::move(create_reader),
+                  cache_dir.empty() ? cache_dir : cache_dir / cCacheSubdirectoryName,
+                  std::move(cache_key),
+                  max_cache_size
+          )},
+          m_size{size},
+          m_max_read_ahead_size{max_read_ahead_size} {
+    m_fetch_workers.reserve(cNumFetchWorkers);
+    for (size_t i{0}; i < cNumFetchWorkers; ++i) {
+        m_fetch_workers.emplace_back(&PrefetchingRangeReader::run_fetch_worker, m_fetch_context);
+    }
+}
+
+PrefetchingRangeReader::~PrefetchingRangeReader() {
+    {
+        std::lock_guard const lock{m_fetch_context->mutex};
+        m_fetch_context->is_stopping = true;
+    }
+    m_fetch_context->fetch_queued.notify_all();
+    for (auto& worker : m_fetch_workers) {
+        worker.join();
+    }
+}
+
+void PrefetchingRangeReader::prefetch(std::vector<ByteRange> const& ranges) {
+    auto const coalesced_ranges = coalesce_byte_ranges(ranges, cMaxGapSize, cMaxFetchSize);
+
+    // Coalescing sorts the ranges, so order the coalesced ranges by the first given range which
+    // overlaps them, so that they're fetched in the order they'll be read
+    std::vector<size_t> first_range_indices(coalesced_ranges.size(), ranges.size());
+    for (size_t i{0}; i < ranges.size(); ++i) {
+        auto const& range = ranges[i];
+        if (range.begin >= range.end) {
+            continue;
+        }
+        auto it = std::upper_bound(
+                coalesced_ranges.cbegin(),
+                coalesced_ranges.cend(),
+                range.begin,
+                [](size_t pos, ByteRange const& coalesced_range) {
+                    return pos < coalesced_range.begin;
+                }
+        );
+        if (coalesced_ranges.cbegin() != it) {
+            --it;
+        }
+        for (; coalesced_ranges.cend() != it && it->begin < range.end; ++it) {
+            auto& first_range_idx = first_range_indices[it - coalesced_ranges.cbegin()];
+            first_range_idx = std::min(first_range_idx, i);
+        }
+    }
+    std::vector<size_t> fetch_order(coalesced_ranges.size());
+    std::iota(fetch_order.begin(), fetch_order.end(), 0);
+    std::stable_sort(fetch_order.begin(), fetch_order.end(), [&](size_t lhs, size_t rhs) {
+        return first_range_indices[lhs] < first_range_indices[rhs];
+    });
+
+    for (auto const idx : fetch_order) {
+        auto range = coalesced_ranges[idx];
+        range.end = std::min(range.end, m_size);
+        if (range.begin < range.end) {
+            m_planned_ranges.push_back(range);
+        }
+    }
+    fetch_planned_ranges();
+}
+
+auto PrefetchingRangeReader::try_read(char* buf, size_t num_bytes_to_read, size_t& num_bytes_read)
+        -> clp::ErrorCode {
+    num_bytes_read = 0;
+    if (m_pos >= m_size) {
+        return clp::ErrorCode_EndOfFile;
+    }
+
+    try {
+        while (num_bytes_read < num_bytes_to_read && m_pos < m_size) {
+            auto it = find_fetched_range(m_pos);
+            if (m_fetched_ranges.cend() == it) {
+                fetch_current_bytes();
+                it = find_fetched_range(m_pos);
+            }
+
+            FetchResult data;
+            try {
+                data = it->second.data.get();
+            } catch (std::exception const&) {
+                // Forget the failed fetch so that the range can be fetched again
+                release_fetched_range(it);
+                throw;
+            }
+            auto const offset_in_range = m_pos - it->first;
+            auto const num_bytes_to_copy = std::min(
+                    num_bytes_to_read - num_bytes_read,
+                    it->second.end - m_pos
+            );
+            std::copy_n(data->data() + offset_in_range, num_bytes_to_copy, buf + num_bytes_read);
+            num_bytes_read += num_bytes_to_copy;
+            m_pos += num_bytes_to_copy;
+
+            // Ranges are read in the order they were planned, so ranges which have been read to
+            // their end make room for the next planned ranges
+            if (m_pos >= it->second.end) {
+                release_fetched_range(it);
+                fetch_planned_ranges();
+            }
+        }
+    } catch (std::exception const& e) {
+        SPDLOG_ERROR("Failed to fetch range at offset {} - {}", m_pos, e.what());
+        return clp::ErrorCode_Failure;
+    }
+    return clp::ErrorCode_Success;
+}
+
+auto PrefetchingRangeReader::try_seek_from_begin(size_t pos) -> clp::ErrorCode {
+    if (pos > m_size) {
+        return clp::ErrorCode_OutOfBounds;
+    }
+    m_pos = pos;
+    return clp::ErrorCode_Success;
+}
+
+void PrefetchingRangeReader::fetch_missing_bytes(ByteRange range, bool is_urgent) {
+    // Walk the fetched ranges which overlap the given range, collecting the gaps between them
+    std::vector<ByteRange> missing_ranges;
+    auto next_missing_begin = range.begin;
+    auto it = m_fetched_ranges.upper_bound(range.begin);
+    if (m_fetched_ranges.cbegin() != it) {
+        auto const prev_it = std::prev(it);
+        next_missing_begin = std::max(next_missing_begin, prev_it->second.end);
+    }
+    for (; m_fetched_ranges.cend() != it && it->first < range.end; ++it) {
+        if (next_missing_begin < it->first) {
+            missing_ranges.push_back({next_missing_begin, it->first});
+        }
+        next_missing_begin = std::max(next_missing_begin, it->second.end);
+    }
+    if (next_missing_begin < range.end) {
+        missing_ranges.push_back({next_missing_begin, range.end});
+    }
+    if (missing_ranges.empty()) {
+        return;
+    }
+
+    {
+        std::lock_guard const lock{m_fetch_context->mutex};
+        auto& pending_fetches = m_fetch_context->pending_fetches;
+        auto insert_idx = is_urgent ? 0 : pending_fetches.size();
+        for (auto const& missing_range : missing_ranges) {
+            PendingFetch pending_fetch{missing_range, {}};
+            m_fetched_ranges.emplace(
+                    missing_range.begin,
+                    FetchedRange{missing_range.end, pending_fetch.result.get_future().share()}
+            );
+            m_num_buffered_bytes += missing_range.end - missing_range.begin;
+            pending_fetches.insert(
+                    pending_fetches.begin() + static_cast<std::ptrdiff_t>(insert_idx++),
+                    std::move(pending_fetch)
+            );
+        }
+    }
+    m_fetch_context->fetch_queued.notify_all();
+}
+
+void PrefetchingRangeReader::fetch_planned_ranges() {
+    while (false == m_planned_ranges.empty()) {
+        auto const range = m_planned_ranges.front();
+        // Ranges larger than the window are still fetched, one at a time
+        if (0 != m_num_buffered_bytes
+            && m_num_buffered_bytes + (range.end - range.begin) > m_max_read_ahead_size)
+        {
+            break;
+        }
+        m_planned_ranges.pop_front();
+        fetch_missing_bytes(range, false);
+    }
+}
+
+void PrefetchingRangeReader::fetch_current_bytes() {
+    ByteRange range{m_pos, std::min(m_pos + cMinOnDemandFetchSize, m_size)};
+    for (auto it = m_planned_ranges.begin(); m_planned_ranges.end() != it; ++it) {
+        if (it->begin <= m_pos && m_pos < it->end) {
+            range = *it;
+            m_planned_ranges.erase(it);
+            break;
+        }
+        // Ranges fetched on demand don't overlap planned ranges, so that their bytes aren't
+        // fetched twice
+        if (m_pos < it->begin) {
+            range.end = std::min(range.end, it->begin);
+        }
+    }
+    fetch_missing_bytes(range, true);
+}
+
+void PrefetchingRangeReader::release_fetched_range(
+        std::map<size_t, FetchedRange>::const_iterator it
+) {
+    m_num_buffered_bytes -= it->second.end - it->first;
+    m_fetched_ranges.erase(it);
+}
+
+auto PrefetchingRangeReader::find_fetched_range(size_t pos) const
+        -> std::map<size_t, FetchedRange>::const_iterator {
+    auto it = m_fetched_ranges.upper_bound(pos);
+    if (m_fetched_ranges.cbegin() == it) {
+        return m_fetched_ranges.cend();
+    }
+    --it;
+    if (pos >= it->second.end) {
+        return m_fetched_ranges.cend();
+    }
+    return it;
+}
+
+void PrefetchingRangeReader::run_fetch_worker(std::shared_ptr<FetchContext> const& context) {
+    while (true) {
+        std::unique_lock lock{context->mutex};
+        context->fetch_queued.wait(lock, [&] {
+            return context->is_stopping || false == context->pending_fetches.empty();
+        });
+        if (context->is_stopping) {
+            return;
+        }
+        auto pending_fetch = std::move(context->pending_fetches.front());
+        context->pending_fetches.pop_front();
+        lock.unlock();
+
+        try {
+            pending_fetch.result.set_value(fetch_range(*context, pending_fetch.range));
+        } catch (std::exception const&) {
+            pending_fetch.result.set_exception(std::current_exception());
+        }
+    }
+}
+
+auto PrefetchingRangeReader::fetch_range(FetchContext& context, ByteRange range) -> FetchResult {
+    auto const num_bytes = range.end - range.begin;
+    std::filesystem::path cache_path;
+    if (false == context.cache_dir.empty()) {
+        cache_path = context.cache_dir
+                     / fmt::format("{}-{}-{}", context.cache_key, range.begin, range.end);
+        std::error_code ec;
+        if (std::filesystem::file_size(cache_path, ec) == num_bytes && false == bool(ec)) {
+            try {
+                auto data = std::make_shared<std::string>(num_bytes, '\0');
+                clp::FileReader reader{cache_path.string()};
+                if (clp::ErrorCode_Success == reader.try_read_exact_length(data->data(), num_bytes))
+                {
+                    // Mark the range as recently used so that it's evicted last
+                    std::filesystem::last_write_time(
+                            cache_path,
+                            std::filesystem::file_time_type::clock::now(),
+                            ec
+                    );
+                    return data;
+                }
+            } catch (std::exception const& e) {
+                SPDLOG_WARN("Failed to read cached range {} - {}", cache_path.string(), e.what());
+            }
+        }
+    }
+
+    auto data = std::make_shared<std::string>(num_bytes, '\0');
+    {
+        ++context.num_requests;
+        // The reader only needs to read the range, so it's destroyed (ending the request) as soon
+        // as the range has been read.
+        auto reader = context.create_reader(range.begin);
+        if (nullptr == reader
+            || clp::ErrorCode_Success != reader->try_read_exact_length(data->data(), num_bytes))
+        {
+            throw OperationFailed(ErrorCodeFailureNetwork, __FILENAME__, __LINE__);
+        }
+    }
+
+    if (false == cache_path.empty() && num_bytes <= context.max_cache_size) {
+        cache_range(context, cache_path, *data);
+    }
+    return data;
+}
+
+void PrefetchingRangeReader::cache_range(
+        FetchContext const& context,
+        std::filesystem::path const& cache_path,
+        std::string const& data
+) {
+    // Write to a temporary file first so that concurrent readers never see a partial range
+    auto temp_path = cache_path;
+    temp_path += fmt::format(
+            ".{}{}",
+            std::hash<std::thread::id>{}(std::this_thread::get_id()),
+            cTempFileExtension
+    );
+    try {
+        std::filesystem::create_directories(context.cache_dir);
+        FileWriter writer;
+        writer.open(temp_path.string(), FileWriter::OpenMode::CreateForWriting);
+        writer.write(data.data(), data.size());
+        writer.close();
+        std::filesystem::rename(temp_path, cache_path);
+    } catch (std::exception const& e) {
+        SPDLOG_WARN("Failed to cache range {} - {}", cache_path.string(), e.what());
+        std::error_code ec;
+        std::filesystem::remove(temp_path, ec);
+        return;
+    }
+
+    // The cache may be shared with other readers (and processes), so its size is recomputed from
+    // the directory each time. Errors are ignored since other readers may evict the same files.
+    // NOTE: The cache directory is a subdirectory which only contains cached ranges, so every file
+    // in it can be evicted.
+    struct CachedRange {
+        std::filesystem::path path;
+        std::filesystem::file_time_type last_write_time;
+        size_t size;
+    };
+    std::vector<CachedRange> cached_ranges;
+    size_t cache_size{0};
+    std::error_code ec;
+    for (std::filesystem::directory_iterator it{context.cache_dir, ec}, end; end != it;
+         it.increment(ec))
+    {
+        if (ec) {
+            break;
+        }
+        auto const& path = it->path();
+        // Ranges which are still being written aren't evicted
+        if (cTempFileExtension == path.extension()) {
+            continue;
+        }
+        auto const size = it->file_size(ec);
+        if (ec) {
+            continue;
+        }
+        auto const last_write_time = it->last_write_time(ec);
+        if (ec) {
+            continue;
+        }
+        cache_size += size;
+        cached_ranges.push_back({path, last_write_time, size});
+    }
+    if (cache_size <= context.max_cache_size) {
+        return;
+    }
+
+    std::sort(
+            cached_ranges.begin(),
+            cached_ranges.end(),
+            [](CachedRange const& lhs, CachedRange const& rhs) {
+                return lhs.last_write_time < rhs.last_write_time;
+            }
+    );
+    for (auto const& cached_range : cached_ranges) {
+        if (cache_size <= context.max_cache_size) {
+            break;
+        }
+        if (std::filesystem::remove(cached_range.path, ec)) {
+            cache_size -= cached_range.size;
+        }
+    }
+}
+}  // namespace clp_s
@@ -0,0 +1,298 @@
+#ifndef CLP_S_PREFETCHINGRANGEREADER_HPP
+#define CLP_S_PREFETCHINGRANGEREADER_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "../clp/ErrorCode.hpp"
+#include "../clp/ReaderInterface.hpp"
+#include "ErrorCode.hpp"
+#include "TraceableException.hpp"
+
+namespace clp_s {
+/**
+ * A range of bytes, [begin, end), in a resource.
+ */
+struct ByteRange {
+    size_t begin;
+    size_t end;
+};
+
+/**
+ * Sorts the given byte ranges and merges the ones which overlap or are separated by at most
+ * `max_gap_size` bytes, since fetching a small gap is cheaper than making another request. Ranges
+ * are only merged up to `max_range_size` bytes, and larger ranges are split, so that large regions
+ * are still fetched with concurrent requests. Empty ranges are dropped.
+ * @param ranges
+ * @param max_gap_size
+ * @param max_range_size
+ * @return The coalesced ranges in ascending order, which don't overlap.
+ */
+[[nodiscard]] auto coalesce_byte_ranges(
+        std::vector<ByteRange> ranges,
+        size_t max_gap_size,
+        size_t max_range_size
+) -> std::vector<ByteRange>;
+
+/**
+ * A reader for resources where every request has a high latency (e.g., objects on S3). The ranges
+ * of the resource which will be read can be prefetched by a fixed pool of workers making concurrent
+ * requests, after which reads within them are served from memory. Reads outside of the prefetched
+ * ranges fetch a range on demand. Unlike a streaming reader, this reader can seek in either
+ * direction.
+ *
+ * To bound memory usage, prefetched ranges are only fetched once they're within a read-ahead
+ * window: the ranges being fetched, or fetched but not yet read, can total at most
+ * `max_read_ahead_size` bytes. Ranges are released from memory once they've been read to their
+ * end, after which further ranges are fetched in the order they were planned.
+ *
+ * Fetched ranges can also be cached on disk, so that later readers of the same resource don't need
+ * to fetch them again. Ranges are cached in a subdirectory of the given cache directory, which the
+ * reader owns: when the files in it exceed the cache's size limit, the least recently used ones are
+ * evicted.
+ */
+class PrefetchingRangeReader : public clp::ReaderInterface {
+public:
+    // Types
+    class OperationFailed : public TraceableException {
+    public:
+        // Constructors
+        OperationFailed(ErrorCode error_code, char const* const filename, int line_number)
+                : TraceableException(error_code, filename, line_number) {}
+    };
+
+    /**
+     * Creates a reader for the resource which starts at the given offset.
+     */
+    using RangeReaderFactory = std::function<std::shared_ptr<clp::ReaderInterface>(size_t offset)>;
+
+    // Constants
+    // Ranges separated by at most this many bytes are fetched with a single request
+    static constexpr size_t cMaxGapSize{1024 * 1024};
+    // The maximum size of a range which is fetched with a single request
+    static constexpr size_t cMaxFetchSize{16 * 1024 * 1024};
+    // The minimum size of a range which is fetched on demand
+    static constexpr size_t cMinOnDemandFetchSize{1024 * 1024};
+    // The number of workers fetching ranges concurrently
+    static constexpr size_t cNumFetchWorkers{8};
+    static constexpr size_t cDefaultMaxReadAheadSize{cNumFetchWorkers * cMaxFetchSize};
+    static constexpr size_t cDefaultMaxCacheSize{10ULL * 1024 * 1024 * 1024};  // 10 GiB
+    // The subdirectory of the cache directory in which ranges are cached
+    static constexpr std::string_view cCacheSubdirectoryName{"clp-s-range-cache"};
+
+    // Constructors
+    /**
+     * @param create_reader
+     * @param size The size of the resource.
+     * @param cache_dir The directory in which to cache fetched ranges (in the
+     * `cCacheSubdirectoryName` subdirectory), or an empty path to disable caching.
+     * @param cache_key A key which uniquely identifies the resource within the cache.
+     * @param max_cache_size The maximum total size of the cached ranges.
+     * @param max_read_ahead_size The maximum total size of the prefetched ranges which are being
+     * fetched, or have been fetched but not yet read.
+     */
+    PrefetchingRangeReader(
+            RangeReaderFactory create_reader,
+            size_t size,
+            std::filesystem::path cache_dir,
+            std::string cache_key,
+            size_t max_cache_size = cDefaultMaxCacheSize,
+            size_t max_read_ahead_size = cDefaultMaxReadAheadSize
+    );
+
+    // Disable copy and move constructors and assignment operators
+    PrefetchingRangeReader(PrefetchingRangeReader const&) = delete;
+    PrefetchingRangeReader(PrefetchingRangeReader&&) = delete;
+    auto operator=(PrefetchingRangeReader const&) -> PrefetchingRangeReader& = delete;
+    auto operator=(PrefetchingRangeReader&&) -> PrefetchingRangeReader& = delete;
+
+    // Destructor
+    ~PrefetchingRangeReader() override;
+
+    // Methods
+    /**
+     * Plans to fetch the given ranges in the background, in the order in which they're given,
+     * skipping any bytes which have already been fetched. Ranges are fetched once they're within
+     * the read-ahead window.
+     * @param ranges
+     */
+    void prefetch(std::vector<ByteRange> const& ranges);
+
+    /**
+     * @return The number of requests made to fetch ranges, excluding ranges read from the cache.
+     */
+    [[nodiscard]] auto get_num_requests() const -> size_t {
+        return m_fetch_context->num_requests.load();
+    }
+
+    /**
+     * @return The total size of the ranges which are being fetched, or have been fetched but not
+     * yet read.
+     */
+    [[nodiscard]] auto get_num_buffered_bytes() const -> size_t { return m_num_buffered_bytes; }
+
+    // Methods implementing the ReaderInterface
+    /**
+     * Tries to read up to a given number of bytes, waiting for them to be fetched if necessary.
+     * @param buf
+     * @param num_bytes_to_read
+     * @param num_bytes_read Returns the number of bytes read
+     * @return ErrorCode_EndOfFile if the end of the resource has been reached
+     * @return ErrorCode_Failure if fetching the bytes failed
+     * @return ErrorCode_Success on success
+     */
+    [[nodiscard]] auto try_read(char* buf, size_t num_bytes_to_read, size_t& num_bytes_read)
+            -> clp::ErrorCode override;
+
+    /**
+     * Tries to seek to the given position, relative to the beginning of the resource.
+     * @param pos
+     * @return ErrorCode_OutOfBounds if the position is past the end of the resource
+     * @return ErrorCode_Success on success
+     */
+    [[nodiscard]] auto try_seek_from_begin(size_t pos) -> clp::ErrorCode override;
+
+    /**
+     * @param pos Returns the position of the read head
+     * @return ErrorCode_Success
+     */
+    [[nodiscard]] auto try_get_pos(size_t& pos) -> clp::ErrorCode override {
+        pos = m_pos;
+        return clp::ErrorCode_Success;
+    }
+
+private:
+    // Types
+    using FetchResult = std::shared_ptr<std::string const>;
+
+    /**
+     * A range waiting for a worker to fetch it.
+     */
+    struct PendingFetch {
+        ByteRange range;
+        std::promise<FetchResult> result;
+    };
+
+    /**
+     * State shared with the fetch workers.
+     */
+    struct FetchContext {
+        FetchContext(
+                RangeReaderFactory create_reader,
+                std::filesystem::path cache_dir,
+                std::string cache_key,
+                size_t max_cache_size
+        )
+                : create_reader{std::move(create_reader)},
+                  cache_dir{std::move(cache_dir)},
+                  cache_key{std::move(cache_key)},
+                  max_cache_size{max_cache_size} {}
+
+        RangeReaderFactory create_reader;
+        std::filesystem::path cache_dir;
+        std::string cache_key;
+        size_t max_cache_size;
+        std::atomic_size_t num_requests{0};
+
+        std::mutex mutex;
+        std::condition_variable fetch_queued;
+        // Protected by `mutex`
+        std::deque<PendingFetch> pending_fetches;
+        bool is_stopping{false};
+    };
+
+    struct FetchedRange {
+        size_t end;
+        std::shared_future<FetchResult> data;
+    };
+
+    // Methods
+    /**
+     * Queues the bytes in the given range which haven't already been fetched for the workers.
+     * @param range
+     * @param is_urgent Whether the range is needed immediately, in which case it's fetched before
+     * any ranges which are already queued.
+     */
+    void fetch_missing_bytes(ByteRange range, bool is_urgent);
+
+    /**
+     * Queues the planned ranges for the workers until the read-ahead window is full.
+     */
+    void fetch_planned_ranges();
+
+    /**
+     * Fetches the bytes at the current position, which haven't been fetched: if they're in a
+     * planned range, the range is fetched immediately; otherwise, a range is fetched on demand.
+     */
+    void fetch_current_bytes();
+
+    /**
+     * Releases a fetched range.
+     * @param it
+     */
+    void release_fetched_range(std::map<size_t, FetchedRange>::const_iterator it);
+
+    /**
+     * @param pos
+     * @return An iterator to the fetched range containing the given position, or the end iterator
+     * if no fetched range contains it.
+     */
+    [[nodiscard]] auto find_fetched_range(size_t pos) const
+            -> std::map<size_t, FetchedRange>::const_iterator;
+
+    /**
+     * Fetches queued ranges until the reader is destroyed.
+     * @param context
+     */
+    static void run_fetch_worker(std::shared_ptr<FetchContext> const& context);
+
+    /**
+     * Fetches the given range, from the cache if possible.
+     * @param context
+     * @param range
+     * @return The bytes in the range
+     * @throw OperationFailed if the range couldn't be fetched
+     */
+    static auto fetch_range(FetchContext& context, ByteRange range) -> FetchResult;
+
+    /**
+     * Writes the given range to the cache, and then evicts the least recently used ranges until the
+     * cache is within its size limit.
+     * @param context
+     * @param cache_path
+     * @param data
+     */
+    static void cache_range(
+            FetchContext const& context,
+            std::filesystem::path const& cache_path,
+            std::string const& data
+    );
+
+    // Variables
+    std::shared_ptr<FetchContext> m_fetch_context;
+    std::vector<std::thread> m_fetch_workers;
+    size_t m_size{0};
+    size_t m_pos{0};
+    size_t m_max_read_ahead_size{cDefaultMaxReadAheadSize};
+    // Ranges which will be read, in the order they'll be read, but which haven't been queued for
+    // the workers yet
+    std::deque<ByteRange> m_planned_ranges;
+    // Maps the beginning of each fetched range to the range. Fetched ranges never overlap.
+    std::map<size_t, FetchedRange> m_fetched_ranges;
+    size_t m_num_buffered_bytes{0};
+};
+}  // namespace clp_s
+
+#endif  // CLP_S_PREFETCHINGRANGEREADER_HPP
@@ -0,0 +1,53 @@
+#include "RecordShapeCache.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "SchemaTree.hpp"
+
+namespace clp_s {
+void RecordShapeCache::clear() {
+    m_states.clear();
+    m_states.emplace_back();
+}
+
+auto RecordShapeCache::find_next_field(
+        state_id_t state_id,
+        int32_t parent_node_id,
+        NodeType type,
+        std::string_view key
+) const -> std::optional<std::pair<int32_t, state_id_t>> {
+    for (auto const& transition : m_states[state_id].transitions) {
+        if (transition.parent_node_id == parent_node_id && transition.type == type
+            && transition.key == key)
+        {
+            return std::make_pair(transition.node_id, transition.next_state_id);
+        }
+    }
+    return std::nullopt;
+}
+
+auto RecordShapeCache::add_next_field(
+        state_id_t state_id,
+        int32_t parent_node_id,
+        NodeType type,
+        std::string_view key,
+        int32_t node_id
+) -> std::optional<state_id_t> {
+    if (m_states.size() >= cMaxNumStates
+        || m_states[state_id].transitions.size() >= cMaxNumTransitionsPerState)
+    {
+        return std::nullopt;
+    }
+
+    auto const next_state_id = m_states.size();
+    m_states.emplace_back();
+    m_states[state_id].transitions.emplace_back(
+            Transition{parent_node_id, type, std::string{key}, node_id, next_state_id}
+    );
+    return next_state_id;
+}
+}  // namespace clp_s
@@ -0,0 +1,122 @@
+#ifndef CLP_S_RECORDSHAPECACHE_HPP
+#define CLP_S_RECORDSHAPECACHE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "Schema.hpp"
+#include "SchemaTree.hpp"
+
+namespace clp_s {
+/**
+ * A cache of the shapes of the records ingested into an archive, which lets records with a
+ * previously seen shape skip MPT lookups and schema construction (similar to the hidden classes used
+ * by JavaScript engines).
+ *
+ * A record's shape is the sequence of fields (parent MPT node ID, key, and node type) visited while
+ * parsing it. Shapes are stored as a trie: each state is a prefix of one or more shapes and records
+ * the fields which have followed it, along with their MPT node IDs, and a state which ends a record
+ * records the record's schema.
+ *
+ * Records typically follow few distinct paths through the trie, so a state's transitions are
+ * searched linearly. To bound the cache's size, transitions aren't added once a state has
+ * `cMaxNumTransitionsPerState` transitions or the cache has `cMaxNumStates` states; the records
+ * which would need them are simply parsed without the cache.
+ */
+class RecordShapeCache {
+public:
+    // Types
+    using state_id_t = size_t;
+
+    // Constants
+    static constexpr state_id_t cEmptyShapeStateId{0};
+    static constexpr size_t cMaxNumStates{64ULL * 1024};
+    static constexpr size_t cMaxNumTransitionsPerState{16};
+
+    // Constructors
+    RecordShapeCache() { clear(); }
+
+    // Methods
+    /**
+     * Removes every shape from the cache. Must be called whenever the MPT is reset.
+     */
+    void clear();
+
+    /**
+     * Finds a field which has previously followed the given state.
+     * @param state_id
+     * @param parent_node_id
+     * @param type
+     * @param key
+     * @return A pair containing the field's MPT node ID and the state which follows the field, or
+     * std::nullopt if the field hasn't followed the given state before.
+     */
+    [[nodiscard]] auto find_next_field(
+            state_id_t state_id,
+            int32_t parent_node_id,
+            NodeType type,
+            std::string_view key
+    ) const -> std::optional<std::pair<int32_t, state_id_t>>;
+
+    /**
+     * Adds a field which follows the given state.
+     * @param state_id
+     * @param parent_node_id
+     * @param type
+     * @param key
+     * @param node_id The field's MPT node ID.
+     * @return The state which follows the field, or std::nullopt if the cache is full.
+     */
+    auto add_next_field(
+            state_id_t state_id,
+            int32_t parent_node_id,
+            NodeType type,
+            std::string_view key,
+            int32_t node_id
+    ) -> std::optional<state_id_t>;
+
+    /**
+     * @param state_id
+     * @return The schema ID and schema of the records which end at the given state, or std::nullopt
+     * if no such record has been cached.
+     */
+    [[nodiscard]] auto get_schema(state_id_t state_id) const
+            -> std::optional<std::pair<int32_t, Schema>> const& {
+        return m_states[state_id].schema;
+    }
+
+    /**
+     * Sets the schema of the records which end at the given state.
+     * @param state_id
+     * @param schema_id
+     * @param schema
+     */
+    void set_schema(state_id_t state_id, int32_t schema_id, Schema const& schema) {
+        m_states[state_id].schema.emplace(schema_id, schema);
+    }
+
+private:
+    // Types
+    struct Transition {
+        int32_t parent_node_id;
+        NodeType type;
+        std::string key;
+        int32_t node_id;
+        state_id_t next_state_id;
+    };
+
+    struct State {
+        std::vector<Transition> transitions;
+        std::optional<std::pair<int32_t, Schema>> schema;
+    };
+
+    std::vector<State> m_states;
+};
+}  // namespace clp_s
+
+#endif  // CLP_S_RECORDSHAPECACHE_HPP
@@ -14,13 +14,17 @@ void Schema::insert_ordered(int32_t mst_node_id) {
             mst_node_id
     );
     ++m_num_ordered;
+    m_hash += hash_ordered_entry(mst_node_id);
 }
 
 void Schema::insert_unordered(int32_t mst_node_id) {
+    m_hash += hash_unordered_entry(mst_node_id, m_schema.size() - m_num_ordered);
     m_schema.push_back(mst_node_id);
 }
 
 void Schema::insert_unordered(Schema const& schema) {
-    m_schema.insert(m_schema.end(), schema.begin(), schema.end());
+    for (auto const schema_entry : schema) {
+        insert_unordered(schema_entry);
+    }
 }
 }  // namespace clp_s
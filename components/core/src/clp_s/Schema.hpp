@@ -20,6 +20,14 @@ namespace clp_s {
  * In the current implementation of clp-s, MST node IDs must be unique in the ordered region of a
  * schema, but can be repeated in the unordered region. The caller is responsible for not inserting
  * duplicate MST nodes into the ordered region of a schema.
+ *
+ * A hash of the schema is updated as nodes are inserted, so that schemas can be interned without
+ * rehashing every node of each schema. Each entry is hashed independently and the entries' hashes
+ * are summed: entries in the ordered region are hashed by value alone, since their position is
+ * determined by the other entries, while entries in the unordered region are hashed along with
+ * their position in that region. The hash is only maintained by the methods which build a schema
+ * (the insert methods, `clear`, and the unordered object methods), and not when the schema is
+ * modified through its iterators, views, `resize`, or `set_num_ordered`.
  */
 class Schema {
 public:
@@ -52,6 +60,7 @@ public:
     void clear() {
         m_schema.clear();
         m_num_ordered = 0;
+        m_hash = 0;
     }
 
     /**
@@ -66,6 +75,11 @@ public:
      */
     [[nodiscard]] size_t get_num_ordered() const { return m_num_ordered; }
 
+    /**
+     * @return the hash of the schema
+     */
+    [[nodiscard]] size_t get_hash() const { return m_hash; }
+
     /**
      * @return the number of elements in the underlying schema
      */
@@ -163,7 +177,11 @@ public:
      * @param start_position
      */
     void end_unordered_object(size_t start_position) {
-        m_schema[start_position - 1] |= static_cast<int32_t>(m_schema.size() - start_position);
+        auto& delimiter = m_schema[start_position - 1];
+        auto const unordered_idx = start_position - 1 - m_num_ordered;
+        m_hash -= hash_unordered_entry(delimiter, unordered_idx);
+        delimiter |= static_cast<int32_t>(m_schema.size() - start_position);
+        m_hash += hash_unordered_entry(delimiter, unordered_idx);
     }
 
     /**
@@ -203,12 +221,48 @@ public:
     }
 
 private:
+    // Methods
+    /**
+     * Mixes the bits of a value so that similar values have dissimilar hashes (the finalizer of
+     * splitmix64).
+     * @param value
+     * @return The mixed value
+     */
+    static constexpr uint64_t mix(uint64_t value) {
+        value = (value ^ (value >> 30U)) * 0xbf58'476d'1ce4'e5b9ULL;
+        value = (value ^ (value >> 27U)) * 0x94d0'49bb'1331'11ebULL;
+        return value ^ (value >> 31U);
+    }
+
+    /**
+     * @param mst_node_id
+     * @return The hash of an entry in the ordered region of a schema
+     */
+    static size_t hash_ordered_entry(int32_t mst_node_id) {
+        return static_cast<size_t>(mix(static_cast<uint32_t>(mst_node_id)));
+    }
+
+    /**
+     * @param schema_entry
+     * @param unordered_idx The entry's position in the unordered region
+     * @return The hash of an entry in the unordered region of a schema
+     */
+    static size_t hash_unordered_entry(int32_t schema_entry, size_t unordered_idx) {
+        // Offsetting the position by one keeps the hashes of unordered entries distinct from the
+        // hashes of ordered entries
+        return static_cast<size_t>(
+                mix(((static_cast<uint64_t>(unordered_idx) + 1) << 32U)
+                    | static_cast<uint32_t>(schema_entry))
+        );
+    }
+
     static constexpr size_t cEncodedTypeOffset = (sizeof(int32_t) - 1) * 8;
     static constexpr int32_t cEncodedTypeBitmask = 0xFF00'0000;
     static constexpr int32_t cEncodedTypeLengthBitmask = ~cEncodedTypeBitmask;
 
     std::vector<int32_t> m_schema;
     size_t m_num_ordered{0};
+    size_t m_hash{0};
 };
 }  // namespace clp_s
 
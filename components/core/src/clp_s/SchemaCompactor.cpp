@@ -0,0 +1,54 @@
+#include "SchemaCompactor.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+
+namespace clp_s {
+auto SchemaCompactor::add_schema(std::span<int32_t const> columns) -> size_t {
+    m_num_shared_columns.resize(m_group_columns.size(), 0);
+    for (auto const column : columns) {
+        auto const it = m_column_to_groups.find(column);
+        if (m_column_to_groups.end() == it) {
+            continue;
+        }
+        for (auto const group_idx : it->second) {
+            if (0 == m_num_shared_columns[group_idx]++) {
+                m_candidate_groups.push_back(group_idx);
+            }
+        }
+    }
+
+    std::optional<size_t> best_group_idx;
+    double best_similarity{m_min_similarity};
+    for (auto const group_idx : m_candidate_groups) {
+        auto const num_shared_columns = m_num_shared_columns[group_idx];
+        auto const num_columns
+                = columns.size() + m_group_columns[group_idx].size() - num_shared_columns;
+        auto const similarity
+                = static_cast<double>(num_shared_columns) / static_cast<double>(num_columns);
+        if (similarity > best_similarity
+            || (false == best_group_idx.has_value() && similarity >= best_similarity))
+        {
+            best_group_idx = group_idx;
+            best_similarity = similarity;
+        }
+        m_num_shared_columns[group_idx] = 0;
+    }
+    m_candidate_groups.clear();
+
+    auto const group_idx = best_group_idx.value_or(m_group_columns.size());
+    if (m_group_columns.size() == group_idx) {
+        m_group_columns.emplace_back();
+        m_group_column_sets.emplace_back();
+    }
+    for (auto const column : columns) {
+        if (m_group_column_sets[group_idx].insert(column).second) {
+            m_group_columns[group_idx].push_back(column);
+            m_column_to_groups[column].push_back(group_idx);
+        }
+    }
+    return group_idx;
+}
+}  // namespace clp_s
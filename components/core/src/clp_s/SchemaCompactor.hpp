@@ -0,0 +1,62 @@
+#ifndef CLP_S_SCHEMACOMPACTOR_HPP
+#define CLP_S_SCHEMACOMPACTOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace clp_s {
+/**
+ * Groups schemas whose columns are similar, so that the tables of each group's schemas can be
+ * compacted into a single table which stores the union of their columns.
+ *
+ * Each schema joins the group whose columns are the most similar to its own, or starts a new group
+ * if no group is similar enough. Similarity is measured as the Jaccard index of the schema's
+ * columns and the union of the group's columns, i.e., the fraction of the columns in either which
+ * are in both.
+ */
+class SchemaCompactor {
+public:
+    // Constructors
+    /**
+     * @param min_similarity The minimum similarity of a schema to a group for it to join the group.
+     */
+    explicit SchemaCompactor(double min_similarity) : m_min_similarity{min_similarity} {}
+
+    // Methods
+    /**
+     * Adds a schema to the group whose columns are the most similar to its own, or to a new group.
+     * @param columns The IDs of the schema's columns, without duplicates.
+     * @return The index of the group that the schema was added to.
+     */
+    auto add_schema(std::span<int32_t const> columns) -> size_t;
+
+    [[nodiscard]] auto get_num_groups() const -> size_t { return m_group_columns.size(); }
+
+    /**
+     * @param group_idx
+     * @return The union of the columns of the group's schemas, in the order the columns were first
+     * added to the group.
+     */
+    [[nodiscard]] auto get_group_columns(size_t group_idx) const -> std::vector<int32_t> const& {
+        return m_group_columns[group_idx];
+    }
+
+private:
+    double m_min_similarity;
+    std::vector<std::vector<int32_t>> m_group_columns;
+    std::vector<std::unordered_set<int32_t>> m_group_column_sets;
+    // The groups containing each column, so that only groups sharing columns with a schema are
+    // compared with it
+    std::unordered_map<int32_t, std::vector<size_t>> m_column_to_groups;
+    // The number of columns each group shares with the schema being added, which is non-zero only
+    // for the groups in `m_candidate_groups`
+    std::vector<size_t> m_num_shared_columns;
+    std::vector<size_t> m_candidate_groups;
+};
+}  // namespace clp_s
+
+#endif  // CLP_S_SCHEMACOMPACTOR_HPP
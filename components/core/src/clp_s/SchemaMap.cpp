@@ -6,11 +6,10 @@
 
 namespace clp_s {
 int32_t SchemaMap::add_schema(Schema const& schema) {
-    auto const schema_it = m_schema_map.find(schema);
-    if (m_schema_map.end() != schema_it) {
+    auto const [schema_it, inserted] = m_schema_map.try_emplace(schema, m_current_schema_id);
+    if (false == inserted) {
         return schema_it->second;
     }
-    m_schema_map.emplace(schema, m_current_schema_id);
     return m_current_schema_id++;
 }
 
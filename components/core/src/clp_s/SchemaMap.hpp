@@ -1,15 +1,26 @@
 #ifndef CLP_S_SCHEMAMAP_HPP
 #define CLP_S_SCHEMAMAP_HPP
 
-#include <map>
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <unordered_map>
 
 #include "Schema.hpp"
 
 namespace clp_s {
 class SchemaMap {
 public:
-    using schema_map_t = std::map<Schema, int32_t>;
+    // Types
+    /**
+     * Hashes schemas using the hash that they maintain as they're built, so that looking up a
+     * schema only needs to compare it with the schemas which share its hash.
+     */
+    struct SchemaHash {
+        size_t operator()(Schema const& schema) const { return schema.get_hash(); }
+    };
+
+    using schema_map_t = std::unordered_map<Schema, int32_t, SchemaHash>;
 
     // Constructor
     SchemaMap() : m_current_schema_id(0) {}
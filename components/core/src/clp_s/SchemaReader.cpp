@@ -1,7 +1,9 @@
 #include "SchemaReader.hpp"
 
+#include <memory>
 #include <stack>
 #include <string>
+#include <utility>
 
 #include "archive_constants.hpp"
 #include "BufferViewReader.hpp"
@@ -17,6 +19,14 @@ void SchemaReader::append_unordered_column(BaseColumnReader* column_reader) {
     m_columns.push_back(column_reader);
 }
 
+auto SchemaReader::get_ordered_column(int32_t column_id) const -> BaseColumnReader* {
+    auto const it = m_column_map.find(column_id);
+    if (m_column_map.end() == it) {
+        return nullptr;
+    }
+    return it->second;
+}
+
 void SchemaReader::mark_column_as_timestamp(BaseColumnReader* column_reader) {
     m_timestamp_column = column_reader;
     if (m_timestamp_column->get_type() == NodeType::DateString) {
@@ -181,7 +191,7 @@ void SchemaReader::generate_json_string() {
 }
 
 bool SchemaReader::get_next_message(std::string& message) {
-    if (m_cur_message >= m_num_messages) {
+    if (done()) {
         return false;
     }
 
@@ -201,7 +211,7 @@ bool SchemaReader::get_next_message(std::string& message) {
 }
 
 bool SchemaReader::get_next_message(std::string& message, FilterClass* filter) {
-    while (m_cur_message < m_num_messages) {
+    while (false == done()) {
         if (false == filter->filter(m_cur_message)) {
             m_cur_message++;
             continue;
@@ -230,12 +240,14 @@ bool SchemaReader::get_next_message_with_metadata(
         std::string& message,
         epochtime_t& timestamp,
         int64_t& log_event_idx,
-        FilterClass* filter
+        FilterClass* filter,
+        std::optional<epochtime_t> min_exclusive_timestamp
 ) {
-    // TODO: If we already get max_num_results messages, we can skip messages
-    // with the timestamp less than the smallest timestamp in the priority queue
-    while (m_cur_message < m_num_messages) {
-        if (false == filter->filter(m_cur_message)) {
+    while (false == done()) {
+        if ((min_exclusive_timestamp.has_value()
+             && m_get_timestamp() <= min_exclusive_timestamp.value())
+            || false == filter->filter(m_cur_message))
+        {
             m_cur_message++;
             continue;
         }
@@ -661,4 +673,33 @@ void SchemaReader::generate_json_template(int32_t id) {
         }
     }
 }
+
+void CompactedTableReader::append_column(BaseColumnReader* column_reader) {
+    m_column_map[column_reader->get_id()] = column_reader;
+    m_columns.emplace_back(column_reader);
+}
+
+auto CompactedTableReader::get_column(int32_t column_id) const -> BaseColumnReader* {
+    auto const it = m_column_map.find(column_id);
+    if (m_column_map.end() == it) {
+        return nullptr;
+    }
+    return it->second;
+}
+
+void CompactedTableReader::load(
+        std::shared_ptr<char[]> stream_buffer,
+        size_t offset,
+        size_t uncompressed_size,
+        uint64_t num_messages
+) {
+    m_stream_buffer = std::move(stream_buffer);
+    BufferViewReader buffer_reader{m_stream_buffer.get() + offset, uncompressed_size};
+    for (auto& reader : m_columns) {
+        reader->load(buffer_reader, num_messages);
+    }
+    if (buffer_reader.get_remaining_size() > 0) {
+        throw SchemaReader::OperationFailed(ErrorCodeCorrupt, __FILENAME__, __LINE__);
+    }
+}
 }  // namespace clp_s
@@ -1,12 +1,15 @@
 #ifndef CLP_S_SCHEMAREADER_HPP
 #define CLP_S_SCHEMAREADER_HPP
 
+#include <algorithm>
 #include <memory>
+#include <optional>
 #include <span>
 #include <string>
 #include <type_traits>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "ColumnReader.hpp"
 #include "FileReader.hpp"
@@ -16,6 +19,7 @@
 #include "ZstdDecompressor.hpp"
 
 namespace clp_s {
+class CompactedTableReader;
 class SchemaReader;
 
 class FilterClass {
@@ -68,6 +72,10 @@ public:
     ~SchemaReader() { delete_columns(); }
 
     void delete_columns() {
+        // The columns of a compacted table are owned by the table
+        if (nullptr != m_compacted_table) {
+            return;
+        }
         for (auto& i : m_columns) {
             delete i;
         }
@@ -99,6 +107,8 @@ public:
         m_serializer_initialized = false;
         m_ordered_schema = ordered_schema;
         delete_columns();
+        m_compacted_table.reset();
+        m_first_message = 0;
         m_column_map.clear();
         m_columns.clear();
         m_reordered_columns.clear();
@@ -115,6 +125,22 @@ public:
         m_should_marshal_records = should_marshal_records;
     }
 
+    /**
+     * Makes the schema reader read its records from a loaded table shared with other schemas
+     * instead of loading its own columns. Must be called before the table's columns are appended
+     * to the schema reader, since the schema reader doesn't take ownership of them.
+     * @param compacted_table
+     * @param first_message The index of the schema's first record in the table
+     */
+    void use_compacted_table(
+            std::shared_ptr<CompactedTableReader> compacted_table,
+            uint64_t first_message
+    ) {
+        m_compacted_table = std::move(compacted_table);
+        m_first_message = first_message;
+        m_cur_message = first_message;
+    }
+
     /**
      * Appends a column to the schema reader
      * @param column_reader
@@ -129,6 +155,13 @@ public:
 
     size_t get_column_size() { return m_columns.size(); }
 
+    /**
+     * @param column_id
+     * @return The reader for the ordered column with the given ID, or nullptr if the schema doesn't
+     * contain it.
+     */
+    [[nodiscard]] auto get_ordered_column(int32_t column_id) const -> BaseColumnReader*;
+
     /**
      * Marks an unordered object for the purpose of marshalling records.
      * @param column_reader_start,
@@ -175,13 +208,16 @@ public:
      * @param timestamp
      * @param log_event_idx
      * @param filter
+     * @param min_exclusive_timestamp If set, messages with a timestamp less than or equal to it are
+     * skipped without being filtered
      * @return true if there is a next message
      */
     bool get_next_message_with_metadata(
             std::string& message,
             epochtime_t& timestamp,
             int64_t& log_event_idx,
-            FilterClass* filter
+            FilterClass* filter,
+            std::optional<epochtime_t> min_exclusive_timestamp = std::nullopt
     );
 
     /**
@@ -233,7 +269,26 @@ public:
     /**
      * @return true if all records in this table have been iterated over, false otherwise
      */
-    bool done() const { return m_cur_message >= m_num_messages; }
+    bool done() const { return m_cur_message >= m_first_message + m_num_messages; }
+
+    /**
+     * @return the index in the column readers of the message most recently returned by
+     * `get_next_message`
+     */
+    uint64_t get_prev_message_column_idx() const { return m_cur_message - 1; }
+
+    /**
+     * @return the index of the next message to be read
+     */
+    uint64_t get_next_message_idx() const { return m_cur_message - m_first_message; }
+
+    /**
+     * Sets the index of the next message to be read, clamped to the number of messages
+     * @param message_idx
+     */
+    void seek_to_message(uint64_t message_idx) {
+        m_cur_message = m_first_message + std::min(message_idx, m_num_messages);
+    }
 
 private:
     /**
@@ -311,7 +366,11 @@ private:
 
     int32_t m_schema_id;
     uint64_t m_num_messages;
+    // The index of the row in the columns which holds the next message, which is offset by
+    // `m_first_message` when the schema's records are stored in a compacted table
     uint64_t m_cur_message;
+    uint64_t m_first_message{0};
+    std::shared_ptr<CompactedTableReader> m_compacted_table;
     std::span<int32_t> m_ordered_schema;
 
     std::unordered_map<int32_t, BaseColumnReader*> m_column_map;
@@ -335,6 +394,47 @@ private:
 
     std::map<int32_t, std::pair<size_t, std::span<int32_t>>> m_global_id_to_unordered_object;
 };
+
+/**
+ * The columns of a table shared by several schemas whose tables were compacted into it. The
+ * columns are loaded once and shared by the schema readers of each of the schemas, which each read
+ * the consecutive rows holding their schema's records.
+ */
+class CompactedTableReader {
+public:
+    // Methods
+    /**
+     * Appends a column to the table, taking ownership of it.
+     * @param column_reader
+     */
+    void append_column(BaseColumnReader* column_reader);
+
+    /**
+     * @param column_id
+     * @return the reader of the column with the given ID, or nullptr if the table doesn't have one
+     */
+    [[nodiscard]] auto get_column(int32_t column_id) const -> BaseColumnReader*;
+
+    /**
+     * Loads the encoded messages from a shared buffer starting at a given offset
+     * @param stream_buffer
+     * @param offset
+     * @param uncompressed_size
+     * @param num_messages The total number of records of every schema in the table
+     * @throw SchemaReader::OperationFailed if the table's size doesn't match its columns
+     */
+    void load(
+            std::shared_ptr<char[]> stream_buffer,
+            size_t offset,
+            size_t uncompressed_size,
+            uint64_t num_messages
+    );
+
+private:
+    std::vector<std::unique_ptr<BaseColumnReader>> m_columns;
+    std::unordered_map<int32_t, BaseColumnReader*> m_column_map;
+    std::shared_ptr<char[]> m_stream_buffer;
+};
 }  // namespace clp_s
 
 #endif  // CLP_S_SCHEMAREADER_HPP
@@ -1,5 +1,7 @@
 #include "SchemaWriter.hpp"
 
+#include <cstdint>
+#include <unordered_map>
 #include <utility>
 
 namespace clp_s {
@@ -26,6 +28,22 @@ size_t SchemaWriter::append_message(ParsedMessage& message) {
     return total_size;
 }
 
+void SchemaWriter::append_messages(SchemaWriter& schema_writer) {
+    std::unordered_map<int32_t, BaseColumnWriter*> id_to_column;
+    for (auto* column : schema_writer.m_columns) {
+        id_to_column.emplace(column->get_id(), column);
+    }
+    for (auto* column : m_columns) {
+        if (auto it = id_to_column.find(column->get_id()); id_to_column.end() != it) {
+            column->merge(*it->second);
+        } else {
+            column->add_placeholders(schema_writer.m_num_messages);
+        }
+    }
+    m_num_messages += schema_writer.m_num_messages;
+    m_total_uncompressed_size += schema_writer.m_total_uncompressed_size;
+}
+
 void SchemaWriter::store(ZstdCompressor& compressor) {
     for (auto& writer : m_columns) {
         writer->store(compressor);
@@ -37,6 +37,14 @@ public:
      */
     size_t append_message(ParsedMessage& message);
 
+    /**
+     * Appends the messages of another schema writer whose columns are a subset of this schema
+     * writer's columns. Columns which the other schema writer doesn't contain are filled with
+     * placeholder values.
+     * @param schema_writer
+     */
+    void append_messages(SchemaWriter& schema_writer);
+
     /**
      * Stores the columns to disk.
      * @param compressor
@@ -45,6 +53,11 @@ public:
 
     uint64_t get_num_messages() const { return m_num_messages; }
 
+    /**
+     * @return the columns of the schema writer, in the order they were appended
+     */
+    std::vector<BaseColumnWriter*> const& get_columns() const { return m_columns; }
+
     /**
      * @return the uncompressed in-memory size of the data that will be written to the compressor
      */
@@ -5,13 +5,31 @@
 #include <string>
 #include <vector>
 
+#include "Defs.hpp"
 #include "msgpack.hpp"
 
 namespace clp_s {
 // define the version
 constexpr uint8_t cArchiveMajorVersion = 0;
-constexpr uint8_t cArchiveMinorVersion = 3;
-constexpr uint16_t cArchivePatchVersion = 2;
+constexpr uint8_t cArchiveMinorVersion = 4;
+constexpr uint16_t cArchivePatchVersion = 0;
+
+/**
+ * @param major
+ * @param minor
+ * @param patch
+ * @return The archive version with the given components, as stored in `ArchiveHeader::version`
+ */
+constexpr auto make_archive_version(uint8_t major, uint8_t minor, uint16_t patch) -> uint32_t {
+    return (static_cast<uint32_t>(major) << 24) | (static_cast<uint32_t>(minor) << 16) | patch;
+}
+
+constexpr uint32_t cArchiveVersion
+        = make_archive_version(cArchiveMajorVersion, cArchiveMinorVersion, cArchivePatchVersion);
+
+// The first version whose integer, float, and unstructured array columns are prefixed by their
+// encoding (`IntegerEncoding`, `FloatEncoding`, and `ArrayEncoding` respectively)
+constexpr uint32_t cColumnEncodingArchiveVersion = make_archive_version(0, 4, 0);
 
 // define the magic number
 constexpr uint8_t cStructuredSFAMagicNumber[] = {0xFD, 0x2F, 0xC5, 0x30};
@@ -35,7 +53,11 @@ enum struct ArchiveMetadataPacketType : uint8_t {
     ArchiveInfo = 0,
     ArchiveFileInfo = 1,
     TimestampDictionary = 2,
-    RangeIndex = 3
+    RangeIndex = 3,
+    TableLogEventIdxRanges = 4,
+    TableTimestampRanges = 5,
+    CompressionDictionary = 6,
+    CompactedTables = 7
 };
 
 struct ArchiveInfoPacket {
@@ -57,6 +79,40 @@ struct ArchiveFileInfoPacket {
 
     MSGPACK_DEFINE_MAP(files);
 };
+
+/**
+ * The range of log event indices, [begin, end), contained in each table of the archive. Stored as
+ * parallel arrays indexed by table.
+ */
+struct TableLogEventIdxRangesPacket {
+    std::vector<int32_t> schema_ids;
+    std::vector<int64_t> begin_log_event_idxs;
+    std::vector<int64_t> end_log_event_idxs;
+
+    MSGPACK_DEFINE_MAP(schema_ids, begin_log_event_idxs, end_log_event_idxs);
+};
+
+/**
+ * The range of timestamps, [begin, end], of the records in each table of the archive that has a
+ * timestamp column. Stored as parallel arrays indexed by table.
+ */
+struct TableTimestampRangesPacket {
+    std::vector<int32_t> schema_ids;
+    std::vector<epochtime_t> begin_timestamps;
+    std::vector<epochtime_t> end_timestamps;
+
+    MSGPACK_DEFINE_MAP(schema_ids, begin_timestamps, end_timestamps);
+};
+
+/**
+ * The schemas whose tables were compacted into a table shared with other schemas. The schemas of
+ * each shared table are listed in the order that their records are stored in it.
+ */
+struct CompactedTablesPacket {
+    std::vector<std::vector<int32_t>> schema_ids;
+
+    MSGPACK_DEFINE_MAP(schema_ids);
+};
 }  // namespace clp_s
 
 #endif  // CLP_S_ARCHIVEDEFS_HPP
@@ -53,12 +53,29 @@ epochtime_t TimestampDictionaryWriter::ingest_entry(
     size_t timestamp_begin_pos = 0, timestamp_end_pos = 0;
     TimestampPattern const* pattern{nullptr};
 
-    // Try parsing the timestamp as one of the previously seen timestamp patterns
-    for (auto it : m_pattern_to_id) {
-        if (it.first->parse_timestamp(timestamp, ret, timestamp_begin_pos, timestamp_end_pos)) {
-            pattern = it.first;
-            pattern_id = it.second;
-            break;
+    // Try parsing the timestamp as the most recently matched pattern first since consecutive
+    // timestamps almost always share a pattern
+    if (nullptr != m_last_matched_pattern
+        && m_last_matched_pattern
+                   ->parse_timestamp(timestamp, ret, timestamp_begin_pos, timestamp_end_pos))
+    {
+        pattern = m_last_matched_pattern;
+        pattern_id = m_last_matched_pattern_id;
+    }
+
+    // Then try parsing the timestamp as one of the other previously seen timestamp patterns
+    if (nullptr == pattern) {
+        for (auto const& [seen_pattern, seen_pattern_id] : m_pattern_to_id) {
+            if (seen_pattern == m_last_matched_pattern) {
+                continue;
+            }
+            if (seen_pattern
+                        ->parse_timestamp(timestamp, ret, timestamp_begin_pos, timestamp_end_pos))
+            {
+                pattern = seen_pattern;
+                pattern_id = seen_pattern_id;
+                break;
+            }
         }
     }
 
@@ -76,6 +93,8 @@ epochtime_t TimestampDictionaryWriter::ingest_entry(
     if (nullptr == pattern) {
         throw OperationFailed(ErrorCodeFailure, __FILE__, __LINE__);
     }
+    m_last_matched_pattern = pattern;
+    m_last_matched_pattern_id = pattern_id;
 
     auto entry = m_column_id_to_range.find(node_id);
     if (entry == m_column_id_to_range.end()) {
@@ -151,6 +170,8 @@ epochtime_t TimestampDictionaryWriter::get_end_timestamp() const {
 void TimestampDictionaryWriter::clear() {
     m_next_id = 0;
     m_pattern_to_id.clear();
+    m_last_matched_pattern = nullptr;
+    m_last_matched_pattern_id = 0;
     m_column_key_to_range.clear();
     m_column_id_to_range.clear();
 }
@@ -107,6 +107,8 @@ private:
     // Variables
     pattern_to_id_t m_pattern_to_id;
     uint64_t m_next_id{};
+    TimestampPattern const* m_last_matched_pattern{nullptr};
+    uint64_t m_last_matched_pattern_id{};
 
     std::map<std::string, TimestampEntry> m_column_key_to_range;
     std::unordered_map<int32_t, TimestampEntry> m_column_id_to_range;
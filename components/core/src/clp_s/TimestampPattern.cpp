@@ -2,6 +2,7 @@
 
 #include "TimestampPattern.hpp"
 
+#include <array>
 #include <chrono>
 #include <cstring>
 #include <string>
@@ -24,6 +25,14 @@ std::unique_ptr<TimestampPattern[]> TimestampPattern::m_known_ts_patterns = null
 size_t TimestampPattern::m_known_ts_patterns_len = 0;
 
 // File-scope constants
+// Character classes in a pattern's signature. Any other character in a signature must match
+// literally.
+static constexpr char cSignatureDigit = '\x01';
+static constexpr char cSignatureAlpha = '\x02';
+static constexpr char cSignatureSpaceOrDigit = '\x03';
+// Maximum number of spaces before a timestamp for which the timestamp's beginning is precomputed
+// when searching the known patterns
+static constexpr size_t cMaxPrecomputedNumSpacesBeforeTs = 8;
 static constexpr int cNumDaysInWeek = 7;
 static char const* cAbbrevDaysOfWeek[cNumDaysInWeek]
         = {"Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"};
@@ -318,11 +327,34 @@ TimestampPattern const* TimestampPattern::search_known_ts_patterns(
         size_t& timestamp_begin_pos,
         size_t& timestamp_end_pos
 ) {
+    // Find where the timestamp would begin for each number of spaces before it in one pass over
+    // the line, rather than once per pattern
+    std::array<size_t, cMaxPrecomputedNumSpacesBeforeTs + 1> ts_begin_ixs{};
+    ts_begin_ixs.fill(string::npos);
+    ts_begin_ixs[0] = 0;
+    size_t num_spaces_found = 0;
+    for (size_t line_ix = 0;
+         line_ix < line.length() && num_spaces_found < cMaxPrecomputedNumSpacesBeforeTs;
+         ++line_ix)
+    {
+        if (' ' == line[line_ix]) {
+            ++num_spaces_found;
+            ts_begin_ixs[num_spaces_found] = line_ix + 1;
+        }
+    }
+
     for (size_t i = 0; i < m_known_ts_patterns_len; ++i) {
-        if (m_known_ts_patterns[i]
-                    .parse_timestamp(line, timestamp, timestamp_begin_pos, timestamp_end_pos))
-        {
-            return &m_known_ts_patterns[i];
+        auto const& pattern = m_known_ts_patterns[i];
+        if (pattern.m_num_spaces_before_ts <= cMaxPrecomputedNumSpacesBeforeTs) {
+            auto const ts_begin_ix = ts_begin_ixs[pattern.m_num_spaces_before_ts];
+            if (string::npos == ts_begin_ix
+                || false == pattern.matches_signature(line, ts_begin_ix))
+            {
+                continue;
+            }
+        }
+        if (pattern.parse_timestamp(line, timestamp, timestamp_begin_pos, timestamp_end_pos)) {
+            return &pattern;
         }
     }
 
@@ -346,6 +378,93 @@ bool TimestampPattern::is_empty() const {
 void TimestampPattern::clear() {
     m_num_spaces_before_ts = 0;
     m_format.clear();
+    m_signature.clear();
+}
+
+string TimestampPattern::compile_signature(string_view format) {
+    string signature;
+    bool is_specifier = false;
+    for (auto const c : format) {
+        if (false == is_specifier) {
+            if ('%' == c) {
+                is_specifier = true;
+            } else {
+                signature.push_back(c);
+            }
+            continue;
+        }
+
+        is_specifier = false;
+        switch (c) {
+            case '%':
+                signature.push_back('%');
+                break;
+            case 'y':
+            case 'm':
+            case 'd':
+            case 'H':
+            case 'I':
+            case 'M':
+            case 'S':
+                signature.append(2, cSignatureDigit);
+                break;
+            case 'Y':
+                signature.append(4, cSignatureDigit);
+                break;
+            case '3':
+                signature.append(3, cSignatureDigit);
+                break;
+            case 'e':
+            case 'k':
+            case 'l':
+                signature.append(2, cSignatureSpaceOrDigit);
+                break;
+            case 'a':
+            case 'b':
+                signature.append(3, cSignatureAlpha);
+                break;
+            case 'p':
+                signature.append(2, cSignatureAlpha);
+                break;
+            default:
+                // Variable-width field
+                return signature;
+        }
+    }
+    return signature;
+}
+
+bool TimestampPattern::matches_signature(string_view line, size_t ts_begin_ix) const {
+    if (ts_begin_ix + m_signature.length() > line.length()) {
+        return false;
+    }
+    for (size_t i = 0; i < m_signature.length(); ++i) {
+        char const c = line[ts_begin_ix + i];
+        bool const is_digit = '0' <= c && c <= '9';
+        switch (m_signature[i]) {
+            case cSignatureDigit:
+                if (false == is_digit) {
+                    return false;
+                }
+                break;
+            case cSignatureAlpha:
+                if (false == (('a' <= c && c <= 'z') || ('A' <= c && c <= 'Z'))) {
+                    return false;
+                }
+                break;
+            case cSignatureSpaceOrDigit:
+                if (false == is_digit && ' ' != c) {
+                    return false;
+                }
+                break;
+            default:
+                if (m_signature[i] != c) {
+                    return false;
+                }
+                break;
+        }
+    }
+    return true;
 }
 
 bool TimestampPattern::parse_timestamp(
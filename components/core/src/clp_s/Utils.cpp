@@ -162,7 +162,7 @@ bool UriUtils::get_last_uri_component(std::string_view const uri, std::string& n
     return true;
 }
 
-bool StringUtils::get_bounds_of_next_var(string const& msg, size_t& begin_pos, size_t& end_pos) {
+bool StringUtils::get_bounds_of_next_var(string_view msg, size_t& begin_pos, size_t& end_pos) {
     auto const msg_length = msg.length();
     if (end_pos >= msg_length) {
         return false;
@@ -126,7 +126,7 @@ public:
      * @param end_pos End position of last variable, changes to end position of next variable
      * @return true if a variable was found, false otherwise
      */
-    static bool get_bounds_of_next_var(std::string const& msg, size_t& begin_pos, size_t& end_pos);
+    static bool get_bounds_of_next_var(std::string_view msg, size_t& begin_pos, size_t& end_pos);
 
     /**
      * Searches haystack starting at the given position for one of the given needles
@@ -366,6 +366,16 @@ public:
         return {m_begin + start * sizeof(T), size};
     }
 
+    /**
+     * Copies a range of the span's elements into an (aligned) buffer.
+     * @param start
+     * @param size
+     * @param dest
+     */
+    void copy_to(size_t start, size_t size, T* dest) {
+        memcpy(dest, m_begin + start * sizeof(T), size * sizeof(T));
+    }
+
 private:
     char* m_begin{nullptr};
     size_t m_size{0};
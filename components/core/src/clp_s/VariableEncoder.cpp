@@ -4,7 +4,7 @@
 
 namespace clp_s {
 void VariableEncoder::encode_and_add_to_dictionary(
-        std::string const& message,
+        std::string_view message,
         LogTypeDictionaryEntry& logtype_dict_entry,
         VariableDictionaryWriter& var_dict,
         std::vector<int64_t>& encoded_vars
@@ -4,6 +4,7 @@
 #define CLP_S_VARIABLEENCODER_HPP
 
 #include <string>
+#include <string_view>
 
 #include "DictionaryEntry.hpp"
 #include "DictionaryWriter.hpp"
@@ -19,7 +20,7 @@ public:
      * @param encoded_vars
      */
     static void encode_and_add_to_dictionary(
-            std::string const& message,
+            std::string_view message,
             LogTypeDictionaryEntry& logtype_dict_entry,
             VariableDictionaryWriter& var_dict,
             std::vector<int64_t>& encoded_vars
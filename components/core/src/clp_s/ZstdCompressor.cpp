@@ -19,7 +19,11 @@ ZstdCompressor::~ZstdCompressor() {
     ZSTD_freeCStream(m_compression_stream);
 }
 
-void ZstdCompressor::open(FileWriter& file_writer, int const compression_level) {
+void ZstdCompressor::open(
+        FileWriter& file_writer,
+        int const compression_level,
+        ZstdCompressionDictionary const* dictionary
+) {
     if (nullptr != m_compressed_stream_file_writer) {
         throw OperationFailed(ErrorCodeNotReady, __FILENAME__, __LINE__);
     }
@@ -39,6 +43,16 @@ void ZstdCompressor::open(FileWriter& file_writer, int const compression_level)
         );
         throw OperationFailed(ErrorCodeFailure, __FILENAME__, __LINE__);
     }
+    if (nullptr != dictionary) {
+        auto const ref_result = ZSTD_CCtx_refCDict(m_compression_stream, dictionary->get());
+        if (ZSTD_isError(ref_result)) {
+            SPDLOG_ERROR(
+                    "ZstdCompressor: ZSTD_CCtx_refCDict() error: {}",
+                    ZSTD_getErrorName(ref_result)
+            );
+            throw OperationFailed(ErrorCodeFailure, __FILENAME__, __LINE__);
+        }
+    }
 
     m_compressed_stream_file_writer = &file_writer;
 
@@ -12,6 +12,7 @@
 #include "Compressor.hpp"
 #include "FileWriter.hpp"
 #include "TraceableException.hpp"
+#include "ZstdDictionary.hpp"
 
 namespace clp_s {
 constexpr int cDefaultCompressionLevel = 3;
@@ -76,8 +77,19 @@ public:
      * Initialize streaming compressor
      * @param file_writer
      * @param compression_level
+     * @param dictionary The dictionary to compress with, or nullptr to compress without one. It
+     * must outlive the compressor's use of it.
      */
-    void open(FileWriter& file_writer, int compression_level = cDefaultCompressionLevel);
+    void open(
+            FileWriter& file_writer,
+            int compression_level = cDefaultCompressionLevel,
+            ZstdCompressionDictionary const* dictionary = nullptr
+    );
+
+    /**
+     * @return The number of uncompressed bytes written since the compressor was opened
+     */
+    [[nodiscard]] size_t get_pos() const { return m_uncompressed_stream_pos; }
 
 private:
     // Variables
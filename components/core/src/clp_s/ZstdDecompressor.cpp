@@ -308,6 +308,17 @@ void ZstdDecompressor::reset_stream() {
     }
 
     ZSTD_initDStream(m_decompression_stream);
+    if (nullptr != m_dictionary) {
+        // Initializing the stream drops its dictionary, so it's referenced again for each stream
+        auto const ref_result = ZSTD_DCtx_refDDict(m_decompression_stream, m_dictionary->get());
+        if (ZSTD_isError(ref_result)) {
+            SPDLOG_ERROR(
+                    "ZstdDecompressor: ZSTD_DCtx_refDDict() error: {}",
+                    ZSTD_getErrorName(ref_result)
+            );
+            throw OperationFailed(ErrorCodeFailure, __FILENAME__, __LINE__);
+        }
+    }
     m_decompressed_stream_pos = 0;
 
     m_compressed_stream_block.pos = 0;
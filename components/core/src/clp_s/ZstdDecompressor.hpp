@@ -12,6 +12,7 @@
 #include "../clp/ReaderInterface.hpp"
 #include "Decompressor.hpp"
 #include "TraceableException.hpp"
+#include "ZstdDictionary.hpp"
 
 namespace clp_s {
 class ZstdDecompressor : public Decompressor {
@@ -54,6 +55,15 @@ public:
     void close_for_reuse();
 
     // Methods
+    /**
+     * Sets the dictionary to decompress streams opened after this call with.
+     * @param dictionary The dictionary, or nullptr to decompress without one. It must outlive the
+     * decompressor's use of it.
+     */
+    void set_dictionary(ZstdDecompressionDictionary const* dictionary) {
+        m_dictionary = dictionary;
+    }
+
     /***
      * Initialize streaming decompressor to decompress from a compressed file specified by the given
      * path
@@ -128,6 +138,7 @@ private:
 
     // Compressed stream variables
     ZSTD_DStream* m_decompression_stream;
+    ZstdDecompressionDictionary const* m_dictionary{nullptr};
 
     boost::iostreams::mapped_file_source m_memory_mapped_compressed_file;
     FileReader* m_file_reader;
@@ -0,0 +1,74 @@
+#include "ZstdDictionary.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#include <spdlog/spdlog.h>
+#include <zdict.h>
+#include <zstd.h>
+
+#include "ErrorCode.hpp"
+
+namespace clp_s {
+ZstdCompressionDictionary::ZstdCompressionDictionary(
+        std::string_view dictionary,
+        int compression_level
+)
+        : m_dictionary{ZSTD_createCDict(dictionary.data(), dictionary.size(), compression_level)} {
+    if (nullptr == m_dictionary) {
+        SPDLOG_ERROR("ZstdCompressionDictionary: ZSTD_createCDict() error");
+        throw OperationFailed(ErrorCodeFailure, __FILENAME__, __LINE__);
+    }
+}
+
+ZstdDecompressionDictionary::ZstdDecompressionDictionary(std::string_view dictionary)
+        : m_dictionary{ZSTD_createDDict(dictionary.data(), dictionary.size())} {
+    if (nullptr == m_dictionary) {
+        SPDLOG_ERROR("ZstdDecompressionDictionary: ZSTD_createDDict() error");
+        throw OperationFailed(ErrorCodeFailure, __FILENAME__, __LINE__);
+    }
+}
+
+ZstdDictionaryTrainer::ZstdDictionaryTrainer(size_t max_dictionary_size, size_t total_data_size)
+        : m_max_dictionary_size{max_dictionary_size},
+          m_max_samples_size{max_dictionary_size * cSamplesPerByte} {
+    auto const num_samples = (total_data_size + cSampleSize - 1) / cSampleSize;
+    auto const max_num_samples = std::max<size_t>(m_max_samples_size / cSampleSize, 1);
+    m_sample_stride = std::max<size_t>((num_samples + max_num_samples - 1) / max_num_samples, 1);
+}
+
+void ZstdDictionaryTrainer::add_data(char const* data, size_t size) {
+    for (size_t offset{0}; offset < size; offset += cSampleSize) {
+        auto const sample_size = std::min(cSampleSize, size - offset);
+        auto const is_sample_kept{0 == m_num_samples_seen % m_sample_stride};
+        ++m_num_samples_seen;
+        if (is_sample_kept && m_samples.size() + sample_size <= m_max_samples_size) {
+            m_samples.append(data + offset, sample_size);
+            m_sample_sizes.push_back(sample_size);
+        }
+    }
+}
+
+auto ZstdDictionaryTrainer::train() const -> std::string {
+    if (m_sample_sizes.empty()) {
+        return {};
+    }
+    std::string dictionary(m_max_dictionary_size, '\0');
+    auto const dictionary_size = ZDICT_trainFromBuffer(
+            dictionary.data(),
+            dictionary.size(),
+            m_samples.data(),
+            m_sample_sizes.data(),
+            static_cast<unsigned>(m_sample_sizes.size())
+    );
+    if (ZDICT_isError(dictionary_size)) {
+        // Training fails when there are too few samples, in which case the data is too small to
+        // benefit from a dictionary
+        return {};
+    }
+    dictionary.resize(dictionary_size);
+    return dictionary;
+}
+}  // namespace clp_s
@@ -0,0 +1,134 @@
+#ifndef CLP_S_ZSTDDICTIONARY_HPP
+#define CLP_S_ZSTDDICTIONARY_HPP
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <zstd.h>
+
+#include "ErrorCode.hpp"
+#include "TraceableException.hpp"
+
+namespace clp_s {
+/**
+ * A zstd dictionary digested for compression at a given level, so that it can be shared by every
+ * stream compressed with it without being digested again.
+ */
+class ZstdCompressionDictionary {
+public:
+    // Types
+    class OperationFailed : public TraceableException {
+    public:
+        // Constructors
+        OperationFailed(ErrorCode error_code, char const* const filename, int line_number)
+                : TraceableException(error_code, filename, line_number) {}
+    };
+
+    // Constructors
+    /**
+     * @param dictionary
+     * @param compression_level
+     * @throw OperationFailed if the dictionary can't be digested
+     */
+    ZstdCompressionDictionary(std::string_view dictionary, int compression_level);
+
+    // Destructor
+    ~ZstdCompressionDictionary() { ZSTD_freeCDict(m_dictionary); }
+
+    // Explicitly disable copy and move constructor/assignment
+    ZstdCompressionDictionary(ZstdCompressionDictionary const&) = delete;
+
+    auto operator=(ZstdCompressionDictionary const&) -> ZstdCompressionDictionary& = delete;
+
+    // Methods
+    [[nodiscard]] auto get() const -> ZSTD_CDict const* { return m_dictionary; }
+
+private:
+    ZSTD_CDict* m_dictionary;
+};
+
+/**
+ * A zstd dictionary digested for decompression, so that it can be shared by every stream
+ * decompressed with it without being digested again.
+ */
+class ZstdDecompressionDictionary {
+public:
+    // Types
+    class OperationFailed : public TraceableException {
+    public:
+        // Constructors
+        OperationFailed(ErrorCode error_code, char const* const filename, int line_number)
+                : TraceableException(error_code, filename, line_number) {}
+    };
+
+    // Constructors
+    /**
+     * @param dictionary
+     * @throw OperationFailed if the dictionary can't be digested
+     */
+    explicit ZstdDecompressionDictionary(std::string_view dictionary);
+
+    // Destructor
+    ~ZstdDecompressionDictionary() { ZSTD_freeDDict(m_dictionary); }
+
+    // Explicitly disable copy and move constructor/assignment
+    ZstdDecompressionDictionary(ZstdDecompressionDictionary const&) = delete;
+
+    auto operator=(ZstdDecompressionDictionary const&) -> ZstdDecompressionDictionary& = delete;
+
+    // Methods
+    [[nodiscard]] auto get() const -> ZSTD_DDict const* { return m_dictionary; }
+
+private:
+    ZSTD_DDict* m_dictionary;
+};
+
+/**
+ * Trains a zstd dictionary on samples of the data that will be compressed with it.
+ *
+ * The data is split into samples of `cSampleSize` bytes, and the samples which are kept are spread
+ * evenly across all of the data, so that the samples fit within a budget of `cSamplesPerByte`
+ * bytes of samples per byte of the dictionary.
+ */
+class ZstdDictionaryTrainer {
+public:
+    // Constants
+    static constexpr size_t cSampleSize{4096};
+    // zstd recommends training on about 100 times as many bytes as the dictionary's size
+    static constexpr size_t cSamplesPerByte{100};
+
+    // Constructors
+    /**
+     * @param max_dictionary_size
+     * @param total_data_size The total size of the data that will be added.
+     */
+    ZstdDictionaryTrainer(size_t max_dictionary_size, size_t total_data_size);
+
+    // Methods
+    /**
+     * Adds data to take samples from.
+     * @param data
+     * @param size
+     */
+    void add_data(char const* data, size_t size);
+
+    /**
+     * @return The trained dictionary, or an empty string if there weren't enough samples to train
+     * one.
+     */
+    [[nodiscard]] auto train() const -> std::string;
+
+private:
+    size_t m_max_dictionary_size;
+    size_t m_max_samples_size;
+    // Every `m_sample_stride`-th sample is kept
+    size_t m_sample_stride;
+    size_t m_num_samples_seen{0};
+    std::string m_samples;
+    std::vector<size_t> m_sample_sizes;
+};
+}  // namespace clp_s
+
+#endif  // CLP_S_ZSTDDICTIONARY_HPP
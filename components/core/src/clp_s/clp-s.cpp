@@ -1,12 +1,15 @@
+#include <cstdint>
 #include <cstdlib>
 #include <exception>
 #include <filesystem>
 #include <iostream>
 #include <memory>
+#include <optional>
 #include <sstream>
 #include <string>
 #include <system_error>
 #include <utility>
+#include <vector>
 
 #include <mongocxx/instance.hpp>
 #include <nlohmann/json.hpp>
@@ -16,26 +19,29 @@
 #include "../clp/CurlGlobalInstance.hpp"
 #include "../clp/ir/constants.hpp"
 #include "../clp/streaming_archive/ArchiveMetadata.hpp"
+#include "../reducer/DistinctCountOperator.hpp"
 #include "../reducer/network_utils.hpp"
+#include "../reducer/NumericAggregationOperator.hpp"
+#include "../reducer/Operator.hpp"
+#include "../reducer/PercentileOperator.hpp"
 #include "CommandLineArguments.hpp"
 #include "Defs.hpp"
+#include "ErrorCode.hpp"
 #include "JsonConstructor.hpp"
 #include "JsonParser.hpp"
 #include "kv_ir_search.hpp"
 #include "OutputHandlerImpl.hpp"
-#include "search/AddTimestampConditions.hpp"
-#include "search/ast/ConvertToExists.hpp"
 #include "search/ast/EmptyExpr.hpp"
 #include "search/ast/Expression.hpp"
-#include "search/ast/NarrowTypes.hpp"
-#include "search/ast/OrOfAndForm.hpp"
 #include "search/ast/SearchUtils.hpp"
+#include "search/ConcurrentSearch.hpp"
 #include "search/EvaluateRangeIndexFilters.hpp"
 #include "search/EvaluateTimestampIndex.hpp"
 #include "search/kql/kql.hpp"
 #include "search/Output.hpp"
 #include "search/OutputHandler.hpp"
 #include "search/Projection.hpp"
+#include "search/QueryPlan.hpp"
 #include "search/SchemaMatch.hpp"
 #include "TimestampPattern.hpp"
 #include "Utils.hpp"
@@ -63,19 +69,60 @@ bool compress(CommandLineArguments const& command_line_arguments);
  */
 void decompress_archive(clp_s::JsonConstructorOption const& json_constructor_option);
 
+/**
+ * Creates the output handler specified by the command line arguments.
+ * @param command_line_arguments
+ * @param reducer_socket_fd
+ * @param reducer_record_group_format
+ * @param max_num_results The number of results after which the handler stops the search, or 0 if
+ * there's no limit (stdout and network output handlers only).
+ * @return The output handler on success, or nullptr on failure
+ */
+auto create_output_handler(
+        CommandLineArguments const& command_line_arguments,
+        int reducer_socket_fd,
+        reducer::RecordGroupFormat reducer_record_group_format,
+        uint64_t max_num_results
+) -> std::unique_ptr<OutputHandler>;
+
 /**
  * Searches the given archive.
  * @param command_line_arguments
  * @param archive_reader
- * @param expr A copy of the search AST which may be modified
- * @param reducer_socket_fd
+ * @param query_plan The archive-independent parts of the search's execution plan
+ * @param output_handler_factory Creates the output handler for the search's results, or returns
+ * nullptr on failure. It's only called once the archive may contain results.
+ * @param num_results Returns the number of results output
  * @return Whether the search succeeded
  */
 bool search_archive(
         CommandLineArguments const& command_line_arguments,
         std::shared_ptr<clp_s::ArchiveReader> const& archive_reader,
-        std::shared_ptr<ast::Expression> expr,
-        int reducer_socket_fd
+        std::shared_ptr<QueryPlan> const& query_plan,
+        OutputHandlerFactory const& output_handler_factory,
+        uint64_t& num_results
+);
+
+/**
+ * Searches the given archives using up to `num-threads` threads, each of which searches one archive
+ * at a time. The parsed query and its plan are shared by every search, and results are written to
+ * a single output handler shared by every search.
+ * @param command_line_arguments
+ * @param archive_paths
+ * @param query_plan The archive-independent parts of the search's execution plan
+ * @param reducer_socket_fd
+ * @param reducer_record_group_format
+ * @param max_num_results The number of results after which the search stops, or 0 if there's no
+ * limit.
+ * @return Whether every search succeeded
+ */
+bool search_archives_concurrently(
+        CommandLineArguments const& command_line_arguments,
+        std::vector<clp_s::Path> const& archive_paths,
+        std::shared_ptr<QueryPlan> const& query_plan,
+        int reducer_socket_fd,
+        reducer::RecordGroupFormat reducer_record_group_format,
+        uint64_t max_num_results
 );
 
 bool compress(CommandLineArguments const& command_line_arguments) {
@@ -99,6 +146,7 @@ bool compress(CommandLineArguments const& command_line_arguments) {
     option.input_file_type = command_line_arguments.get_file_type();
     option.archives_dir = archives_dir.string();
     option.target_encoded_size = command_line_arguments.get_target_encoded_size();
+    option.flush_interval_ms = command_line_arguments.get_flush_interval_ms();
     option.max_document_size = command_line_arguments.get_max_document_size();
     option.min_table_size = command_line_arguments.get_minimum_table_size();
     option.compression_level = command_line_arguments.get_compression_level();
@@ -106,6 +154,10 @@ bool compress(CommandLineArguments const& command_line_arguments) {
     option.print_archive_stats = command_line_arguments.print_archive_stats();
     option.single_file_archive = command_line_arguments.get_single_file_archive();
     option.structurize_arrays = command_line_arguments.get_structurize_arrays();
+    option.float_encoding = command_line_arguments.get_float_encoding();
+    option.array_encoding = command_line_arguments.get_array_encoding();
+    option.zstd_dictionary_size = command_line_arguments.get_zstd_dictionary_size();
+    option.schema_compaction_threshold = command_line_arguments.get_schema_compaction_threshold();
     option.record_log_order = command_line_arguments.get_record_log_order();
 
     clp_s::JsonParser parser(option);
@@ -129,48 +181,127 @@ void decompress_archive(clp_s::JsonConstructorOption const& json_constructor_opt
     constructor.store();
 }
 
+auto create_output_handler(
+        CommandLineArguments const& command_line_arguments,
+        int reducer_socket_fd,
+        reducer::RecordGroupFormat reducer_record_group_format,
+        uint64_t max_num_results
+) -> std::unique_ptr<OutputHandler> {
+    std::unique_ptr<OutputHandler> output_handler;
+    try {
+        switch (command_line_arguments.get_output_handler_type()) {
+            case CommandLineArguments::OutputHandlerType::Network:
+                output_handler = std::make_unique<clp_s::NetworkOutputHandler>(
+                        command_line_arguments.get_network_dest_host(),
+                        command_line_arguments.get_network_dest_port(),
+                        false,
+                        max_num_results
+                );
+                break;
+            case CommandLineArguments::OutputHandlerType::Reducer:
+                if (command_line_arguments.do_count_results_aggregation()) {
+                    output_handler = std::make_unique<clp_s::CountOutputHandler>(
+                            reducer_socket_fd,
+                            reducer_record_group_format
+                    );
+                } else if (command_line_arguments.do_count_by_time_aggregation()) {
+                    output_handler = std::make_unique<clp_s::CountByTimeOutputHandler>(
+                            reducer_socket_fd,
+                            reducer_record_group_format,
+                            command_line_arguments.get_count_by_time_bucket_size()
+                    );
+                } else if (CommandLineArguments::ColumnAggregationType::None
+                           != command_line_arguments.get_column_aggregation_type())
+                {
+                    auto const& column = command_line_arguments.get_aggregation_column();
+                    std::shared_ptr<reducer::Operator> op;
+                    bool is_numeric_aggregation{true};
+                    switch (command_line_arguments.get_column_aggregation_type()) {
+                        case CommandLineArguments::ColumnAggregationType::Numeric:
+                            op = std::make_shared<reducer::NumericAggregationOperator>(column);
+                            break;
+                        case CommandLineArguments::ColumnAggregationType::DistinctCount:
+                            op = std::make_shared<reducer::DistinctCountOperator>(column);
+                            is_numeric_aggregation = false;
+                            break;
+                        case CommandLineArguments::ColumnAggregationType::Percentile:
+                            op = std::make_shared<reducer::PercentileOperator>(
+                                    column,
+                                    command_line_arguments.get_percentiles()
+                            );
+                            break;
+                        default:
+                            SPDLOG_ERROR("Unhandled aggregation type.");
+                            return nullptr;
+                    }
+                    output_handler = std::make_unique<clp_s::ColumnAggregationOutputHandler>(
+                            reducer_socket_fd,
+                            reducer_record_group_format,
+                            column,
+                            op,
+                            is_numeric_aggregation
+                    );
+                } else {
+                    SPDLOG_ERROR("Unhandled aggregation type.");
+                    return nullptr;
+                }
+                break;
+            case CommandLineArguments::OutputHandlerType::ResultsCache:
+                output_handler = std::make_unique<clp_s::ResultsCacheOutputHandler>(
+                        command_line_arguments.get_mongodb_uri(),
+                        command_line_arguments.get_mongodb_collection(),
+                        command_line_arguments.get_batch_size(),
+                        command_line_arguments.get_max_num_results()
+                );
+                break;
+            case CommandLineArguments::OutputHandlerType::Stdout:
+                output_handler = std::make_unique<clp_s::StandardOutputHandler>(
+                        false,
+                        max_num_results
+                );
+                break;
+            default:
+                SPDLOG_ERROR("Unhandled OutputHandlerType.");
+                return nullptr;
+        }
+    } catch (std::exception const& e) {
+        SPDLOG_ERROR("Failed to create output handler - {}", e.what());
+        return nullptr;
+    }
+    return output_handler;
+}
+
 bool search_archive(
         CommandLineArguments const& command_line_arguments,
         std::shared_ptr<clp_s::ArchiveReader> const& archive_reader,
-        std::shared_ptr<ast::Expression> expr,
-        int reducer_socket_fd
+        std::shared_ptr<QueryPlan> const& query_plan,
+        OutputHandlerFactory const& output_handler_factory,
+        uint64_t& num_results
 ) {
     auto const& query = command_line_arguments.get_query();
 
     auto timestamp_dict = archive_reader->get_timestamp_dictionary();
-    AddTimestampConditions add_timestamp_conditions(
+    std::shared_ptr<ast::Expression> expr;
+    switch (query_plan->get_normalized_expression(
             timestamp_dict->get_authoritative_timestamp_tokenized_column(),
-            command_line_arguments.get_search_begin_ts(),
-            command_line_arguments.get_search_end_ts()
-    );
-    if (expr = add_timestamp_conditions.run(expr); std::dynamic_pointer_cast<ast::EmptyExpr>(expr))
+            expr
+    ))
     {
-        SPDLOG_ERROR(
-                "Query '{}' specified timestamp filters tge {} tle {}, but no authoritative "
-                "timestamp column was found for this archive",
-                query,
-                command_line_arguments.get_search_begin_ts().value_or(cEpochTimeMin),
-                command_line_arguments.get_search_end_ts().value_or(cEpochTimeMax)
-        );
-        return false;
-    }
-
-    ast::OrOfAndForm standardize_pass;
-    if (expr = standardize_pass.run(expr); std::dynamic_pointer_cast<ast::EmptyExpr>(expr)) {
-        SPDLOG_ERROR("Query '{}' is logically false", query);
-        return false;
-    }
-
-    ast::NarrowTypes narrow_pass;
-    if (expr = narrow_pass.run(expr); std::dynamic_pointer_cast<ast::EmptyExpr>(expr)) {
-        SPDLOG_ERROR("Query '{}' is logically false", query);
-        return false;
-    }
-
-    ast::ConvertToExists convert_pass;
-    if (expr = convert_pass.run(expr); std::dynamic_pointer_cast<ast::EmptyExpr>(expr)) {
-        SPDLOG_ERROR("Query '{}' is logically false", query);
-        return false;
+        case QueryPlan::NormalizationResult::MissingTimestampColumn:
+            SPDLOG_ERROR(
+                    "Query '{}' specified timestamp filters tge {} tle {}, but no authoritative "
+                    "timestamp column was found for this archive",
+                    query,
+                    command_line_arguments.get_search_begin_ts().value_or(cEpochTimeMin),
+                    command_line_arguments.get_search_end_ts().value_or(cEpochTimeMax)
+            );
+            return false;
+        case QueryPlan::NormalizationResult::LogicallyFalse:
+            SPDLOG_ERROR("Query '{}' is logically false", query);
+            return false;
+        case QueryPlan::NormalizationResult::Success:
+        default:
+            break;
     }
 
     EvaluateRangeIndexFilters metadata_filter_pass{
@@ -234,45 +365,8 @@ bool search_archive(
     projection->resolve_columns(archive_reader->get_schema_tree());
     archive_reader->set_projection(projection);
 
-    std::unique_ptr<OutputHandler> output_handler;
-    try {
-        switch (command_line_arguments.get_output_handler_type()) {
-            case CommandLineArguments::OutputHandlerType::Network:
-                output_handler = std::make_unique<clp_s::NetworkOutputHandler>(
-                        command_line_arguments.get_network_dest_host(),
-                        command_line_arguments.get_network_dest_port()
-                );
-                break;
-            case CommandLineArguments::OutputHandlerType::Reducer:
-                if (command_line_arguments.do_count_results_aggregation()) {
-                    output_handler = std::make_unique<clp_s::CountOutputHandler>(reducer_socket_fd);
-                } else if (command_line_arguments.do_count_by_time_aggregation()) {
-                    output_handler = std::make_unique<clp_s::CountByTimeOutputHandler>(
-                            reducer_socket_fd,
-                            command_line_arguments.get_count_by_time_bucket_size()
-                    );
-                } else {
-                    SPDLOG_ERROR("Unhandled aggregation type.");
-                    return false;
-                }
-                break;
-            case CommandLineArguments::OutputHandlerType::ResultsCache:
-                output_handler = std::make_unique<clp_s::ResultsCacheOutputHandler>(
-                        command_line_arguments.get_mongodb_uri(),
-                        command_line_arguments.get_mongodb_collection(),
-                        command_line_arguments.get_batch_size(),
-                        command_line_arguments.get_max_num_results()
-                );
-                break;
-            case CommandLineArguments::OutputHandlerType::Stdout:
-                output_handler = std::make_unique<clp_s::StandardOutputHandler>();
-                break;
-            default:
-                SPDLOG_ERROR("Unhandled OutputHandlerType.");
-                return false;
-        }
-    } catch (std::exception const& e) {
-        SPDLOG_ERROR("Failed to create output handler - {}", e.what());
+    auto output_handler = output_handler_factory();
+    if (nullptr == output_handler) {
         return false;
     }
 
@@ -282,15 +376,64 @@ bool search_archive(
             expr,
             archive_reader,
             std::move(output_handler),
-            command_line_arguments.get_ignore_case()
+            command_line_arguments.get_ignore_case(),
+            query_plan
+    );
+    if (false == output.filter()) {
+        return false;
+    }
+    num_results = output.get_num_results();
+    return true;
+}
+
+bool search_archives_concurrently(
+        CommandLineArguments const& command_line_arguments,
+        std::vector<clp_s::Path> const& archive_paths,
+        std::shared_ptr<QueryPlan> const& query_plan,
+        int reducer_socket_fd,
+        reducer::RecordGroupFormat reducer_record_group_format,
+        uint64_t max_num_results
+) {
+    std::shared_ptr<OutputHandler> const output_handler{create_output_handler(
+            command_line_arguments,
+            reducer_socket_fd,
+            reducer_record_group_format,
+            max_num_results
+    )};
+    if (nullptr == output_handler) {
+        return false;
+    }
+
+    return clp_s::search::search_archives_concurrently(
+            archive_paths,
+            command_line_arguments.get_num_search_threads(),
+            output_handler,
+            [&](clp_s::ArchiveReader& archive_reader, clp_s::Path const& archive_path) {
+                archive_reader.open(
+                        archive_path,
+                        command_line_arguments.get_network_auth(),
+                        command_line_arguments.get_network_cache_dir(),
+                        command_line_arguments.get_network_cache_size()
+                );
+            },
+            [&](std::shared_ptr<clp_s::ArchiveReader> const& archive_reader,
+                OutputHandlerFactory const& output_handler_factory) {
+                uint64_t num_results{0};
+                return search_archive(
+                        command_line_arguments,
+                        archive_reader,
+                        query_plan,
+                        output_handler_factory,
+                        num_results
+                );
+            }
     );
-    return output.filter();
 }
 }  // namespace
 
 int main(int argc, char const* argv[]) {
     try {
-        auto stderr_logger = spdlog::stderr_logger_st("stderr");
+        auto stderr_logger = spdlog::stderr_logger_mt("stderr");
         spdlog::set_default_logger(stderr_logger);
         spdlog::set_pattern("%Y-%m-%dT%H:%M:%S.%e%z [%l] %v");
     } catch (std::exception& e) {
@@ -328,6 +471,9 @@ int main(int argc, char const* argv[]) {
         option.output_dir = command_line_arguments.get_output_dir();
         option.ordered = command_line_arguments.get_ordered_decompression();
         option.target_ordered_chunk_size = command_line_arguments.get_target_ordered_chunk_size();
+        option.ordered_memory_budget
+                = command_line_arguments.get_ordered_decompression_memory_budget();
+        option.log_event_idx_range = command_line_arguments.get_log_event_idx_range();
         option.print_ordered_chunk_stats = command_line_arguments.print_ordered_chunk_stats();
         option.network_auth = command_line_arguments.get_network_auth();
         if (false == command_line_arguments.get_mongodb_uri().empty()) {
@@ -359,13 +505,15 @@ int main(int argc, char const* argv[]) {
         }
 
         int reducer_socket_fd{-1};
+        auto const reducer_record_group_format{command_line_arguments.get_record_group_format()};
         if (command_line_arguments.get_output_handler_type()
             == CommandLineArguments::OutputHandlerType::Reducer)
         {
             reducer_socket_fd = reducer::connect_to_reducer(
                     command_line_arguments.get_reducer_host(),
                     command_line_arguments.get_reducer_port(),
-                    command_line_arguments.get_job_id()
+                    command_line_arguments.get_job_id(),
+                    reducer_record_group_format
             );
             if (-1 == reducer_socket_fd) {
                 SPDLOG_ERROR("Failed to connect to reducer");
@@ -373,8 +521,24 @@ int main(int argc, char const* argv[]) {
             }
         }
 
+        std::optional<uint64_t> num_remaining_results;
+        if (0 != command_line_arguments.get_limit()) {
+            num_remaining_results = command_line_arguments.get_limit();
+        }
+        // The archive-independent parts of the query are compiled once and reused for every archive
+        auto query_plan = std::make_shared<QueryPlan>(
+                expr,
+                command_line_arguments.get_search_begin_ts(),
+                command_line_arguments.get_search_end_ts()
+        );
+        // Archives searched concurrently are collected and searched after every IR stream
+        auto const search_concurrently{command_line_arguments.get_num_search_threads() > 1};
+        std::vector<clp_s::Path> archive_paths;
         auto archive_reader = std::make_shared<clp_s::ArchiveReader>();
         for (auto const& input_path : command_line_arguments.get_input_paths()) {
+            if (num_remaining_results.has_value() && 0 == num_remaining_results.value()) {
+                break;
+            }
             if (std::string::npos != input_path.path.find(clp::ir::cIrFileExtension)) {
                 auto const result{clp_s::search_kv_ir_stream(
                         input_path,
@@ -423,24 +587,62 @@ int main(int argc, char const* argv[]) {
                 }
             }
 
+            if (search_concurrently) {
+                archive_paths.emplace_back(input_path);
+                continue;
+            }
+
             try {
-                archive_reader->open(input_path, command_line_arguments.get_network_auth());
+                archive_reader->open(
+                        input_path,
+                        command_line_arguments.get_network_auth(),
+                        command_line_arguments.get_network_cache_dir(),
+                        command_line_arguments.get_network_cache_size()
+                );
             } catch (std::exception const& e) {
                 SPDLOG_ERROR("Failed to open archive - {}", e.what());
                 return 1;
             }
+            uint64_t num_results{0};
             if (false
                 == search_archive(
                         command_line_arguments,
                         archive_reader,
-                        expr->copy(),
-                        reducer_socket_fd
+                        query_plan,
+                        [&]() {
+                            return create_output_handler(
+                                    command_line_arguments,
+                                    reducer_socket_fd,
+                                    reducer_record_group_format,
+                                    num_remaining_results.value_or(0)
+                            );
+                        },
+                        num_results
                 ))
             {
                 return 1;
             }
+            if (num_remaining_results.has_value()) {
+                // The output handler stops the search once the remaining number of results is
+                // reached
+                num_remaining_results = num_remaining_results.value() - num_results;
+            }
             archive_reader->close();
         }
+
+        if (false == archive_paths.empty()
+            && false
+                       == search_archives_concurrently(
+                               command_line_arguments,
+                               archive_paths,
+                               query_plan,
+                               reducer_socket_fd,
+                               reducer_record_group_format,
+                               num_remaining_results.value_or(0)
+                       ))
+        {
+            return 1;
+        }
     }
 
     return 0;
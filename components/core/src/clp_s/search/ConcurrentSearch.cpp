@@ -0,0 +1,121 @@
+#include "ConcurrentSearch.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#include "../../clp/type_utils.hpp"
+#include "../ArchiveReader.hpp"
+#include "../ErrorCode.hpp"
+#include "../InputConfig.hpp"
+#include "OutputHandler.hpp"
+#include "SharedOutputHandler.hpp"
+
+namespace clp_s::search {
+namespace {
+/**
+ * Closes an archive reader when destroyed.
+ */
+class ArchiveReaderCloser {
+public:
+    explicit ArchiveReaderCloser(ArchiveReader& archive_reader)
+            : m_archive_reader{archive_reader} {}
+
+    ~ArchiveReaderCloser() {
+        try {
+            m_archive_reader.close();
+        } catch (std::exception const& e) {
+            SPDLOG_ERROR("Failed to close archive - {}", e.what());
+        }
+    }
+
+    ArchiveReaderCloser(ArchiveReaderCloser const&) = delete;
+    ArchiveReaderCloser(ArchiveReaderCloser&&) = delete;
+    auto operator=(ArchiveReaderCloser const&) -> ArchiveReaderCloser& = delete;
+    auto operator=(ArchiveReaderCloser&&) -> ArchiveReaderCloser& = delete;
+
+private:
+    ArchiveReader& m_archive_reader;
+};
+}  // namespace
+
+auto search_archives_concurrently(
+        std::vector<Path> const& archive_paths,
+        size_t num_threads,
+        std::shared_ptr<OutputHandler> const& output_handler,
+        ArchiveOpener const& open_archive,
+        ArchiveSearcher const& search_archive
+) -> bool {
+    auto const output_handler_mutex = std::make_shared<std::mutex>();
+    OutputHandlerFactory const shared_output_handler_factory
+            = [&]() -> std::unique_ptr<OutputHandler> {
+        return std::make_unique<SharedOutputHandler>(output_handler, output_handler_mutex);
+    };
+    auto const should_stop = [&]() -> bool {
+        std::lock_guard const lock{*output_handler_mutex};
+        return output_handler->should_stop();
+    };
+
+    std::atomic_size_t next_archive_idx{0};
+    std::atomic_bool failed{false};
+    auto const search_next_archives = [&]() {
+        auto archive_reader = std::make_shared<ArchiveReader>();
+        for (auto archive_idx = next_archive_idx++;
+             archive_idx < archive_paths.size() && false == should_stop();
+             archive_idx = next_archive_idx++)
+        {
+            // Closes the archive on every path out of this iteration, including failed opens
+            ArchiveReaderCloser const archive_reader_closer{*archive_reader};
+            try {
+                open_archive(*archive_reader, archive_paths[archive_idx]);
+            } catch (std::exception const& e) {
+                SPDLOG_ERROR("Failed to open archive - {}", e.what());
+                failed = true;
+                output_handler->request_stop();
+                return;
+            }
+            bool succeeded{false};
+            try {
+                succeeded = search_archive(archive_reader, shared_output_handler_factory);
+            } catch (std::exception const& e) {
+                SPDLOG_ERROR("Encountered error during search - {}", e.what());
+            }
+            if (false == succeeded) {
+                failed = true;
+                output_handler->request_stop();
+                return;
+            }
+        }
+    };
+
+    num_threads = std::min(num_threads, archive_paths.size());
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads);
+    for (size_t i{0}; i < num_threads; ++i) {
+        threads.emplace_back(search_next_archives);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    if (failed) {
+        return false;
+    }
+
+    // Each archive's search only flushes the shared output handler, so it's finished once here
+    if (auto const ecode = output_handler->finish(); ErrorCode::ErrorCodeSuccess != ecode) {
+        SPDLOG_ERROR(
+                "Failed to flush output handler, error={}.",
+                clp::enum_to_underlying_type(ecode)
+        );
+        return false;
+    }
+    return true;
+}
+}  // namespace clp_s::search
@@ -0,0 +1,57 @@
+#ifndef CLP_S_SEARCH_CONCURRENTSEARCH_HPP
+#define CLP_S_SEARCH_CONCURRENTSEARCH_HPP
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "../ArchiveReader.hpp"
+#include "../InputConfig.hpp"
+#include "OutputHandler.hpp"
+
+namespace clp_s::search {
+/**
+ * Creates the output handler for a search's results, or returns nullptr on failure.
+ */
+using OutputHandlerFactory = std::function<std::unique_ptr<OutputHandler>()>;
+
+/**
+ * Opens the archive at the given path with the given archive reader.
+ * @throw Any exception if the archive can't be opened
+ */
+using ArchiveOpener = std::function<void(ArchiveReader&, Path const&)>;
+
+/**
+ * Searches an opened archive, writing its results to the output handler created by the given
+ * factory.
+ * @return Whether the search succeeded
+ * @throw Any exception if the search fails
+ */
+using ArchiveSearcher = std::function<
+        bool(std::shared_ptr<ArchiveReader> const&, OutputHandlerFactory const&)>;
+
+/**
+ * Searches the given archives using up to `num_threads` threads, each of which searches one archive
+ * at a time. Results are written to a single output handler shared by every search, which is
+ * finished once every search has completed.
+ *
+ * No more archives are searched once the shared output handler should stop (e.g., once it has
+ * reached its limit), or once any archive fails to be opened or searched.
+ * @param archive_paths
+ * @param num_threads
+ * @param output_handler
+ * @param open_archive
+ * @param search_archive
+ * @return Whether every archive was searched successfully and the output handler was finished
+ */
+[[nodiscard]] auto search_archives_concurrently(
+        std::vector<Path> const& archive_paths,
+        size_t num_threads,
+        std::shared_ptr<OutputHandler> const& output_handler,
+        ArchiveOpener const& open_archive,
+        ArchiveSearcher const& search_archive
+) -> bool;
+}  // namespace clp_s::search
+
+#endif  // CLP_S_SEARCH_CONCURRENTSEARCH_HPP
@@ -1,11 +1,21 @@
 #include "Output.hpp"
 
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <map>
 #include <memory>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include <spdlog/spdlog.h>
 
 #include "../../clp/type_utils.hpp"
+#include "../archive_constants.hpp"
 #include "../SchemaTree.hpp"
 #include "../Utils.hpp"
 #include "ast/AndExpr.hpp"
@@ -81,17 +91,72 @@ bool Output::filter() {
     m_query_runner.global_init();
     m_archive_reader->open_packed_streams();
 
+    bool const keeps_latest_log_events{m_output_handler->keeps_latest_log_events()};
+    if (keeps_latest_log_events) {
+        order_tables_by_descending_timestamp(matched_schemas);
+    } else if (m_output_handler->may_stop_early()) {
+        order_tables_by_estimated_cost(matched_schemas);
+    }
+    m_archive_reader->set_planned_table_order(matched_schemas);
+
+    if (auto const aggregated_column = m_output_handler->get_aggregated_column();
+        aggregated_column.has_value())
+    {
+        resolve_aggregated_column(aggregated_column.value());
+    }
+
     std::string message;
     auto const archive_id = m_archive_reader->get_archive_id();
+    auto const& schema_metadata = m_archive_reader->get_schema_metadata();
+    std::optional<uint64_t> prev_stream_id;
     for (int32_t schema_id : matched_schemas) {
-        if (EvaluatedValue::False == m_query_runner.schema_init(schema_id)) {
+        if (m_output_handler->should_stop()) {
+            break;
+        }
+
+        if (keeps_latest_log_events && false == may_contain_latest_log_events(schema_id)) {
+            continue;
+        }
+
+        auto const schema_value = m_query_runner.schema_init(schema_id);
+        if (EvaluatedValue::False == schema_value) {
             continue;
         }
 
+        // When every record in the table matches, handlers that only aggregate records can take
+        // the table's record count from its metadata without the table being read
+        if (EvaluatedValue::True == schema_value) {
+            auto const num_messages = schema_metadata.at(schema_id).num_messages;
+            if (m_output_handler->write_count(
+                        num_messages,
+                        m_archive_reader->get_table_timestamp_range(schema_id)
+                ))
+            {
+                m_num_results += num_messages;
+                continue;
+            }
+        }
+
+        auto const stream_id = schema_metadata.at(schema_id).stream_id;
+        if (prev_stream_id.has_value() && stream_id < prev_stream_id.value()) {
+            m_archive_reader->rewind_packed_streams();
+        }
+        prev_stream_id = stream_id;
+
+        // Handlers that aggregate a single column read it directly from its column reader, unless
+        // some of its values in the table can only be read by marshalling the records
+        int32_t aggregated_column_id{-1};
+        bool should_marshal_records{m_should_marshal_records};
+        if (m_aggregated_column_node_ids.has_value()) {
+            bool has_unstored_values{false};
+            std::tie(aggregated_column_id, has_unstored_values) = find_aggregated_column(schema_id);
+            should_marshal_records = m_should_marshal_records && has_unstored_values;
+        }
+
         auto& reader = m_archive_reader->read_schema_table(
                 schema_id,
                 m_output_handler->should_output_metadata(),
-                m_should_marshal_records
+                should_marshal_records
         );
         reader.initialize_filter(&m_query_runner);
 
@@ -102,14 +167,37 @@ bool Output::filter() {
                     message,
                     timestamp,
                     log_event_idx,
-                    &m_query_runner
+                    &m_query_runner,
+                    m_output_handler->get_min_exclusive_timestamp()
             ))
             {
                 m_output_handler->write(message, timestamp, archive_id, log_event_idx);
+                ++m_num_results;
+                if (m_output_handler->should_stop()) {
+                    break;
+                }
+            }
+        } else if (m_aggregated_column_node_ids.has_value() && false == should_marshal_records) {
+            auto* const aggregated_column_reader = reader.get_ordered_column(aggregated_column_id);
+            while (reader.get_next_message(message, &m_query_runner)) {
+                if (nullptr != aggregated_column_reader) {
+                    m_output_handler->write_column_value(
+                            *aggregated_column_reader,
+                            reader.get_prev_message_column_idx()
+                    );
+                }
+                ++m_num_results;
+                if (m_output_handler->should_stop()) {
+                    break;
+                }
             }
         } else {
             while (reader.get_next_message(message, &m_query_runner)) {
                 m_output_handler->write(message);
+                ++m_num_results;
+                if (m_output_handler->should_stop()) {
+                    break;
+                }
             }
         }
         auto ecode = m_output_handler->flush();
@@ -131,4 +219,176 @@ bool Output::filter() {
     }
     return true;
 }
+
+void Output::resolve_aggregated_column(std::vector<std::string> const& keys) {
+    auto& node_ids = m_aggregated_column_node_ids.emplace();
+    auto const schema_tree = m_archive_reader->get_schema_tree();
+    auto node_id = schema_tree->get_object_subtree_node_id_for_namespace(
+            constants::cDefaultNamespace
+    );
+    for (size_t i{0}; -1 != node_id && i < keys.size(); ++i) {
+        bool const is_last_key{keys.size() - 1 == i};
+        auto const parent_id = node_id;
+        node_id = -1;
+        for (auto const child_id : schema_tree->get_node(parent_id).get_children_ids()) {
+            auto const& child = schema_tree->get_node(child_id);
+            if (child.get_key_name() != keys[i]) {
+                continue;
+            }
+            if (is_last_key) {
+                node_ids.emplace(child_id);
+            } else if (NodeType::Object == child.get_type()) {
+                // Intermediate nodes must be objects
+                node_id = child_id;
+                break;
+            }
+        }
+    }
+}
+
+auto Output::find_aggregated_column(int32_t schema_id) const -> std::pair<int32_t, bool> {
+    auto const& node_ids = m_aggregated_column_node_ids.value();
+    auto const schema_tree = m_archive_reader->get_schema_tree();
+    auto& schema = m_archive_reader->get_schema_map()->at(schema_id);
+    int32_t column_id{-1};
+    bool has_unstored_values{false};
+    for (auto const node_id : schema.get_ordered_schema_view()) {
+        auto const& node = schema_tree->get_node(node_id);
+        if (node_ids.contains(node_id)) {
+            if (NodeType::Object == node.get_type() || NodeType::NullValue == node.get_type()) {
+                has_unstored_values = true;
+            } else {
+                column_id = node_id;
+            }
+            continue;
+        }
+
+        // The values of nested objects are stored in the columns of their descendants
+        for (auto ancestor_id = node.get_parent_id(); -1 != ancestor_id;
+             ancestor_id = schema_tree->get_node(ancestor_id).get_parent_id())
+        {
+            if (node_ids.contains(ancestor_id)) {
+                has_unstored_values = true;
+                break;
+            }
+        }
+    }
+
+    // Structured arrays are stored in unordered columns
+    if (schema.get_num_ordered() < schema.size()) {
+        for (auto const node_id : node_ids) {
+            if (NodeType::StructuredArray == schema_tree->get_node(node_id).get_type()) {
+                has_unstored_values = true;
+            }
+        }
+    }
+    return {column_id, has_unstored_values};
+}
+
+void Output::order_tables_by_descending_timestamp(std::vector<int32_t>& schema_ids) const {
+    // Tables whose timestamp range isn't recorded may contain any timestamp
+    std::map<int32_t, epochtime_t> schema_id_to_end_timestamp;
+    std::map<uint64_t, epochtime_t> stream_id_to_end_timestamp;
+    auto const& schema_metadata = m_archive_reader->get_schema_metadata();
+    for (auto schema_id : schema_ids) {
+        auto const range = m_archive_reader->get_table_timestamp_range(schema_id);
+        auto const end_timestamp
+                = range.has_value() ? range->second : std::numeric_limits<epochtime_t>::max();
+        schema_id_to_end_timestamp.emplace(schema_id, end_timestamp);
+        auto const [it, inserted] = stream_id_to_end_timestamp.try_emplace(
+                schema_metadata.at(schema_id).stream_id,
+                end_timestamp
+        );
+        if (false == inserted) {
+            it->second = std::max(it->second, end_timestamp);
+        }
+    }
+    sort_tables_by_priority(schema_ids, stream_id_to_end_timestamp, schema_id_to_end_timestamp);
+}
+
+void Output::order_tables_by_estimated_cost(std::vector<int32_t>& schema_ids) {
+    // Every record matches in tables where the query is always true, while the selectivity in
+    // other tables is unknown and assumed to be low.
+    constexpr double cUnknownSelectivity{0.1};
+
+    auto const& schema_metadata = m_archive_reader->get_schema_metadata();
+    // A stream is decompressed as a whole, so its cost is the size of all of its tables
+    std::map<uint64_t, uint64_t> stream_id_to_size;
+    for (auto const& [schema_id, metadata] : schema_metadata) {
+        stream_id_to_size[metadata.stream_id] += metadata.uncompressed_size;
+    }
+
+    std::map<int32_t, double> schema_id_to_matches_per_byte;
+    std::map<uint64_t, double> stream_id_to_matches_per_byte;
+    for (auto schema_id : schema_ids) {
+        auto const& metadata = schema_metadata.at(schema_id);
+        double num_expected_matches{0.0};
+        // The initialized context is cached so that searching the table doesn't initialize it again
+        switch (m_query_runner.cache_schema_init(schema_id)) {
+            case EvaluatedValue::True:
+                num_expected_matches = static_cast<double>(metadata.num_messages);
+                break;
+            case EvaluatedValue::Unknown:
+                num_expected_matches
+                        = static_cast<double>(metadata.num_messages) * cUnknownSelectivity;
+                break;
+            default:
+                break;
+        }
+        schema_id_to_matches_per_byte.emplace(
+                schema_id,
+                num_expected_matches
+                        / static_cast<double>(std::max(metadata.uncompressed_size, uint64_t{1}))
+        );
+        stream_id_to_matches_per_byte[metadata.stream_id]
+                += num_expected_matches
+                   / static_cast<double>(
+                           std::max(stream_id_to_size.at(metadata.stream_id), uint64_t{1})
+                   );
+    }
+    sort_tables_by_priority(
+            schema_ids,
+            stream_id_to_matches_per_byte,
+            schema_id_to_matches_per_byte
+    );
+}
+
+template <typename Priority>
+void Output::sort_tables_by_priority(
+        std::vector<int32_t>& schema_ids,
+        std::map<uint64_t, Priority> const& stream_id_to_priority,
+        std::map<int32_t, Priority> const& schema_id_to_priority
+) const {
+    auto const& schema_metadata = m_archive_reader->get_schema_metadata();
+    auto const get_stream_id
+            = [&](int32_t schema_id) { return schema_metadata.at(schema_id).stream_id; };
+
+    // Reading streams out of order requires rewinding, so streams stay in ascending order if the
+    // archive can't be rewound.
+    bool const can_reorder_streams{m_archive_reader->can_rewind_packed_streams()};
+    std::stable_sort(schema_ids.begin(), schema_ids.end(), [&](int32_t lhs, int32_t rhs) {
+        auto const lhs_stream_id = get_stream_id(lhs);
+        auto const rhs_stream_id = get_stream_id(rhs);
+        if (lhs_stream_id != rhs_stream_id) {
+            if (can_reorder_streams) {
+                auto const& lhs_stream_priority = stream_id_to_priority.at(lhs_stream_id);
+                auto const& rhs_stream_priority = stream_id_to_priority.at(rhs_stream_id);
+                if (lhs_stream_priority != rhs_stream_priority) {
+                    return lhs_stream_priority > rhs_stream_priority;
+                }
+            }
+            return lhs_stream_id < rhs_stream_id;
+        }
+        return schema_id_to_priority.at(lhs) > schema_id_to_priority.at(rhs);
+    });
+}
+
+auto Output::may_contain_latest_log_events(int32_t schema_id) const -> bool {
+    auto const min_exclusive_timestamp = m_output_handler->get_min_exclusive_timestamp();
+    if (false == min_exclusive_timestamp.has_value()) {
+        return true;
+    }
+    auto const range = m_archive_reader->get_table_timestamp_range(schema_id);
+    return false == range.has_value() || range->second > min_exclusive_timestamp.value();
+}
 }  // namespace clp_s::search
@@ -1,13 +1,16 @@
 #ifndef CLP_S_SEARCH_OUTPUT_HPP
 #define CLP_S_SEARCH_OUTPUT_HPP
 
+#include <cstdint>
 #include <map>
+#include <optional>
 #include <set>
 #include <stack>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
+#include <vector>
 
 #include "../ArchiveReader.hpp"
 #include "../SchemaReader.hpp"
@@ -16,6 +19,7 @@
 #include "ast/StringLiteral.hpp"
 #include "clp_search/Query.hpp"
 #include "OutputHandler.hpp"
+#include "QueryPlan.hpp"
 #include "QueryRunner.hpp"
 #include "SchemaMatch.hpp"
 
@@ -33,8 +37,9 @@ public:
            std::shared_ptr<ast::Expression> const& expr,
            std::shared_ptr<ArchiveReader> const& archive_reader,
            std::unique_ptr<OutputHandler> output_handler,
-           bool ignore_case)
-            : m_query_runner(match, expr, archive_reader, ignore_case),
+           bool ignore_case,
+           std::shared_ptr<QueryPlan> query_plan = nullptr)
+            : m_query_runner(match, expr, archive_reader, ignore_case, std::move(query_plan)),
               m_archive_reader(archive_reader),
               m_expr(expr),
               m_match(match),
@@ -49,13 +54,77 @@ public:
      */
     auto filter() -> bool;
 
+    /**
+     * @return The number of results written to the output handler.
+     */
+    [[nodiscard]] auto get_num_results() const -> uint64_t { return m_num_results; }
+
 private:
+    /**
+     * Orders tables so that tables with later timestamps are searched first, while keeping the
+     * tables in each packed stream together. Streams are only reordered if the archive can be
+     * rewound.
+     * @param schema_ids
+     */
+    void order_tables_by_descending_timestamp(std::vector<int32_t>& schema_ids) const;
+
+    /**
+     * Orders tables so that the tables expected to produce the most results per decompressed byte
+     * are searched first, while keeping the tables in each packed stream together. The number of
+     * results is estimated from each table's number of records and whether the query is always
+     * true for the table. Streams are only reordered if the archive can be rewound.
+     * @param schema_ids
+     */
+    void order_tables_by_estimated_cost(std::vector<int32_t>& schema_ids);
+
+    /**
+     * Sorts tables by descending priority while keeping the tables in each packed stream together.
+     * Streams are sorted by descending priority if the archive can be rewound, or kept in
+     * ascending order otherwise.
+     * @tparam Priority
+     * @param schema_ids
+     * @param stream_id_to_priority
+     * @param schema_id_to_priority
+     */
+    template <typename Priority>
+    void sort_tables_by_priority(
+            std::vector<int32_t>& schema_ids,
+            std::map<uint64_t, Priority> const& stream_id_to_priority,
+            std::map<int32_t, Priority> const& schema_id_to_priority
+    ) const;
+
+    /**
+     * @param schema_id
+     * @return Whether the given schema's table may contain log events that the output handler
+     * would keep, based on the table's timestamp range.
+     */
+    [[nodiscard]] auto may_contain_latest_log_events(int32_t schema_id) const -> bool;
+
+    /**
+     * Resolves the output handler's aggregated column to the schema tree nodes it matches.
+     * @param keys
+     */
+    void resolve_aggregated_column(std::vector<std::string> const& keys);
+
+    /**
+     * Finds the column storing the output handler's aggregated column in the given table.
+     * @param schema_id
+     * @return A pair of:
+     * - The ID of the column, or -1 if the table has no column storing the aggregated column.
+     * - Whether the table contains values of the aggregated column which aren't stored in a column
+     *   reader (e.g., objects and nulls).
+     */
+    [[nodiscard]] auto find_aggregated_column(int32_t schema_id) const -> std::pair<int32_t, bool>;
+
     QueryRunner m_query_runner;
     std::shared_ptr<ArchiveReader> m_archive_reader;
     std::shared_ptr<ast::Expression> m_expr;
     std::shared_ptr<SchemaMatch> m_match;
     std::unique_ptr<OutputHandler> m_output_handler;
     bool m_should_marshal_records{true};
+    // The IDs of the schema tree nodes matching the output handler's aggregated column, if any
+    std::optional<std::unordered_set<int32_t>> m_aggregated_column_node_ids;
+    uint64_t m_num_results{0};
 };
 }  // namespace clp_s::search
 
@@ -1,9 +1,15 @@
 #ifndef CLP_S_SEARCH_OUTPUTHANDLER_HPP
 #define CLP_S_SEARCH_OUTPUTHANDLER_HPP
 
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <string>
 #include <string_view>
+#include <utility>
 #include <vector>
 
+#include "../ColumnReader.hpp"
 #include "../Defs.hpp"
 #include "../ErrorCode.hpp"
 
@@ -42,6 +48,46 @@ public:
      */
     virtual void write(std::string_view message) = 0;
 
+    /**
+     * Writes the number of log events in a table that all match the query, without the log events
+     * being read. Handlers that only aggregate log events can accept this in place of calls to
+     * `write`, letting the table be skipped.
+     * @param count
+     * @param timestamp_range The range of timestamps, [begin, end], of the log events, or
+     * std::nullopt if it's unknown.
+     * @return Whether the handler accepted the count. If not, the log events are written
+     * individually instead.
+     */
+    [[nodiscard]] virtual auto write_count(
+            [[maybe_unused]] uint64_t count,
+            [[maybe_unused]] std::optional<std::pair<epochtime_t, epochtime_t>> const&
+                    timestamp_range
+    ) -> bool {
+        return false;
+    }
+
+    /**
+     * @return The keys of the only column that the handler reads from each log event, or
+     * std::nullopt if the handler reads whole log events. If set, the column's values are read
+     * directly from the tables' column readers and written with `write_column_value`. In tables
+     * where the column's values aren't stored in a column reader (e.g., objects and nulls), log
+     * events are only written (with `write`) if the handler marshals records.
+     */
+    [[nodiscard]] virtual auto get_aggregated_column() const
+            -> std::optional<std::vector<std::string>> {
+        return std::nullopt;
+    }
+
+    /**
+     * Writes the value of the column returned by `get_aggregated_column` in a log event.
+     * @param column_reader The reader for the column in the log event's table.
+     * @param message_idx The index of the log event in the column reader.
+     */
+    virtual void write_column_value(
+            [[maybe_unused]] BaseColumnReader& column_reader,
+            [[maybe_unused]] uint64_t message_idx
+    ) {}
+
     /**
      * Flushes the output handler after each table that gets searched.
      * @return ErrorCodeSuccess on success or relevant error code on error
@@ -54,13 +100,54 @@ public:
      */
     [[nodiscard]] virtual auto finish() -> ErrorCode { return ErrorCode::ErrorCodeSuccess; }
 
+    /**
+     * @return Whether the handler only keeps the log events with the latest timestamps. If so,
+     * tables are searched in descending timestamp order so that tables which can't contain any
+     * log events the handler would keep can be skipped.
+     */
+    [[nodiscard]] virtual auto keeps_latest_log_events() const -> bool { return false; }
+
+    /**
+     * @return The timestamp that a log event's timestamp must exceed for the handler to keep it, or
+     * std::nullopt if the handler would keep any log event.
+     */
+    [[nodiscard]] virtual auto get_min_exclusive_timestamp() const -> std::optional<epochtime_t> {
+        return std::nullopt;
+    }
+
+    /**
+     * @return Whether the handler may stop the search before all tables have been searched (see
+     * `should_stop`). If so, tables likely to produce results quickly are searched first.
+     */
+    [[nodiscard]] virtual auto may_stop_early() const -> bool { return false; }
+
+    /**
+     * Requests that the search stop as soon as possible. This method is thread-safe.
+     */
+    void request_stop() { m_stop_requested.store(true, std::memory_order_relaxed); }
+
+    /**
+     * @return Whether the search should stop, either because it was requested or because the
+     * handler doesn't need any more results.
+     */
+    [[nodiscard]] auto should_stop() const -> bool {
+        return m_stop_requested.load(std::memory_order_relaxed) || is_done();
+    }
+
     [[nodiscard]] auto should_output_metadata() const -> bool { return m_should_output_metadata; }
 
     [[nodiscard]] auto should_marshal_records() const -> bool { return m_should_marshal_records; }
 
+protected:
+    /**
+     * @return Whether the handler doesn't need any more results.
+     */
+    [[nodiscard]] virtual auto is_done() const -> bool { return false; }
+
 private:
     bool m_should_output_metadata{};
     bool m_should_marshal_records{};
+    std::atomic_bool m_stop_requested{false};
 };
 }  // namespace clp_s::search
 
@@ -0,0 +1,75 @@
+#include "QueryPlan.hpp"
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include "AddTimestampConditions.hpp"
+#include "ast/ConvertToExists.hpp"
+#include "ast/EmptyExpr.hpp"
+#include "ast/Expression.hpp"
+#include "ast/NarrowTypes.hpp"
+#include "ast/OrOfAndForm.hpp"
+#include "clp_search/Grep.hpp"
+
+namespace clp_s::search {
+auto QueryPlan::get_normalized_expression(
+        TimestampColumn const& timestamp_column,
+        std::shared_ptr<ast::Expression>& normalized_expr
+) -> NormalizationResult {
+    // Without timestamp filters, the normalized query doesn't depend on the timestamp column
+    TimestampColumn key;
+    if (m_begin_ts.has_value() || m_end_ts.has_value()) {
+        key = timestamp_column;
+    }
+
+    std::lock_guard const lock{m_mutex};
+    auto it = m_normalized_exprs.find(key);
+    if (m_normalized_exprs.end() == it) {
+        auto expr = m_expr->copy();
+        auto result = NormalizationResult::Success;
+
+        AddTimestampConditions add_timestamp_conditions(key, m_begin_ts, m_end_ts);
+        ast::OrOfAndForm standardize_pass;
+        ast::NarrowTypes narrow_pass;
+        ast::ConvertToExists convert_pass;
+        if (expr = add_timestamp_conditions.run(expr);
+            std::dynamic_pointer_cast<ast::EmptyExpr>(expr))
+        {
+            result = NormalizationResult::MissingTimestampColumn;
+        } else if (expr = standardize_pass.run(expr);
+                   std::dynamic_pointer_cast<ast::EmptyExpr>(expr))
+        {
+            result = NormalizationResult::LogicallyFalse;
+        } else if (expr = narrow_pass.run(expr); std::dynamic_pointer_cast<ast::EmptyExpr>(expr)) {
+            result = NormalizationResult::LogicallyFalse;
+        } else if (expr = convert_pass.run(expr); std::dynamic_pointer_cast<ast::EmptyExpr>(expr))
+        {
+            result = NormalizationResult::LogicallyFalse;
+        }
+        it = m_normalized_exprs.emplace(std::move(key), std::make_pair(result, std::move(expr)))
+                     .first;
+    }
+
+    auto const& [result, expr] = it->second;
+    normalized_expr = expr->copy();
+    return result;
+}
+
+auto QueryPlan::get_preprocessed_clp_string_query(std::string const& query_string)
+        -> clp_search::Grep::PreprocessedQuery const& {
+    // Entries are never erased, so the returned reference stays valid after the lock is released
+    std::lock_guard const lock{m_mutex};
+    auto it = m_preprocessed_clp_string_queries.find(query_string);
+    if (m_preprocessed_clp_string_queries.end() == it) {
+        it = m_preprocessed_clp_string_queries
+                     .emplace(
+                             query_string,
+                             clp_search::Grep::preprocess_raw_query(query_string, false)
+                     )
+                     .first;
+    }
+    return it->second;
+}
+}  // namespace clp_s::search
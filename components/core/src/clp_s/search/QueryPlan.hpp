@@ -0,0 +1,88 @@
+#ifndef CLP_S_SEARCH_QUERYPLAN_HPP
+#define CLP_S_SEARCH_QUERYPLAN_HPP
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../Defs.hpp"
+#include "ast/Expression.hpp"
+#include "clp_search/Grep.hpp"
+
+namespace clp_s::search {
+/**
+ * The parts of a query's execution plan which don't depend on the archive being searched, compiled
+ * once and reused across every archive a search covers:
+ * - the query normalized by the `AddTimestampConditions`, `OrOfAndForm`, `NarrowTypes`, and
+ *   `ConvertToExists` passes, for each authoritative timestamp column encountered.
+ * - the tokens of each clp string sub-query, along with how each token may be encoded.
+ *
+ * Binding the plan to an archive then only requires the archive-dependent passes (range index and
+ * timestamp index evaluation and schema matching) and dictionary lookups.
+ *
+ * The plan is thread-safe, so it can be shared by archives which are searched concurrently.
+ */
+class QueryPlan {
+public:
+    // Types
+    using TimestampColumn = std::optional<std::pair<std::vector<std::string>, std::string>>;
+
+    enum class NormalizationResult : uint8_t {
+        Success,
+        // Timestamp filters were specified, but the archive has no authoritative timestamp column
+        MissingTimestampColumn,
+        LogicallyFalse
+    };
+
+    // Constructors
+    /**
+     * @param expr The parsed query.
+     * @param begin_ts The optional beginning of the range of timestamps to search.
+     * @param end_ts The optional end of the range of timestamps to search.
+     */
+    QueryPlan(
+            std::shared_ptr<ast::Expression> expr,
+            std::optional<epochtime_t> begin_ts,
+            std::optional<epochtime_t> end_ts
+    )
+            : m_expr{std::move(expr)},
+              m_begin_ts{begin_ts},
+              m_end_ts{end_ts} {}
+
+    // Methods
+    /**
+     * Gets the normalized query for an archive, normalizing it only the first time the archive's
+     * authoritative timestamp column is encountered.
+     * @param timestamp_column The archive's authoritative timestamp column.
+     * @param normalized_expr Returns a copy of the normalized query, which the caller may modify.
+     * @return The result of normalizing the query.
+     */
+    auto get_normalized_expression(
+            TimestampColumn const& timestamp_column,
+            std::shared_ptr<ast::Expression>& normalized_expr
+    ) -> NormalizationResult;
+
+    /**
+     * @param query_string A clp string sub-query, as serialized by `Literal::as_clp_string`.
+     * @return The sub-query preprocessed for `Grep::process_raw_query`, without added wildcards.
+     */
+    auto get_preprocessed_clp_string_query(std::string const& query_string)
+            -> clp_search::Grep::PreprocessedQuery const&;
+
+private:
+    std::shared_ptr<ast::Expression> m_expr;
+    std::optional<epochtime_t> m_begin_ts;
+    std::optional<epochtime_t> m_end_ts;
+    std::map<TimestampColumn, std::pair<NormalizationResult, std::shared_ptr<ast::Expression>>>
+            m_normalized_exprs;
+    std::map<std::string, clp_search::Grep::PreprocessedQuery> m_preprocessed_clp_string_queries;
+    std::mutex m_mutex;
+};
+}  // namespace clp_s::search
+
+#endif  // CLP_S_SEARCH_QUERYPLAN_HPP
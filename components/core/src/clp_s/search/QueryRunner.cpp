@@ -1,9 +1,16 @@
 #include "QueryRunner.hpp"
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <string>
+#include <string_view>
 #include <vector>
 
+#include <simdjson.h>
+
 #include "../../clp/type_utils.hpp"
+#include "../ArrayTape.hpp"
 #include "../SchemaTree.hpp"
 #include "../Utils.hpp"
 #include "ast/AndExpr.hpp"
@@ -33,12 +40,213 @@ using clp_s::search::ast::OrExpr;
 #define eval(op, a, b) (((op) == FilterOperation::EQ) ? ((a) == (b)) : ((a) != (b)))
 
 namespace clp_s::search {
+namespace {
+class SimdjsonArray;
+class SimdjsonObject;
+
+/**
+ * Accessors through which the array filter evaluators read arrays, so that arrays stored as JSON
+ * and as array tapes are evaluated by the same code. Each value accessor reports its type as an
+ * `ArrayTapeValueType`; each array accessor visits its values with `any_value`, and each object
+ * accessor visits its fields with `any_field`, stopping at the first value or field for which the
+ * visitor returns true.
+ */
+class SimdjsonArrayValue {
+public:
+    // Constructors
+    explicit SimdjsonArrayValue(ondemand::value value) : m_value{value} {}
+
+    // Methods
+    [[nodiscard]] auto get_type() -> ArrayTapeValueType;
+
+    [[nodiscard]] auto get_int64() -> int64_t { return m_number.get_int64(); }
+
+    [[nodiscard]] auto get_uint64() -> uint64_t { return m_number.get_uint64(); }
+
+    [[nodiscard]] auto get_double() -> double { return m_number.get_double(); }
+
+    [[nodiscard]] auto get_string() -> std::string_view { return m_value.get_string().value(); }
+
+    [[nodiscard]] auto get_array() -> SimdjsonArray;
+
+    [[nodiscard]] auto get_object() -> SimdjsonObject;
+
+private:
+    ondemand::value m_value;
+    // The number read by `get_type`, if the value is a number
+    ondemand::number m_number{};
+};
+
+class SimdjsonArray {
+public:
+    // Constructors
+    explicit SimdjsonArray(ondemand::array array) : m_array{array} {}
+
+    // Methods
+    template <typename Visitor>
+    auto any_value(Visitor visitor) -> bool {
+        for (ondemand::value item : m_array) {
+            SimdjsonArrayValue value{item};
+            if (visitor(value)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    ondemand::array m_array;
+};
+
+class SimdjsonObject {
+public:
+    // Constructors
+    explicit SimdjsonObject(ondemand::object object) : m_object{object} {}
+
+    // Methods
+    template <typename Visitor>
+    auto any_field(Visitor visitor) -> bool {
+        for (auto field : m_object) {
+            std::string_view const key = field.unescaped_key(true).value();
+            SimdjsonArrayValue value{field.value()};
+            if (visitor(key, value)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    ondemand::object m_object;
+};
+
+auto SimdjsonArrayValue::get_type() -> ArrayTapeValueType {
+    switch (m_value.type()) {
+        case ondemand::json_type::array:
+            return ArrayTapeValueType::Array;
+        case ondemand::json_type::object:
+            return ArrayTapeValueType::Object;
+        case ondemand::json_type::number:
+            m_number = m_value.get_number();
+            if (m_number.is_double()) {
+                return ArrayTapeValueType::Double;
+            }
+            if (m_number.is_uint64()) {
+                return ArrayTapeValueType::UInt64;
+            }
+            return ArrayTapeValueType::Int64;
+        case ondemand::json_type::string:
+            return ArrayTapeValueType::String;
+        case ondemand::json_type::boolean:
+            return m_value.get_bool() ? ArrayTapeValueType::True : ArrayTapeValueType::False;
+        case ondemand::json_type::null:
+        default:
+            return ArrayTapeValueType::Null;
+    }
+}
+
+auto SimdjsonArrayValue::get_array() -> SimdjsonArray {
+    return SimdjsonArray{m_value.get_array()};
+}
+
+auto SimdjsonArrayValue::get_object() -> SimdjsonObject {
+    return SimdjsonObject{m_value.get_object()};
+}
+
+class ArrayTapeContainer;
+
+class ArrayTapeArrayValue {
+public:
+    // Constructors
+    explicit ArrayTapeArrayValue(ArrayTapeValue const& value) : m_value{value} {}
+
+    // Methods
+    [[nodiscard]] auto get_type() const -> ArrayTapeValueType { return m_value.get_type(); }
+
+    [[nodiscard]] auto get_int64() const -> int64_t { return m_value.get_int64(); }
+
+    [[nodiscard]] auto get_uint64() const -> uint64_t { return m_value.get_uint64(); }
+
+    [[nodiscard]] auto get_double() const -> double { return m_value.get_double(); }
+
+    [[nodiscard]] auto get_string() const -> std::string_view { return m_value.get_string(); }
+
+    [[nodiscard]] auto get_array() const -> ArrayTapeContainer;
+
+    [[nodiscard]] auto get_object() const -> ArrayTapeContainer;
+
+private:
+    ArrayTapeValue m_value;
+};
+
+/**
+ * An array tape, or the contents of an array or object within one.
+ */
+class ArrayTapeContainer {
+public:
+    // Constructors
+    explicit ArrayTapeContainer(std::string_view contents) : m_contents{contents} {}
+
+    // Methods
+    template <typename Visitor>
+    auto any_value(Visitor visitor) const -> bool {
+        ArrayTapeIterator it{m_contents};
+        while (it.has_next()) {
+            ArrayTapeArrayValue value{it.next_value()};
+            if (visitor(value)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    template <typename Visitor>
+    auto any_field(Visitor visitor) const -> bool {
+        ArrayTapeIterator it{m_contents};
+        while (it.has_next()) {
+            auto const key = it.next_key();
+            ArrayTapeArrayValue value{it.next_value()};
+            if (visitor(key, value)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    std::string_view m_contents;
+};
+
+auto ArrayTapeArrayValue::get_array() const -> ArrayTapeContainer {
+    return ArrayTapeContainer{m_value.get_contents()};
+}
+
+auto ArrayTapeArrayValue::get_object() const -> ArrayTapeContainer {
+    return ArrayTapeContainer{m_value.get_contents()};
+}
+}  // namespace
+
 void QueryRunner::global_init() {
     populate_internal_columns();
     populate_string_queries(m_expr);
 }
 
 auto QueryRunner::schema_init(int32_t schema_id) -> EvaluatedValue {
+    if (auto it = m_cached_schema_contexts.find(schema_id); m_cached_schema_contexts.end() != it) {
+        auto& context = it->second;
+        m_expr = std::move(context.expr);
+        m_expr_clp_query = std::move(context.expr_clp_query);
+        m_expr_var_match_map = std::move(context.expr_var_match_map);
+        m_wildcard_columns = std::move(context.wildcard_columns);
+        m_wildcard_to_searched_basic_columns
+                = std::move(context.wildcard_to_searched_basic_columns);
+        m_wildcard_type_mask = context.wildcard_type_mask;
+        m_expression_value = context.expression_value;
+        m_schema = schema_id;
+        m_cached_schema_contexts.erase(it);
+        return m_expression_value;
+    }
+
     m_expr_clp_query.clear();
     m_expr_var_match_map.clear();
     m_wildcard_to_searched_basic_columns.clear();
@@ -56,11 +264,30 @@ auto QueryRunner::schema_init(int32_t schema_id) -> EvaluatedValue {
     return m_expression_value;
 }
 
+auto QueryRunner::cache_schema_init(int32_t schema_id) -> EvaluatedValue {
+    auto const value = schema_init(schema_id);
+    m_cached_schema_contexts.insert_or_assign(
+            schema_id,
+            SchemaContext{
+                    .expr = std::move(m_expr),
+                    .expr_clp_query = std::move(m_expr_clp_query),
+                    .expr_var_match_map = std::move(m_expr_var_match_map),
+                    .wildcard_columns = std::move(m_wildcard_columns),
+                    .wildcard_to_searched_basic_columns
+                    = std::move(m_wildcard_to_searched_basic_columns),
+                    .wildcard_type_mask = m_wildcard_type_mask,
+                    .expression_value = value
+            }
+    );
+    return value;
+}
+
 void QueryRunner::clear_readers() {
     m_clp_string_readers.clear();
     m_var_string_readers.clear();
     m_datestring_readers.clear();
     m_basic_readers.clear();
+    m_array_tape_readers.clear();
 }
 
 void QueryRunner::initialize_reader(int32_t column_id, BaseColumnReader* column_reader) {
@@ -72,6 +299,7 @@ void QueryRunner::initialize_reader(int32_t column_id, BaseColumnReader* column_
         auto* clp_reader = dynamic_cast<ClpStringColumnReader*>(column_reader);
         auto* var_reader = dynamic_cast<VariableStringColumnReader*>(column_reader);
         auto* date_reader = dynamic_cast<DateStringColumnReader*>(column_reader);
+        auto* array_reader = dynamic_cast<UnstructuredArrayColumnReader*>(column_reader);
         if (nullptr != clp_reader && clp_reader->get_type() == NodeType::ClpString) {
             m_clp_string_readers[column_id].push_back(clp_reader);
         } else if (nullptr != var_reader && var_reader->get_type() == NodeType::VarString) {
@@ -79,6 +307,10 @@ void QueryRunner::initialize_reader(int32_t column_id, BaseColumnReader* column_
         } else if (nullptr != date_reader) {
             // Datestring readers with a given column ID are guaranteed not to repeat
             m_datestring_readers.emplace(column_id, date_reader);
+        } else if (nullptr != array_reader && ArrayEncoding::Tape == array_reader->get_encoding())
+        {
+            // Unstructured array readers with a given column ID are guaranteed not to repeat
+            m_array_tape_readers.emplace(column_id, array_reader);
         } else {
             m_basic_readers[column_id].push_back(column_reader);
         }
@@ -251,6 +483,16 @@ bool QueryRunner::evaluate_wildcard_filter(FilterExpr* expr, int32_t schema) {
                 ret = evaluate_bool_filter(op, column_id, literal);
                 break;
             case LiteralType::ArrayT:
+                if (auto const it = m_array_tape_readers.find(column_id);
+                    m_array_tape_readers.end() != it)
+                {
+                    ret = evaluate_wildcard_array_tape_filter(
+                            op,
+                            it->second->get_tape(m_cur_message),
+                            literal
+                    );
+                    break;
+                }
                 ret = evaluate_wildcard_array_filter(
                         op,
                         get_cached_decompressed_unstructured_array(column_id),
@@ -297,6 +539,16 @@ bool QueryRunner::evaluate_filter(FilterExpr* expr, int32_t schema) {
         case LiteralType::BooleanT:
             return evaluate_bool_filter(expr->get_operation(), column_id, literal);
         case LiteralType::ArrayT:
+            if (auto const it = m_array_tape_readers.find(column_id);
+                m_array_tape_readers.end() != it)
+            {
+                return evaluate_array_tape_filter(
+                        expr->get_operation(),
+                        column->get_unresolved_tokens(),
+                        it->second->get_tape(m_cur_message),
+                        literal
+                );
+            }
             return evaluate_array_filter(
                     expr->get_operation(),
                     column->get_unresolved_tokens(),
@@ -490,8 +742,28 @@ bool QueryRunner::evaluate_array_filter(
         value.reserve(value.size() + simdjson::SIMDJSON_PADDING);
     }
     auto obj = m_array_parser.iterate(value);
-    ondemand::array array = obj.get_array();
+    SimdjsonArray array{obj.get_array()};
 
+    prepare_array_filter(op, operand);
+    return evaluate_array_filter_array(array, op, unresolved_tokens, 0, operand);
+}
+
+bool QueryRunner::evaluate_array_tape_filter(
+        FilterOperation op,
+        DescriptorList const& unresolved_tokens,
+        std::string_view tape,
+        std::shared_ptr<Literal> const& operand
+) {
+    ArrayTapeContainer array{tape};
+
+    prepare_array_filter(op, operand);
+    return evaluate_array_filter_array(array, op, unresolved_tokens, 0, operand);
+}
+
+void QueryRunner::prepare_array_filter(
+        FilterOperation op,
+        std::shared_ptr<Literal> const& operand
+) {
     // pre-evaluate whether we can match strings or numbers to eliminate
     // duplicate effort on every item
     m_maybe_string = !(op == FilterOperation::EXISTS || op == FilterOperation::NEXISTS)
@@ -501,21 +773,20 @@ bool QueryRunner::evaluate_array_filter(
     int64_t tmp_int;
     m_maybe_number = !(op == FilterOperation::EXISTS || op == FilterOperation::NEXISTS)
                      && (operand->as_float(tmp_double, op) || operand->as_int(tmp_int, op));
-
-    return evaluate_array_filter_array(array, op, unresolved_tokens, 0, operand);
 }
 
+template <typename ArrayValue>
 bool QueryRunner::evaluate_array_filter_value(
-        ondemand::value& item,
+        ArrayValue& item,
         FilterOperation op,
         DescriptorList const& unresolved_tokens,
         size_t cur_idx,
         std::shared_ptr<Literal> const& operand
 ) const {
     bool match = false;
-    switch (item.type()) {
-        case ondemand::json_type::object: {
-            ondemand::object nested_object = item.get_object();
+    switch (auto const type = item.get_type(); type) {
+        case ArrayTapeValueType::Object: {
+            auto nested_object = item.get_object();
             if (evaluate_array_filter_object(
                         nested_object,
                         op,
@@ -527,17 +798,17 @@ bool QueryRunner::evaluate_array_filter_value(
                 match = true;
             }
         } break;
-        case ondemand::json_type::array: {
-            ondemand::array nested_array = item.get_array();
+        case ArrayTapeValueType::Array: {
+            auto nested_array = item.get_array();
             if (evaluate_array_filter_array(nested_array, op, unresolved_tokens, cur_idx, operand))
             {
                 match = true;
             }
         } break;
-        case ondemand::json_type::string: {
+        case ArrayTapeValueType::String: {
             if (true == m_maybe_string && unresolved_tokens.size() == cur_idx
                 && StringUtils::wildcard_match_unsafe(
-                        item.get_string().value(),
+                        item.get_string(),
                         m_array_search_string,
                         false == m_ignore_case
                 ))
@@ -545,40 +816,44 @@ bool QueryRunner::evaluate_array_filter_value(
                 match = op == FilterOperation::EQ;
             }
         } break;
-        case ondemand::json_type::number: {
+        case ArrayTapeValueType::Double:
+        case ArrayTapeValueType::UInt64:
+        case ArrayTapeValueType::Int64: {
             if (false == m_maybe_number || unresolved_tokens.size() != cur_idx) {
                 break;
             }
-            ondemand::number number = item.get_number();
-            if (number.is_double()) {
+            if (ArrayTapeValueType::Double == type) {
                 double tmp_double;
                 operand->as_float(tmp_double, op);
-                match = eval(op, number.get_double(), tmp_double);
-            } else if (number.is_uint64()) {
+                match = eval(op, item.get_double(), tmp_double);
+            } else if (ArrayTapeValueType::UInt64 == type) {
                 int64_t tmp_int;
                 operand->as_int(tmp_int, op);
-                match = eval(op, number.get_uint64(), tmp_int);
+                match = eval(op, item.get_uint64(), tmp_int);
             } else {
                 int64_t tmp_int;
                 operand->as_int(tmp_int, op);
                 // TODO: once we properly support unsigned at at least the AST level we should
                 // replace this with something like operand->as_uint(tmp_uint)
                 uint64_t tmp_uint = bit_cast<uint64_t, int64_t>(tmp_int);
-                match = eval(op, number.get_int64(), tmp_uint);
+                match = eval(op, item.get_int64(), tmp_uint);
             }
         } break;
-        case ondemand::json_type::boolean: {
+        case ArrayTapeValueType::False:
+        case ArrayTapeValueType::True: {
             if (unresolved_tokens.size() != cur_idx || op == FilterOperation::EXISTS
                 || op == FilterOperation::NEXISTS)
             {
                 break;
             }
             bool tmp_bool;
-            if (operand->as_bool(tmp_bool, op) && eval(op, item.get_bool(), tmp_bool)) {
+            if (operand->as_bool(tmp_bool, op)
+                && eval(op, ArrayTapeValueType::True == type, tmp_bool))
+            {
                 match = true;
             }
         } break;
-        case ondemand::json_type::null: {
+        case ArrayTapeValueType::Null: {
             if (op != FilterOperation::EXISTS && op != FilterOperation::NEXISTS
                 && operand->as_null(op))
             {
@@ -589,23 +864,22 @@ bool QueryRunner::evaluate_array_filter_value(
     return match;
 }
 
+template <typename Array>
 bool QueryRunner::evaluate_array_filter_array(
-        ondemand::array& array,
+        Array& array,
         FilterOperation op,
         DescriptorList const& unresolved_tokens,
         size_t cur_idx,
         std::shared_ptr<Literal> const& operand
 ) const {
-    for (ondemand::value item : array) {
-        if (evaluate_array_filter_value(item, op, unresolved_tokens, cur_idx, operand)) {
-            return true;
-        }
-    }
-    return false;
+    return array.any_value([&](auto& item) {
+        return evaluate_array_filter_value(item, op, unresolved_tokens, cur_idx, operand);
+    });
 }
 
+template <typename Object>
 bool QueryRunner::evaluate_array_filter_object(
-        ondemand::object& object,
+        Object& object,
         FilterOperation op,
         DescriptorList const& unresolved_tokens,
         size_t cur_idx,
@@ -615,22 +889,24 @@ bool QueryRunner::evaluate_array_filter_object(
         return false;
     }
 
-    for (auto field : object) {
-        if (field.unescaped_key(true).value() != unresolved_tokens[cur_idx].get_token()) {
-            continue;
+    // Only the first field with the key is evaluated
+    bool match = false;
+    object.any_field([&](std::string_view key, auto& item) {
+        if (key != unresolved_tokens[cur_idx].get_token()) {
+            return false;
         }
 
         cur_idx += 1;
         if (cur_idx == unresolved_tokens.size()
             && (op == FilterOperation::EXISTS || op == FilterOperation::NEXISTS))
         {
-            return op == FilterOperation::EXISTS;
+            match = op == FilterOperation::EXISTS;
+        } else {
+            match = evaluate_array_filter_value(item, op, unresolved_tokens, cur_idx, operand);
         }
-
-        ondemand::value item = field.value();
-        return evaluate_array_filter_value(item, op, unresolved_tokens, cur_idx, operand);
-    }
-    return false;
+        return true;
+    });
+    return match;
 }
 
 bool QueryRunner::evaluate_wildcard_array_filter(
@@ -642,161 +918,119 @@ bool QueryRunner::evaluate_wildcard_array_filter(
         value.reserve(value.size() + simdjson::SIMDJSON_PADDING);
     }
     auto obj = m_array_parser.iterate(value);
-    ondemand::array array = obj.get_array();
+    SimdjsonArray array{obj.get_array()};
 
     // pre-evaluate whether we can match strings or numbers to eliminate
     // duplicate effort on every item
     m_maybe_string = operand->as_var_string(m_array_search_string, op)
                      || operand->as_clp_string(m_array_search_string, op);
 
-    return evaluate_wildcard_array_filter(array, op, operand);
+    return evaluate_wildcard_array_filter_array(array, op, operand);
 }
 
-bool QueryRunner::evaluate_wildcard_array_filter(
-        ondemand::array& array,
+bool QueryRunner::evaluate_wildcard_array_tape_filter(
+        FilterOperation op,
+        std::string_view tape,
+        std::shared_ptr<Literal> const& operand
+) {
+    ArrayTapeContainer array{tape};
+
+    // pre-evaluate whether we can match strings to eliminate duplicate effort on every item
+    m_maybe_string = operand->as_var_string(m_array_search_string, op)
+                     || operand->as_clp_string(m_array_search_string, op);
+
+    return evaluate_wildcard_array_filter_array(array, op, operand);
+}
+
+template <typename Array>
+bool QueryRunner::evaluate_wildcard_array_filter_array(
+        Array& array,
         FilterOperation op,
         std::shared_ptr<Literal> const& operand
 ) const {
-    bool match = false;
-    for (auto item : array) {
-        switch (item.type()) {
-            case ondemand::json_type::object: {
-                ondemand::object nested_object = item.get_object();
-                if (evaluate_wildcard_array_filter(nested_object, op, operand)) {
-                    match = true;
-                }
-            } break;
-            case ondemand::json_type::array: {
-                ondemand::array nested_array = item.get_array();
-                if (evaluate_wildcard_array_filter(nested_array, op, operand)) {
-                    match = true;
-                }
-            } break;
-            case ondemand::json_type::string: {
-                if (false == m_maybe_string) {
-                    break;
-                }
-                if (StringUtils::wildcard_match_unsafe(
-                            item.get_string().value(),
-                            m_array_search_string,
-                            false == m_ignore_case
-                    ))
-                {
-                    match |= op == FilterOperation::EQ;
-                }
-                break;
-            } break;
-            case ondemand::json_type::number: {
-                if (false == m_maybe_number) {
-                    break;
-                }
-                ondemand::number number = item.get_number();
-                if (number.is_double()) {
-                    double tmp_double;
-                    operand->as_float(tmp_double, op);
-                    match |= eval(op, number.get_double(), tmp_double);
-                } else if (number.is_uint64()) {
-                    int64_t tmp_int;
-                    operand->as_int(tmp_int, op);
-                    match |= eval(op, number.get_uint64(), tmp_int);
-                } else {
-                    int64_t tmp_int;
-                    operand->as_int(tmp_int, op);
-                    match |= eval(op, number.get_int64(), tmp_int);
-                }
-            } break;
-            case ondemand::json_type::boolean: {
-                bool tmp;
-                if (operand->as_bool(tmp, op) && eval(op, item.get_bool(), tmp)) {
-                    match = true;
-                }
-            } break;
-            case ondemand::json_type::null:
-                if (operand->as_null(op)) {
-                    match |= op == FilterOperation::EQ;
-                }
-                break;
-        }
+    return array.any_value([&](auto& item) {
+        return evaluate_wildcard_array_filter_value(item, op, operand);
+    });
+}
 
-        if (match) {
-            return true;
-        }
-    }
-    return false;
+template <typename Object>
+bool QueryRunner::evaluate_wildcard_array_filter_object(
+        Object& object,
+        FilterOperation op,
+        std::shared_ptr<Literal> const& operand
+) const {
+    return object.any_field([&]([[maybe_unused]] std::string_view key, auto& item) {
+        return evaluate_wildcard_array_filter_value(item, op, operand);
+    });
 }
 
-bool QueryRunner::evaluate_wildcard_array_filter(
-        ondemand::object& object,
+template <typename ArrayValue>
+bool QueryRunner::evaluate_wildcard_array_filter_value(
+        ArrayValue& item,
         FilterOperation op,
         std::shared_ptr<Literal> const& operand
 ) const {
     bool match = false;
-    for (auto field : object) {
-        ondemand::value item = field.value();
-        switch (item.type()) {
-            case ondemand::json_type::object: {
-                ondemand::object nested_object = item.get_object();
-                if (evaluate_wildcard_array_filter(nested_object, op, operand)) {
-                    match = true;
-                }
-            } break;
-            case ondemand::json_type::array: {
-                ondemand::array nested_array = item.get_array();
-                if (evaluate_wildcard_array_filter(nested_array, op, operand)) {
-                    match = true;
-                }
-            } break;
-            case ondemand::json_type::string: {
-                if (false == m_maybe_string) {
-                    break;
-                }
-                if (StringUtils::wildcard_match_unsafe(
-                            item.get_string().value(),
-                            m_array_search_string,
-                            false == m_ignore_case
-                    ))
-                {
-                    match |= op == FilterOperation::EQ;
-                }
+    switch (auto const type = item.get_type(); type) {
+        case ArrayTapeValueType::Object: {
+            auto nested_object = item.get_object();
+            if (evaluate_wildcard_array_filter_object(nested_object, op, operand)) {
+                match = true;
+            }
+        } break;
+        case ArrayTapeValueType::Array: {
+            auto nested_array = item.get_array();
+            if (evaluate_wildcard_array_filter_array(nested_array, op, operand)) {
+                match = true;
+            }
+        } break;
+        case ArrayTapeValueType::String: {
+            if (false == m_maybe_string) {
                 break;
-            } break;
-            case ondemand::json_type::number: {
-                if (false == m_maybe_number) {
-                    break;
-                }
-                ondemand::number number = item.get_number();
-                if (number.is_double()) {
-                    double tmp_double;
-                    operand->as_float(tmp_double, op);
-                    match |= eval(op, number.get_double(), tmp_double);
-                } else if (number.is_uint64()) {
-                    int64_t tmp_int;
-                    operand->as_int(tmp_int, op);
-                    match |= eval(op, number.get_uint64(), tmp_int);
-                } else {
-                    int64_t tmp_int;
-                    operand->as_int(tmp_int, op);
-                    match |= eval(op, number.get_int64(), tmp_int);
-                }
-            } break;
-            case ondemand::json_type::boolean: {
-                bool tmp;
-                if (operand->as_bool(tmp, op) && eval(op, item.get_bool(), tmp)) {
-                    match = true;
-                }
-            } break;
-            case ondemand::json_type::null:
-                if (operand->as_null(op)) {
-                    match |= op == FilterOperation::EQ;
-                }
+            }
+            if (StringUtils::wildcard_match_unsafe(
+                        item.get_string(),
+                        m_array_search_string,
+                        false == m_ignore_case
+                ))
+            {
+                match |= op == FilterOperation::EQ;
+            }
+        } break;
+        case ArrayTapeValueType::Double:
+        case ArrayTapeValueType::UInt64:
+        case ArrayTapeValueType::Int64: {
+            if (false == m_maybe_number) {
                 break;
-        }
-
-        if (match) {
-            return true;
-        }
+            }
+            if (ArrayTapeValueType::Double == type) {
+                double tmp_double;
+                operand->as_float(tmp_double, op);
+                match |= eval(op, item.get_double(), tmp_double);
+            } else if (ArrayTapeValueType::UInt64 == type) {
+                int64_t tmp_int;
+                operand->as_int(tmp_int, op);
+                match |= eval(op, item.get_uint64(), tmp_int);
+            } else {
+                int64_t tmp_int;
+                operand->as_int(tmp_int, op);
+                match |= eval(op, item.get_int64(), tmp_int);
+            }
+        } break;
+        case ArrayTapeValueType::False:
+        case ArrayTapeValueType::True: {
+            bool tmp;
+            if (operand->as_bool(tmp, op) && eval(op, ArrayTapeValueType::True == type, tmp)) {
+                match = true;
+            }
+        } break;
+        case ArrayTapeValueType::Null:
+            if (operand->as_null(op)) {
+                match |= op == FilterOperation::EQ;
+            }
+            break;
     }
-    return false;
+    return match;
 }
 
 bool QueryRunner::evaluate_bool_filter(
@@ -856,16 +1090,28 @@ void QueryRunner::populate_string_queries(std::shared_ptr<Expression> const& exp
             }
 
             // search on log type dictionary
-            m_string_query_map.emplace(
-                    query_string,
-                    Grep::process_raw_query(
-                            m_log_dict,
-                            m_var_dict,
-                            query_string,
-                            m_ignore_case,
-                            false
-                    )
-            );
+            if (nullptr != m_query_plan) {
+                m_string_query_map.emplace(
+                        query_string,
+                        Grep::process_raw_query(
+                                m_log_dict,
+                                m_var_dict,
+                                m_query_plan->get_preprocessed_clp_string_query(query_string),
+                                m_ignore_case
+                        )
+                );
+            } else {
+                m_string_query_map.emplace(
+                        query_string,
+                        Grep::process_raw_query(
+                                m_log_dict,
+                                m_var_dict,
+                                query_string,
+                                m_ignore_case,
+                                false
+                        )
+                );
+            }
         }
         SubQuery sub_query;
         if (filter->get_column()->matches_type(LiteralType::VarStringT)) {
@@ -1008,7 +1254,7 @@ EvaluatedValue QueryRunner::constant_propagate(std::shared_ptr<Expression> const
             return expr->is_inverted() ? EvaluatedValue::True : EvaluatedValue::False;
         }
     } else if (std::dynamic_pointer_cast<AndExpr>(expr)) {
-        bool any_unknown = true;
+        bool any_unknown = false;
         std::vector<OpList::iterator> to_delete;
         for (auto it = expr->op_begin(); it != expr->op_end(); it++) {
             auto subExpr = std::static_pointer_cast<Expression>(*it);
@@ -1166,13 +1412,79 @@ EvaluatedValue QueryRunner::constant_propagate(std::shared_ptr<Expression> const
                 return EvaluatedValue::Unknown;
             }
         } else {
-            return EvaluatedValue::Unknown;
+            return evaluate_timestamp_range_filter(filter.get());
         }
     }
 
     return EvaluatedValue::Unknown;
 }
 
+auto QueryRunner::evaluate_timestamp_range_filter(FilterExpr* filter) const -> EvaluatedValue {
+    auto* column = filter->get_column().get();
+    if (column->is_pure_wildcard() || column->has_unresolved_tokens()) {
+        return EvaluatedValue::Unknown;
+    }
+
+    // Float timestamps are truncated when their range is recorded, so only integral timestamps can
+    // be compared against the range exactly
+    auto const literal_type = column->get_literal_type();
+    if (LiteralType::IntegerT != literal_type && LiteralType::EpochDateT != literal_type) {
+        return EvaluatedValue::Unknown;
+    }
+    auto const& timestamp_column_ids = m_timestamp_dict->get_authoritative_timestamp_column_ids();
+    if (0 == timestamp_column_ids.count(column->get_column_id())) {
+        return EvaluatedValue::Unknown;
+    }
+
+    auto const range = m_archive_reader->get_table_timestamp_range(m_schema);
+    int64_t operand{};
+    if (false == range.has_value()
+        || false == filter->get_operand()->as_int(operand, filter->get_operation()))
+    {
+        return EvaluatedValue::Unknown;
+    }
+
+    auto const [begin_timestamp, end_timestamp] = range.value();
+    bool matches_all{false};
+    bool matches_none{false};
+    switch (filter->get_operation()) {
+        case FilterOperation::EQ:
+            matches_all = begin_timestamp == operand && end_timestamp == operand;
+            matches_none = operand < begin_timestamp || operand > end_timestamp;
+            break;
+        case FilterOperation::NEQ:
+            matches_all = operand < begin_timestamp || operand > end_timestamp;
+            matches_none = begin_timestamp == operand && end_timestamp == operand;
+            break;
+        case FilterOperation::LT:
+            matches_all = end_timestamp < operand;
+            matches_none = begin_timestamp >= operand;
+            break;
+        case FilterOperation::LTE:
+            matches_all = end_timestamp <= operand;
+            matches_none = begin_timestamp > operand;
+            break;
+        case FilterOperation::GT:
+            matches_all = begin_timestamp > operand;
+            matches_none = end_timestamp <= operand;
+            break;
+        case FilterOperation::GTE:
+            matches_all = begin_timestamp >= operand;
+            matches_none = end_timestamp < operand;
+            break;
+        default:
+            return EvaluatedValue::Unknown;
+    }
+
+    if (matches_all) {
+        return filter->is_inverted() ? EvaluatedValue::False : EvaluatedValue::True;
+    }
+    if (matches_none) {
+        return filter->is_inverted() ? EvaluatedValue::True : EvaluatedValue::False;
+    }
+    return EvaluatedValue::Unknown;
+}
+
 bool QueryRunner::evaluate_epoch_date_filter(
         FilterOperation op,
         DateStringColumnReader* reader,
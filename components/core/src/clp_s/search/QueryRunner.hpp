@@ -9,6 +9,7 @@
 #include <set>
 #include <stack>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
@@ -17,6 +18,7 @@
 #include <simdjson.h>
 
 #include "../ArchiveReader.hpp"
+#include "../ArrayTape.hpp"
 #include "../ColumnReader.hpp"
 #include "../DictionaryReader.hpp"
 #include "../ReaderUtils.hpp"
@@ -30,6 +32,7 @@
 #include "ast/FilterOperation.hpp"
 #include "ast/Literal.hpp"
 #include "clp_search/Query.hpp"
+#include "QueryPlan.hpp"
 #include "SchemaMatch.hpp"
 
 using namespace simdjson;
@@ -50,12 +53,14 @@ public:
             std::shared_ptr<SchemaMatch> const& match,
             std::shared_ptr<ast::Expression> const& expr,
             std::shared_ptr<ArchiveReader> const& archive_reader,
-            bool ignore_case
+            bool ignore_case,
+            std::shared_ptr<QueryPlan> query_plan = nullptr
     )
             : m_archive_reader(archive_reader),
               m_expr(expr),
               m_match(match),
               m_ignore_case(ignore_case),
+              m_query_plan(std::move(query_plan)),
               m_schema_tree(m_archive_reader->get_schema_tree()),
               m_var_dict(m_archive_reader->get_variable_dictionary()),
               m_log_dict(m_archive_reader->get_log_type_dictionary()),
@@ -85,10 +90,22 @@ public:
      * the expression. If the expression evaluates to false, it returns EvaluatedValue::False.
      * Otherwise, it sets the wildcard matching type mask.
      *
+     * If the context for the schema was saved by `cache_schema_init`, it's restored instead.
+     *
      * @param schema_id
      */
     auto schema_init(int32_t schema_id) -> EvaluatedValue;
 
+    /**
+     * Initializes the query processing context for a given schema like `schema_init`, and saves it
+     * so that the next call to `schema_init` for the schema restores it instead of initializing it
+     * again. This lets schemas be evaluated before they're searched (e.g., to order them).
+     *
+     * @param schema_id
+     * @return The value that the query evaluates to for the schema.
+     */
+    auto cache_schema_init(int32_t schema_id) -> EvaluatedValue;
+
 protected:
     // Methods inherited from FilterClass
     auto filter(uint64_t cur_message) -> bool override;
@@ -113,10 +130,23 @@ private:
         Filter
     };
 
+    // The query processing context initialized by `schema_init` for a schema
+    struct SchemaContext {
+        std::shared_ptr<ast::Expression> expr;
+        std::unordered_map<ast::Expression*, Query*> expr_clp_query;
+        std::unordered_map<ast::Expression*, std::unordered_set<int64_t>*> expr_var_match_map;
+        std::vector<ast::ColumnDescriptor*> wildcard_columns;
+        std::map<ast::ColumnDescriptor*, std::set<int32_t>> wildcard_to_searched_basic_columns;
+        ast::literal_type_bitmask_t wildcard_type_mask{0};
+        EvaluatedValue expression_value{EvaluatedValue::Unknown};
+    };
+
     std::shared_ptr<ArchiveReader> m_archive_reader;
     std::shared_ptr<ast::Expression> m_expr;
     std::shared_ptr<SchemaMatch> m_match;
     bool m_ignore_case;
+    // Caches the archive-independent preprocessing of string queries across archives, if set
+    std::shared_ptr<QueryPlan> m_query_plan;
 
     // variables for the current schema being filtered
     int32_t m_schema{-1};
@@ -138,6 +168,7 @@ private:
     std::unordered_map<int32_t, std::vector<VariableStringColumnReader*>> m_var_string_readers;
     std::unordered_map<int32_t, DateStringColumnReader*> m_datestring_readers;
     std::unordered_map<int32_t, std::vector<BaseColumnReader*>> m_basic_readers;
+    std::unordered_map<int32_t, UnstructuredArrayColumnReader*> m_array_tape_readers;
     std::unordered_map<int32_t, std::string> m_extracted_unstructured_arrays;
     uint64_t m_cur_message{0};
     EvaluatedValue m_expression_value{EvaluatedValue::Unknown};
@@ -146,6 +177,7 @@ private:
     std::map<ast::ColumnDescriptor*, std::set<int32_t>> m_wildcard_to_searched_basic_columns;
     ast::literal_type_bitmask_t m_wildcard_type_mask{0};
     std::unordered_set<int32_t> m_metadata_columns;
+    std::unordered_map<int32_t, SchemaContext> m_cached_schema_contexts;
 
     std::stack<
             std::pair<ExpressionType, ast::OpList::iterator>,
@@ -290,7 +322,33 @@ private:
     ) -> bool;
 
     /**
-     * Evaluates a filter expression on a single value for precise array search.
+     * Evaluates an array filter expression on an array encoded as a tape, without parsing it
+     * @param op
+     * @param unresolved_tokens
+     * @param tape
+     * @param operand
+     * @return true if the expression evaluates to true, false otherwise
+     */
+    auto evaluate_array_tape_filter(
+            ast::FilterOperation op,
+            ast::DescriptorList const& unresolved_tokens,
+            std::string_view tape,
+            std::shared_ptr<ast::Literal> const& operand
+    ) -> bool;
+
+    /**
+     * Pre-evaluates whether the operand of an array filter expression can match strings or numbers,
+     * so that it isn't re-evaluated for every item in the array.
+     * @param op
+     * @param operand
+     */
+    void
+    prepare_array_filter(ast::FilterOperation op, std::shared_ptr<ast::Literal> const& operand);
+
+    /**
+     * Evaluates a filter expression on a single value for precise array search. Arrays stored as
+     * JSON and as array tapes are both evaluated through the accessors defined in QueryRunner.cpp.
+     * @tparam ArrayValue The accessor for a value in an array
      * @param item
      * @param op
      * @param unresolved_tokens
@@ -298,8 +356,9 @@ private:
      * @param operand
      * @return true if the expression evaluates to true, false otherwise
      */
-    inline auto evaluate_array_filter_value(
-            ondemand::value& item,
+    template <typename ArrayValue>
+    auto evaluate_array_filter_value(
+            ArrayValue& item,
             ast::FilterOperation op,
             ast::DescriptorList const& unresolved_tokens,
             size_t cur_idx,
@@ -308,6 +367,7 @@ private:
 
     /**
      * Evaluates a filter expression on an array (top level or nested) for precise array search.
+     * @tparam Array The accessor for an array
      * @param array
      * @param op
      * @param unresolved_tokens
@@ -315,8 +375,9 @@ private:
      * @param operand
      * @return true if the expression evaluates to true, false otherwise
      */
+    template <typename Array>
     auto evaluate_array_filter_array(
-            ondemand::array& array,
+            Array& array,
             ast::FilterOperation op,
             ast::DescriptorList const& unresolved_tokens,
             size_t cur_idx,
@@ -325,6 +386,7 @@ private:
 
     /**
      * Evaluates a filter expression on an object inside of an array for precise array search.
+     * @tparam Object The accessor for an object
      * @param object
      * @param op
      * @param unresolved_tokens
@@ -332,8 +394,9 @@ private:
      * @param operand
      * @return true if the expression evaluates to true, false otherwise
      */
+    template <typename Object>
     auto evaluate_array_filter_object(
-            ondemand::object& object,
+            Object& object,
             ast::FilterOperation op,
             ast::DescriptorList const& unresolved_tokens,
             size_t cur_idx,
@@ -354,27 +417,60 @@ private:
     ) -> bool;
 
     /**
-     * The implementation of evaluate_wildcard_array_filter
+     * Evaluates a wildcard array filter expression on an array encoded as a tape, without parsing
+     * it
+     * @param op
+     * @param tape
+     * @param operand
+     * @return true if the expression evaluates to true, false otherwise
+     */
+    auto evaluate_wildcard_array_tape_filter(
+            ast::FilterOperation op,
+            std::string_view tape,
+            std::shared_ptr<ast::Literal> const& operand
+    ) -> bool;
+
+    /**
+     * The implementation of evaluate_wildcard_array_filter for an array
+     * @tparam Array The accessor for an array
      * @param array
      * @param op
      * @param operand
      * @return true if the expression evaluates to true, false otherwise
      */
-    auto evaluate_wildcard_array_filter(
-            ondemand::array& array,
+    template <typename Array>
+    auto evaluate_wildcard_array_filter_array(
+            Array& array,
             ast::FilterOperation op,
             std::shared_ptr<ast::Literal> const& operand
     ) const -> bool;
 
     /**
-     * The implementation of evaluate_wildcard_array_filter
+     * The implementation of evaluate_wildcard_array_filter for an object
+     * @tparam Object The accessor for an object
      * @param object
      * @param op
      * @param operand
      * @return true if the expression evaluates to true, false otherwise
      */
-    auto evaluate_wildcard_array_filter(
-            ondemand::object& object,
+    template <typename Object>
+    auto evaluate_wildcard_array_filter_object(
+            Object& object,
+            ast::FilterOperation op,
+            std::shared_ptr<ast::Literal> const& operand
+    ) const -> bool;
+
+    /**
+     * The implementation of evaluate_wildcard_array_filter for a single value
+     * @tparam ArrayValue The accessor for a value in an array
+     * @param item
+     * @param op
+     * @param operand
+     * @return true if the expression evaluates to true, false otherwise
+     */
+    template <typename ArrayValue>
+    auto evaluate_wildcard_array_filter_value(
+            ArrayValue& item,
             ast::FilterOperation op,
             std::shared_ptr<ast::Literal> const& operand
     ) const -> bool;
@@ -411,6 +507,16 @@ private:
      */
     auto constant_propagate(std::shared_ptr<ast::Expression> const& expr) -> EvaluatedValue;
 
+    /**
+     * Evaluates a filter on the authoritative timestamp column against the range of timestamps in
+     * the current schema's table, which tells whether the filter matches every record in the table
+     * or none of them.
+     * @param filter
+     * @return EvaluatedValue::True if the filter matches every record in the table,
+     * EvaluatedValue::False if it matches none of them, EvaluatedValue::Unknown otherwise
+     */
+    auto evaluate_timestamp_range_filter(ast::FilterExpr* filter) const -> EvaluatedValue;
+
     /**
      * Populates searched wildcard columns
      * @param expr
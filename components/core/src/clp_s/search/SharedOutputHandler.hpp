@@ -0,0 +1,105 @@
+#ifndef CLP_S_SEARCH_SHAREDOUTPUTHANDLER_HPP
+#define CLP_S_SEARCH_SHAREDOUTPUTHANDLER_HPP
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "../ColumnReader.hpp"
+#include "../Defs.hpp"
+#include "../ErrorCode.hpp"
+#include "OutputHandler.hpp"
+
+namespace clp_s::search {
+/**
+ * Output handler that forwards results to an output handler shared by several searches running
+ * concurrently (e.g., of different archives), serializing every access to the shared handler.
+ *
+ * The shared handler must be finished by its owner once every search using it has completed, so
+ * `finish` only flushes it.
+ */
+class SharedOutputHandler : public OutputHandler {
+public:
+    // Constructors
+    /**
+     * @param handler The shared output handler.
+     * @param mutex The mutex serializing access to the shared output handler, which must be shared
+     * by every SharedOutputHandler forwarding to it.
+     */
+    SharedOutputHandler(std::shared_ptr<OutputHandler> handler, std::shared_ptr<std::mutex> mutex)
+            : OutputHandler(handler->should_output_metadata(), handler->should_marshal_records()),
+              m_handler{std::move(handler)},
+              m_mutex{std::move(mutex)} {}
+
+    // Methods inherited from OutputHandler
+    void write(
+            std::string_view message,
+            epochtime_t timestamp,
+            std::string_view archive_id,
+            int64_t log_event_idx
+    ) override {
+        std::lock_guard const lock{*m_mutex};
+        m_handler->write(message, timestamp, archive_id, log_event_idx);
+    }
+
+    void write(std::string_view message) override {
+        std::lock_guard const lock{*m_mutex};
+        m_handler->write(message);
+    }
+
+    [[nodiscard]] auto write_count(
+            uint64_t count,
+            std::optional<std::pair<epochtime_t, epochtime_t>> const& timestamp_range
+    ) -> bool override {
+        std::lock_guard const lock{*m_mutex};
+        return m_handler->write_count(count, timestamp_range);
+    }
+
+    [[nodiscard]] auto get_aggregated_column() const
+            -> std::optional<std::vector<std::string>> override {
+        return m_handler->get_aggregated_column();
+    }
+
+    void write_column_value(BaseColumnReader& column_reader, uint64_t message_idx) override {
+        std::lock_guard const lock{*m_mutex};
+        m_handler->write_column_value(column_reader, message_idx);
+    }
+
+    [[nodiscard]] auto flush() -> ErrorCode override {
+        std::lock_guard const lock{*m_mutex};
+        return m_handler->flush();
+    }
+
+    [[nodiscard]] auto finish() -> ErrorCode override { return flush(); }
+
+    [[nodiscard]] auto keeps_latest_log_events() const -> bool override {
+        return m_handler->keeps_latest_log_events();
+    }
+
+    [[nodiscard]] auto get_min_exclusive_timestamp() const -> std::optional<epochtime_t> override {
+        std::lock_guard const lock{*m_mutex};
+        return m_handler->get_min_exclusive_timestamp();
+    }
+
+    [[nodiscard]] auto may_stop_early() const -> bool override {
+        return m_handler->may_stop_early();
+    }
+
+protected:
+    [[nodiscard]] auto is_done() const -> bool override {
+        std::lock_guard const lock{*m_mutex};
+        return m_handler->should_stop();
+    }
+
+private:
+    std::shared_ptr<OutputHandler> m_handler;
+    std::shared_ptr<std::mutex> m_mutex;
+};
+}  // namespace clp_s::search
+
+#endif  // CLP_S_SEARCH_SHAREDOUTPUTHANDLER_HPP
@@ -21,62 +21,6 @@ enum class SubQueryMatchabilityResult {
     SupercedesAllSubQueries  // The subquery will cause all messages to be matched
 };
 
-// Class representing a token in a query. It is used to interpret a token in user's search
-// string.
-class QueryToken {
-public:
-    // Constructors
-    QueryToken(string const& query_string, size_t begin_pos, size_t end_pos, bool is_var);
-
-    // Methods
-    bool cannot_convert_to_non_dict_var() const;
-    bool contains_wildcards() const;
-    bool has_greedy_wildcard_in_middle() const;
-    bool has_prefix_greedy_wildcard() const;
-    bool has_suffix_greedy_wildcard() const;
-    bool is_ambiguous_token() const;
-    bool is_double_var() const;
-    bool is_var() const;
-    bool is_wildcard() const;
-
-    size_t get_begin_pos() const;
-    size_t get_end_pos() const;
-    string const& get_value() const;
-
-    bool change_to_next_possible_type();
-
-private:
-    // Types
-    // Type for the purpose of generating different subqueries. E.g., if a token is of type
-    // DictOrIntVar, it would generate a different subquery than if it was of type Logtype.
-    enum class Type {
-        Wildcard,
-        // Ambiguous indicates the token can be more than one of the types listed below
-        Ambiguous,
-        Logtype,
-        DictOrIntVar,
-        DoubleVar
-    };
-
-    // Variables
-    bool m_cannot_convert_to_non_dict_var;
-    bool m_contains_wildcards;
-    bool m_has_greedy_wildcard_in_middle;
-    bool m_has_prefix_greedy_wildcard;
-    bool m_has_suffix_greedy_wildcard;
-
-    size_t m_begin_pos;
-    size_t m_end_pos;
-    string m_value;
-
-    // Type if variable has unambiguous type
-    Type m_type;
-    // Types if variable type is ambiguous
-    vector<Type> m_possible_types;
-    // Index of the current possible type selected for generating a subquery
-    size_t m_current_possible_type_ix;
-};
-
 QueryToken::QueryToken(
         string const& query_string,
         size_t const begin_pos,
@@ -411,8 +355,20 @@ std::optional<Query> Grep::process_raw_query(
         bool ignore_case,
         bool add_wildcards
 ) {
+    return process_raw_query(
+            std::move(log_dict),
+            std::move(var_dict),
+            preprocess_raw_query(search_string, add_wildcards),
+            ignore_case
+    );
+}
+
+auto Grep::preprocess_raw_query(string const& search_string, bool add_wildcards)
+        -> PreprocessedQuery {
+    PreprocessedQuery preprocessed_query;
+    auto& processed_search_string = preprocessed_query.processed_search_string;
+
     // Add prefix and suffix '*' to make the search a sub-string match
-    string processed_search_string;
     if (add_wildcards) {
         processed_search_string = "*";
         processed_search_string += search_string;
@@ -431,13 +387,29 @@ std::optional<Query> Grep::process_raw_query(
     processed_search_string = StringUtils::clean_up_wildcard_search_string(processed_search_string);
 
     // Split search_string into tokens with wildcards
-    vector<QueryToken> query_tokens;
     size_t begin_pos = 0;
     size_t end_pos = 0;
     bool is_var;
     while (get_bounds_of_next_potential_var(processed_search_string, begin_pos, end_pos, is_var)) {
-        query_tokens.emplace_back(processed_search_string, begin_pos, end_pos, is_var);
+        preprocessed_query.query_tokens.emplace_back(
+                processed_search_string,
+                begin_pos,
+                end_pos,
+                is_var
+        );
     }
+    return preprocessed_query;
+}
+
+std::optional<Query> Grep::process_raw_query(
+        std::shared_ptr<LogTypeDictionaryReader> log_dict,
+        std::shared_ptr<VariableDictionaryReader> var_dict,
+        PreprocessedQuery const& preprocessed_query,
+        bool ignore_case
+) {
+    // The tokens are copied since their types are changed while generating sub-queries
+    string processed_search_string = preprocessed_query.processed_search_string;
+    vector<QueryToken> query_tokens = preprocessed_query.query_tokens;
 
     // Get pointers to all ambiguous tokens. Exclude tokens with wildcards in the middle since
     // we fall-back to decompression + wildcard matching for those.
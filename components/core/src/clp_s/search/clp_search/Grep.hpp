@@ -6,14 +6,81 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <vector>
 
 #include "../../Defs.hpp"
 #include "../../DictionaryReader.hpp"
 #include "Query.hpp"
 
 namespace clp_s::search::clp_search {
+// Class representing a token in a query. It is used to interpret a token in user's search
+// string.
+class QueryToken {
+public:
+    // Constructors
+    QueryToken(std::string const& query_string, size_t begin_pos, size_t end_pos, bool is_var);
+
+    // Methods
+    bool cannot_convert_to_non_dict_var() const;
+    bool contains_wildcards() const;
+    bool has_greedy_wildcard_in_middle() const;
+    bool has_prefix_greedy_wildcard() const;
+    bool has_suffix_greedy_wildcard() const;
+    bool is_ambiguous_token() const;
+    bool is_double_var() const;
+    bool is_var() const;
+    bool is_wildcard() const;
+
+    size_t get_begin_pos() const;
+    size_t get_end_pos() const;
+    std::string const& get_value() const;
+
+    bool change_to_next_possible_type();
+
+private:
+    // Types
+    // Type for the purpose of generating different subqueries. E.g., if a token is of type
+    // DictOrIntVar, it would generate a different subquery than if it was of type Logtype.
+    enum class Type {
+        Wildcard,
+        // Ambiguous indicates the token can be more than one of the types listed below
+        Ambiguous,
+        Logtype,
+        DictOrIntVar,
+        DoubleVar
+    };
+
+    // Variables
+    bool m_cannot_convert_to_non_dict_var;
+    bool m_contains_wildcards;
+    bool m_has_greedy_wildcard_in_middle;
+    bool m_has_prefix_greedy_wildcard;
+    bool m_has_suffix_greedy_wildcard;
+
+    size_t m_begin_pos;
+    size_t m_end_pos;
+    std::string m_value;
+
+    // Type if variable has unambiguous type
+    Type m_type;
+    // Types if variable type is ambiguous
+    std::vector<Type> m_possible_types;
+    // Index of the current possible type selected for generating a subquery
+    size_t m_current_possible_type_ix;
+};
+
 class Grep {
 public:
+    // Types
+    /**
+     * A raw query which has been cleaned up and split into tokens. This doesn't depend on the
+     * dictionaries being searched, so it can be reused across archives.
+     */
+    struct PreprocessedQuery {
+        std::string processed_search_string;
+        std::vector<QueryToken> query_tokens;
+    };
+
     // Methods
     /**
      * Processes a raw user query into a Query
@@ -32,6 +99,30 @@ public:
             bool add_wildcards = true
     );
 
+    /**
+     * Cleans up a raw user query and splits it into tokens
+     * @param search_string
+     * @param add_wildcards
+     * @return The preprocessed query
+     */
+    static auto preprocess_raw_query(std::string const& search_string, bool add_wildcards = true)
+            -> PreprocessedQuery;
+
+    /**
+     * Processes a preprocessed user query into a Query
+     * @param log_dict
+     * @param var_dict
+     * @param preprocessed_query
+     * @param ignore_case
+     * @return Query if it may match a message, std::nullopt otherwise
+     */
+    static std::optional<Query> process_raw_query(
+            std::shared_ptr<LogTypeDictionaryReader> log_dict,
+            std::shared_ptr<VariableDictionaryReader> var_dict,
+            PreprocessedQuery const& preprocessed_query,
+            bool ignore_case
+    );
+
     /**
      * Returns bounds of next potential variable (either a definite variable or a token with
      * wildcards)
@@ -0,0 +1,400 @@
+#include "ColumnarRecordGroup.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../clp/ErrorCode.hpp"
+#include "ConstRecordIterator.hpp"
+#include "GroupTags.hpp"
+#include "RecordTypedKeyIterator.hpp"
+
+namespace reducer {
+namespace {
+constexpr size_t cNumBitsPerByte = 8;
+
+/**
+ * A bounds-checked reader over a serialized columnar record group.
+ */
+class BufferReader {
+public:
+    BufferReader(char const* buf, size_t len) : m_cur{buf}, m_end{buf + len} {}
+
+    /**
+     * Reads a fixed-width integer.
+     * @tparam T
+     * @param value Returns the value read.
+     * @return Whether there were enough bytes to read the value.
+     */
+    template <typename T>
+    [[nodiscard]] bool read_int(T& value) {
+        if (static_cast<size_t>(m_end - m_cur) < sizeof(T)) {
+            return false;
+        }
+        memcpy(&value, m_cur, sizeof(T));
+        m_cur += sizeof(T);
+        return true;
+    }
+
+    /**
+     * Skips over the given number of bytes.
+     * @param num_bytes
+     * @param bytes Returns a pointer to the first byte skipped.
+     * @return Whether there were enough bytes to skip.
+     */
+    [[nodiscard]] bool read_bytes(size_t num_bytes, char const*& bytes) {
+        if (static_cast<size_t>(m_end - m_cur) < num_bytes) {
+            return false;
+        }
+        bytes = m_cur;
+        m_cur += num_bytes;
+        return true;
+    }
+
+    [[nodiscard]] bool is_exhausted() const { return m_cur == m_end; }
+
+private:
+    char const* m_cur;
+    char const* m_end;
+};
+
+/**
+ * A column being built by `serialize_columnar`.
+ */
+struct ColumnBuilder {
+    ColumnBuilder(std::string_view key, ValueType type) : key{key}, type{type} {
+        string_offsets.push_back(0);
+    }
+
+    std::string key;
+    ValueType type;
+    size_t num_records{0};
+    size_t num_values{0};
+    std::vector<uint8_t> presence_bitmap;
+    // Fixed-width values for Int64 and Double columns
+    std::vector<uint8_t> values;
+    // Offsets and data for String columns
+    std::vector<uint32_t> string_offsets;
+    std::string string_data;
+};
+
+/**
+ * Appends a fixed-width integer to the given buffer.
+ * @tparam T
+ * @param value
+ * @param buf
+ */
+template <typename T>
+void append_int(T value, std::vector<uint8_t>& buf);
+
+/**
+ * Appends the given bytes to the given buffer.
+ * @param bytes
+ * @param buf
+ */
+void append_bytes(std::string_view bytes, std::vector<uint8_t>& buf);
+
+/**
+ * Appends the given record's value for the given column's key to the column.
+ * @param record
+ * @param column
+ */
+void append_value(Record const& record, ColumnBuilder& column);
+
+/**
+ * Appends a missing value to the given column.
+ * @param column
+ */
+void append_missing_value(ColumnBuilder& column);
+
+/**
+ * Appends the serialized form of the given column to the given buffer.
+ * @param column
+ * @param buf
+ */
+void append_column(ColumnBuilder const& column, std::vector<uint8_t>& buf);
+
+template <typename T>
+void append_int(T value, std::vector<uint8_t>& buf) {
+    auto const* bytes = reinterpret_cast<uint8_t const*>(&value);
+    buf.insert(buf.end(), bytes, bytes + sizeof(T));
+}
+
+void append_bytes(std::string_view bytes, std::vector<uint8_t>& buf) {
+    buf.insert(buf.end(), bytes.begin(), bytes.end());
+}
+
+void append_value(Record const& record, ColumnBuilder& column) {
+    if (column.presence_bitmap.size() * cNumBitsPerByte <= column.num_records) {
+        column.presence_bitmap.push_back(0);
+    }
+    column.presence_bitmap.back() |= (1U << (column.num_records % cNumBitsPerByte));
+
+    switch (column.type) {
+        case ValueType::Int64:
+            append_int(record.get_int64_value(column.key), column.values);
+            break;
+        case ValueType::Double:
+            append_int(record.get_double_value(column.key), column.values);
+            break;
+        case ValueType::String:
+            column.string_data.append(record.get_string_view(column.key));
+            column.string_offsets.push_back(static_cast<uint32_t>(column.string_data.size()));
+            break;
+    }
+    ++column.num_values;
+    ++column.num_records;
+}
+
+void append_missing_value(ColumnBuilder& column) {
+    if (column.presence_bitmap.size() * cNumBitsPerByte <= column.num_records) {
+        column.presence_bitmap.push_back(0);
+    }
+
+    switch (column.type) {
+        case ValueType::Int64:
+            append_int(int64_t{0}, column.values);
+            break;
+        case ValueType::Double:
+            append_int(double{0.0}, column.values);
+            break;
+        case ValueType::String:
+            column.string_offsets.push_back(column.string_offsets.back());
+            break;
+    }
+    ++column.num_records;
+}
+
+void append_column(ColumnBuilder const& column, std::vector<uint8_t>& buf) {
+    buf.push_back(static_cast<uint8_t>(column.type));
+    append_int(static_cast<uint32_t>(column.key.size()), buf);
+    append_bytes(column.key, buf);
+
+    bool const is_dense = column.num_values == column.num_records;
+    buf.push_back(is_dense ? 1 : 0);
+    if (false == is_dense) {
+        buf.insert(buf.end(), column.presence_bitmap.begin(), column.presence_bitmap.end());
+    }
+
+    if (ValueType::String == column.type) {
+        for (auto const offset : column.string_offsets) {
+            append_int(offset, buf);
+        }
+        append_bytes(column.string_data, buf);
+    } else {
+        buf.insert(buf.end(), column.values.begin(), column.values.end());
+    }
+}
+}  // namespace
+
+ColumnarRecordGroup::ColumnarRecordGroup(char const* buf, size_t len) : m_record_it{m_columns} {
+    BufferReader reader{buf, len};
+
+    uint8_t magic{0};
+    uint8_t version{0};
+    if (false == reader.read_int(magic) || false == reader.read_int(version) || cMagic != magic) {
+        throw OperationFailed(clp::ErrorCode_Corrupt, __FILENAME__, __LINE__);
+    }
+    if (cVersion != version) {
+        throw OperationFailed(clp::ErrorCode_Unsupported, __FILENAME__, __LINE__);
+    }
+
+    uint32_t num_tags{0};
+    if (false == reader.read_int(num_tags)) {
+        throw OperationFailed(clp::ErrorCode_Truncated, __FILENAME__, __LINE__);
+    }
+    for (uint32_t i = 0; i < num_tags; ++i) {
+        uint32_t tag_length{0};
+        char const* tag{nullptr};
+        if (false == reader.read_int(tag_length) || false == reader.read_bytes(tag_length, tag)) {
+            throw OperationFailed(clp::ErrorCode_Truncated, __FILENAME__, __LINE__);
+        }
+        m_tags.emplace_back(tag, tag_length);
+    }
+
+    uint32_t num_records{0};
+    uint32_t num_columns{0};
+    if (false == reader.read_int(num_records) || false == reader.read_int(num_columns)) {
+        throw OperationFailed(clp::ErrorCode_Truncated, __FILENAME__, __LINE__);
+    }
+
+    size_t const presence_bitmap_size = (num_records + cNumBitsPerByte - 1) / cNumBitsPerByte;
+    for (uint32_t i = 0; i < num_columns; ++i) {
+        Column column;
+
+        uint8_t type{0};
+        uint32_t key_length{0};
+        char const* key{nullptr};
+        uint8_t is_dense{0};
+        if (false == reader.read_int(type) || false == reader.read_int(key_length)
+            || false == reader.read_bytes(key_length, key) || false == reader.read_int(is_dense))
+        {
+            throw OperationFailed(clp::ErrorCode_Truncated, __FILENAME__, __LINE__);
+        }
+        column.key = std::string_view{key, key_length};
+        if (type > static_cast<uint8_t>(ValueType::Double)) {
+            throw OperationFailed(clp::ErrorCode_Corrupt, __FILENAME__, __LINE__);
+        }
+        column.type = static_cast<ValueType>(type);
+
+        if (0 == is_dense
+            && false == reader.read_bytes(presence_bitmap_size, column.presence_bitmap))
+        {
+            throw OperationFailed(clp::ErrorCode_Truncated, __FILENAME__, __LINE__);
+        }
+
+        if (ValueType::String == column.type) {
+            if (false == reader.read_bytes((num_records + 1ULL) * sizeof(uint32_t), column.values))
+            {
+                throw OperationFailed(clp::ErrorCode_Truncated, __FILENAME__, __LINE__);
+            }
+
+            // Validate that the offsets are monotonic and within the string data
+            uint32_t prev_offset{0};
+            for (size_t record_idx = 0; record_idx <= num_records; ++record_idx) {
+                uint32_t offset{0};
+                memcpy(&offset, column.values + record_idx * sizeof(uint32_t), sizeof(offset));
+                if (offset < prev_offset || (0 == record_idx && 0 != offset)) {
+                    throw OperationFailed(clp::ErrorCode_Corrupt, __FILENAME__, __LINE__);
+                }
+                prev_offset = offset;
+            }
+            if (false == reader.read_bytes(prev_offset, column.string_data)) {
+                throw OperationFailed(clp::ErrorCode_Truncated, __FILENAME__, __LINE__);
+            }
+        } else if (false == reader.read_bytes(num_records * sizeof(int64_t), column.values)) {
+            throw OperationFailed(clp::ErrorCode_Truncated, __FILENAME__, __LINE__);
+        }
+
+        m_columns.push_back(column);
+    }
+
+    if (false == reader.is_exhausted()) {
+        throw OperationFailed(clp::ErrorCode_Corrupt, __FILENAME__, __LINE__);
+    }
+    m_record_it.set_num_records(num_records);
+}
+
+bool ColumnarRecordGroup::has_value(Column const& column, size_t record_idx) {
+    if (nullptr == column.presence_bitmap) {
+        return true;
+    }
+    auto const byte = static_cast<uint8_t>(column.presence_bitmap[record_idx / cNumBitsPerByte]);
+    return 0 != (byte & (1U << (record_idx % cNumBitsPerByte)));
+}
+
+std::string_view
+ColumnarRecordGroup::ColumnarRecord::get_string_view(std::string_view key) const {
+    auto const* column = find_column(key, ValueType::String);
+    if (nullptr == column) {
+        return {};
+    }
+    uint32_t begin_offset{0};
+    uint32_t end_offset{0};
+    auto const* offsets = column->values + m_record_idx * sizeof(uint32_t);
+    memcpy(&begin_offset, offsets, sizeof(begin_offset));
+    memcpy(&end_offset, offsets + sizeof(uint32_t), sizeof(end_offset));
+    return {column->string_data + begin_offset, end_offset - begin_offset};
+}
+
+int64_t ColumnarRecordGroup::ColumnarRecord::get_int64_value(std::string_view key) const {
+    auto const* column = find_column(key, ValueType::Int64);
+    if (nullptr == column) {
+        return 0;
+    }
+    int64_t value{0};
+    memcpy(&value, column->values + m_record_idx * sizeof(value), sizeof(value));
+    return value;
+}
+
+double ColumnarRecordGroup::ColumnarRecord::get_double_value(std::string_view key) const {
+    auto const* column = find_column(key, ValueType::Double);
+    if (nullptr == column) {
+        return 0.0;
+    }
+    double value{0.0};
+    memcpy(&value, column->values + m_record_idx * sizeof(value), sizeof(value));
+    return value;
+}
+
+std::unique_ptr<RecordTypedKeyIterator>
+ColumnarRecordGroup::ColumnarRecord::typed_key_iter() const {
+    return std::make_unique<ColumnarRecordTypedKeyIterator>(*m_columns, m_record_idx);
+}
+
+ColumnarRecordGroup::Column const*
+ColumnarRecordGroup::ColumnarRecord::find_column(std::string_view key, ValueType type) const {
+    // Record groups have very few columns, so a linear search is faster than a hash lookup
+    for (auto const& column : *m_columns) {
+        if (column.type == type && column.key == key) {
+            return has_value(column, m_record_idx) ? &column : nullptr;
+        }
+    }
+    return nullptr;
+}
+
+void ColumnarRecordGroup::ColumnarRecordTypedKeyIterator::skip_absent_columns() {
+    while (m_column_idx < m_columns->size()
+           && false == has_value((*m_columns)[m_column_idx], m_record_idx))
+    {
+        ++m_column_idx;
+    }
+}
+
+std::vector<uint8_t> serialize_columnar(GroupTags const& tags, ConstRecordIterator& record_it) {
+    std::vector<ColumnBuilder> columns;
+    size_t num_records{0};
+    for (; false == record_it.done(); record_it.next()) {
+        auto const& record = record_it.get();
+        for (auto typed_key_it = record.typed_key_iter(); false == typed_key_it->done();
+             typed_key_it->next())
+        {
+            auto const typed_key = typed_key_it->get();
+            ColumnBuilder* column{nullptr};
+            for (auto& candidate : columns) {
+                if (candidate.type == typed_key.get_type() && candidate.key == typed_key.get_key())
+                {
+                    column = &candidate;
+                    break;
+                }
+            }
+            if (nullptr == column) {
+                column = &columns.emplace_back(typed_key.get_key(), typed_key.get_type());
+                while (column->num_records < num_records) {
+                    append_missing_value(*column);
+                }
+            }
+            if (column->num_records > num_records) {
+                // Duplicate key within the record; keep the first value
+                continue;
+            }
+            append_value(record, *column);
+        }
+        ++num_records;
+        for (auto& column : columns) {
+            if (column.num_records < num_records) {
+                append_missing_value(column);
+            }
+        }
+    }
+
+    std::vector<uint8_t> buf;
+    buf.push_back(ColumnarRecordGroup::cMagic);
+    buf.push_back(ColumnarRecordGroup::cVersion);
+    append_int(static_cast<uint32_t>(tags.size()), buf);
+    for (auto const& tag : tags) {
+        append_int(static_cast<uint32_t>(tag.size()), buf);
+        append_bytes(tag, buf);
+    }
+    append_int(static_cast<uint32_t>(num_records), buf);
+    append_int(static_cast<uint32_t>(columns.size()), buf);
+    for (auto const& column : columns) {
+        append_column(column, buf);
+    }
+    return buf;
+}
+}  // namespace reducer
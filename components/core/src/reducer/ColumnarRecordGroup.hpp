@@ -0,0 +1,216 @@
+#ifndef REDUCER_COLUMNARRECORDGROUP_HPP
+#define REDUCER_COLUMNARRECORDGROUP_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include "../clp/ErrorCode.hpp"
+#include "../clp/TraceableException.hpp"
+#include "ConstRecordIterator.hpp"
+#include "GroupTags.hpp"
+#include "Record.hpp"
+#include "RecordGroup.hpp"
+#include "RecordTypedKeyIterator.hpp"
+
+namespace reducer {
+/**
+ * Class which exposes a record group serialized by `serialize_columnar` without copying or
+ * deserializing its records.
+ *
+ * The serialized format is laid out as follows (all integers are in the host's byte order, like
+ * the size prefix that record groups are framed with):
+ * - `cMagic` and `cVersion` (one byte each).
+ * - The group tags: the number of tags (u32), followed by each tag's length (u32) and bytes.
+ * - The number of records (u32) and the number of columns (u32).
+ * - For each column:
+ *   - the value type (u8), the key's length (u32), and the key's bytes;
+ *   - whether every record has a value for the column (u8), and if not, a bitmap indicating which
+ *     records have a value;
+ *   - the values:
+ *     - Int64 and Double: one 8-byte value per record;
+ *     - String: (number of records + 1) u32 offsets into the string data, followed by the string
+ *       data.
+ *
+ * Each column is identified by its key and value type. Records without a value for a column
+ * behave as if the key doesn't exist, same as in the other `Record` implementations.
+ *
+ * NOTE: The serialized buffer must outlive this object and any records obtained from it.
+ */
+class ColumnarRecordGroup : public RecordGroup {
+public:
+    // Types
+    class OperationFailed : public clp::TraceableException {
+    public:
+        // Constructors
+        OperationFailed(clp::ErrorCode error_code, char const* filename, int line_number)
+                : clp::TraceableException{error_code, filename, line_number} {}
+
+        // Methods
+        [[nodiscard]] char const* what() const noexcept override {
+            return "reducer::ColumnarRecordGroup operation failed";
+        }
+    };
+
+    // Constants
+    // 0xC1 is never used by MessagePack, so this lets receivers distinguish columnar record groups
+    // from record groups serialized by `serialize`.
+    static constexpr uint8_t cMagic = 0xC1;
+    static constexpr uint8_t cVersion = 1;
+
+    // Constructors
+    /**
+     * @param buf
+     * @param len
+     * @throw OperationFailed if the buffer doesn't contain a valid columnar record group.
+     */
+    ColumnarRecordGroup(char const* buf, size_t len);
+
+    // Disable copy and move since the record iterator references this object's columns
+    ColumnarRecordGroup(ColumnarRecordGroup const&) = delete;
+    ColumnarRecordGroup(ColumnarRecordGroup&&) = delete;
+    ColumnarRecordGroup& operator=(ColumnarRecordGroup const&) = delete;
+    ColumnarRecordGroup& operator=(ColumnarRecordGroup&&) = delete;
+
+    ~ColumnarRecordGroup() override = default;
+
+    // Methods
+    /**
+     * @param buf
+     * @param len
+     * @return Whether the given serialized record group is in the columnar format.
+     */
+    [[nodiscard]] static bool is_columnar(char const* buf, size_t len) {
+        return len > 0 && cMagic == static_cast<uint8_t>(buf[0]);
+    }
+
+    [[nodiscard]] GroupTags const& get_tags() const override { return m_tags; }
+
+    [[nodiscard]] ConstRecordIterator& record_iter() override { return m_record_it; }
+
+private:
+    // Types
+    /**
+     * A view of a column within the serialized buffer.
+     */
+    struct Column {
+        std::string_view key;
+        ValueType type{ValueType::String};
+        // nullptr if every record has a value
+        char const* presence_bitmap{nullptr};
+        // Fixed-width values, or string offsets for string columns
+        char const* values{nullptr};
+        char const* string_data{nullptr};
+    };
+
+    /**
+     * A view of a single record, which reads its values directly from the columns.
+     */
+    class ColumnarRecord : public Record {
+    public:
+        explicit ColumnarRecord(std::vector<Column> const& columns) : m_columns{&columns} {}
+
+        void set_record_idx(size_t record_idx) { m_record_idx = record_idx; }
+
+        [[nodiscard]] std::string_view get_string_view(std::string_view key) const override;
+
+        [[nodiscard]] int64_t get_int64_value(std::string_view key) const override;
+
+        [[nodiscard]] double get_double_value(std::string_view key) const override;
+
+        [[nodiscard]] std::unique_ptr<RecordTypedKeyIterator> typed_key_iter() const override;
+
+    private:
+        /**
+         * @param key
+         * @param type
+         * @return The column with the given key and type if the current record has a value for
+         * it, or nullptr otherwise.
+         */
+        [[nodiscard]] Column const* find_column(std::string_view key, ValueType type) const;
+
+        std::vector<Column> const* m_columns;
+        size_t m_record_idx{0};
+    };
+
+    /**
+     * A ConstRecordIterator over the records in a columnar record group.
+     */
+    class ColumnarRecordIterator : public ConstRecordIterator {
+    public:
+        explicit ColumnarRecordIterator(std::vector<Column> const& columns)
+                : m_record{columns} {}
+
+        void set_num_records(size_t num_records) { m_num_records = num_records; }
+
+        [[nodiscard]] Record const& get() const override { return m_record; }
+
+        void next() override { m_record.set_record_idx(++m_cur_record_idx); }
+
+        bool done() override { return m_cur_record_idx >= m_num_records; }
+
+    private:
+        ColumnarRecord m_record;
+        size_t m_num_records{0};
+        size_t m_cur_record_idx{0};
+    };
+
+    /**
+     * A RecordTypedKeyIterator over the columns for which a record has a value.
+     */
+    class ColumnarRecordTypedKeyIterator : public RecordTypedKeyIterator {
+    public:
+        ColumnarRecordTypedKeyIterator(std::vector<Column> const& columns, size_t record_idx)
+                : m_columns{&columns},
+                  m_record_idx{record_idx} {
+            skip_absent_columns();
+        }
+
+        TypedRecordKey get() override {
+            auto const& column = (*m_columns)[m_column_idx];
+            return {column.key, column.type};
+        }
+
+        void next() override {
+            ++m_column_idx;
+            skip_absent_columns();
+        }
+
+        bool done() override { return m_column_idx >= m_columns->size(); }
+
+    private:
+        void skip_absent_columns();
+
+        std::vector<Column> const* m_columns;
+        size_t m_record_idx;
+        size_t m_column_idx{0};
+    };
+
+    // Methods
+    /**
+     * @param column
+     * @param record_idx
+     * @return Whether the given record has a value for the given column.
+     */
+    [[nodiscard]] static bool has_value(Column const& column, size_t record_idx);
+
+    GroupTags m_tags;
+    std::vector<Column> m_columns;
+    ColumnarRecordIterator m_record_it;
+};
+
+/**
+ * Serializes a record group into the columnar format that can be read by ColumnarRecordGroup.
+ *
+ * Unlike `serialize`, this doesn't build an intermediate JSON object per record; each value is
+ * appended directly to its column.
+ * @param tags The tags in the record group.
+ * @param record_it An iterator for the records in the record group.
+ * @return The serialized data.
+ */
+std::vector<uint8_t> serialize_columnar(GroupTags const& tags, ConstRecordIterator& record_it);
+}  // namespace reducer
+
+#endif  // REDUCER_COLUMNARRECORDGROUP_HPP
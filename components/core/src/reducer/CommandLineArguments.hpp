@@ -1,7 +1,10 @@
 #ifndef REDUCER_COMMANDLINEARGUMENTS_HPP
 #define REDUCER_COMMANDLINEARGUMENTS_HPP
 
+#include <algorithm>
+#include <cstddef>
 #include <string>
+#include <thread>
 
 #include "../clp/CommandLineArgumentsBase.hpp"
 
@@ -30,6 +33,8 @@ public:
 
     [[nodiscard]] int get_upsert_interval() const { return m_upsert_interval; }
 
+    [[nodiscard]] size_t get_num_threads() const { return m_num_threads; }
+
 private:
     // Methods
     void print_basic_usage() const override;
@@ -41,6 +46,7 @@ private:
     int m_scheduler_port{7000};
     std::string m_mongodb_uri{"mongodb://localhost:27017/clp-search"};
     int m_upsert_interval{100};  // Milliseconds
+    size_t m_num_threads{std::max(std::thread::hardware_concurrency(), 1U)};
 };
 }  // namespace reducer
 
@@ -0,0 +1,244 @@
+#include "DDSketch.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+namespace reducer {
+namespace {
+constexpr char cFieldDelim = ';';
+constexpr char cBucketDelim = ',';
+constexpr char cBucketIdxCountDelim = ':';
+
+/**
+ * Appends the given number to the given string.
+ * @tparam T
+ * @param value
+ * @param str
+ */
+template <typename T>
+void append_number(T value, std::string& str);
+
+/**
+ * Parses a number from the front of the given string, removing it from the string.
+ * @tparam T
+ * @param str
+ * @param value Returns the parsed value.
+ * @return Whether a number was parsed.
+ */
+template <typename T>
+bool consume_number(std::string_view& str, T& value);
+
+/**
+ * Removes the given delimiter from the front of the given string.
+ * @param str
+ * @param delim
+ * @return Whether the string started with the delimiter.
+ */
+bool consume_delim(std::string_view& str, char delim);
+
+/**
+ * Appends the given buckets to the given string.
+ * @param buckets
+ * @param str
+ */
+void append_buckets(std::map<int32_t, uint64_t> const& buckets, std::string& str);
+
+/**
+ * Parses buckets from the front of the given string, up to the next field delimiter or the end of
+ * the string.
+ * @param str
+ * @param buckets Returns the parsed buckets.
+ * @param count Returns the total count of the parsed buckets.
+ * @return Whether the buckets were parsed successfully.
+ */
+bool consume_buckets(std::string_view& str, std::map<int32_t, uint64_t>& buckets, uint64_t& count);
+
+template <typename T>
+void append_number(T value, std::string& str) {
+    // Large enough for the shortest round-trip representation of any double or 64-bit integer
+    constexpr size_t cMaxNumberLength = 32;
+    char buf[cMaxNumberLength];
+    auto const [end, ec] = std::to_chars(buf, buf + cMaxNumberLength, value);
+    str.append(buf, end);
+}
+
+template <typename T>
+bool consume_number(std::string_view& str, T& value) {
+    auto const [end, ec] = std::from_chars(str.data(), str.data() + str.size(), value);
+    if (std::errc{} != ec) {
+        return false;
+    }
+    str.remove_prefix(end - str.data());
+    return true;
+}
+
+bool consume_delim(std::string_view& str, char delim) {
+    if (str.empty() || delim != str.front()) {
+        return false;
+    }
+    str.remove_prefix(1);
+    return true;
+}
+
+void append_buckets(std::map<int32_t, uint64_t> const& buckets, std::string& str) {
+    bool is_first_bucket{true};
+    for (auto const& [bucket_idx, count] : buckets) {
+        if (false == is_first_bucket) {
+            str.push_back(cBucketDelim);
+        }
+        is_first_bucket = false;
+        append_number(bucket_idx, str);
+        str.push_back(cBucketIdxCountDelim);
+        append_number(count, str);
+    }
+}
+
+bool consume_buckets(std::string_view& str, std::map<int32_t, uint64_t>& buckets, uint64_t& count) {
+    if (str.empty() || cFieldDelim == str.front()) {
+        return true;
+    }
+    do {
+        int32_t bucket_idx{0};
+        uint64_t bucket_count{0};
+        if (false == consume_number(str, bucket_idx)
+            || false == consume_delim(str, cBucketIdxCountDelim)
+            || false == consume_number(str, bucket_count))
+        {
+            return false;
+        }
+        buckets[bucket_idx] += bucket_count;
+        count += bucket_count;
+    } while (consume_delim(str, cBucketDelim));
+    return true;
+}
+}  // namespace
+
+DDSketch::DDSketch(double relative_accuracy)
+        : m_relative_accuracy{relative_accuracy},
+          m_gamma{(1.0 + relative_accuracy) / (1.0 - relative_accuracy)},
+          m_log_gamma{std::log(m_gamma)} {}
+
+std::optional<DDSketch> DDSketch::deserialize(std::string_view serialized_sketch) {
+    double relative_accuracy{0.0};
+    uint64_t zero_count{0};
+    if (false == consume_number(serialized_sketch, relative_accuracy)
+        || false == (relative_accuracy > 0.0 && relative_accuracy < 1.0)
+        || false == consume_delim(serialized_sketch, cFieldDelim)
+        || false == consume_number(serialized_sketch, zero_count)
+        || false == consume_delim(serialized_sketch, cFieldDelim))
+    {
+        return std::nullopt;
+    }
+
+    DDSketch sketch{relative_accuracy};
+    sketch.m_zero_count = zero_count;
+    sketch.m_count = zero_count;
+    if (false == consume_buckets(serialized_sketch, sketch.m_positive_buckets, sketch.m_count)
+        || false == consume_delim(serialized_sketch, cFieldDelim)
+        || false == consume_buckets(serialized_sketch, sketch.m_negative_buckets, sketch.m_count)
+        || false == serialized_sketch.empty())
+    {
+        return std::nullopt;
+    }
+    return sketch;
+}
+
+void DDSketch::add(double value) {
+    if (false == std::isfinite(value)) {
+        return;
+    }
+    ++m_count;
+    auto const magnitude = std::fabs(value);
+    if (magnitude < cMinIndexableValue) {
+        ++m_zero_count;
+    } else if (value > 0) {
+        ++m_positive_buckets[get_bucket_idx(magnitude)];
+    } else {
+        ++m_negative_buckets[get_bucket_idx(magnitude)];
+    }
+}
+
+bool DDSketch::merge(DDSketch const& other) {
+    if (m_relative_accuracy != other.m_relative_accuracy) {
+        return false;
+    }
+    m_count += other.m_count;
+    m_zero_count += other.m_zero_count;
+    for (auto const& [bucket_idx, count] : other.m_positive_buckets) {
+        m_positive_buckets[bucket_idx] += count;
+    }
+    for (auto const& [bucket_idx, count] : other.m_negative_buckets) {
+        m_negative_buckets[bucket_idx] += count;
+    }
+    return true;
+}
+
+std::optional<double> DDSketch::get_quantile(double quantile) const {
+    if (0 == m_count || quantile < 0.0 || quantile > 1.0) {
+        return std::nullopt;
+    }
+
+    auto const rank = static_cast<uint64_t>(quantile * static_cast<double>(m_count - 1));
+    uint64_t num_values_seen{0};
+
+    // Negative values in ascending order (i.e., descending magnitude)
+    for (auto it = m_negative_buckets.crbegin(); m_negative_buckets.crend() != it; ++it) {
+        num_values_seen += it->second;
+        if (num_values_seen > rank) {
+            return -get_bucket_value(it->first);
+        }
+    }
+
+    num_values_seen += m_zero_count;
+    if (num_values_seen > rank) {
+        return 0.0;
+    }
+
+    for (auto const& [bucket_idx, count] : m_positive_buckets) {
+        num_values_seen += count;
+        if (num_values_seen > rank) {
+            return get_bucket_value(bucket_idx);
+        }
+    }
+
+    // Unreachable since the buckets' counts sum to `m_count`
+    return std::nullopt;
+}
+
+std::string DDSketch::serialize() const {
+    std::string serialized_sketch;
+    append_number(m_relative_accuracy, serialized_sketch);
+    serialized_sketch.push_back(cFieldDelim);
+    append_number(m_zero_count, serialized_sketch);
+    serialized_sketch.push_back(cFieldDelim);
+    append_buckets(m_positive_buckets, serialized_sketch);
+    serialized_sketch.push_back(cFieldDelim);
+    append_buckets(m_negative_buckets, serialized_sketch);
+    return serialized_sketch;
+}
+
+int32_t DDSketch::get_bucket_idx(double magnitude) const {
+    // Clamp the index so that the cast is defined; with tiny relative accuracies, magnitudes outside
+    // the index range share the extreme buckets
+    return static_cast<int32_t>(std::clamp(
+            std::ceil(std::log(magnitude) / m_log_gamma),
+            static_cast<double>(std::numeric_limits<int32_t>::min()),
+            static_cast<double>(std::numeric_limits<int32_t>::max())
+    ));
+}
+
+double DDSketch::get_bucket_value(int32_t bucket_idx) const {
+    // Bucket i contains (gamma^(i-1), gamma^i], so this value is within the relative accuracy of
+    // both bounds.
+    return 2.0 * std::pow(m_gamma, bucket_idx) / (m_gamma + 1.0);
+}
+}  // namespace reducer
@@ -0,0 +1,95 @@
+#ifndef REDUCER_DDSKETCH_HPP
+#define REDUCER_DDSKETCH_HPP
+
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace reducer {
+/**
+ * A DDSketch for estimating quantiles of a stream of numbers with a bounded relative error.
+ *
+ * Values are counted in logarithmically-sized buckets, so any quantile estimate is within
+ * `relative_accuracy` of the true value, and sketches with the same relative accuracy can be merged
+ * exactly. The number of buckets grows with the logarithm of the range of the values (e.g., ~700
+ * buckets cover 1us to 1000s with 1% accuracy), independent of the number of values.
+ */
+class DDSketch {
+public:
+    // Constants
+    static constexpr double cDefaultRelativeAccuracy = 0.01;
+    // Values whose magnitude is smaller than this are counted as zero
+    static constexpr double cMinIndexableValue = 1e-9;
+
+    // Constructors
+    /**
+     * @param relative_accuracy Must be in (0, 1).
+     */
+    explicit DDSketch(double relative_accuracy = cDefaultRelativeAccuracy);
+
+    // Methods
+    /**
+     * Deserializes a sketch serialized by `serialize`.
+     * @param serialized_sketch
+     * @return The sketch on success, or std::nullopt if the serialized sketch is invalid.
+     */
+    [[nodiscard]] static std::optional<DDSketch> deserialize(std::string_view serialized_sketch);
+
+    /**
+     * Adds a value to the sketch. Non-finite values (NaNs and infinities) are ignored.
+     * @param value
+     */
+    void add(double value);
+
+    /**
+     * Merges another sketch into this one.
+     * @param other
+     * @return Whether the sketches could be merged (i.e., they have the same relative accuracy).
+     */
+    bool merge(DDSketch const& other);
+
+    /**
+     * @param quantile In [0, 1].
+     * @return An estimate of the given quantile, or std::nullopt if the sketch is empty.
+     */
+    [[nodiscard]] std::optional<double> get_quantile(double quantile) const;
+
+    [[nodiscard]] uint64_t get_count() const { return m_count; }
+
+    [[nodiscard]] double get_relative_accuracy() const { return m_relative_accuracy; }
+
+    /**
+     * Serializes the sketch into a printable string of the form
+     * "<relative_accuracy>;<zero_count>;<index>:<count>,...;<index>:<count>,..." where the last two
+     * fields are the positive and negative buckets, respectively.
+     * @return The serialized sketch.
+     */
+    [[nodiscard]] std::string serialize() const;
+
+private:
+    /**
+     * @param magnitude Must be finite and at least `cMinIndexableValue`.
+     * @return The index of the bucket containing the given magnitude.
+     */
+    [[nodiscard]] int32_t get_bucket_idx(double magnitude) const;
+
+    /**
+     * @param bucket_idx
+     * @return The representative value of the given bucket, which is within `m_relative_accuracy`
+     * of every value in the bucket.
+     */
+    [[nodiscard]] double get_bucket_value(int32_t bucket_idx) const;
+
+    double m_relative_accuracy;
+    double m_gamma;
+    double m_log_gamma;
+    uint64_t m_count{0};
+    uint64_t m_zero_count{0};
+    std::map<int32_t, uint64_t> m_positive_buckets;
+    std::map<int32_t, uint64_t> m_negative_buckets;
+};
+}  // namespace reducer
+
+#endif  // REDUCER_DDSKETCH_HPP
@@ -0,0 +1,53 @@
+#include "DistinctCountOperator.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <memory>
+
+#include "RecordGroupIterator.hpp"
+
+namespace reducer {
+void DistinctCountOperator::push_intra_stage_record_group(
+        GroupTags const& tags,
+        ConstRecordIterator& record_it
+) {
+    auto& sketch = get_group_sketch(tags);
+
+    for (; false == record_it.done(); record_it.next()) {
+        auto const partial_sketch = HyperLogLog::deserialize(
+                record_it.get().get_string_view(static_cast<char const*>(cSketchKey))
+        );
+        if (partial_sketch.has_value()) {
+            // Sketches with a different precision can't be merged, so they're dropped
+            sketch.merge(partial_sketch.value());
+        }
+    }
+}
+
+void DistinctCountOperator::push_inter_stage_record_group(
+        GroupTags const& tags,
+        ConstRecordIterator& record_it
+) {
+    auto& sketch = get_group_sketch(tags);
+
+    for (; false == record_it.done(); record_it.next()) {
+        sketch.add(record_it.get().get_string_view(m_element_key));
+    }
+}
+
+std::unique_ptr<RecordGroupIterator> DistinctCountOperator::get_stored_result_iterator() {
+    return std::make_unique<StateMapRecordGroupIterator<HyperLogLog>>(
+            m_group_sketches,
+            sketch_to_record
+    );
+}
+
+HyperLogLog& DistinctCountOperator::get_group_sketch(GroupTags const& tags) {
+    return m_group_sketches.try_emplace(tags, m_precision).first->second;
+}
+
+void DistinctCountOperator::sketch_to_record(HyperLogLog const& sketch, KeyValueRecord& record) {
+    record.set_string_value(cSketchKey, sketch.serialize());
+    record.set_int64_value(cDistinctCountKey, std::llround(sketch.estimate()));
+}
+}  // namespace reducer
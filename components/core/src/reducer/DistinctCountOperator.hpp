@@ -0,0 +1,67 @@
+#ifndef REDUCER_DISTINCTCOUNTOPERATOR_HPP
+#define REDUCER_DISTINCTCOUNTOPERATOR_HPP
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "GroupTags.hpp"
+#include "HyperLogLog.hpp"
+#include "Operator.hpp"
+#include "Record.hpp"
+
+namespace reducer {
+/**
+ * Operator that estimates the number of distinct values of an element per record group, using a
+ * HyperLogLog sketch.
+ *
+ * Inter-stage records contain the (string) element to count. Intra-stage records contain serialized
+ * partial sketches (as output by this operator), which are merged.
+ */
+class DistinctCountOperator : public Operator {
+public:
+    static constexpr char cSketchKey[] = "hll_sketch";
+    static constexpr char cDistinctCountKey[] = "distinct_count";
+
+    /**
+     * @param element_key The key of the element to count in inter-stage records.
+     * @param precision The precision of the HyperLogLog sketches.
+     */
+    explicit DistinctCountOperator(
+            std::string element_key,
+            uint8_t precision = HyperLogLog::cDefaultPrecision
+    )
+            : m_element_key{std::move(element_key)},
+              m_precision{precision} {}
+
+    void
+    push_intra_stage_record_group(GroupTags const& tags, ConstRecordIterator& record_it) override;
+
+    void
+    push_inter_stage_record_group(GroupTags const& tags, ConstRecordIterator& record_it) override;
+
+    std::unique_ptr<RecordGroupIterator> get_stored_result_iterator() override;
+
+private:
+    /**
+     * @param tags
+     * @return The sketch for the given group, created if necessary.
+     */
+    HyperLogLog& get_group_sketch(GroupTags const& tags);
+
+    /**
+     * Writes the given sketch and its estimate into the given record.
+     * @param sketch
+     * @param record
+     */
+    static void sketch_to_record(HyperLogLog const& sketch, KeyValueRecord& record);
+
+    std::string m_element_key;
+    uint8_t m_precision;
+    std::map<GroupTags, HyperLogLog> m_group_sketches;
+};
+}  // namespace reducer
+
+#endif  // REDUCER_DISTINCTCOUNTOPERATOR_HPP
@@ -0,0 +1,118 @@
+#include "HyperLogLog.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace reducer {
+namespace {
+// Characters used to serialize the precision and the register values. Register values are at most
+// 65 - precision, so they're always printable.
+constexpr char cSerializedValueBase = '0';
+
+constexpr uint64_t cFnvOffsetBasis = 0xcbf2'9ce4'8422'2325ULL;
+constexpr uint64_t cFnvPrime = 0x100'0000'01b3ULL;
+}  // namespace
+
+HyperLogLog::HyperLogLog(uint8_t precision)
+        : m_precision{std::clamp(precision, cMinPrecision, cMaxPrecision)},
+          m_registers(size_t{1} << m_precision, 0) {}
+
+std::optional<HyperLogLog> HyperLogLog::deserialize(std::string_view serialized_sketch) {
+    if (serialized_sketch.empty()) {
+        return std::nullopt;
+    }
+    auto const precision = static_cast<uint8_t>(serialized_sketch.front() - cSerializedValueBase);
+    if (precision < cMinPrecision || precision > cMaxPrecision
+        || serialized_sketch.size() != (size_t{1} << precision) + 1)
+    {
+        return std::nullopt;
+    }
+
+    HyperLogLog sketch{precision};
+    uint8_t const max_register_value = 64 - precision + 1;
+    for (size_t i = 0; i < sketch.m_registers.size(); ++i) {
+        auto const value = static_cast<uint8_t>(serialized_sketch[i + 1] - cSerializedValueBase);
+        if (value > max_register_value) {
+            return std::nullopt;
+        }
+        sketch.m_registers[i] = value;
+    }
+    return sketch;
+}
+
+void HyperLogLog::add_hash(uint64_t hash) {
+    // The top `m_precision` bits select the register; the register tracks the maximum position of
+    // the leftmost 1-bit in the remaining bits.
+    auto const register_idx = static_cast<size_t>(hash >> (64 - m_precision));
+    uint64_t const remaining_bits = hash << m_precision;
+    auto const rank = static_cast<uint8_t>(
+            std::min(std::countl_zero(remaining_bits), 64 - m_precision) + 1
+    );
+    auto& reg = m_registers[register_idx];
+    reg = std::max(reg, rank);
+}
+
+bool HyperLogLog::merge(HyperLogLog const& other) {
+    if (m_precision != other.m_precision) {
+        return false;
+    }
+    for (size_t i = 0; i < m_registers.size(); ++i) {
+        m_registers[i] = std::max(m_registers[i], other.m_registers[i]);
+    }
+    return true;
+}
+
+double HyperLogLog::estimate() const {
+    auto const num_registers = static_cast<double>(m_registers.size());
+
+    double sum{0.0};
+    size_t num_zero_registers{0};
+    for (auto const reg : m_registers) {
+        sum += std::ldexp(1.0, -static_cast<int>(reg));
+        if (0 == reg) {
+            ++num_zero_registers;
+        }
+    }
+
+    double const alpha = 0.7213 / (1.0 + 1.079 / num_registers);
+    double const raw_estimate = alpha * num_registers * num_registers / sum;
+
+    // Use linear counting for small cardinalities, where the raw estimate is biased
+    if (raw_estimate <= 2.5 * num_registers && num_zero_registers > 0) {
+        return num_registers * std::log(num_registers / static_cast<double>(num_zero_registers));
+    }
+    return raw_estimate;
+}
+
+std::string HyperLogLog::serialize() const {
+    std::string serialized_sketch;
+    serialized_sketch.reserve(m_registers.size() + 1);
+    serialized_sketch.push_back(static_cast<char>(cSerializedValueBase + m_precision));
+    for (auto const reg : m_registers) {
+        serialized_sketch.push_back(static_cast<char>(cSerializedValueBase + reg));
+    }
+    return serialized_sketch;
+}
+
+uint64_t HyperLogLog::hash(std::string_view value) {
+    // FNV-1a followed by MurmurHash3's 64-bit finalizer, so that every output bit depends on every
+    // input bit (FNV-1a's high bits, which select the register, are poorly mixed on their own).
+    uint64_t hash{cFnvOffsetBasis};
+    for (auto const c : value) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= cFnvPrime;
+    }
+    hash ^= hash >> 33;
+    hash *= 0xff51'afd7'ed55'8ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ce'b9fe'1a85'ec53ULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+}  // namespace reducer
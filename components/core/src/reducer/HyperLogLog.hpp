@@ -0,0 +1,89 @@
+#ifndef REDUCER_HYPERLOGLOG_HPP
+#define REDUCER_HYPERLOGLOG_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace reducer {
+/**
+ * A HyperLogLog sketch for estimating the number of distinct values in a stream.
+ *
+ * Sketches with the same precision can be merged, which lets workers compute partial sketches
+ * locally and ship only the sketch (2^precision bytes when serialized) to the reducer.
+ */
+class HyperLogLog {
+public:
+    // Constants
+    static constexpr uint8_t cMinPrecision = 4;
+    static constexpr uint8_t cMaxPrecision = 18;
+    // Standard error of ~1.6%
+    static constexpr uint8_t cDefaultPrecision = 12;
+
+    // Constructors
+    /**
+     * @param precision The number of hash bits used to select a register. Clamped to
+     * [cMinPrecision, cMaxPrecision].
+     */
+    explicit HyperLogLog(uint8_t precision = cDefaultPrecision);
+
+    // Methods
+    /**
+     * Deserializes a sketch serialized by `serialize`.
+     * @param serialized_sketch
+     * @return The sketch on success, or std::nullopt if the serialized sketch is invalid.
+     */
+    [[nodiscard]] static std::optional<HyperLogLog> deserialize(std::string_view serialized_sketch);
+
+    /**
+     * Adds a value to the sketch.
+     * @param value
+     */
+    void add(std::string_view value) { add_hash(hash(value)); }
+
+    /**
+     * Adds a value to the sketch, given the value's 64-bit hash.
+     * @param hash
+     */
+    void add_hash(uint64_t hash);
+
+    /**
+     * Merges another sketch into this one.
+     * @param other
+     * @return Whether the sketches could be merged (i.e., they have the same precision).
+     */
+    bool merge(HyperLogLog const& other);
+
+    /**
+     * @return The estimated number of distinct values added to this sketch (and any merged
+     * sketches).
+     */
+    [[nodiscard]] double estimate() const;
+
+    /**
+     * Serializes the sketch into a printable string: the precision followed by one character per
+     * register.
+     * @return The serialized sketch.
+     */
+    [[nodiscard]] std::string serialize() const;
+
+    [[nodiscard]] uint8_t get_precision() const { return m_precision; }
+
+    /**
+     * Hashes the given value. The hash is stable across processes and platforms, so sketches built
+     * by different workers can be merged.
+     * @param value
+     * @return The 64-bit hash.
+     */
+    [[nodiscard]] static uint64_t hash(std::string_view value);
+
+private:
+    uint8_t m_precision;
+    std::vector<uint8_t> m_registers;
+};
+}  // namespace reducer
+
+#endif  // REDUCER_HYPERLOGLOG_HPP
@@ -0,0 +1,69 @@
+#include "NumericAggregationOperator.hpp"
+
+#include <algorithm>
+#include <memory>
+
+#include "RecordGroupIterator.hpp"
+
+namespace reducer {
+void NumericAggregationOperator::push_intra_stage_record_group(
+        GroupTags const& tags,
+        ConstRecordIterator& record_it
+) {
+    auto& aggregate = m_group_aggregates[tags];
+
+    for (; false == record_it.done(); record_it.next()) {
+        auto const& record = record_it.get();
+        auto const count = record.get_int64_value(static_cast<char const*>(cCountKey));
+        if (count <= 0) {
+            // The partial aggregate's min and max are meaningless without any values
+            continue;
+        }
+        aggregate.count += count;
+        aggregate.sum += record.get_double_value(static_cast<char const*>(cSumKey));
+        aggregate.min = std::min(
+                aggregate.min,
+                record.get_double_value(static_cast<char const*>(cMinKey))
+        );
+        aggregate.max = std::max(
+                aggregate.max,
+                record.get_double_value(static_cast<char const*>(cMaxKey))
+        );
+    }
+}
+
+void NumericAggregationOperator::push_inter_stage_record_group(
+        GroupTags const& tags,
+        ConstRecordIterator& record_it
+) {
+    auto& aggregate = m_group_aggregates[tags];
+
+    for (; false == record_it.done(); record_it.next()) {
+        auto const value = record_it.get().get_double_value(m_element_key);
+        ++aggregate.count;
+        aggregate.sum += value;
+        aggregate.min = std::min(aggregate.min, value);
+        aggregate.max = std::max(aggregate.max, value);
+    }
+}
+
+std::unique_ptr<RecordGroupIterator> NumericAggregationOperator::get_stored_result_iterator() {
+    return std::make_unique<StateMapRecordGroupIterator<Aggregate>>(
+            m_group_aggregates,
+            aggregate_to_record
+    );
+}
+
+void NumericAggregationOperator::aggregate_to_record(
+        Aggregate const& aggregate,
+        KeyValueRecord& record
+) {
+    record.set_int64_value(cCountKey, aggregate.count);
+    record.set_double_value(cSumKey, aggregate.sum);
+    if (aggregate.count > 0) {
+        record.set_double_value(cMinKey, aggregate.min);
+        record.set_double_value(cMaxKey, aggregate.max);
+        record.set_double_value(cAvgKey, aggregate.sum / static_cast<double>(aggregate.count));
+    }
+}
+}  // namespace reducer
@@ -0,0 +1,65 @@
+#ifndef REDUCER_NUMERICAGGREGATIONOPERATOR_HPP
+#define REDUCER_NUMERICAGGREGATIONOPERATOR_HPP
+
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "GroupTags.hpp"
+#include "Operator.hpp"
+#include "Record.hpp"
+
+namespace reducer {
+/**
+ * Operator that accumulates the count, sum, min, max, and average of a numeric element per record
+ * group.
+ *
+ * Inter-stage records contain the element to aggregate. Intra-stage records contain partial
+ * aggregates (as output by this operator), which are merged.
+ */
+class NumericAggregationOperator : public Operator {
+public:
+    static constexpr char cCountKey[] = "count";
+    static constexpr char cSumKey[] = "sum";
+    static constexpr char cMinKey[] = "min";
+    static constexpr char cMaxKey[] = "max";
+    static constexpr char cAvgKey[] = "avg";
+
+    /**
+     * @param element_key The key of the element to aggregate in inter-stage records.
+     */
+    explicit NumericAggregationOperator(std::string element_key)
+            : m_element_key{std::move(element_key)} {}
+
+    void
+    push_intra_stage_record_group(GroupTags const& tags, ConstRecordIterator& record_it) override;
+
+    void
+    push_inter_stage_record_group(GroupTags const& tags, ConstRecordIterator& record_it) override;
+
+    std::unique_ptr<RecordGroupIterator> get_stored_result_iterator() override;
+
+private:
+    struct Aggregate {
+        int64_t count{0};
+        double sum{0.0};
+        double min{std::numeric_limits<double>::infinity()};
+        double max{-std::numeric_limits<double>::infinity()};
+    };
+
+    /**
+     * Writes the given aggregate into the given record.
+     * @param aggregate
+     * @param record
+     */
+    static void aggregate_to_record(Aggregate const& aggregate, KeyValueRecord& record);
+
+    std::string m_element_key;
+    std::map<GroupTags, Aggregate> m_group_aggregates;
+};
+}  // namespace reducer
+
+#endif  // REDUCER_NUMERICAGGREGATIONOPERATOR_HPP
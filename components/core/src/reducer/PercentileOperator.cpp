@@ -0,0 +1,84 @@
+#include "PercentileOperator.hpp"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "RecordGroupIterator.hpp"
+
+namespace reducer {
+namespace {
+constexpr double cMaxPercentile = 100.0;
+}  // namespace
+
+PercentileOperator::PercentileOperator(
+        std::string element_key,
+        std::vector<double> percentiles,
+        double relative_accuracy
+)
+        : m_element_key{std::move(element_key)},
+          m_relative_accuracy{relative_accuracy} {
+    for (auto const percentile : percentiles) {
+        m_percentiles_and_keys.emplace_back(percentile, get_percentile_key(percentile));
+    }
+}
+
+void PercentileOperator::push_intra_stage_record_group(
+        GroupTags const& tags,
+        ConstRecordIterator& record_it
+) {
+    auto& sketch = get_group_sketch(tags);
+
+    for (; false == record_it.done(); record_it.next()) {
+        auto const partial_sketch = DDSketch::deserialize(
+                record_it.get().get_string_view(static_cast<char const*>(cSketchKey))
+        );
+        if (partial_sketch.has_value()) {
+            // Sketches with a different relative accuracy can't be merged, so they're dropped
+            sketch.merge(partial_sketch.value());
+        }
+    }
+}
+
+void PercentileOperator::push_inter_stage_record_group(
+        GroupTags const& tags,
+        ConstRecordIterator& record_it
+) {
+    auto& sketch = get_group_sketch(tags);
+
+    for (; false == record_it.done(); record_it.next()) {
+        sketch.add(record_it.get().get_double_value(m_element_key));
+    }
+}
+
+std::unique_ptr<RecordGroupIterator> PercentileOperator::get_stored_result_iterator() {
+    return std::make_unique<StateMapRecordGroupIterator<DDSketch>>(
+            m_group_sketches,
+            [this](DDSketch const& sketch, KeyValueRecord& record) {
+                sketch_to_record(sketch, record);
+            }
+    );
+}
+
+std::string PercentileOperator::get_percentile_key(double percentile) {
+    return fmt::format("p{:g}", percentile);
+}
+
+DDSketch& PercentileOperator::get_group_sketch(GroupTags const& tags) {
+    return m_group_sketches.try_emplace(tags, m_relative_accuracy).first->second;
+}
+
+void PercentileOperator::sketch_to_record(DDSketch const& sketch, KeyValueRecord& record) const {
+    record.set_string_value(cSketchKey, sketch.serialize());
+    record.set_int64_value(cCountKey, static_cast<int64_t>(sketch.get_count()));
+    for (auto const& [percentile, key] : m_percentiles_and_keys) {
+        auto const value = sketch.get_quantile(percentile / cMaxPercentile);
+        if (value.has_value()) {
+            record.set_double_value(key, value.value());
+        }
+    }
+}
+}  // namespace reducer
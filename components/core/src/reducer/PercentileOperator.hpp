@@ -0,0 +1,76 @@
+#ifndef REDUCER_PERCENTILEOPERATOR_HPP
+#define REDUCER_PERCENTILEOPERATOR_HPP
+
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "DDSketch.hpp"
+#include "GroupTags.hpp"
+#include "Operator.hpp"
+#include "Record.hpp"
+
+namespace reducer {
+/**
+ * Operator that estimates percentiles of a numeric element per record group, using a DDSketch.
+ *
+ * Inter-stage records contain the element to aggregate. Intra-stage records contain serialized
+ * partial sketches (as output by this operator), which are merged.
+ *
+ * Besides the sketch, each output record contains the value count and an estimate of each requested
+ * percentile, keyed by "p" followed by the percentile (e.g., "p50", "p99.9").
+ */
+class PercentileOperator : public Operator {
+public:
+    static constexpr char cSketchKey[] = "ddsketch";
+    static constexpr char cCountKey[] = "count";
+
+    /**
+     * @param element_key The key of the element to aggregate in inter-stage records.
+     * @param percentiles The percentiles to output, each in [0, 100].
+     * @param relative_accuracy The relative accuracy of the DDSketches.
+     */
+    PercentileOperator(
+            std::string element_key,
+            std::vector<double> percentiles,
+            double relative_accuracy = DDSketch::cDefaultRelativeAccuracy
+    );
+
+    void
+    push_intra_stage_record_group(GroupTags const& tags, ConstRecordIterator& record_it) override;
+
+    void
+    push_inter_stage_record_group(GroupTags const& tags, ConstRecordIterator& record_it) override;
+
+    std::unique_ptr<RecordGroupIterator> get_stored_result_iterator() override;
+
+    /**
+     * @param percentile
+     * @return The key of the given percentile's estimate in output records.
+     */
+    [[nodiscard]] static std::string get_percentile_key(double percentile);
+
+private:
+    /**
+     * @param tags
+     * @return The sketch for the given group, created if necessary.
+     */
+    DDSketch& get_group_sketch(GroupTags const& tags);
+
+    /**
+     * Writes the given sketch, its count, and the requested percentiles into the given record.
+     * @param sketch
+     * @param record
+     */
+    void sketch_to_record(DDSketch const& sketch, KeyValueRecord& record) const;
+
+    std::string m_element_key;
+    std::vector<std::pair<double, std::string>> m_percentiles_and_keys;
+    double m_relative_accuracy;
+    std::map<GroupTags, DDSketch> m_group_sketches;
+};
+}  // namespace reducer
+
+#endif  // REDUCER_PERCENTILEOPERATOR_HPP
@@ -6,6 +6,7 @@
 #include <string>
 #include <utility>
 #include <variant>
+#include <vector>
 
 #include "RecordTypedKeyIterator.hpp"
 
@@ -94,6 +95,106 @@ private:
     int64_t m_value{};
 };
 
+/**
+ * Record implementation which exposes a single double key-value pair.
+ *
+ * The value associated with the key can be updated allowing this class to act as an adapter for a
+ * larger set of data.
+ */
+class SingleDoubleRecordAdapter : public Record {
+public:
+    explicit SingleDoubleRecordAdapter(std::string key_name) : m_key_name{std::move(key_name)} {}
+
+    void set_record_value(double value) { m_value = value; }
+
+    [[nodiscard]] double get_double_value(std::string_view key) const override {
+        if (key == m_key_name) {
+            return m_value;
+        }
+        return 0.0;
+    }
+
+    [[nodiscard]] std::unique_ptr<RecordTypedKeyIterator> typed_key_iter() const override {
+        return std::make_unique<SingleTypedKeyIterator>(m_key_name, ValueType::Double);
+    }
+
+private:
+    std::string m_key_name;
+    double m_value{};
+};
+
+/**
+ * Record implementation which exposes a small number of typed key-value pairs.
+ *
+ * Lookups are linear in the number of elements, so this class is only suitable for records with a
+ * handful of elements (e.g., the result of an aggregation).
+ */
+class KeyValueRecord : public Record {
+public:
+    void clear() { m_elements.clear(); }
+
+    void set_string_value(std::string key, std::string value) {
+        m_elements.emplace_back(std::move(key), std::move(value));
+    }
+
+    void set_int64_value(std::string key, int64_t value) {
+        m_elements.emplace_back(std::move(key), value);
+    }
+
+    void set_double_value(std::string key, double value) {
+        m_elements.emplace_back(std::move(key), value);
+    }
+
+    [[nodiscard]] std::string_view get_string_view(std::string_view key) const override {
+        auto const* value = find_value<std::string>(key);
+        return nullptr == value ? std::string_view{} : std::string_view{*value};
+    }
+
+    [[nodiscard]] int64_t get_int64_value(std::string_view key) const override {
+        auto const* value = find_value<int64_t>(key);
+        return nullptr == value ? 0 : *value;
+    }
+
+    [[nodiscard]] double get_double_value(std::string_view key) const override {
+        auto const* value = find_value<double>(key);
+        return nullptr == value ? 0.0 : *value;
+    }
+
+    [[nodiscard]] std::unique_ptr<RecordTypedKeyIterator> typed_key_iter() const override {
+        std::vector<TypedRecordKey> typed_keys;
+        typed_keys.reserve(m_elements.size());
+        for (auto const& [key, value] : m_elements) {
+            ValueType type{ValueType::String};
+            if (std::holds_alternative<int64_t>(value)) {
+                type = ValueType::Int64;
+            } else if (std::holds_alternative<double>(value)) {
+                type = ValueType::Double;
+            }
+            typed_keys.emplace_back(key, type);
+        }
+        return std::make_unique<VectorTypedKeyIterator>(std::move(typed_keys));
+    }
+
+private:
+    /**
+     * @tparam T
+     * @param key
+     * @return A pointer to the value of the element with the given key and type, or nullptr if
+     * no such element exists.
+     */
+    template <typename T>
+    [[nodiscard]] T const* find_value(std::string_view key) const {
+        for (auto const& [element_key, value] : m_elements) {
+            if (element_key == key) {
+                return std::get_if<T>(&value);
+            }
+        }
+        return nullptr;
+    }
+
+    std::vector<std::pair<std::string, std::variant<std::string, int64_t, double>>> m_elements;
+};
+
 /**
  * Record implementation for an empty record.
  */
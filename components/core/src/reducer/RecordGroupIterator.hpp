@@ -1,6 +1,7 @@
 #ifndef REDUCER_RECORDGROUPITERATOR_HPP
 #define REDUCER_RECORDGROUPITERATOR_HPP
 
+#include <functional>
 #include <map>
 #include <set>
 #include <utility>
@@ -158,6 +159,45 @@ private:
     std::set<GroupTags>::const_iterator m_filter_end_it;
 };
 
+/**
+ * A RecordGroupIterator that exposes a map which maps GroupTags to aggregation states. Each state
+ * is exposed as a single record populated by the given method.
+ * @tparam State
+ */
+template <typename State>
+class StateMapRecordGroupIterator : public RecordGroupIterator {
+public:
+    using StateToRecordMethod = std::function<void(State const&, KeyValueRecord&)>;
+
+    StateMapRecordGroupIterator(
+            std::map<GroupTags, State> const& map,
+            StateToRecordMethod state_to_record
+    )
+            : m_map_it{map.cbegin()},
+              m_map_end_it{map.cend()},
+              m_state_to_record{std::move(state_to_record)},
+              m_group{nullptr, m_record} {}
+
+    RecordGroup& get() override {
+        m_record.clear();
+        m_state_to_record(m_map_it->second, m_record);
+        m_group.set_tags(&m_map_it->first);
+        m_group.reset_record_iterator();
+        return m_group;
+    }
+
+    void next() override { ++m_map_it; }
+
+    bool done() override { return m_map_it == m_map_end_it; }
+
+private:
+    typename std::map<GroupTags, State>::const_iterator m_map_it;
+    typename std::map<GroupTags, State>::const_iterator m_map_end_it;
+    StateToRecordMethod m_state_to_record;
+    KeyValueRecord m_record;
+    SingleRecordGroup m_group;
+};
+
 /**
  * A RecordGroupIterator over an empty RecordGroup.
  */
@@ -1,6 +1,9 @@
 #include "RecordReceiverContext.hpp"
 
+#include <exception>
+
 #include "../clp/spdlog_with_specializations.hpp"
+#include "ColumnarRecordGroup.hpp"
 #include "DeserializedRecordGroup.hpp"
 #include "types.hpp"
 
@@ -14,6 +17,10 @@ bool RecordReceiverContext::read_connection_init_packet() {
     }
 
     memcpy(&job_id, m_buf.data(), sizeof(job_id));
+    if (job_id < 0) {
+        job_id = decode_columnar_format_job_id(job_id);
+        m_record_group_format = RecordGroupFormat::Columnar;
+    }
     if (job_id != m_server_ctx->get_job_id()) {
         SPDLOG_ERROR(
                 "Rejecting connection from worker with job_id={} during processing of "
@@ -29,7 +36,9 @@ bool RecordReceiverContext::read_connection_init_packet() {
 }
 
 bool RecordReceiverContext::send_connection_accept_packet() {
-    char const response = 'y';
+    char const response = RecordGroupFormat::Columnar == m_record_group_format
+                                  ? cColumnarConnectionAcceptedResponse
+                                  : cConnectionAcceptedResponse;
     boost::system::error_code e;
     auto transferred
             = boost::asio::write(m_socket, boost::asio::buffer(&response, sizeof(response)), e);
@@ -61,8 +70,24 @@ bool RecordReceiverContext::read_record_groups_packet() {
         }
         read_head += sizeof(record_size);
 
-        auto record_group = DeserializedRecordGroup{read_head, record_size};
-        m_server_ctx->push_record_group(record_group.get_tags(), record_group.record_iter());
+        try {
+            if (ColumnarRecordGroup::is_columnar(read_head, record_size)) {
+                ColumnarRecordGroup record_group{read_head, record_size};
+                m_server_ctx->push_record_group(
+                        record_group.get_tags(),
+                        record_group.record_iter()
+                );
+            } else {
+                auto record_group = DeserializedRecordGroup{read_head, record_size};
+                m_server_ctx->push_record_group(
+                        record_group.get_tags(),
+                        record_group.record_iter()
+                );
+            }
+        } catch (std::exception const& e) {
+            SPDLOG_ERROR("Failed to deserialize record group - {}", e.what());
+            return false;
+        }
         m_buf_num_bytes_occupied -= (record_size + sizeof(record_size));
         read_head += record_size;
     }
@@ -7,6 +7,7 @@
 #include <boost/asio/ip/tcp.hpp>
 
 #include "ServerContext.hpp"
+#include "types.hpp"
 
 namespace reducer {
 class RecordReceiverContext {
@@ -41,6 +42,9 @@ public:
 
     /**
      * Reads a connection initiation packet.
+     *
+     * If the sender encoded its job ID using `encode_columnar_format_job_id`, the sender will send
+     * record groups in the columnar format; otherwise, it will send them in the MessagePack format.
      * @return false if there are an unexpected number of bytes in the buffer or the sender's job ID
      * doesn't match the one currently being processed.
      * @return true otherwise.
@@ -48,13 +52,15 @@ public:
     bool read_connection_init_packet();
 
     /**
-     * Sends a connection accept packet.
+     * Sends a connection accept packet, indicating whether the sender should use the columnar
+     * format.
      * @return Whether the acceptance was sent successfully.
      */
     bool send_connection_accept_packet();
 
     /**
-     * Reads a packet containing record groups.
+     * Reads a packet containing record groups. Each record group may be in either the MessagePack
+     * or the columnar format.
      * @return Whether the read was successful.
      */
     bool read_record_groups_packet();
@@ -86,6 +92,7 @@ private:
     boost::asio::ip::tcp::socket m_socket;
     std::vector<char> m_buf;
     size_t m_buf_num_bytes_occupied{0};
+    RecordGroupFormat m_record_group_format{RecordGroupFormat::Msgpack};
 };
 }  // namespace reducer
 #endif  // REDUCER_RECORDRECEIVERCONTEXT_HPP
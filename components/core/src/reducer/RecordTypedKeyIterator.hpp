@@ -1,7 +1,11 @@
 #ifndef REDUCER_RECORDTYPEDKEYITERATOR_HPP
 #define REDUCER_RECORDTYPEDKEYITERATOR_HPP
 
+#include <cstddef>
+#include <cstdint>
 #include <string_view>
+#include <utility>
+#include <vector>
 
 namespace reducer {
 /**
@@ -90,6 +94,25 @@ private:
     ValueType m_type;
     bool m_done{false};
 };
+
+/**
+ * A RecordTypedKeyIterator over a collection of typed keys.
+ */
+class VectorTypedKeyIterator : public RecordTypedKeyIterator {
+public:
+    explicit VectorTypedKeyIterator(std::vector<TypedRecordKey> typed_keys)
+            : m_typed_keys{std::move(typed_keys)} {}
+
+    TypedRecordKey get() override { return m_typed_keys[m_idx]; }
+
+    void next() override { ++m_idx; }
+
+    bool done() override { return m_idx >= m_typed_keys.size(); }
+
+private:
+    std::vector<TypedRecordKey> m_typed_keys;
+    size_t m_idx{0};
+};
 }  // namespace reducer
 
 #endif  // REDUCER_RECORDTYPEDKEYITERATOR_HPP
@@ -1,5 +1,10 @@
 #include "ServerContext.hpp"
 
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
 #include <bsoncxx/builder/stream/document.hpp>
 #include <mongocxx/bulk_write.hpp>
 #include <mongocxx/client.hpp>
@@ -15,6 +20,9 @@
 #include "CommandLineArguments.hpp"
 #include "CountOperator.hpp"
 #include "DeserializedRecordGroup.hpp"
+#include "DistinctCountOperator.hpp"
+#include "NumericAggregationOperator.hpp"
+#include "PercentileOperator.hpp"
 
 using boost::asio::ip::tcp;
 using std::vector;
@@ -34,6 +42,16 @@ namespace {
  */
 vector<uint8_t> serialize_timeline_result(GroupTags const& tags, ConstRecordIterator& record_it);
 
+/**
+ * Creates the operator that merges the partial results sent by the search workers.
+ * @param query_config
+ * @return The operator specified by the job's aggregation type, or a CountOperator if the job
+ * doesn't specify one.
+ * @throw nlohmann::json::exception if the aggregation attributes have unexpected types.
+ * @throw ServerContext::OperationFailed if the aggregation type is unknown.
+ */
+std::shared_ptr<Operator> create_aggregation_operator(nlohmann::json const& query_config);
+
 vector<uint8_t> serialize_timeline_result(GroupTags const& tags, ConstRecordIterator& record_it) {
     nlohmann::json json;
     json["timestamp"] = std::stoll(tags.front());
@@ -47,12 +65,41 @@ vector<uint8_t> serialize_timeline_result(GroupTags const& tags, ConstRecordIter
 
     return nlohmann::json::to_bson(json);
 }
+
+std::shared_ptr<Operator> create_aggregation_operator(nlohmann::json const& query_config) {
+    if (0 == query_config.count(cJobAttributes::AggregationType)
+        || query_config[cJobAttributes::AggregationType].is_null())
+    {
+        return std::make_shared<CountOperator>();
+    }
+
+    auto const aggregation_type
+            = query_config[cJobAttributes::AggregationType].get<std::string>();
+    auto column = query_config[cJobAttributes::AggregationColumn].get<std::string>();
+    if (cAggregationTypes::Numeric == aggregation_type) {
+        return std::make_shared<NumericAggregationOperator>(std::move(column));
+    }
+    if (cAggregationTypes::DistinctCount == aggregation_type) {
+        return std::make_shared<DistinctCountOperator>(std::move(column));
+    }
+    if (cAggregationTypes::Percentile == aggregation_type) {
+        return std::make_shared<PercentileOperator>(
+                std::move(column),
+                query_config[cJobAttributes::Percentiles].get<vector<double>>()
+        );
+    }
+
+    SPDLOG_ERROR("Unknown aggregation type \"{}\"", aggregation_type);
+    throw ServerContext::OperationFailed(clp::ErrorCode_BadParam, __FILENAME__, __LINE__);
+}
 }  // namespace
 
 // TODO: We should use tcp::v6 and set ip::v6_only to false, but this isn't guaranteed to work; so
 // for now, we use v4 to be safe.
 ServerContext::ServerContext(CommandLineArguments& args)
-        : m_tcp_acceptor{m_ioctx, tcp::endpoint(tcp::v4(), args.get_reducer_port())},
+        : m_strand{boost::asio::make_strand(m_ioctx)},
+          m_num_threads{args.get_num_threads()},
+          m_tcp_acceptor{m_ioctx, tcp::endpoint(tcp::v4(), args.get_reducer_port())},
           m_scheduler_socket{m_ioctx},
           m_upsert_timer{m_ioctx},
           m_reducer_host{args.get_reducer_host()},
@@ -73,11 +120,43 @@ void ServerContext::reset() {
     m_pipeline.reset(nullptr);
     m_status = ServerStatus::Idle;
     m_job_id = -1;
+    m_results_finalized = false;
     m_is_timeline_aggregation = false;
-    m_updated_tags.clear();
     m_num_active_receiver_tasks = 0;
 }
 
+void ServerContext::run() {
+    std::vector<std::thread> threads;
+    std::vector<std::exception_ptr> thread_exceptions(m_num_threads);
+    threads.reserve(m_num_threads - 1);
+    // The calling thread runs the event loop too
+    for (size_t i = 1; i < m_num_threads; ++i) {
+        threads.emplace_back([this, &exception = thread_exceptions[i]]() {
+            try {
+                m_ioctx.run();
+            } catch (...) {
+                exception = std::current_exception();
+                m_ioctx.stop();
+            }
+        });
+    }
+    try {
+        m_ioctx.run();
+    } catch (...) {
+        thread_exceptions.front() = std::current_exception();
+        m_ioctx.stop();
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (auto const& exception : thread_exceptions) {
+        if (nullptr != exception) {
+            std::rethrow_exception(exception);
+        }
+    }
+}
+
 void ServerContext::stop_event_loop() {
     m_tcp_acceptor.cancel();
     m_scheduler_socket.close();
@@ -98,6 +177,8 @@ bool ServerContext::register_with_scheduler(
     nlohmann::json reducer_advertisement;
     reducer_advertisement["host"] = m_reducer_host;
     reducer_advertisement["port"] = m_reducer_port;
+    // Lets the scheduler tell workers that they can send record groups in the columnar format
+    reducer_advertisement["supports_columnar_record_groups"] = true;
     auto serialized_advertisement = nlohmann::json::to_msgpack(reducer_advertisement);
     auto message_size = serialized_advertisement.size();
 
@@ -132,11 +213,14 @@ bool ServerContext::ack_query_scheduler() {
 }
 
 void ServerContext::decrement_num_active_receiver_tasks() {
-    --m_num_active_receiver_tasks;
-    if (0 == m_num_active_receiver_tasks && ServerStatus::ReceivedAllResults == m_status) {
-        if (false == try_finalize_results()) {
-            m_status = ServerStatus::UnrecoverableFailure;
-        }
+    if (1 == m_num_active_receiver_tasks.fetch_sub(1)
+        && ServerStatus::ReceivedAllResults == m_status)
+    {
+        boost::asio::post(m_strand, [this]() {
+            if (false == try_finalize_results()) {
+                m_status = ServerStatus::UnrecoverableFailure;
+            }
+        });
     }
 }
 
@@ -145,44 +229,39 @@ void ServerContext::set_up_pipeline(nlohmann::json const& query_config) {
 
     SPDLOG_INFO("Setting up pipeline for job {}", m_job_id);
 
-    // For now, all pipelines only perform count and optionally, group-by time and count for the
-    // timeline aggregation.
+    // Pipelines either perform a count (optionally, grouped by time for the timeline aggregation)
+    // or merge the partial aggregates computed by the search workers for a single column.
     // TODO: We'll need to implement more general pipeline initialization once more operators are
     // needed.
-    m_pipeline = std::make_unique<Pipeline>(PipelineInputMode::IntraStage);
-    m_pipeline->add_pipeline_stage(std::make_shared<CountOperator>());
-
     if (query_config.count(cJobAttributes::TimeBucketSize) > 0
         && false == query_config[cJobAttributes::TimeBucketSize].is_null())
     {
         m_is_timeline_aggregation = true;
     }
 
+    // Each thread receiving results pushes into the shard that owns the record group's tags, so we
+    // use one shard per thread.
+    m_pipeline = std::make_unique<ShardedPipeline>(
+            m_num_threads,
+            [&]() { return create_aggregation_operator(query_config); },
+            m_is_timeline_aggregation
+    );
+
     auto collection_name = std::to_string(m_job_id);
     m_mongodb_results_collection = m_mongodb_results_database[collection_name];
 }
 
 void ServerContext::push_record_group(GroupTags const& tags, ConstRecordIterator& record_it) {
-    if (m_is_timeline_aggregation) {
-        m_updated_tags.insert(tags);
-    }
     m_pipeline->push_record_group(tags, record_it);
 }
 
 bool ServerContext::upsert_timeline_results() {
-    if (m_updated_tags.empty()) {
-        return true;
-    }
-
     bool any_updates = false;
     auto bulk_write = m_mongodb_results_collection.create_bulk_write();
     vector<vector<uint8_t>> results;
-    for (auto group_it = m_pipeline->finish(m_updated_tags); false == group_it->done();
-         group_it->next())
-    {
-        int64_t timestamp{std::stoll(group_it->get().get_tags().front())};
+    m_pipeline->visit_updated_results([&](RecordGroup& group) {
+        int64_t timestamp{std::stoll(group.get_tags().front())};
 
-        auto& group = group_it->get();
         results.emplace_back(serialize_timeline_result(group.get_tags(), group.record_iter()));
 
         auto& result = results.back();
@@ -196,11 +275,10 @@ bool ServerContext::upsert_timeline_results() {
         bulk_write.append(replace_op);
 
         any_updates = true;
-    }
+    });
     try {
         if (any_updates) {
             bulk_write.execute();
-            m_updated_tags.clear();
         }
     } catch (mongocxx::bulk_write_exception const& e) {
         SPDLOG_ERROR("Failed to upsert timeline results - {}", e.what());
@@ -213,13 +291,12 @@ bool ServerContext::upsert_timeline_results() {
 bool ServerContext::publish_pipeline_results() {
     vector<vector<uint8_t>> results;
     vector<bsoncxx::document::view> result_documents;
-    for (auto group_it = m_pipeline->finish(); false == group_it->done(); group_it->next()) {
-        auto& group = group_it->get();
+    m_pipeline->visit_results([&](RecordGroup& group) {
         results.push_back(
                 serialize(group.get_tags(), group.record_iter(), nlohmann::json::to_bson)
         );
-
-        vector<uint8_t>& encoded_result = results.back();
+    });
+    for (auto const& encoded_result : results) {
         result_documents.emplace_back(encoded_result.data(), encoded_result.size());
     }
     try {
@@ -235,6 +312,10 @@ bool ServerContext::publish_pipeline_results() {
 }
 
 bool ServerContext::try_finalize_results() {
+    if (m_results_finalized) {
+        // Both the scheduler listener and the last receiver task may try to finalize the results
+        return true;
+    }
     if (ServerStatus::Running == m_status) {
         // The pipeline's still running
         return true;
@@ -249,6 +330,7 @@ bool ServerContext::try_finalize_results() {
 
     bool published_results_successfully
             = m_is_timeline_aggregation ? upsert_timeline_results() : publish_pipeline_results();
+    m_results_finalized = true;
     if (false == published_results_successfully) {
         SPDLOG_ERROR("Failed to publish results to results cache.");
         return false;
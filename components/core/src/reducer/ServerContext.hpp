@@ -1,8 +1,10 @@
 #ifndef REDUCER_SERVERCONTEXT_HPP
 #define REDUCER_SERVERCONTEXT_HPP
 
+#include <atomic>
+#include <cstddef>
+#include <memory>
 #include <optional>
-#include <set>
 
 #include <boost/asio.hpp>
 #include <mongocxx/client.hpp>
@@ -11,7 +13,7 @@
 
 #include "../clp/TraceableException.hpp"
 #include "CommandLineArguments.hpp"
-#include "Pipeline.hpp"
+#include "ShardedPipeline.hpp"
 #include "types.hpp"
 
 namespace reducer {
@@ -26,11 +28,28 @@ enum class ServerStatus : uint8_t {
 namespace cJobAttributes {
 constexpr char JobId[] = "job_id";
 constexpr char TimeBucketSize[] = "count_by_time_bucket_size";
+constexpr char AggregationType[] = "aggregation_type";
+constexpr char AggregationColumn[] = "aggregation_column";
+constexpr char Percentiles[] = "percentiles";
+}  // namespace cJobAttributes
+
+/**
+ * Values of the `cJobAttributes::AggregationType` job attribute.
+ */
+namespace cAggregationTypes {
+constexpr char Numeric[] = "numeric";
+constexpr char DistinctCount[] = "distinct_count";
+constexpr char Percentile[] = "percentile";
 }  // namespace cJobAttributes
 
 /**
  * Class which manages interactions with the jobs database and result cache database. Also holds
  * state for the reducer job this server is handling.
+ *
+ * The server's event loop runs on a pool of threads. Tasks which interact with the scheduler, the
+ * acceptor socket, or the results cache must run on the server's strand (see `get_strand`), while
+ * tasks which receive records from senders can run on any thread and push record groups into a
+ * pipeline that's sharded by group so that concurrent pushes rarely contend.
  */
 class ServerContext {
 public:
@@ -58,9 +77,10 @@ public:
     void reset();
 
     /**
-     * Executes the server event loop until no tasks remain.
+     * Executes the server event loop on the server's thread pool until no tasks remain.
+     * @throw boost::system::system_error if any thread fails to run the event loop.
      */
-    void run() { m_ioctx.run(); }
+    void run();
 
     /**
      * Stops the event loop by closing the connection to the scheduler, and cancelling any ongoing
@@ -85,13 +105,15 @@ public:
     bool ack_query_scheduler();
 
     /**
-     * Increments the number of active receiver tasks which may receive some results.
+     * Increments the number of active receiver tasks which may receive some results. This method is
+     * thread-safe.
      */
     void increment_num_active_receiver_tasks() { ++m_num_active_receiver_tasks; }
 
     /**
-     * Decrements the number of active receiver tasks, and calls try_finalize_results if the server
-     * is in the state ReceivedAllResults and there are no remaining active receiver tasks.
+     * Decrements the number of active receiver tasks, and queues a call to try_finalize_results on
+     * the server's strand if the server is in the state ReceivedAllResults and there are no
+     * remaining active receiver tasks. This method is thread-safe.
      */
     void decrement_num_active_receiver_tasks();
 
@@ -102,7 +124,7 @@ public:
     void set_up_pipeline(nlohmann::json const& query_config);
 
     /**
-     * Pushes a record group into the reducer pipeline.
+     * Pushes a record group into the reducer pipeline. This method is thread-safe.
      * @param group_tags The tags in the record group.
      * @param record_it An iterator for the records in the record group.
      */
@@ -133,6 +155,12 @@ public:
 
     boost::asio::io_context& get_io_context() { return m_ioctx; }
 
+    /**
+     * @return The strand which serializes all tasks that interact with the scheduler, the acceptor
+     * socket, or the results cache.
+     */
+    boost::asio::strand<boost::asio::io_context::executor_type>& get_strand() { return m_strand; }
+
     boost::asio::ip::tcp::acceptor& get_tcp_acceptor() { return m_tcp_acceptor; }
 
     boost::asio::ip::tcp::socket& get_scheduler_update_socket() { return m_scheduler_socket; }
@@ -147,6 +175,8 @@ public:
 
     void set_status(ServerStatus new_status) { m_status = new_status; }
 
+    [[nodiscard]] size_t get_num_threads() const { return m_num_threads; }
+
     [[nodiscard]] job_id_t get_job_id() const { return m_job_id; }
 
     [[nodiscard]] bool is_timeline_aggregation() const { return m_is_timeline_aggregation; }
@@ -157,20 +187,22 @@ public:
 
 private:
     boost::asio::io_context m_ioctx;
+    boost::asio::strand<boost::asio::io_context::executor_type> m_strand;
+    size_t m_num_threads;
     boost::asio::ip::tcp::acceptor m_tcp_acceptor;
     boost::asio::ip::tcp::socket m_scheduler_socket;
     std::vector<char> m_scheduler_update_buffer;
 
     std::string m_reducer_host;
     int m_reducer_port;
-    int m_num_active_receiver_tasks{0};
+    std::atomic<int> m_num_active_receiver_tasks{0};
 
-    ServerStatus m_status{ServerStatus::Idle};
+    std::atomic<ServerStatus> m_status{ServerStatus::Idle};
     job_id_t m_job_id{-1};
+    bool m_results_finalized{false};
 
-    std::unique_ptr<Pipeline> m_pipeline;
+    std::unique_ptr<ShardedPipeline> m_pipeline;
     bool m_is_timeline_aggregation{false};
-    std::set<GroupTags> m_updated_tags;
 
     boost::asio::steady_timer m_upsert_timer;
     int m_upsert_interval;
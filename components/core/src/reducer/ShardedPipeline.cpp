@@ -0,0 +1,77 @@
+#include "ShardedPipeline.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <utility>
+
+#include "ConstRecordIterator.hpp"
+#include "GroupTags.hpp"
+
+namespace reducer {
+ShardedPipeline::ShardedPipeline(
+        size_t num_shards,
+        OperatorFactory const& create_operator,
+        bool track_updated_tags
+)
+        : m_track_updated_tags{track_updated_tags} {
+    num_shards = std::max<size_t>(num_shards, 1);
+    m_shards.reserve(num_shards);
+    for (size_t i = 0; i < num_shards; ++i) {
+        auto& shard = m_shards.emplace_back(std::make_unique<Shard>());
+        shard->pipeline.add_pipeline_stage(create_operator());
+    }
+}
+
+void ShardedPipeline::push_record_group(GroupTags const& tags, ConstRecordIterator& record_it) {
+    auto& shard = get_shard(tags);
+    std::lock_guard const lock{shard.mutex};
+    if (m_track_updated_tags) {
+        shard.updated_tags.insert(tags);
+    }
+    shard.pipeline.push_record_group(tags, record_it);
+}
+
+void ShardedPipeline::visit_results(RecordGroupVisitor const& visitor) {
+    for (auto& shard : m_shards) {
+        std::lock_guard const lock{shard->mutex};
+        for (auto group_it = shard->pipeline.finish(); false == group_it->done(); group_it->next())
+        {
+            visitor(group_it->get());
+        }
+    }
+}
+
+void ShardedPipeline::visit_updated_results(RecordGroupVisitor const& visitor) {
+    for (auto& shard : m_shards) {
+        std::lock_guard const lock{shard->mutex};
+        if (shard->updated_tags.empty()) {
+            continue;
+        }
+        for (auto group_it = shard->pipeline.finish(shard->updated_tags);
+             false == group_it->done();
+             group_it->next())
+        {
+            visitor(group_it->get());
+        }
+        shard->updated_tags.clear();
+    }
+}
+
+ShardedPipeline::Shard& ShardedPipeline::get_shard(GroupTags const& tags) {
+    if (1 == m_shards.size()) {
+        return *m_shards.front();
+    }
+
+    // Combine the tags' hashes the same way as boost::hash_combine
+    size_t hash{0};
+    for (auto const& tag : tags) {
+        hash ^= std::hash<std::string>{}(tag) + 0x9e37'79b9 + (hash << 6) + (hash >> 2);
+    }
+    return *m_shards[hash % m_shards.size()];
+}
+}  // namespace reducer
@@ -0,0 +1,93 @@
+#ifndef REDUCER_SHARDEDPIPELINE_HPP
+#define REDUCER_SHARDEDPIPELINE_HPP
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
+
+#include "ConstRecordIterator.hpp"
+#include "GroupTags.hpp"
+#include "Operator.hpp"
+#include "Pipeline.hpp"
+#include "RecordGroup.hpp"
+
+namespace reducer {
+/**
+ * A set of independent single-stage pipelines which allows record groups to be pushed concurrently
+ * from multiple threads.
+ *
+ * Each record group is routed to a shard by the hash of its tags, so all of a group's records are
+ * aggregated by the same shard. Since the shards hold disjoint sets of groups, the overall results
+ * are just the union of every shard's results. Each shard is protected by its own lock, so pushes
+ * to different shards don't contend.
+ */
+class ShardedPipeline {
+public:
+    // Types
+    using OperatorFactory = std::function<std::shared_ptr<Operator>()>;
+    using RecordGroupVisitor = std::function<void(RecordGroup&)>;
+
+    // Constructors
+    /**
+     * @param num_shards Clamped to at least 1.
+     * @param create_operator Creates the operator for each shard's pipeline.
+     * @param track_updated_tags Whether to track the tags updated since the last call to
+     * `visit_updated_results`.
+     */
+    ShardedPipeline(
+            size_t num_shards,
+            OperatorFactory const& create_operator,
+            bool track_updated_tags
+    );
+
+    // Methods
+    /**
+     * Pushes a record group into the shard responsible for the group's tags. This method is
+     * thread-safe.
+     * @param tags
+     * @param record_it
+     */
+    void push_record_group(GroupTags const& tags, ConstRecordIterator& record_it);
+
+    /**
+     * Finishes each shard's pipeline and visits every resulting record group. Pushes to a shard
+     * block while the shard is being visited.
+     * @param visitor
+     */
+    void visit_results(RecordGroupVisitor const& visitor);
+
+    /**
+     * Visits the resulting record groups whose tags were updated since the last call to this
+     * method, and then forgets the updated tags. Pushes to a shard block while the shard is being
+     * visited.
+     * @param visitor
+     */
+    void visit_updated_results(RecordGroupVisitor const& visitor);
+
+    [[nodiscard]] size_t get_num_shards() const { return m_shards.size(); }
+
+private:
+    // Types
+    struct Shard {
+        std::mutex mutex;
+        Pipeline pipeline{PipelineInputMode::IntraStage};
+        std::set<GroupTags> updated_tags;
+    };
+
+    // Methods
+    /**
+     * @param tags
+     * @return The shard responsible for the group with the given tags.
+     */
+    Shard& get_shard(GroupTags const& tags);
+
+    // Variables
+    std::vector<std::unique_ptr<Shard>> m_shards;
+    bool m_track_updated_tags;
+};
+}  // namespace reducer
+
+#endif  // REDUCER_SHARDEDPIPELINE_HPP
@@ -9,33 +9,48 @@
 #include "../clp/ErrorCode.hpp"
 #include "../clp/networking/socket_utils.hpp"
 #include "BufferedSocketWriter.hpp"
+#include "ColumnarRecordGroup.hpp"
 #include "DeserializedRecordGroup.hpp"
 #include "RecordGroupIterator.hpp"
 #include "types.hpp"
 
 namespace reducer {
-int connect_to_reducer(std::string const& host, int port, job_id_t job_id) {
-    constexpr char cConnectionAcceptedResponse = 'y';
+int connect_to_reducer(
+        std::string const& host,
+        int port,
+        job_id_t job_id,
+        RecordGroupFormat record_group_format
+) {
     auto reducer_socket_fd = clp::networking::connect_to_server(host, std::to_string(port));
     if (-1 == reducer_socket_fd) {
         return -1;
     }
 
+    auto const is_columnar{RecordGroupFormat::Columnar == record_group_format};
+    auto const init_packet_job_id{is_columnar ? encode_columnar_format_job_id(job_id) : job_id};
     auto ecode = clp::networking::try_send(
             reducer_socket_fd,
-            reinterpret_cast<char const*>(&job_id),
-            sizeof(job_id)
+            reinterpret_cast<char const*>(&init_packet_job_id),
+            sizeof(init_packet_job_id)
     );
     if (clp::ErrorCode::ErrorCode_Success != ecode) {
         close(reducer_socket_fd);
         return -1;
     }
 
-    char ret{0};
+    char response{0};
     size_t bytes_received{0};
-    ecode = clp::networking::try_receive(reducer_socket_fd, &ret, sizeof(ret), bytes_received);
-    if (clp::ErrorCode::ErrorCode_Success != ecode || sizeof(ret) != bytes_received
-        || cConnectionAcceptedResponse != ret)
+    ecode = clp::networking::try_receive(
+            reducer_socket_fd,
+            &response,
+            sizeof(response),
+            bytes_received
+    );
+    auto const expected_response{
+            is_columnar ? cColumnarConnectionAcceptedResponse : cConnectionAcceptedResponse
+    };
+    if (clp::ErrorCode::ErrorCode_Success != ecode || sizeof(response) != bytes_received
+        || expected_response != response)
     {
         close(reducer_socket_fd);
         return -1;
@@ -44,13 +59,19 @@ int connect_to_reducer(std::string const& host, int port, job_id_t job_id) {
     return reducer_socket_fd;
 }
 
-bool send_pipeline_results(int reducer_socket_fd, std::unique_ptr<RecordGroupIterator> results) {
+bool send_pipeline_results(
+        int reducer_socket_fd,
+        std::unique_ptr<RecordGroupIterator> results,
+        RecordGroupFormat record_group_format
+) {
     constexpr int cBufSize = 1024;
     BufferedSocketWriter buffered_writer{reducer_socket_fd, cBufSize};
 
     for (; false == results->done(); results->next()) {
         auto& group = results->get();
-        auto serialized_result = serialize(group.get_tags(), group.record_iter());
+        auto serialized_result = RecordGroupFormat::Columnar == record_group_format
+                                         ? serialize_columnar(group.get_tags(), group.record_iter())
+                                         : serialize(group.get_tags(), group.record_iter());
         auto serialized_result_size = serialized_result.size();
 
         // Send size
@@ -13,18 +13,30 @@ namespace reducer {
  * @param host
  * @param port
  * @param job_id
+ * @param record_group_format The format that record groups will be sent in. The columnar format
+ * must only be requested from reducers which advertise support for it.
  * @return Socket file descriptor for the reducer on success
  * @return -1 on any error
  */
-int connect_to_reducer(std::string const& host, int port, job_id_t job_id);
+int connect_to_reducer(
+        std::string const& host,
+        int port,
+        job_id_t job_id,
+        RecordGroupFormat record_group_format
+);
 
 /**
  * Sends results to the reducer.
  * @param reducer_socket_fd
  * @param results
+ * @param record_group_format The format passed to `connect_to_reducer`.
  * @return Whether the results were sent successfully.
  */
-bool send_pipeline_results(int reducer_socket_fd, std::unique_ptr<RecordGroupIterator> results);
+bool send_pipeline_results(
+        int reducer_socket_fd,
+        std::unique_ptr<RecordGroupIterator> results,
+        RecordGroupFormat record_group_format
+);
 }  // namespace reducer
 
 #endif  // REDUCER_NETWORK_UTILS_HPP
@@ -1,4 +1,5 @@
 #include <cassert>
+#include <exception>
 #include <memory>
 #include <string>
 #include <utility>
@@ -122,7 +123,9 @@ void PeriodicUpsertTask::operator()([[maybe_unused]] boost::system::error_code c
 
     auto& upsert_timer = m_server_ctx->get_upsert_timer();
     upsert_timer.expires_after(std::chrono::milliseconds(m_server_ctx->get_upsert_interval()));
-    upsert_timer.async_wait(PeriodicUpsertTask(m_server_ctx));
+    upsert_timer.async_wait(
+            boost::asio::bind_executor(m_server_ctx->get_strand(), PeriodicUpsertTask(m_server_ctx))
+    );
 }
 
 void ReceiveTask::operator()(boost::system::error_code const& error, size_t num_bytes_read) {
@@ -200,7 +203,14 @@ void SchedulerUpdateListenerTask::operator()(
 
     auto status = m_server_ctx->get_status();
     if (ServerStatus::Idle == status) {
-        m_server_ctx->set_up_pipeline(message);
+        try {
+            m_server_ctx->set_up_pipeline(message);
+        } catch (std::exception const& e) {
+            SPDLOG_ERROR("Failed to set up pipeline - {}", e.what());
+            m_server_ctx->set_status(ServerStatus::RecoverableFailure);
+            m_server_ctx->stop_event_loop();
+            return;
+        }
         m_server_ctx->set_status(ServerStatus::Running);
 
         if (m_server_ctx->is_timeline_aggregation()) {
@@ -208,7 +218,12 @@ void SchedulerUpdateListenerTask::operator()(
             upsert_timer.expires_after(
                     std::chrono::milliseconds(m_server_ctx->get_upsert_interval())
             );
-            upsert_timer.async_wait(PeriodicUpsertTask(m_server_ctx));
+            upsert_timer.async_wait(
+                    boost::asio::bind_executor(
+                            m_server_ctx->get_strand(),
+                            PeriodicUpsertTask(m_server_ctx)
+                    )
+            );
         }
 
         // Synchronously notify the scheduler that the reducer is ready
@@ -263,7 +278,10 @@ void ValidateSenderTask::operator()(boost::system::error_code const& error, size
 
 void queue_accept_task(std::shared_ptr<ServerContext> const& ctx) {
     auto rctx = RecordReceiverContext::new_receiver(ctx);
-    ctx->get_tcp_acceptor().async_accept(rctx->get_socket(), AcceptTask(rctx));
+    ctx->get_tcp_acceptor().async_accept(
+            rctx->get_socket(),
+            boost::asio::bind_executor(ctx->get_strand(), AcceptTask(rctx))
+    );
 }
 
 void queue_receive_task(std::shared_ptr<RecordReceiverContext> const& ctx) {
@@ -282,7 +300,10 @@ void queue_scheduler_update_listener_task(
             ctx->get_scheduler_update_socket(),
             boost::asio::dynamic_buffer(ctx->get_scheduler_update_buffer()),
             boost::asio::transfer_at_least(1),  // Makes boost::asio forward results right away
-            SchedulerUpdateListenerTask(ctx, current_buffer_occupancy)
+            boost::asio::bind_executor(
+                    ctx->get_strand(),
+                    SchedulerUpdateListenerTask(ctx, current_buffer_occupancy)
+            )
     );
 }
 
@@ -321,7 +342,7 @@ std::string server_status_to_string(ServerStatus status) {
 int main(int argc, char const* argv[]) {
     // Program-wide initialization
     try {
-        auto stderr_logger = spdlog::stderr_logger_st("stderr");
+        auto stderr_logger = spdlog::stderr_logger_mt("stderr");
         spdlog::set_default_logger(stderr_logger);
         spdlog::set_pattern("%Y-%m-%dT%H:%M:%S.%e%z [%l] %v");
     } catch (std::exception& e) {
@@ -348,7 +369,12 @@ int main(int argc, char const* argv[]) {
         return 1;
     }
 
-    SPDLOG_INFO("Starting on host {} port {}", ctx->get_reducer_host(), ctx->get_reducer_port());
+    SPDLOG_INFO(
+            "Starting on host {} port {} with {} threads",
+            ctx->get_reducer_host(),
+            ctx->get_reducer_port(),
+            ctx->get_num_threads()
+    );
 
     // Job acquisition loop
     while (true) {
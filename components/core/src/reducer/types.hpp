@@ -5,6 +5,45 @@
 
 namespace reducer {
 using job_id_t = int64_t;
+
+/**
+ * Formats that a worker can serialize record groups in when sending them to the reducer.
+ */
+enum class RecordGroupFormat : uint8_t {
+    // Serialized by `serialize` (a MessagePack-encoded JSON object)
+    Msgpack,
+    // Serialized by `serialize_columnar`
+    Columnar
+};
+
+/**
+ * Encodes the job ID sent in a connection initiation packet by a worker that wants to send record
+ * groups in the columnar format.
+ *
+ * Valid job IDs are non-negative, so the encoded ID is always negative. This lets the reducer tell
+ * the two kinds of initiation packets apart. Reducers that support the columnar format advertise
+ * it when registering with the scheduler (see `ServerContext::register_with_scheduler`), and
+ * workers only send an encoded ID when told to, since older reducers reject it as a job ID
+ * mismatch.
+ * @param job_id
+ * @return The encoded job ID.
+ */
+constexpr job_id_t encode_columnar_format_job_id(job_id_t job_id) {
+    return -job_id - 1;
+}
+
+/**
+ * Decodes a job ID encoded by `encode_columnar_format_job_id`.
+ * @param encoded_job_id
+ * @return The job ID.
+ */
+constexpr job_id_t decode_columnar_format_job_id(job_id_t encoded_job_id) {
+    return -(encoded_job_id + 1);
+}
+
+// Responses to a connection initiation packet that indicate the connection was accepted
+constexpr char cConnectionAcceptedResponse = 'y';
+constexpr char cColumnarConnectionAcceptedResponse = 'c';
 }  // namespace reducer
 
 #endif  // REDUCER_TYPES_HPP
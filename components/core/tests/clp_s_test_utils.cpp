@@ -7,6 +7,7 @@
 #include <catch2/catch.hpp>
 
 #include "../src/clp_s/ArchiveWriter.hpp"
+#include "../src/clp_s/ArrayTape.hpp"
 #include "../src/clp_s/InputConfig.hpp"
 #include "../src/clp_s/JsonParser.hpp"
 
@@ -15,7 +16,10 @@ auto compress_archive(
         std::string const& archive_directory,
         bool single_file_archive,
         bool structurize_arrays,
-        clp_s::FileType file_type
+        clp_s::FileType file_type,
+        std::string const& timestamp_key,
+        double schema_compaction_threshold,
+        clp_s::ArrayEncoding array_encoding
 ) -> std::vector<clp_s::ArchiveStats> {
     constexpr auto cDefaultTargetEncodedSize{8ULL * 1024 * 1024 * 1024};  // 8 GiB
     constexpr auto cDefaultMaxDocumentSize{512ULL * 1024 * 1024};  // 512 MiB
@@ -39,6 +43,9 @@ auto compress_archive(
     parser_option.structurize_arrays = structurize_arrays;
     parser_option.single_file_archive = single_file_archive;
     parser_option.input_file_type = file_type;
+    parser_option.timestamp_key = timestamp_key;
+    parser_option.schema_compaction_threshold = schema_compaction_threshold;
+    parser_option.array_encoding = array_encoding;
 
     clp_s::JsonParser parser{parser_option};
     std::vector<clp_s::ArchiveStats> archive_stats;
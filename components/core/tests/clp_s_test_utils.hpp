@@ -5,6 +5,7 @@
 #include <vector>
 
 #include "../src/clp_s/ArchiveWriter.hpp"
+#include "../src/clp_s/ArrayTape.hpp"
 #include "../src/clp_s/InputConfig.hpp"
 
 /**
@@ -17,6 +18,10 @@
  * @param single_file_archive
  * @param structurize_arrays
  * @param file_type
+ * @param timestamp_key The authoritative timestamp key, or empty if there isn't one.
+ * @param schema_compaction_threshold The minimum similarity of schemas whose tables are compacted,
+ * or 0 to not compact tables.
+ * @param array_encoding The encoding of unstructured arrays.
  * @return Statistics for every compressed archive.
  */
 [[nodiscard]] auto compress_archive(
@@ -24,6 +29,9 @@
         std::string const& archive_directory,
         bool single_file_archive,
         bool structurize_arrays,
-        clp_s::FileType file_type
+        clp_s::FileType file_type,
+        std::string const& timestamp_key = {},
+        double schema_compaction_threshold = 0.0,
+        clp_s::ArrayEncoding array_encoding = clp_s::ArrayEncoding::ClpString
 ) -> std::vector<clp_s::ArchiveStats>;
 #endif  // CLP_S_TEST_UTILS_HPP
@@ -1,3 +1,7 @@
+#include <string>
+#include <utility>
+#include <vector>
+
 #include <catch2/catch.hpp>
 
 #include "../src/clp/TimestampPattern.hpp"
@@ -549,3 +553,43 @@ TEST_CASE("Test known timestamp patterns", "[KnownTimestampPatterns]") {
     specific_pattern.insert_formatted_timestamp(timestamp, content);
     REQUIRE(line == content);
 }
+
+TEST_CASE("Test known timestamp pattern signatures", "[KnownTimestampPatterns]") {
+    TimestampPattern::init();
+
+    epochtime_t timestamp{};
+    size_t timestamp_begin_pos{};
+    size_t timestamp_end_pos{};
+
+    // Lines that only differ from other known patterns in their separators or in the number of
+    // spaces before the timestamp
+    std::vector<std::pair<string, string>> const lines_and_formats{
+            {"2015/01/31 15:50:45 content after", "%Y/%m/%d %H:%M:%S"},
+            {"Start-Date: 2015-01-31  15:50:45 content after", "%Y-%m-%d  %H:%M:%S"},
+            {"150131  9:50:45 content after", "%y%m%d %k:%M:%S"},
+            {"ERROR: apport (pid 4557) Sun Jan  1 15:50:45 2015", "%a %b %e %H:%M:%S %Y"},
+            {"January 31, 2015 15:50 content after", "%B %d, %Y %H:%M"},
+            {"916321 content after", "%#3"}
+    };
+    for (auto const& [line, format] : lines_and_formats) {
+        auto const* pattern = TimestampPattern::search_known_ts_patterns(
+                line,
+                timestamp,
+                timestamp_begin_pos,
+                timestamp_end_pos
+        );
+        REQUIRE(nullptr != pattern);
+        REQUIRE(pattern->get_format() == format);
+    }
+
+    string const line{"no timestamp in this line"};
+    REQUIRE(nullptr
+            == TimestampPattern::search_known_ts_patterns(
+                    line,
+                    timestamp,
+                    timestamp_begin_pos,
+                    timestamp_end_pos
+            ));
+    REQUIRE(string::npos == timestamp_begin_pos);
+    REQUIRE(string::npos == timestamp_end_pos);
+}
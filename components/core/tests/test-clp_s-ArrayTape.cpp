@@ -0,0 +1,154 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <catch2/catch.hpp>
+
+#include "../src/clp_s/ArrayTape.hpp"
+#include "../src/clp_s/BufferViewReader.hpp"
+#include "../src/clp_s/ColumnReader.hpp"
+
+using clp_s::ArrayEncoding;
+using clp_s::ArrayTapeIterator;
+using clp_s::ArrayTapeValueType;
+using clp_s::ArrayTapeWriter;
+using clp_s::BufferViewReader;
+using clp_s::UnstructuredArrayColumnReader;
+
+namespace {
+/**
+ * @param tape
+ * @return The JSON text of the array with the given tape.
+ */
+auto get_json(std::string_view tape) -> std::string {
+    std::string json;
+    ArrayTapeIterator::append_array_as_json(tape, json);
+    return json;
+}
+}  // namespace
+
+TEST_CASE("clp-s-array-tape", "[clp-s][ArrayTape]") {
+    ArrayTapeWriter writer;
+
+    SECTION("Arrays round-trip") {
+        REQUIRE("[]" == get_json(writer.get_tape()));
+
+        // [1,-2,18446744073709551615,2.5,3.0,1e+300,"a\"b",null,true,false,[],{"k":[{"z":0}]}]
+        writer.add_int64(1);
+        writer.add_int64(-2);
+        writer.add_uint64(std::numeric_limits<uint64_t>::max());
+        writer.add_double(2.5);
+        writer.add_double(3.0);
+        writer.add_double(1e300);
+        writer.add_string("a\"b");
+        writer.add_null();
+        writer.add_bool(true);
+        writer.add_bool(false);
+        writer.begin_array();
+        writer.end_container();
+        writer.begin_object();
+        writer.add_key("k");
+        writer.begin_array();
+        writer.begin_object();
+        writer.add_key("z");
+        writer.add_int64(0);
+        writer.end_container();
+        writer.end_container();
+        writer.end_container();
+        REQUIRE(
+                R"([1,-2,18446744073709551615,2.5,3.0,1e+300,"a\"b",null,true,false,[],)"
+                R"({"k":[{"z":0}]}])"
+                == get_json(writer.get_tape())
+        );
+
+        writer.clear();
+        writer.add_string("x");
+        REQUIRE(R"(["x"])" == get_json(writer.get_tape()));
+    }
+
+    SECTION("Values can be iterated and containers skipped") {
+        writer.begin_object();
+        writer.add_key("a");
+        writer.add_string("b");
+        writer.add_key("c");
+        writer.begin_array();
+        writer.add_int64(7);
+        writer.end_container();
+        writer.end_container();
+        writer.add_double(-0.5);
+
+        ArrayTapeIterator it{writer.get_tape()};
+        REQUIRE(it.has_next());
+        auto const object = it.next_value();
+        REQUIRE(ArrayTapeValueType::Object == object.get_type());
+        REQUIRE(it.has_next());
+        auto const number = it.next_value();
+        REQUIRE(ArrayTapeValueType::Double == number.get_type());
+        REQUIRE(-0.5 == number.get_double());
+        REQUIRE_FALSE(it.has_next());
+
+        ArrayTapeIterator object_it{object.get_contents()};
+        REQUIRE("a" == object_it.next_key());
+        auto const string = object_it.next_value();
+        REQUIRE(ArrayTapeValueType::String == string.get_type());
+        REQUIRE("b" == string.get_string());
+        REQUIRE("c" == object_it.next_key());
+        auto const array = object_it.next_value();
+        REQUIRE(ArrayTapeValueType::Array == array.get_type());
+        REQUIRE_FALSE(object_it.has_next());
+
+        ArrayTapeIterator array_it{array.get_contents()};
+        REQUIRE(7 == array_it.next_value().get_int64());
+        REQUIRE_FALSE(array_it.has_next());
+    }
+
+    SECTION("Corrupt tapes are rejected") {
+        REQUIRE_THROWS_AS(writer.end_container(), ArrayTapeWriter::OperationFailed);
+
+        writer.begin_array();
+        writer.add_int64(1);
+        writer.end_container();
+        std::string tape{writer.get_tape()};
+
+        // Truncated container
+        REQUIRE_THROWS_AS(
+                get_json(std::string_view{tape}.substr(0, tape.size() - 1)),
+                ArrayTapeIterator::OperationFailed
+        );
+
+        // Unknown value type
+        tape.front() = static_cast<char>(0xFF);
+        REQUIRE_THROWS_AS(get_json(tape), ArrayTapeIterator::OperationFailed);
+    }
+
+    SECTION("Columns from archives which don't store array encodings are read as CLP strings") {
+        // The first byte of the first log type ID would be misread as `ArrayEncoding::Tape`
+        uint64_t const log_type_id{static_cast<uint64_t>(ArrayEncoding::Tape)};
+        size_t const num_encoded_vars{0};
+        // Archives older than 0.4.0 store unstructured array columns as CLP strings without an
+        // encoding
+        std::string column(sizeof(log_type_id) + sizeof(num_encoded_vars), '\0');
+        std::memcpy(column.data(), &log_type_id, sizeof(log_type_id));
+        std::memcpy(
+                column.data() + sizeof(log_type_id),
+                &num_encoded_vars,
+                sizeof(num_encoded_vars)
+        );
+        std::string const encoded_column{static_cast<char>(ArrayEncoding::ClpString) + column};
+
+        for (auto const& [buffer, is_encoding_stored] :
+             {std::pair{column, false}, std::pair{encoded_column, true}})
+        {
+            auto column_buffer{buffer};
+            BufferViewReader reader{column_buffer.data(), column_buffer.size()};
+            UnstructuredArrayColumnReader column_reader{0, nullptr, nullptr, is_encoding_stored};
+            column_reader.load(reader, 1);
+            REQUIRE(ArrayEncoding::ClpString == column_reader.get_encoding());
+            REQUIRE(0 == reader.get_remaining_size());
+        }
+    }
+}
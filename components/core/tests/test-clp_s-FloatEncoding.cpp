@@ -0,0 +1,149 @@
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "../src/clp_s/BufferViewReader.hpp"
+#include "../src/clp_s/ColumnReader.hpp"
+#include "../src/clp_s/FloatEncoding.hpp"
+#include "../src/clp_s/Utils.hpp"
+
+using clp_s::AlpEncodedValues;
+using clp_s::AlpEncoder;
+using clp_s::BufferViewReader;
+using clp_s::FloatColumnReader;
+using clp_s::FloatEncoding;
+using clp_s::UnalignedMemSpan;
+
+namespace {
+/**
+ * Creates a span over the given vector's elements.
+ * @tparam T
+ * @param values
+ * @return The span
+ */
+template <typename T>
+auto create_span(std::vector<T>& values) -> UnalignedMemSpan<T> {
+    return {reinterpret_cast<char*>(values.data()), values.size()};
+}
+
+/**
+ * Decodes the given encoded values.
+ * @param encoded_values
+ * @return The decoded values
+ */
+auto decode(AlpEncodedValues& encoded_values) -> std::vector<double> {
+    std::vector<double> values;
+    REQUIRE(AlpEncoder::decode(
+            encoded_values.exponent,
+            encoded_values.factor,
+            create_span(encoded_values.digits),
+            create_span(encoded_values.exception_positions),
+            create_span(encoded_values.exception_values),
+            values
+    ));
+    return values;
+}
+
+/**
+ * @param lhs
+ * @param rhs
+ * @return Whether the given values are bitwise identical.
+ */
+auto are_identical(std::vector<double> const& lhs, std::vector<double> const& rhs) -> bool {
+    if (lhs.size() != rhs.size()) {
+        return false;
+    }
+    for (size_t i{0}; i < lhs.size(); ++i) {
+        if (std::bit_cast<uint64_t>(lhs[i]) != std::bit_cast<uint64_t>(rhs[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+}  // namespace
+
+TEST_CASE("clp-s-alp-float-encoding", "[clp-s][FloatEncoding]") {
+    SECTION("Decimal values round-trip with few exceptions") {
+        std::vector<double> values;
+        for (size_t i{0}; i < 5000; ++i) {
+            // Latency-like values with three decimal digits
+            values.push_back(static_cast<double>((i * 7919) % 100'000) / 1000.0);
+        }
+        auto encoded_values = AlpEncoder::encode(values);
+        REQUIRE(encoded_values.has_value());
+        // Multiplying by inexact negative powers of 10 doesn't round-trip every value
+        REQUIRE(encoded_values->exception_positions.size() < values.size() / 50);
+        REQUIRE(are_identical(values, decode(encoded_values.value())));
+    }
+
+    SECTION("Values which can't be encoded round-trip as exceptions") {
+        std::vector<double> values;
+        for (size_t i{0}; i < 1000; ++i) {
+            values.push_back(static_cast<double>(i) * 0.25);
+        }
+        values[3] = -0.0;
+        values[100] = std::numeric_limits<double>::quiet_NaN();
+        values[500] = std::numeric_limits<double>::infinity();
+        values[999] = 1e300;
+        auto encoded_values = AlpEncoder::encode(values);
+        REQUIRE(encoded_values.has_value());
+        REQUIRE(4 == encoded_values->exception_positions.size());
+        REQUIRE(are_identical(values, decode(encoded_values.value())));
+    }
+
+    SECTION("Values with too many significant digits aren't encoded") {
+        std::vector<double> values;
+        double value{0.1};
+        for (size_t i{0}; i < 1000; ++i) {
+            value = value * 1.0001 + 1.0 / 3.0;
+            values.push_back(value);
+        }
+        REQUIRE_FALSE(AlpEncoder::encode(values).has_value());
+        REQUIRE_FALSE(AlpEncoder::encode({}).has_value());
+    }
+
+    SECTION("Invalid encoded values are rejected") {
+        std::vector<double> values{1.5, 2.5};
+        auto encoded_values = AlpEncoder::encode(values);
+        REQUIRE(encoded_values.has_value());
+        encoded_values->exception_positions.push_back(values.size());
+        encoded_values->exception_values.push_back(0.0);
+        std::vector<double> decoded_values;
+        REQUIRE_FALSE(AlpEncoder::decode(
+                encoded_values->exponent,
+                encoded_values->factor,
+                create_span(encoded_values->digits),
+                create_span(encoded_values->exception_positions),
+                create_span(encoded_values->exception_values),
+                decoded_values
+        ));
+    }
+
+    SECTION("Columns from archives which don't store float encodings are read as raw") {
+        std::vector<double> const values{1.5, -2.25, 1e300};
+        // Archives older than 0.4.0 store float columns as raw values without an encoding
+        std::string column(sizeof(double) * values.size(), '\0');
+        std::memcpy(column.data(), values.data(), column.size());
+        std::string const encoded_column{static_cast<char>(FloatEncoding::Raw) + column};
+
+        for (auto const& [buffer, is_encoding_stored] :
+             {std::pair{column, false}, std::pair{encoded_column, true}})
+        {
+            auto column_buffer{buffer};
+            BufferViewReader reader{column_buffer.data(), column_buffer.size()};
+            FloatColumnReader column_reader{0, is_encoding_stored};
+            column_reader.load(reader, values.size());
+            for (size_t i{0}; i < values.size(); ++i) {
+                REQUIRE(values[i] == std::get<double>(column_reader.extract_value(i)));
+            }
+        }
+    }
+}
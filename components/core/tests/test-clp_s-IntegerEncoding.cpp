@@ -0,0 +1,194 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "../src/clp_s/BufferViewReader.hpp"
+#include "../src/clp_s/ColumnReader.hpp"
+#include "../src/clp_s/IntegerEncoding.hpp"
+#include "../src/clp_s/Utils.hpp"
+
+using clp_s::BufferViewReader;
+using clp_s::Int64ColumnReader;
+using clp_s::IntegerColumnStatistics;
+using clp_s::IntegerEncoder;
+using clp_s::IntegerEncoding;
+using clp_s::UnalignedMemSpan;
+
+namespace {
+/**
+ * Creates a span over the given vector's elements.
+ * @tparam T
+ * @param values
+ * @return The span
+ */
+template <typename T>
+auto create_span(std::vector<T>& values) -> UnalignedMemSpan<T> {
+    return {reinterpret_cast<char*>(values.data()), values.size()};
+}
+
+/**
+ * @param values
+ * @return The best encoding for the given values.
+ */
+auto get_best_encoding(std::vector<int64_t> const& values) -> IntegerEncoding {
+    IntegerColumnStatistics statistics;
+    for (auto const value : values) {
+        statistics.add_value(value);
+    }
+    return statistics.get_best_encoding();
+}
+
+/**
+ * Encodes and decodes the given values with each encoding, checking that they round-trip.
+ * @param values
+ */
+void require_round_trips(std::vector<int64_t> const& values) {
+    std::vector<int64_t> decoded_values;
+
+    auto for_encoded_values = IntegerEncoder::encode_frame_of_reference(values);
+    REQUIRE(IntegerEncoder::decode_frame_of_reference(
+            for_encoded_values.base,
+            for_encoded_values.bit_width,
+            create_span(for_encoded_values.packed_values),
+            values.size(),
+            decoded_values
+    ));
+    REQUIRE(values == decoded_values);
+
+    auto delta_encoded_values = IntegerEncoder::encode_delta(values);
+    REQUIRE(IntegerEncoder::decode_delta(
+            delta_encoded_values.first_value,
+            delta_encoded_values.deltas.base,
+            delta_encoded_values.deltas.bit_width,
+            create_span(delta_encoded_values.deltas.packed_values),
+            values.size(),
+            decoded_values
+    ));
+    REQUIRE(values == decoded_values);
+
+    auto rle_encoded_values = IntegerEncoder::encode_run_length(values);
+    REQUIRE(IntegerEncoder::decode_run_length(
+            create_span(rle_encoded_values.run_values),
+            create_span(rle_encoded_values.run_lengths),
+            values.size(),
+            decoded_values
+    ));
+    REQUIRE(values == decoded_values);
+}
+}  // namespace
+
+TEST_CASE("clp-s-integer-encoding", "[clp-s][IntegerEncoding]") {
+    SECTION("Values round-trip with every encoding") {
+        std::vector<int64_t> values;
+        require_round_trips(values);
+        for (size_t i{0}; i < 1000; ++i) {
+            values.push_back(static_cast<int64_t>((i * 7919) % 1000) - 500);
+            // Cover every block size, including partial blocks, at every bit width
+            require_round_trips(values);
+        }
+
+        for (uint8_t bit_width{0}; bit_width < IntegerEncoder::cMaxBitWidth; ++bit_width) {
+            std::vector<int64_t> values_with_bit_width{0, static_cast<int64_t>(1ULL << bit_width)};
+            for (size_t i{0}; i < 200; ++i) {
+                values_with_bit_width.push_back(static_cast<int64_t>(i) % 3);
+            }
+            require_round_trips(values_with_bit_width);
+        }
+
+        // Differences which overflow int64_t
+        require_round_trips(
+                {std::numeric_limits<int64_t>::max(),
+                 std::numeric_limits<int64_t>::min(),
+                 0,
+                 std::numeric_limits<int64_t>::max(),
+                 -1}
+        );
+    }
+
+    SECTION("The smallest encoding is chosen") {
+        REQUIRE(IntegerEncoding::Raw == get_best_encoding({}));
+
+        std::vector<int64_t> constant_values(1000, 1'700'000'000'000);
+        REQUIRE(IntegerEncoding::FrameOfReference == get_best_encoding(constant_values));
+
+        std::vector<int64_t> small_range_values;
+        std::vector<int64_t> monotonic_values;
+        std::vector<int64_t> run_values;
+        std::vector<int64_t> random_values;
+        uint64_t state{1};
+        for (size_t i{0}; i < 1000; ++i) {
+            state = state * 6'364'136'223'846'793'005ULL + 1'442'695'040'888'963'407ULL;
+            small_range_values.push_back(1'000'000 + static_cast<int64_t>(state >> 56));
+            monotonic_values.push_back(1'700'000'000'000 + static_cast<int64_t>(i * 1000 + i % 7));
+            run_values.push_back((i / 100 % 2 == 0) ? std::numeric_limits<int64_t>::min() : 1);
+            random_values.push_back(static_cast<int64_t>(state));
+        }
+        REQUIRE(IntegerEncoding::FrameOfReference == get_best_encoding(small_range_values));
+        REQUIRE(IntegerEncoding::Delta == get_best_encoding(monotonic_values));
+        REQUIRE(IntegerEncoding::RunLength == get_best_encoding(run_values));
+        REQUIRE(IntegerEncoding::Raw == get_best_encoding(random_values));
+    }
+
+    SECTION("Invalid encoded values are rejected") {
+        std::vector<int64_t> values{1, 2, 3};
+        std::vector<int64_t> decoded_values;
+
+        auto for_encoded_values = IntegerEncoder::encode_frame_of_reference(values);
+        REQUIRE_FALSE(IntegerEncoder::decode_frame_of_reference(
+                for_encoded_values.base,
+                IntegerEncoder::cMaxBitWidth + 1,
+                create_span(for_encoded_values.packed_values),
+                values.size(),
+                decoded_values
+        ));
+        REQUIRE_FALSE(IntegerEncoder::decode_frame_of_reference(
+                for_encoded_values.base,
+                for_encoded_values.bit_width,
+                create_span(for_encoded_values.packed_values),
+                values.size() + IntegerEncoder::cBlockSize,
+                decoded_values
+        ));
+
+        auto rle_encoded_values = IntegerEncoder::encode_run_length(values);
+        REQUIRE_FALSE(IntegerEncoder::decode_run_length(
+                create_span(rle_encoded_values.run_values),
+                create_span(rle_encoded_values.run_lengths),
+                values.size() - 1,
+                decoded_values
+        ));
+        REQUIRE_FALSE(IntegerEncoder::decode_run_length(
+                create_span(rle_encoded_values.run_values),
+                create_span(rle_encoded_values.run_lengths),
+                values.size() + 1,
+                decoded_values
+        ));
+    }
+
+    SECTION("Columns from archives which don't store integer encodings are read as raw") {
+        // The first byte of each value would be misread as an encoding
+        std::vector<int64_t> const values{1, 2, 3};
+        // Archives older than 0.4.0 store integer columns as raw values without an encoding
+        std::string column(sizeof(int64_t) * values.size(), '\0');
+        std::memcpy(column.data(), values.data(), column.size());
+        std::string const encoded_column{static_cast<char>(IntegerEncoding::Raw) + column};
+
+        for (auto const& [buffer, is_encoding_stored] :
+             {std::pair{column, false}, std::pair{encoded_column, true}})
+        {
+            auto column_buffer{buffer};
+            BufferViewReader reader{column_buffer.data(), column_buffer.size()};
+            Int64ColumnReader column_reader{0, is_encoding_stored};
+            column_reader.load(reader, values.size());
+            for (size_t i{0}; i < values.size(); ++i) {
+                REQUIRE(values[i] == std::get<int64_t>(column_reader.extract_value(i)));
+            }
+        }
+    }
+}
@@ -0,0 +1,152 @@
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "../src/clp_s/ParsedMessage.hpp"
+
+using clp_s::ParsedMessage;
+
+namespace {
+/**
+ * @param message
+ * @return The node IDs of the message's content, in order.
+ */
+auto get_node_ids(ParsedMessage& message) -> std::vector<int32_t>;
+
+/**
+ * Adds strings of the given sizes to the message, both as ordered values (with ascending node IDs)
+ * and as unordered values, and checks that each value still matches its original once all of them
+ * have been added.
+ * @param message
+ * @param sizes
+ * @param fill_offset Offset used to vary the contents of the strings between calls.
+ */
+void
+add_and_check_strings(ParsedMessage& message, std::vector<size_t> const& sizes, char fill_offset);
+
+auto get_node_ids(ParsedMessage& message) -> std::vector<int32_t> {
+    std::vector<int32_t> node_ids;
+    for (auto const& [node_id, value] : message.get_content()) {
+        node_ids.push_back(node_id);
+    }
+    return node_ids;
+}
+
+void
+add_and_check_strings(ParsedMessage& message, std::vector<size_t> const& sizes, char fill_offset) {
+    std::vector<std::string> originals;
+    std::string buf;
+    for (size_t i{0}; i < sizes.size(); ++i) {
+        originals.emplace_back(sizes[i], static_cast<char>('a' + (fill_offset + i) % 26));
+        // Add the value from a buffer that's overwritten afterwards to ensure it was copied
+        buf = originals.back();
+        message.add_value(static_cast<int32_t>(i), std::string_view{buf});
+        message.add_unordered_value(std::string_view{buf});
+        buf.assign(buf.size(), '#');
+    }
+
+    auto const& content{message.get_content()};
+    auto const& unordered_content{message.get_unordered_content()};
+    REQUIRE(originals.size() == content.size());
+    REQUIRE(originals.size() == unordered_content.size());
+    for (size_t i{0}; i < originals.size(); ++i) {
+        REQUIRE(static_cast<int32_t>(i) == content[i].first);
+        REQUIRE(originals[i] == std::get<std::string_view>(content[i].second));
+        REQUIRE(originals[i] == std::get<std::string_view>(unordered_content[i]));
+    }
+}
+}  // namespace
+
+TEST_CASE("clp-s-parsed-message", "[clp-s][ParsedMessage]") {
+    ParsedMessage message;
+
+    SECTION("Content is ordered by node ID") {
+        message.add_value(3, int64_t{30});
+        message.add_value(1, 1.5);
+        message.add_value(2, true);
+        message.add_value(0, uint64_t{7}, clp_s::epochtime_t{1000});
+
+        REQUIRE(std::vector<int32_t>{0, 1, 2, 3} == get_node_ids(message));
+        auto const& content{message.get_content()};
+        REQUIRE(std::make_pair(uint64_t{7}, clp_s::epochtime_t{1000})
+                == std::get<std::pair<uint64_t, clp_s::epochtime_t>>(content[0].second));
+        REQUIRE(1.5 == std::get<double>(content[1].second));
+        REQUIRE(std::get<bool>(content[2].second));
+        REQUIRE(30 == std::get<int64_t>(content[3].second));
+
+        // Getting the content again doesn't change it
+        REQUIRE(std::vector<int32_t>{0, 1, 2, 3} == get_node_ids(message));
+    }
+
+    SECTION("Only the first value of a duplicate node ID is kept") {
+        message.add_value(2, std::string_view{"first"});
+        message.add_value(1, int64_t{1});
+        message.add_value(2, std::string_view{"second"});
+        message.add_value(3, int64_t{3});
+        message.add_value(3, int64_t{4});
+
+        REQUIRE(std::vector<int32_t>{1, 2, 3} == get_node_ids(message));
+        auto const& content{message.get_content()};
+        REQUIRE(1 == std::get<int64_t>(content[0].second));
+        REQUIRE("first" == std::get<std::string_view>(content[1].second));
+        REQUIRE(3 == std::get<int64_t>(content[2].second));
+    }
+
+    SECTION("Duplicates are removed even when node IDs are otherwise ascending") {
+        message.add_value(0, int64_t{0});
+        message.add_value(1, int64_t{1});
+        message.add_value(1, int64_t{2});
+
+        REQUIRE(std::vector<int32_t>{0, 1} == get_node_ids(message));
+        REQUIRE(1 == std::get<int64_t>(message.get_content()[1].second));
+    }
+
+    SECTION("Unowned values aren't copied") {
+        std::string const value{"unowned"};
+        message.add_unowned_value(0, value);
+        message.add_unordered_unowned_value(value);
+        auto const& ordered_value{std::get<std::string_view>(message.get_content()[0].second)};
+        auto const& unordered_value{std::get<std::string_view>(message.get_unordered_content()[0])};
+        REQUIRE(value.data() == ordered_value.data());
+        REQUIRE(value.data() == unordered_value.data());
+    }
+
+    SECTION("Copied strings stay valid across arena blocks and after clearing") {
+        constexpr size_t cKiB{1024};
+        // Strings which fill and overflow several 64 KiB arena blocks, including strings larger
+        // than a block and empty strings.
+        std::vector<size_t> const sizes{
+                40 * cKiB,
+                40 * cKiB,
+                0,
+                1,
+                64 * cKiB,
+                100 * cKiB,
+                63 * cKiB,
+                2 * cKiB,
+                64 * cKiB - 1,
+                300 * cKiB
+        };
+        add_and_check_strings(message, sizes, 0);
+
+        // Reuse the arena with the same strings in a different order, with different contents
+        message.clear();
+        REQUIRE(message.get_content().empty());
+        REQUIRE(message.get_unordered_content().empty());
+        std::vector<size_t> const reversed_sizes(sizes.rbegin(), sizes.rend());
+        add_and_check_strings(message, reversed_sizes, 1);
+
+        // Reuse the arena with more and larger strings than it has room for
+        message.clear();
+        std::vector<size_t> larger_sizes{sizes};
+        larger_sizes.insert(larger_sizes.end(), sizes.begin(), sizes.end());
+        larger_sizes.push_back(1024 * cKiB);
+        add_and_check_strings(message, larger_sizes, 2);
+    }
+}
@@ -0,0 +1,294 @@
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "../src/clp/ErrorCode.hpp"
+#include "../src/clp/ReaderInterface.hpp"
+#include "../src/clp/StringReader.hpp"
+#include "../src/clp_s/PrefetchingRangeReader.hpp"
+#include "LogSuppressor.hpp"
+#include "TestOutputCleaner.hpp"
+
+namespace {
+constexpr std::string_view cTestCacheDirectory{"test-clp-s-range-reader-cache"};
+constexpr size_t cResourceSize{4 * clp_s::PrefetchingRangeReader::cMinOnDemandFetchSize};
+
+/**
+ * @return A resource whose bytes depend on their offset.
+ */
+auto create_resource() -> std::string {
+    std::string resource(cResourceSize, '\0');
+    for (size_t i = 0; i < resource.size(); ++i) {
+        resource[i] = static_cast<char>(i % 251);
+    }
+    return resource;
+}
+
+/**
+ * Stands in for a server handling range requests by serving the resource from memory.
+ * @param resource
+ * @return A factory for readers of the resource.
+ */
+auto create_reader_factory(std::string const& resource)
+        -> clp_s::PrefetchingRangeReader::RangeReaderFactory {
+    return [&resource](size_t offset) -> std::shared_ptr<clp::ReaderInterface> {
+        auto reader = std::make_shared<clp::StringReader>();
+        reader->open(resource);
+        if (clp::ErrorCode_Success != reader->try_seek_from_begin(offset)) {
+            return nullptr;
+        }
+        return reader;
+    };
+}
+
+/**
+ * Reads the given range from the reader.
+ * @param reader
+ * @param begin
+ * @param end
+ * @return The bytes read
+ */
+auto read_range(clp_s::PrefetchingRangeReader& reader, size_t begin, size_t end) -> std::string {
+    std::string data(end - begin, '\0');
+    REQUIRE(clp::ErrorCode_Success == reader.try_seek_from_begin(begin));
+    REQUIRE(clp::ErrorCode_Success == reader.try_read_exact_length(data.data(), data.size()));
+    return data;
+}
+}  // namespace
+
+TEST_CASE("clp-s-coalesce-byte-ranges", "[clp-s][PrefetchingRangeReader]") {
+    constexpr size_t cMaxGapSize{10};
+
+    SECTION("Nearby ranges are coalesced") {
+        constexpr size_t cMaxRangeSize{1000};
+        auto const coalesced_ranges = clp_s::coalesce_byte_ranges(
+                {{100, 150}, {0, 10}, {15, 20}, {20, 20}, {140, 200}, {40, 50}},
+                cMaxGapSize,
+                cMaxRangeSize
+        );
+        REQUIRE(3 == coalesced_ranges.size());
+        REQUIRE(0 == coalesced_ranges[0].begin);
+        REQUIRE(20 == coalesced_ranges[0].end);
+        REQUIRE(40 == coalesced_ranges[1].begin);
+        REQUIRE(50 == coalesced_ranges[1].end);
+        REQUIRE(100 == coalesced_ranges[2].begin);
+        REQUIRE(200 == coalesced_ranges[2].end);
+    }
+
+    SECTION("Coalesced ranges are bounded in size") {
+        constexpr size_t cMaxRangeSize{60};
+        auto const coalesced_ranges = clp_s::coalesce_byte_ranges(
+                {{100, 150}, {0, 10}, {15, 20}, {210, 400}, {140, 200}},
+                cMaxGapSize,
+                cMaxRangeSize
+        );
+        std::vector<clp_s::ByteRange> const expected_ranges{
+                {0, 20},
+                {100, 150},
+                {150, 200},
+                {210, 270},
+                {270, 330},
+                {330, 390},
+                {390, 400}
+        };
+        REQUIRE(expected_ranges.size() == coalesced_ranges.size());
+        for (size_t i{0}; i < expected_ranges.size(); ++i) {
+            REQUIRE(expected_ranges[i].begin == coalesced_ranges[i].begin);
+            REQUIRE(expected_ranges[i].end == coalesced_ranges[i].end);
+        }
+    }
+}
+
+TEST_CASE("clp-s-prefetching-range-reader", "[clp-s][PrefetchingRangeReader]") {
+    auto const resource = create_resource();
+    auto const expected_range = [&](size_t begin, size_t end) {
+        return resource.substr(begin, end - begin);
+    };
+
+    SECTION("Prefetched ranges are fetched once and can be read in any order") {
+        clp_s::PrefetchingRangeReader reader{
+                create_reader_factory(resource),
+                resource.size(),
+                {},
+                "resource"
+        };
+        reader.prefetch({{3000, 4000}, {0, 1000}, {500, 2000}});
+        // Ranges which were already fetched aren't fetched again
+        reader.prefetch({{0, 4000}});
+        REQUIRE(expected_range(3500, 3600) == read_range(reader, 3500, 3600));
+        REQUIRE(expected_range(0, 4000) == read_range(reader, 0, 4000));
+        REQUIRE(1 == reader.get_num_requests());
+    }
+
+    SECTION("Prefetched ranges are bounded by the read-ahead window") {
+        // Ranges separated by more than the maximum gap, so that they aren't coalesced
+        constexpr size_t cRangeSize{1000};
+        constexpr size_t cRangeSpacing{clp_s::PrefetchingRangeReader::cMaxGapSize + 2 * cRangeSize};
+        constexpr size_t cMaxReadAheadSize{cRangeSize + cRangeSize / 2};
+        clp_s::PrefetchingRangeReader reader{
+                create_reader_factory(resource),
+                resource.size(),
+                {},
+                "resource",
+                clp_s::PrefetchingRangeReader::cDefaultMaxCacheSize,
+                cMaxReadAheadSize
+        };
+        // Ranges are fetched in the given order rather than in ascending order
+        std::vector<size_t> const range_begins{cRangeSpacing, 0, 2 * cRangeSpacing};
+        std::vector<clp_s::ByteRange> ranges;
+        for (auto const begin : range_begins) {
+            ranges.push_back({begin, begin + cRangeSize});
+        }
+        reader.prefetch(ranges);
+        REQUIRE(cRangeSize == reader.get_num_buffered_bytes());
+        for (auto const begin : range_begins) {
+            REQUIRE(expected_range(begin, begin + cRangeSize)
+                    == read_range(reader, begin, begin + cRangeSize));
+        }
+        REQUIRE(0 == reader.get_num_buffered_bytes());
+        REQUIRE(range_begins.size() == reader.get_num_requests());
+    }
+
+    SECTION("Reads outside of prefetched ranges are fetched on demand") {
+        clp_s::PrefetchingRangeReader reader{
+                create_reader_factory(resource),
+                resource.size(),
+                {},
+                "resource"
+        };
+        constexpr size_t cFetchSize{clp_s::PrefetchingRangeReader::cMinOnDemandFetchSize};
+        REQUIRE(expected_range(cFetchSize, cFetchSize + 10)
+                == read_range(reader, cFetchSize, cFetchSize + 10));
+        REQUIRE(expected_range(cFetchSize + 10, 2 * cFetchSize - 10)
+                == read_range(reader, cFetchSize + 10, 2 * cFetchSize - 10));
+        REQUIRE(1 == reader.get_num_requests());
+
+        // Reads spanning several ranges fetch only the missing bytes
+        REQUIRE(expected_range(cFetchSize - 10, 2 * cFetchSize + 10)
+                == read_range(reader, cFetchSize - 10, 2 * cFetchSize + 10));
+        REQUIRE(3 == reader.get_num_requests());
+    }
+
+    SECTION("Reads and seeks are bounded by the size of the resource") {
+        clp_s::PrefetchingRangeReader reader{
+                create_reader_factory(resource),
+                resource.size(),
+                {},
+                "resource"
+        };
+        std::string buf(100, '\0');
+        size_t num_bytes_read{};
+        REQUIRE(clp::ErrorCode_Success == reader.try_seek_from_begin(resource.size() - 10));
+        REQUIRE(clp::ErrorCode_Success == reader.try_read(buf.data(), buf.size(), num_bytes_read));
+        REQUIRE(10 == num_bytes_read);
+        REQUIRE(clp::ErrorCode_EndOfFile
+                == reader.try_read(buf.data(), buf.size(), num_bytes_read));
+        REQUIRE(clp::ErrorCode_OutOfBounds == reader.try_seek_from_begin(resource.size() + 1));
+    }
+
+    SECTION("Failed fetches are reported as read failures") {
+        LogSuppressor const suppressor;
+        clp_s::PrefetchingRangeReader reader{
+                [](size_t) -> std::shared_ptr<clp::ReaderInterface> { return nullptr; },
+                resource.size(),
+                {},
+                "resource"
+        };
+        std::string buf(100, '\0');
+        size_t num_bytes_read{};
+        REQUIRE(clp::ErrorCode_Failure == reader.try_read(buf.data(), buf.size(), num_bytes_read));
+    }
+
+    SECTION("Failed fetches are retried") {
+        LogSuppressor const suppressor;
+        size_t num_reader_creations{0};
+        auto create_reader = create_reader_factory(resource);
+        clp_s::PrefetchingRangeReader reader{
+                [&](size_t offset) -> std::shared_ptr<clp::ReaderInterface> {
+                    if (0 == num_reader_creations++) {
+                        return nullptr;
+                    }
+                    return create_reader(offset);
+                },
+                resource.size(),
+                {},
+                "resource"
+        };
+        reader.prefetch({{0, 1000}});
+        std::string buf(100, '\0');
+        size_t num_bytes_read{};
+        REQUIRE(clp::ErrorCode_Failure == reader.try_read(buf.data(), buf.size(), num_bytes_read));
+        REQUIRE(expected_range(0, 1000) == read_range(reader, 0, 1000));
+    }
+
+    SECTION("Cached ranges aren't fetched again") {
+        TestOutputCleaner const test_cleanup{{std::string{cTestCacheDirectory}}};
+        std::vector<clp_s::ByteRange> const ranges{{100, 1000}, {5000, 9000}};
+        {
+            clp_s::PrefetchingRangeReader reader{
+                    create_reader_factory(resource),
+                    resource.size(),
+                    std::string{cTestCacheDirectory},
+                    "resource"
+            };
+            reader.prefetch(ranges);
+            REQUIRE(expected_range(100, 9000) == read_range(reader, 100, 9000));
+            REQUIRE(1 == reader.get_num_requests());
+        }
+
+        clp_s::PrefetchingRangeReader reader{
+                create_reader_factory(resource),
+                resource.size(),
+                std::string{cTestCacheDirectory},
+                "resource"
+        };
+        reader.prefetch(ranges);
+        REQUIRE(expected_range(100, 9000) == read_range(reader, 100, 9000));
+        REQUIRE(0 == reader.get_num_requests());
+    }
+
+    SECTION("The least recently used cached ranges are evicted") {
+        TestOutputCleaner const test_cleanup{{std::string{cTestCacheDirectory}}};
+        constexpr size_t cMaxCacheSize{2000};
+        // Files in the cache directory which aren't cached ranges are never evicted
+        auto const unrelated_file_path = std::filesystem::path{cTestCacheDirectory} / "unrelated";
+        std::filesystem::create_directories(cTestCacheDirectory);
+        {
+            std::ofstream unrelated_file{unrelated_file_path};
+            unrelated_file << std::string(cMaxCacheSize, 'x');
+        }
+
+        clp_s::PrefetchingRangeReader reader{
+                create_reader_factory(resource),
+                resource.size(),
+                std::string{cTestCacheDirectory},
+                "resource",
+                cMaxCacheSize
+        };
+        reader.prefetch({{0, 1000}});
+        REQUIRE(expected_range(0, 1000) == read_range(reader, 0, 1000));
+        reader.prefetch({{5000, 6500}});
+        REQUIRE(expected_range(5000, 6500) == read_range(reader, 5000, 6500));
+        // Ranges larger than the cache aren't cached
+        reader.prefetch({{8000, 8000 + cMaxCacheSize + 1}});
+        REQUIRE(expected_range(8000, 8000 + cMaxCacheSize + 1)
+                == read_range(reader, 8000, 8000 + cMaxCacheSize + 1));
+
+        auto const num_cached_ranges = std::distance(
+                std::filesystem::directory_iterator{
+                        std::filesystem::path{cTestCacheDirectory}
+                        / clp_s::PrefetchingRangeReader::cCacheSubdirectoryName
+                },
+                std::filesystem::directory_iterator{}
+        );
+        REQUIRE(1 == num_cached_ranges);
+        REQUIRE(std::filesystem::exists(unrelated_file_path));
+    }
+}
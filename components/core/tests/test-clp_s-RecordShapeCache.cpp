@@ -0,0 +1,85 @@
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <catch2/catch.hpp>
+
+#include "../src/clp_s/RecordShapeCache.hpp"
+#include "../src/clp_s/Schema.hpp"
+#include "../src/clp_s/SchemaTree.hpp"
+
+using clp_s::NodeType;
+using clp_s::RecordShapeCache;
+
+TEST_CASE("clp-s-record-shape-cache", "[clp-s][RecordShapeCache]") {
+    constexpr int32_t cRootNodeId{-1};
+    RecordShapeCache cache;
+    auto const empty_shape = RecordShapeCache::cEmptyShapeStateId;
+
+    SECTION("Fields are found only after the same preceding fields") {
+        REQUIRE_FALSE(cache.find_next_field(empty_shape, cRootNodeId, NodeType::Integer, "a")
+                              .has_value());
+        auto const after_a
+                = cache.add_next_field(empty_shape, cRootNodeId, NodeType::Integer, "a", 0);
+        REQUIRE(after_a.has_value());
+        auto const after_b = cache.add_next_field(*after_a, cRootNodeId, NodeType::Object, "b", 1);
+        REQUIRE(after_b.has_value());
+        auto const after_b_c = cache.add_next_field(*after_b, 1, NodeType::VarString, "c", 2);
+        REQUIRE(after_b_c.has_value());
+
+        auto const found_a
+                = cache.find_next_field(empty_shape, cRootNodeId, NodeType::Integer, "a");
+        REQUIRE(found_a.has_value());
+        REQUIRE(0 == found_a->first);
+        REQUIRE(*after_a == found_a->second);
+
+        // The same key with a different type, parent, or preceding field is a different field
+        REQUIRE_FALSE(cache.find_next_field(empty_shape, cRootNodeId, NodeType::Float, "a")
+                              .has_value());
+        REQUIRE_FALSE(cache.find_next_field(*after_b, cRootNodeId, NodeType::VarString, "c")
+                              .has_value());
+        REQUIRE_FALSE(cache.find_next_field(*after_a, 1, NodeType::VarString, "c").has_value());
+
+        auto const found_c = cache.find_next_field(*after_b, 1, NodeType::VarString, "c");
+        REQUIRE(found_c.has_value());
+        REQUIRE(2 == found_c->first);
+        REQUIRE(*after_b_c == found_c->second);
+    }
+
+    SECTION("Schemas are cached for the states which end records") {
+        auto const after_a
+                = cache.add_next_field(empty_shape, cRootNodeId, NodeType::Integer, "a", 0);
+        REQUIRE(after_a.has_value());
+        REQUIRE_FALSE(cache.get_schema(*after_a).has_value());
+
+        clp_s::Schema schema;
+        schema.insert_ordered(0);
+        cache.set_schema(*after_a, 3, schema);
+        auto const& cached_schema = cache.get_schema(*after_a);
+        REQUIRE(cached_schema.has_value());
+        REQUIRE(3 == cached_schema->first);
+        REQUIRE(schema == cached_schema->second);
+        REQUIRE_FALSE(cache.get_schema(empty_shape).has_value());
+
+        cache.clear();
+        REQUIRE_FALSE(cache.find_next_field(empty_shape, cRootNodeId, NodeType::Integer, "a")
+                              .has_value());
+    }
+
+    SECTION("Transitions aren't added to states with too many transitions") {
+        for (size_t i{0}; i < RecordShapeCache::cMaxNumTransitionsPerState; ++i) {
+            REQUIRE(cache.add_next_field(
+                                 empty_shape,
+                                 cRootNodeId,
+                                 NodeType::Integer,
+                                 std::to_string(i),
+                                 static_cast<int32_t>(i)
+                         )
+                            .has_value());
+        }
+        REQUIRE_FALSE(
+                cache.add_next_field(empty_shape, cRootNodeId, NodeType::Integer, "overflow", 0)
+                        .has_value()
+        );
+    }
+}
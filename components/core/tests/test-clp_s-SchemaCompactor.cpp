@@ -0,0 +1,50 @@
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "../src/clp_s/SchemaCompactor.hpp"
+
+using clp_s::SchemaCompactor;
+
+TEST_CASE("clp-s-schema-compactor", "[clp-s][SchemaCompactor]") {
+    SECTION("Similar schemas share a group") {
+        SchemaCompactor compactor{0.5};
+        std::vector<int32_t> const a_b_c{1, 2, 3};
+        std::vector<int32_t> const a_b{1, 2};
+        std::vector<int32_t> const b_c_d{2, 3, 4};
+        REQUIRE(0 == compactor.add_schema(a_b_c));
+        // {a, b} shares two of three columns with {a, b, c}
+        REQUIRE(0 == compactor.add_schema(a_b));
+        // {b, c, d} shares two of four columns with {a, b, c}
+        REQUIRE(0 == compactor.add_schema(b_c_d));
+        REQUIRE(1 == compactor.get_num_groups());
+        REQUIRE(std::vector<int32_t>{1, 2, 3, 4} == compactor.get_group_columns(0));
+    }
+
+    SECTION("Dissimilar schemas start new groups") {
+        SchemaCompactor compactor{0.5};
+        std::vector<int32_t> const a_b_c{1, 2, 3};
+        std::vector<int32_t> const c_d_e{3, 4, 5};
+        std::vector<int32_t> const f{6};
+        REQUIRE(0 == compactor.add_schema(a_b_c));
+        // {c, d, e} shares one of five columns with {a, b, c}
+        REQUIRE(1 == compactor.add_schema(c_d_e));
+        REQUIRE(2 == compactor.add_schema(f));
+        REQUIRE(3 == compactor.get_num_groups());
+        REQUIRE(std::vector<int32_t>{3, 4, 5} == compactor.get_group_columns(1));
+    }
+
+    SECTION("Schemas join the most similar group") {
+        SchemaCompactor compactor{0.25};
+        std::vector<int32_t> const a_b_c_d{1, 2, 3, 4};
+        std::vector<int32_t> const e_f{5, 6};
+        std::vector<int32_t> const d_e_f{4, 5, 6};
+        REQUIRE(0 == compactor.add_schema(a_b_c_d));
+        REQUIRE(1 == compactor.add_schema(e_f));
+        // {d, e, f} shares one of six columns with {a, b, c, d}, and two of three with {e, f}
+        REQUIRE(1 == compactor.add_schema(d_e_f));
+        REQUIRE(std::vector<int32_t>{5, 6, 4} == compactor.get_group_columns(1));
+    }
+}
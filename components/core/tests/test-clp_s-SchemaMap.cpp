@@ -0,0 +1,146 @@
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "../src/clp_s/Schema.hpp"
+#include "../src/clp_s/SchemaMap.hpp"
+#include "../src/clp_s/SchemaTree.hpp"
+
+using clp_s::NodeType;
+using clp_s::Schema;
+using clp_s::SchemaMap;
+
+namespace {
+/**
+ * Builds synthetic schemas which share most of their nodes, like the schemas of records from the
+ * same source.
+ * @param num_schemas
+ * @param num_nodes_per_schema
+ * @return The schemas
+ */
+auto build_synthetic_schemas(size_t num_schemas, size_t num_nodes_per_schema)
+        -> std::vector<Schema>;
+
+auto build_synthetic_schemas(size_t num_schemas, size_t num_nodes_per_schema)
+        -> std::vector<Schema> {
+    std::vector<Schema> schemas(num_schemas);
+    for (size_t i{0}; i < num_schemas; ++i) {
+        for (size_t node_id{0}; node_id < num_nodes_per_schema; ++node_id) {
+            schemas[i].insert_ordered(static_cast<int32_t>(node_id));
+        }
+        // Each schema differs from the others in its last few nodes
+        for (auto remaining{i}; remaining > 0; remaining /= 8) {
+            schemas[i].insert_ordered(static_cast<int32_t>(num_nodes_per_schema + remaining));
+        }
+    }
+    return schemas;
+}
+}  // namespace
+
+TEST_CASE("clp-s-schema-map", "[clp-s][SchemaMap]") {
+    SECTION("Equal schemas have equal hashes regardless of their ordered insertion order") {
+        Schema forward;
+        Schema backward;
+        for (int32_t node_id{0}; node_id < 5; ++node_id) {
+            forward.insert_ordered(node_id);
+            backward.insert_ordered(4 - node_id);
+        }
+        forward.insert_unordered(7);
+        backward.insert_unordered(7);
+        REQUIRE(forward == backward);
+        REQUIRE(forward.get_hash() == backward.get_hash());
+    }
+
+    SECTION("Unordered regions are hashed by position") {
+        Schema a_b;
+        a_b.insert_unordered(1);
+        a_b.insert_unordered(2);
+        Schema b_a;
+        b_a.insert_unordered(2);
+        b_a.insert_unordered(1);
+        REQUIRE(a_b.get_hash() != b_a.get_hash());
+
+        // The same node in the ordered and unordered regions hashes differently
+        Schema ordered;
+        ordered.insert_ordered(1);
+        Schema unordered;
+        unordered.insert_unordered(1);
+        REQUIRE(ordered.get_hash() != unordered.get_hash());
+    }
+
+    SECTION("Hashes track unordered objects and nested schemas") {
+        Schema nested;
+        auto const start = nested.start_unordered_object(NodeType::StructuredArray);
+        nested.insert_unordered(3);
+        nested.insert_unordered(4);
+        nested.end_unordered_object(start);
+
+        Schema built_with_nested;
+        built_with_nested.insert_ordered(1);
+        built_with_nested.insert_unordered(nested);
+        built_with_nested.insert_ordered(0);
+
+        Schema built_directly;
+        built_directly.insert_ordered(0);
+        built_directly.insert_ordered(1);
+        auto const direct_start = built_directly.start_unordered_object(NodeType::StructuredArray);
+        built_directly.insert_unordered(3);
+        built_directly.insert_unordered(4);
+        built_directly.end_unordered_object(direct_start);
+
+        REQUIRE(built_with_nested == built_directly);
+        REQUIRE(built_with_nested.get_hash() == built_directly.get_hash());
+
+        built_directly.clear();
+        REQUIRE(Schema{}.get_hash() == built_directly.get_hash());
+    }
+
+    SECTION("Schemas are interned") {
+        auto const schemas = build_synthetic_schemas(100, 10);
+        SchemaMap schema_map;
+        for (size_t i{0}; i < schemas.size(); ++i) {
+            REQUIRE(static_cast<int32_t>(i) == schema_map.add_schema(schemas[i]));
+        }
+        for (size_t i{0}; i < schemas.size(); ++i) {
+            REQUIRE(static_cast<int32_t>(i) == schema_map.add_schema(schemas[i]));
+        }
+    }
+}
+
+TEST_CASE("clp-s-schema-map-benchmark", "[.][benchmark][clp-s][SchemaMap]") {
+    constexpr size_t cNumNodesPerSchema{40};
+    constexpr size_t cNumLookups{100'000};
+    auto const num_schemas = GENERATE(as<size_t>{}, 10, 1000, 10'000);
+    auto const schemas = build_synthetic_schemas(num_schemas, cNumNodesPerSchema);
+
+    // Lookups cycle through every schema, like records from many sources with different shapes
+    BENCHMARK("std::map (" + std::to_string(num_schemas) + " schemas)") {
+        std::map<Schema, int32_t> schema_map;
+        int32_t next_schema_id{0};
+        int64_t schema_id_sum{0};
+        for (size_t i{0}; i < cNumLookups; ++i) {
+            auto const& schema = schemas[i % num_schemas];
+            auto const it = schema_map.find(schema);
+            if (schema_map.end() != it) {
+                schema_id_sum += it->second;
+                continue;
+            }
+            schema_map.emplace(schema, next_schema_id);
+            schema_id_sum += next_schema_id++;
+        }
+        return schema_id_sum;
+    };
+
+    BENCHMARK("SchemaMap (" + std::to_string(num_schemas) + " schemas)") {
+        SchemaMap schema_map;
+        int64_t schema_id_sum{0};
+        for (size_t i{0}; i < cNumLookups; ++i) {
+            schema_id_sum += schema_map.add_schema(schemas[i % num_schemas]);
+        }
+        return schema_id_sum;
+    };
+}
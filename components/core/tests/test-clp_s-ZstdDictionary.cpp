@@ -0,0 +1,146 @@
+#include <cstddef>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "../src/clp_s/ErrorCode.hpp"
+#include "../src/clp_s/FileWriter.hpp"
+#include "../src/clp_s/ZstdCompressor.hpp"
+#include "../src/clp_s/ZstdDecompressor.hpp"
+#include "../src/clp_s/ZstdDictionary.hpp"
+#include "TestOutputCleaner.hpp"
+
+using clp_s::ErrorCodeSuccess;
+using clp_s::FileWriter;
+using clp_s::ZstdCompressionDictionary;
+using clp_s::ZstdCompressor;
+using clp_s::ZstdDecompressionDictionary;
+using clp_s::ZstdDecompressor;
+using clp_s::ZstdDictionaryTrainer;
+
+namespace {
+constexpr char cTestCompressedFile[] = "test-clp_s-ZstdDictionary.zst";
+constexpr size_t cDictionarySize{16 * 1024};
+
+/**
+ * @param num_records
+ * @return Records which share most of their structure, like the small tables of an archive.
+ */
+auto create_records(size_t num_records) -> std::vector<std::string> {
+    std::vector<std::string> records;
+    for (size_t i{0}; i < num_records; ++i) {
+        records.push_back(
+                R"({"timestamp":"2024-01-01T00:00:)" + std::to_string(i % 60)
+                + R"(Z","level":"INFO","service":"checkout","message":"Processed order )"
+                + std::to_string(i * 7919) + R"( for customer )" + std::to_string(i % 97) + "\"}"
+        );
+    }
+    return records;
+}
+
+/**
+ * Compresses each record into its own frame.
+ * @param records
+ * @param dictionary
+ * @return The compressed size of each record.
+ */
+auto compress_records(
+        std::vector<std::string> const& records,
+        ZstdCompressionDictionary const* dictionary
+) -> std::vector<size_t> {
+    FileWriter file_writer;
+    file_writer.open(cTestCompressedFile, FileWriter::OpenMode::CreateForWriting);
+    ZstdCompressor compressor;
+    std::vector<size_t> compressed_sizes;
+    for (auto const& record : records) {
+        auto const begin_pos = file_writer.get_pos();
+        compressor.open(file_writer, clp_s::cDefaultCompressionLevel, dictionary);
+        compressor.write_string(record);
+        compressor.close();
+        compressed_sizes.push_back(file_writer.get_pos() - begin_pos);
+    }
+    file_writer.close();
+    return compressed_sizes;
+}
+
+/**
+ * Decompresses each record from its own frame, and checks that it matches the original record.
+ * @param records
+ * @param compressed_sizes
+ * @param dictionary
+ * @return Whether every record was decompressed successfully.
+ */
+auto decompress_records(
+        std::vector<std::string> const& records,
+        std::vector<size_t> const& compressed_sizes,
+        ZstdDecompressionDictionary const* dictionary
+) -> bool {
+    std::ifstream file{cTestCompressedFile, std::ios::binary};
+    std::string const compressed_data{std::istreambuf_iterator<char>{file}, {}};
+    ZstdDecompressor decompressor;
+    decompressor.set_dictionary(dictionary);
+    size_t offset{0};
+    std::string record;
+    for (size_t i{0}; i < records.size(); ++i) {
+        decompressor.open(compressed_data.data() + offset, compressed_sizes[i]);
+        auto const rc = decompressor.try_read_string(records[i].size(), record);
+        decompressor.close();
+        if (ErrorCodeSuccess != rc || records[i] != record) {
+            return false;
+        }
+        offset += compressed_sizes[i];
+    }
+    return true;
+}
+
+auto get_total_size(std::vector<size_t> const& sizes) -> size_t {
+    size_t total_size{0};
+    for (auto const size : sizes) {
+        total_size += size;
+    }
+    return total_size;
+}
+}  // namespace
+
+TEST_CASE("clp-s-zstd-dictionary", "[clp-s][ZstdDictionary]") {
+    TestOutputCleaner const test_cleanup{{cTestCompressedFile}};
+    auto const records = create_records(2000);
+
+    size_t total_data_size{0};
+    for (auto const& record : records) {
+        total_data_size += record.size();
+    }
+    ZstdDictionaryTrainer trainer{cDictionarySize, total_data_size};
+    for (auto const& record : records) {
+        trainer.add_data(record.data(), record.size());
+    }
+    auto const dictionary = trainer.train();
+    REQUIRE_FALSE(dictionary.empty());
+    REQUIRE(dictionary.size() <= cDictionarySize);
+
+    SECTION("Frames compressed with a dictionary are smaller and round-trip") {
+        auto const sizes_without_dictionary = compress_records(records, nullptr);
+        REQUIRE(decompress_records(records, sizes_without_dictionary, nullptr));
+
+        ZstdCompressionDictionary const compression_dictionary{
+                dictionary,
+                clp_s::cDefaultCompressionLevel
+        };
+        ZstdDecompressionDictionary const decompression_dictionary{dictionary};
+        auto const sizes_with_dictionary = compress_records(records, &compression_dictionary);
+        REQUIRE(decompress_records(records, sizes_with_dictionary, &decompression_dictionary));
+        REQUIRE(get_total_size(sizes_with_dictionary) < get_total_size(sizes_without_dictionary));
+
+        // Frames compressed with a dictionary can't be decompressed without it
+        REQUIRE_FALSE(decompress_records(records, sizes_with_dictionary, nullptr));
+    }
+
+    SECTION("No dictionary is trained without enough data") {
+        ZstdDictionaryTrainer small_trainer{cDictionarySize, records.front().size()};
+        small_trainer.add_data(records.front().data(), records.front().size());
+        REQUIRE(small_trainer.train().empty());
+    }
+}
@@ -1,10 +1,14 @@
 #include <sys/wait.h>
 
+#include <cstddef>
+#include <cstdint>
 #include <cstdlib>
 #include <filesystem>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <utility>
+#include <vector>
 
 #include <catch2/catch.hpp>
 #include <fmt/format.h>
@@ -25,7 +29,23 @@ namespace {
 auto get_test_input_path_relative_to_tests_dir() -> std::filesystem::path;
 auto get_test_input_local_path() -> std::string;
 auto extract() -> std::filesystem::path;
-void compare(std::filesystem::path const& extracted_json_path);
+auto extract_in_order(
+        size_t memory_budget,
+        std::optional<std::pair<int64_t, int64_t>> log_event_idx_range = std::nullopt
+) -> std::filesystem::path;
+void compare(std::filesystem::path const& extracted_json_path, bool should_sort = true);
+/**
+ * Compares the extracted records against the input records in the given range of log event
+ * indices, [begin, end), which correspond to lines in the input file.
+ * @param extracted_json_path
+ * @param begin_log_event_idx
+ * @param end_log_event_idx
+ */
+void compare_range(
+        std::filesystem::path const& extracted_json_path,
+        int64_t begin_log_event_idx,
+        int64_t end_log_event_idx
+);
 
 auto get_test_input_path_relative_to_tests_dir() -> std::filesystem::path {
     return std::filesystem::path{cTestEndToEndInputFileDirectory} / cTestEndToEndInputFile;
@@ -63,14 +83,48 @@ auto extract() -> std::filesystem::path {
     return extracted_json_path;
 }
 
+auto extract_in_order(
+        size_t memory_budget,
+        std::optional<std::pair<int64_t, int64_t>> log_event_idx_range
+) -> std::filesystem::path {
+    std::filesystem::create_directory(cTestEndToEndOutputDirectory);
+    REQUIRE(std::filesystem::is_directory(cTestEndToEndOutputDirectory));
+
+    clp_s::JsonConstructorOption constructor_option{};
+    constructor_option.output_dir = cTestEndToEndOutputDirectory;
+    constructor_option.ordered = true;
+    constructor_option.ordered_memory_budget = memory_budget;
+    constructor_option.log_event_idx_range = log_event_idx_range;
+    for (auto const& entry : std::filesystem::directory_iterator(cTestEndToEndArchiveDirectory)) {
+        constructor_option.archive_path = clp_s::Path{
+                .source{clp_s::InputSource::Filesystem},
+                .path{entry.path().string()}
+        };
+        clp_s::JsonConstructor constructor{constructor_option};
+        constructor.store();
+    }
+
+    // Without chunking, the (single) archive is extracted into a single file
+    std::vector<std::filesystem::path> extracted_json_paths;
+    for (auto const& entry : std::filesystem::directory_iterator(cTestEndToEndOutputDirectory)) {
+        extracted_json_paths.emplace_back(entry.path());
+    }
+    REQUIRE((1 == extracted_json_paths.size()));
+
+    return extracted_json_paths.front();
+}
+
 // Silence the checks below since our use of `std::system` is safe in the context of testing.
 // NOLINTBEGIN(cert-env33-c,concurrency-mt-unsafe)
-void compare(std::filesystem::path const& extracted_json_path) {
+void compare(std::filesystem::path const& extracted_json_path, bool should_sort) {
     int result{std::system("command -v jq >/dev/null 2>&1")};
     REQUIRE((0 == result));
+    // The input file is sorted, so when extracting in log order, the output should already match
+    // it without sorting
     auto command = fmt::format(
-            "jq --sort-keys --compact-output '.' {} | sort > {}",
+            "jq --sort-keys --compact-output '.' {} {} > {}",
             extracted_json_path.string(),
+            should_sort ? "| sort" : "",
             cTestEndToEndOutputSortedJson
     );
     result = std::system(command.c_str());
@@ -90,12 +144,38 @@ void compare(std::filesystem::path const& extracted_json_path) {
     REQUIRE((0 == WEXITSTATUS(result)));
 }
 
+void compare_range(
+        std::filesystem::path const& extracted_json_path,
+        int64_t begin_log_event_idx,
+        int64_t end_log_event_idx
+) {
+    auto command = fmt::format(
+            "jq --sort-keys --compact-output '.' {} > {}",
+            extracted_json_path.string(),
+            cTestEndToEndOutputSortedJson
+    );
+    auto result = std::system(command.c_str());
+    REQUIRE((0 == result));
+
+    command = fmt::format(
+            "sed -n '{},{}p' {} | diff --unified {} - > /dev/null",
+            begin_log_event_idx + 1,
+            end_log_event_idx,
+            get_test_input_local_path(),
+            cTestEndToEndOutputSortedJson
+    );
+    result = std::system(command.c_str());
+    REQUIRE((true == WIFEXITED(result)));
+    REQUIRE((0 == WEXITSTATUS(result)));
+}
+
 // NOLINTEND(cert-env33-c,concurrency-mt-unsafe)
 }  // namespace
 
 TEST_CASE("clp-s-compress-extract-no-floats", "[clp-s][end-to-end]") {
     auto structurize_arrays = GENERATE(true, false);
     auto single_file_archive = GENERATE(true, false);
+    auto schema_compaction_threshold = GENERATE(0.0, 0.1);
 
     TestOutputCleaner const test_cleanup{
             {std::string{cTestEndToEndArchiveDirectory},
@@ -109,7 +189,9 @@ TEST_CASE("clp-s-compress-extract-no-floats", "[clp-s][end-to-end]") {
                     std::string{cTestEndToEndArchiveDirectory},
                     single_file_archive,
                     structurize_arrays,
-                    clp_s::FileType::Json
+                    clp_s::FileType::Json,
+                    {},
+                    schema_compaction_threshold
             )
     );
 
@@ -117,3 +199,57 @@ TEST_CASE("clp-s-compress-extract-no-floats", "[clp-s][end-to-end]") {
 
     compare(extracted_json_path);
 }
+
+TEST_CASE("clp-s-compress-extract-in-order", "[clp-s][end-to-end]") {
+    auto single_file_archive = GENERATE(true, false);
+    // A budget of 1B forces a separate pass over the tables for every record
+    auto memory_budget = GENERATE(0ULL, 1ULL, 1024ULL * 1024);
+
+    TestOutputCleaner const test_cleanup{
+            {std::string{cTestEndToEndArchiveDirectory},
+             std::string{cTestEndToEndOutputDirectory},
+             std::string{cTestEndToEndOutputSortedJson}}
+    };
+
+    REQUIRE_NOTHROW(
+            std::ignore = compress_archive(
+                    get_test_input_local_path(),
+                    std::string{cTestEndToEndArchiveDirectory},
+                    single_file_archive,
+                    false,
+                    clp_s::FileType::Json
+            )
+    );
+
+    auto extracted_json_path = extract_in_order(memory_budget);
+
+    compare(extracted_json_path, false);
+}
+
+TEST_CASE("clp-s-compress-extract-log-event-idx-range", "[clp-s][end-to-end]") {
+    constexpr int64_t cBeginLogEventIdx{1};
+    constexpr int64_t cEndLogEventIdx{3};
+    auto single_file_archive = GENERATE(true, false);
+    auto memory_budget = GENERATE(0ULL, 1ULL);
+
+    TestOutputCleaner const test_cleanup{
+            {std::string{cTestEndToEndArchiveDirectory},
+             std::string{cTestEndToEndOutputDirectory},
+             std::string{cTestEndToEndOutputSortedJson}}
+    };
+
+    REQUIRE_NOTHROW(
+            std::ignore = compress_archive(
+                    get_test_input_local_path(),
+                    std::string{cTestEndToEndArchiveDirectory},
+                    single_file_archive,
+                    false,
+                    clp_s::FileType::Json
+            )
+    );
+
+    auto extracted_json_path
+            = extract_in_order(memory_budget, std::make_pair(cBeginLogEventIdx, cEndLogEventIdx));
+
+    compare_range(extracted_json_path, cBeginLogEventIdx, cEndLogEventIdx);
+}
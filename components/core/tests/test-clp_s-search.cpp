@@ -1,11 +1,20 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
 #include <exception>
 #include <filesystem>
+#include <functional>
 #include <memory>
+#include <optional>
+#include <queue>
 #include <set>
 #include <sstream>
 #include <string>
 #include <string_view>
+#include <thread>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -15,22 +24,22 @@
 
 #include "../src/clp_s/archive_constants.hpp"
 #include "../src/clp_s/ArchiveReader.hpp"
+#include "../src/clp_s/ArrayTape.hpp"
 #include "../src/clp_s/InputConfig.hpp"
 #include "../src/clp_s/OutputHandlerImpl.hpp"
 #include "../src/clp_s/search/ast/ColumnDescriptor.hpp"
-#include "../src/clp_s/search/ast/ConvertToExists.hpp"
 #include "../src/clp_s/search/ast/EmptyExpr.hpp"
 #include "../src/clp_s/search/ast/Expression.hpp"
 #include "../src/clp_s/search/ast/FilterExpr.hpp"
 #include "../src/clp_s/search/ast/Integral.hpp"
-#include "../src/clp_s/search/ast/NarrowTypes.hpp"
 #include "../src/clp_s/search/ast/OrExpr.hpp"
-#include "../src/clp_s/search/ast/OrOfAndForm.hpp"
+#include "../src/clp_s/search/ConcurrentSearch.hpp"
 #include "../src/clp_s/search/EvaluateRangeIndexFilters.hpp"
 #include "../src/clp_s/search/EvaluateTimestampIndex.hpp"
 #include "../src/clp_s/search/kql/kql.hpp"
 #include "../src/clp_s/search/Output.hpp"
 #include "../src/clp_s/search/Projection.hpp"
+#include "../src/clp_s/search/QueryPlan.hpp"
 #include "../src/clp_s/search/SchemaMatch.hpp"
 #include "../src/clp_s/Utils.hpp"
 #include "clp_s_test_utils.hpp"
@@ -39,19 +48,201 @@
 constexpr std::string_view cTestSearchArchiveDirectory{"test-clp-s-search-archive"};
 constexpr std::string_view cTestInputFileDirectory{"test_log_files"};
 constexpr std::string_view cTestSearchInputFile{"test_search.jsonl"};
+constexpr std::string_view cTestSearchArraysInputFile{"test_search_arrays.jsonl"};
 constexpr std::string_view cTestIdxKey{"idx"};
 
 namespace {
+/**
+ * Output handler that only keeps the log events with the latest timestamps, like
+ * `ResultsCacheOutputHandler`.
+ */
+class LatestResultsOutputHandler : public clp_s::search::OutputHandler {
+public:
+    // Constructors
+    LatestResultsOutputHandler(
+            std::vector<clp_s::VectorOutputHandler::QueryResult>& output,
+            size_t max_num_results
+    )
+            : clp_s::search::OutputHandler{true, true},
+              m_output{output},
+              m_max_num_results{max_num_results} {}
+
+    // Methods inherited from OutputHandler
+    void write(
+            std::string_view message,
+            clp_s::epochtime_t timestamp,
+            std::string_view archive_id,
+            int64_t log_event_idx
+    ) override {
+        if (m_latest_results.size() < m_max_num_results) {
+            m_latest_results.emplace(timestamp, message);
+        } else if (m_latest_results.top().first < timestamp) {
+            m_latest_results.pop();
+            m_latest_results.emplace(timestamp, message);
+        }
+    }
+
+    void write(std::string_view message) override { write(message, 0, {}, 0); }
+
+    [[nodiscard]] auto finish() -> clp_s::ErrorCode override {
+        for (; false == m_latest_results.empty(); m_latest_results.pop()) {
+            auto const& [timestamp, message] = m_latest_results.top();
+            m_output.emplace_back(message, timestamp, std::string_view{}, int64_t{});
+        }
+        return clp_s::ErrorCode::ErrorCodeSuccess;
+    }
+
+    [[nodiscard]] auto keeps_latest_log_events() const -> bool override { return true; }
+
+    [[nodiscard]] auto get_min_exclusive_timestamp() const
+            -> std::optional<clp_s::epochtime_t> override {
+        if (m_latest_results.size() < m_max_num_results) {
+            return std::nullopt;
+        }
+        return m_latest_results.top().first;
+    }
+
+private:
+    using TimestampAndMessage = std::pair<clp_s::epochtime_t, std::string>;
+
+    std::vector<clp_s::VectorOutputHandler::QueryResult>& m_output;
+    size_t m_max_num_results;
+    std::priority_queue<
+            TimestampAndMessage,
+            std::vector<TimestampAndMessage>,
+            std::greater<TimestampAndMessage>>
+            m_latest_results;
+};
+
+/**
+ * Output handler that counts results like `CountOutputHandler`, keeping track of how many were
+ * counted without their tables being read.
+ */
+class CountingOutputHandler : public clp_s::search::OutputHandler {
+public:
+    // Constructors
+    CountingOutputHandler(uint64_t& num_written, uint64_t& num_counted)
+            : clp_s::search::OutputHandler{false, false},
+              m_num_written{num_written},
+              m_num_counted{num_counted} {}
+
+    // Methods inherited from OutputHandler
+    void write(
+            [[maybe_unused]] std::string_view message,
+            [[maybe_unused]] clp_s::epochtime_t timestamp,
+            [[maybe_unused]] std::string_view archive_id,
+            [[maybe_unused]] int64_t log_event_idx
+    ) override {
+        ++m_num_written;
+    }
+
+    void write([[maybe_unused]] std::string_view message) override { ++m_num_written; }
+
+    [[nodiscard]] auto write_count(
+            uint64_t count,
+            [[maybe_unused]] std::optional<std::pair<clp_s::epochtime_t, clp_s::epochtime_t>> const&
+                    timestamp_range
+    ) -> bool override {
+        m_num_counted += count;
+        return true;
+    }
+
+private:
+    uint64_t& m_num_written;
+    uint64_t& m_num_counted;
+};
+
+/**
+ * Output handler that aggregates a column like `ColumnAggregationOutputHandler`, keeping the values
+ * read from column readers and the records which had to be marshalled.
+ */
+class ColumnValueOutputHandler : public clp_s::search::OutputHandler {
+public:
+    // Constructors
+    ColumnValueOutputHandler(
+            std::vector<std::string> column_keys,
+            std::vector<std::string>& column_values,
+            std::vector<std::string>& marshalled_records
+    )
+            : clp_s::search::OutputHandler{false, true},
+              m_column_keys{std::move(column_keys)},
+              m_column_values{column_values},
+              m_marshalled_records{marshalled_records} {}
+
+    // Methods inherited from OutputHandler
+    void write(
+            std::string_view message,
+            [[maybe_unused]] clp_s::epochtime_t timestamp,
+            [[maybe_unused]] std::string_view archive_id,
+            [[maybe_unused]] int64_t log_event_idx
+    ) override {
+        write(message);
+    }
+
+    void write(std::string_view message) override { m_marshalled_records.emplace_back(message); }
+
+    [[nodiscard]] auto get_aggregated_column() const
+            -> std::optional<std::vector<std::string>> override {
+        return m_column_keys;
+    }
+
+    void write_column_value(clp_s::BaseColumnReader& column_reader, uint64_t message_idx) override {
+        column_reader.extract_string_value_into_buffer(
+                message_idx,
+                m_column_values.emplace_back()
+        );
+    }
+
+private:
+    std::vector<std::string> m_column_keys;
+    std::vector<std::string>& m_column_values;
+    std::vector<std::string>& m_marshalled_records;
+};
+
+using OutputHandlerFactory = std::function<std::unique_ptr<clp_s::search::OutputHandler>(
+        std::vector<clp_s::VectorOutputHandler::QueryResult>&
+)>;
+
 auto get_test_input_path_relative_to_tests_dir() -> std::filesystem::path;
 auto get_test_input_local_path() -> std::string;
+auto get_test_arrays_input_local_path() -> std::string;
+auto create_vector_output_handler(std::vector<clp_s::VectorOutputHandler::QueryResult>& results)
+        -> std::unique_ptr<clp_s::search::OutputHandler>;
 auto create_first_record_match_metadata_query() -> std::shared_ptr<clp_s::search::ast::Expression>;
 void
 search(std::string const& query, bool ignore_case, std::vector<int64_t> const& expected_results);
+/**
+ * Searches every archive in the test archive directory.
+ * @param expr
+ * @param ignore_case
+ * @param create_output_handler Creates the output handler for each archive, given the vector that
+ * results should be written to.
+ * @return The results of the search.
+ */
+auto run_search(
+        std::shared_ptr<clp_s::search::ast::Expression> expr,
+        bool ignore_case,
+        OutputHandlerFactory const& create_output_handler
+) -> std::vector<clp_s::VectorOutputHandler::QueryResult>;
 void search(
         std::shared_ptr<clp_s::search::ast::Expression> expr,
         bool ignore_case,
-        std::vector<int64_t> const& expected_results
+        std::vector<int64_t> const& expected_results,
+        OutputHandlerFactory const& create_output_handler = create_vector_output_handler
 );
+/**
+ * Searches an opened archive like `run_search` (case-sensitively), but without assertions so that
+ * it can be called from any thread.
+ * @param archive_reader
+ * @param query_plan
+ * @param output_handler_factory
+ * @return Whether the search succeeded.
+ */
+auto search_opened_archive(
+        std::shared_ptr<clp_s::ArchiveReader> const& archive_reader,
+        std::shared_ptr<clp_s::search::QueryPlan> const& query_plan,
+        clp_s::search::OutputHandlerFactory const& output_handler_factory
+) -> bool;
 void validate_results(
         std::vector<clp_s::VectorOutputHandler::QueryResult> const& results,
         std::vector<int64_t> const& expected_results
@@ -67,6 +258,17 @@ auto get_test_input_local_path() -> std::string {
     return (tests_dir / get_test_input_path_relative_to_tests_dir()).string();
 }
 
+auto get_test_arrays_input_local_path() -> std::string {
+    std::filesystem::path const current_file_path{__FILE__};
+    auto const tests_dir{current_file_path.parent_path()};
+    return (tests_dir / cTestInputFileDirectory / cTestSearchArraysInputFile).string();
+}
+
+auto create_vector_output_handler(std::vector<clp_s::VectorOutputHandler::QueryResult>& results)
+        -> std::unique_ptr<clp_s::search::OutputHandler> {
+    return std::make_unique<clp_s::VectorOutputHandler>(results);
+}
+
 auto create_first_record_match_metadata_query() -> std::shared_ptr<clp_s::search::ast::Expression> {
     auto zero_literal = clp_s::search::ast::Integral::create_from_int(0);
     auto one_literal = clp_s::search::ast::Integral::create_from_int(1);
@@ -129,25 +331,16 @@ search(std::string const& query, bool ignore_case, std::vector<int64_t> const& e
     search(expr, ignore_case, expected_results);
 }
 
-void search(
+auto run_search(
         std::shared_ptr<clp_s::search::ast::Expression> expr,
         bool ignore_case,
-        std::vector<int64_t> const& expected_results
-) {
+        OutputHandlerFactory const& create_output_handler
+) -> std::vector<clp_s::VectorOutputHandler::QueryResult> {
     REQUIRE(nullptr != expr);
     REQUIRE(nullptr == std::dynamic_pointer_cast<clp_s::search::ast::EmptyExpr>(expr));
 
-    clp_s::search::ast::OrOfAndForm standardize_pass;
-    expr = standardize_pass.run(expr);
-    REQUIRE(nullptr != expr);
-
-    clp_s::search::ast::NarrowTypes narrow_pass;
-    expr = narrow_pass.run(expr);
-    REQUIRE(nullptr != expr);
-
-    clp_s::search::ast::ConvertToExists convert_pass;
-    expr = convert_pass.run(expr);
-    REQUIRE(nullptr != expr);
+    // Shared by all archives so that the archive-independent parts of the plan are reused
+    auto query_plan = std::make_shared<clp_s::search::QueryPlan>(expr, std::nullopt, std::nullopt);
 
     std::vector<clp_s::VectorOutputHandler::QueryResult> results;
     for (auto const& entry : std::filesystem::directory_iterator(cTestSearchArchiveDirectory)) {
@@ -158,7 +351,14 @@ void search(
         };
         archive_reader->open(archive_path, clp_s::NetworkAuthOption{});
 
-        auto archive_expr = expr->copy();
+        std::shared_ptr<clp_s::search::ast::Expression> archive_expr;
+        REQUIRE(clp_s::search::QueryPlan::NormalizationResult::Success
+                == query_plan->get_normalized_expression(
+                        archive_reader->get_timestamp_dictionary()
+                                ->get_authoritative_timestamp_tokenized_column(),
+                        archive_expr
+                ));
+        REQUIRE(nullptr != archive_expr);
 
         clp_s::search::EvaluateRangeIndexFilters metadata_filter_pass{
                 archive_reader->get_range_index(),
@@ -179,20 +379,85 @@ void search(
         archive_expr = match_pass->run(archive_expr);
         REQUIRE(nullptr != archive_expr);
 
-        auto output_handler = std::make_unique<clp_s::VectorOutputHandler>(results);
         clp_s::search::Output output_pass(
                 match_pass,
                 archive_expr,
                 archive_reader,
-                std::move(output_handler),
-                ignore_case
+                create_output_handler(results),
+                ignore_case,
+                query_plan
         );
         output_pass.filter();
         archive_reader->close();
     }
+    return results;
+}
 
+void search(
+        std::shared_ptr<clp_s::search::ast::Expression> expr,
+        bool ignore_case,
+        std::vector<int64_t> const& expected_results,
+        OutputHandlerFactory const& create_output_handler
+) {
+    auto const results = run_search(std::move(expr), ignore_case, create_output_handler);
     validate_results(results, expected_results);
 }
+
+auto search_opened_archive(
+        std::shared_ptr<clp_s::ArchiveReader> const& archive_reader,
+        std::shared_ptr<clp_s::search::QueryPlan> const& query_plan,
+        clp_s::search::OutputHandlerFactory const& output_handler_factory
+) -> bool {
+    std::shared_ptr<clp_s::search::ast::Expression> archive_expr;
+    if (clp_s::search::QueryPlan::NormalizationResult::Success
+        != query_plan->get_normalized_expression(
+                archive_reader->get_timestamp_dictionary()
+                        ->get_authoritative_timestamp_tokenized_column(),
+                archive_expr
+        ))
+    {
+        return false;
+    }
+
+    clp_s::search::EvaluateRangeIndexFilters metadata_filter_pass{
+            archive_reader->get_range_index(),
+            true
+    };
+    archive_expr = metadata_filter_pass.run(archive_expr);
+    if (std::dynamic_pointer_cast<clp_s::search::ast::EmptyExpr>(archive_expr)) {
+        return true;
+    }
+
+    clp_s::search::EvaluateTimestampIndex timestamp_index_pass(
+            archive_reader->get_timestamp_dictionary()
+    );
+    if (clp_s::EvaluatedValue::False == timestamp_index_pass.run(archive_expr)) {
+        return true;
+    }
+
+    auto match_pass = std::make_shared<clp_s::search::SchemaMatch>(
+            archive_reader->get_schema_tree(),
+            archive_reader->get_schema_map()
+    );
+    archive_expr = match_pass->run(archive_expr);
+    if (std::dynamic_pointer_cast<clp_s::search::ast::EmptyExpr>(archive_expr)) {
+        return true;
+    }
+
+    auto output_handler = output_handler_factory();
+    if (nullptr == output_handler) {
+        return false;
+    }
+    clp_s::search::Output output_pass(
+            match_pass,
+            archive_expr,
+            archive_reader,
+            std::move(output_handler),
+            false,
+            query_plan
+    );
+    return output_pass.filter();
+}
 }  // namespace
 
 TEST_CASE("clp-s-search", "[clp-s][search]") {
@@ -224,6 +489,8 @@ TEST_CASE("clp-s-search", "[clp-s][search]") {
     };
     auto structurize_arrays = GENERATE(true, false);
     auto single_file_archive = GENERATE(true, false);
+    auto schema_compaction_threshold = GENERATE(0.0, 0.1);
+    auto array_encoding = GENERATE(clp_s::ArrayEncoding::ClpString, clp_s::ArrayEncoding::Tape);
 
     TestOutputCleaner const test_cleanup{{std::string{cTestSearchArchiveDirectory}}};
 
@@ -233,7 +500,10 @@ TEST_CASE("clp-s-search", "[clp-s][search]") {
                     std::string{cTestSearchArchiveDirectory},
                     single_file_archive,
                     structurize_arrays,
-                    clp_s::FileType::Json
+                    clp_s::FileType::Json,
+                    {},
+                    schema_compaction_threshold,
+                    array_encoding
             )
     );
 
@@ -246,3 +516,353 @@ TEST_CASE("clp-s-search", "[clp-s][search]") {
     REQUIRE_NOTHROW(expr = create_first_record_match_metadata_query());
     REQUIRE_NOTHROW(search(expr, false, {0}));
 }
+
+TEST_CASE("clp-s-search-unstructured-arrays", "[clp-s][search]") {
+    // Arrays stored as JSON and as array tapes are searched by the same evaluators, so every query
+    // must have the same results under both encodings.
+    std::vector<std::pair<std::string, std::vector<int64_t>>> queries_and_results{
+            {R"aa(arr: 2)aa", {0}},
+            {R"aa(arr: -4)aa", {2}},
+            {R"aa(arr: true)aa", {2}},
+            {R"aa(arr: "hello*")aa", {2}},
+            {R"aa(arr: "str")aa", {3}},
+            {R"aa(arr.a.b: 5)aa", {1}},
+            {R"aa(arr.a.b: 6)aa", {1}},
+            {R"aa(arr.c: true)aa", {4}},
+            {R"aa(arr.c: false)aa", {4}},
+            {R"aa(arr.d: "str")aa", {4}}
+    };
+    auto single_file_archive = GENERATE(true, false);
+    auto array_encoding = GENERATE(clp_s::ArrayEncoding::ClpString, clp_s::ArrayEncoding::Tape);
+
+    TestOutputCleaner const test_cleanup{{std::string{cTestSearchArchiveDirectory}}};
+
+    REQUIRE_NOTHROW(
+            std::ignore = compress_archive(
+                    get_test_arrays_input_local_path(),
+                    std::string{cTestSearchArchiveDirectory},
+                    single_file_archive,
+                    false,
+                    clp_s::FileType::Json,
+                    {},
+                    0.0,
+                    array_encoding
+            )
+    );
+
+    for (auto const& [query, expected_results] : queries_and_results) {
+        CAPTURE(query);
+        REQUIRE_NOTHROW(search(query, false, expected_results));
+    }
+}
+
+TEST_CASE("clp-s-search-latest-results", "[clp-s][search]") {
+    constexpr size_t cMaxNumLatestResults{3};
+    auto single_file_archive = GENERATE(true, false);
+
+    TestOutputCleaner const test_cleanup{{std::string{cTestSearchArchiveDirectory}}};
+
+    // Every record is in its own table, and `idx` is used as the timestamp so that the latest
+    // results are the records with the largest `idx`.
+    REQUIRE_NOTHROW(
+            std::ignore = compress_archive(
+                    get_test_input_local_path(),
+                    std::string{cTestSearchArchiveDirectory},
+                    single_file_archive,
+                    false,
+                    clp_s::FileType::Json,
+                    std::string{cTestIdxKey}
+            )
+    );
+
+    auto const create_latest_results_output_handler
+            = [&](std::vector<clp_s::VectorOutputHandler::QueryResult>& output)
+            -> std::unique_ptr<clp_s::search::OutputHandler> {
+        return std::make_unique<LatestResultsOutputHandler>(output, cMaxNumLatestResults);
+    };
+    auto query_stream = std::istringstream{"idx >= 0"};
+    auto expr = clp_s::search::kql::parse_kql_expression(query_stream);
+    REQUIRE_NOTHROW(search(expr, false, {7, 8, 9}, create_latest_results_output_handler));
+}
+
+TEST_CASE("clp-s-search-limit", "[clp-s][search]") {
+    constexpr size_t cMaxNumResults{4};
+    constexpr int64_t cNumRecords{10};
+    auto single_file_archive = GENERATE(true, false);
+
+    TestOutputCleaner const test_cleanup{{std::string{cTestSearchArchiveDirectory}}};
+
+    REQUIRE_NOTHROW(
+            std::ignore = compress_archive(
+                    get_test_input_local_path(),
+                    std::string{cTestSearchArchiveDirectory},
+                    single_file_archive,
+                    false,
+                    clp_s::FileType::Json
+            )
+    );
+
+    auto query_stream = std::istringstream{"idx >= 0"};
+    auto expr = clp_s::search::kql::parse_kql_expression(query_stream);
+    auto const results = run_search(
+            expr,
+            false,
+            [&](std::vector<clp_s::VectorOutputHandler::QueryResult>& output)
+                    -> std::unique_ptr<clp_s::search::OutputHandler> {
+                return std::make_unique<clp_s::VectorOutputHandler>(output, cMaxNumResults);
+            }
+    );
+    REQUIRE((cMaxNumResults == results.size()));
+
+    std::set<int64_t> results_set;
+    for (auto const& result : results) {
+        auto const idx = nlohmann::json::parse(result.message)[cTestIdxKey].get<int64_t>();
+        REQUIRE((idx >= 0 && idx < cNumRecords));
+        results_set.insert(idx);
+    }
+    REQUIRE((cMaxNumResults == results_set.size()));
+}
+
+TEST_CASE("clp-s-search-concurrently", "[clp-s][search]") {
+    constexpr size_t cNumArchives{8};
+    constexpr size_t cNumThreads{4};
+    constexpr size_t cNumRecords{10};
+    constexpr size_t cMaxNumResults{1};
+    constexpr std::chrono::seconds cMaxStopWaitTime{10};
+    constexpr std::string_view cMissingArchivePath{"test-clp-s-search-missing-archive"};
+
+    TestOutputCleaner const test_cleanup{{std::string{cTestSearchArchiveDirectory}}};
+
+    // Each compression creates another archive in the archive directory
+    for (size_t i{0}; i < cNumArchives; ++i) {
+        REQUIRE_NOTHROW(
+                std::ignore = compress_archive(
+                        get_test_input_local_path(),
+                        std::string{cTestSearchArchiveDirectory},
+                        true,
+                        false,
+                        clp_s::FileType::Json
+                )
+        );
+    }
+    std::vector<clp_s::Path> archive_paths;
+    for (auto const& entry : std::filesystem::directory_iterator(cTestSearchArchiveDirectory)) {
+        archive_paths.emplace_back(
+                clp_s::Path{.source{clp_s::InputSource::Filesystem}, .path{entry.path().string()}}
+        );
+    }
+    REQUIRE((cNumArchives == archive_paths.size()));
+
+    auto query_stream = std::istringstream{"idx >= 0"};
+    auto expr = clp_s::search::kql::parse_kql_expression(query_stream);
+    auto query_plan = std::make_shared<clp_s::search::QueryPlan>(expr, std::nullopt, std::nullopt);
+
+    auto const open_archive = [](clp_s::ArchiveReader& archive_reader,
+                                 clp_s::Path const& archive_path) {
+        archive_reader.open(archive_path, clp_s::NetworkAuthOption{});
+    };
+    std::atomic_size_t num_searched_archives{0};
+    auto const search_archive
+            = [&](std::shared_ptr<clp_s::ArchiveReader> const& archive_reader,
+                  clp_s::search::OutputHandlerFactory const& output_handler_factory) {
+                  ++num_searched_archives;
+                  return search_opened_archive(archive_reader, query_plan, output_handler_factory);
+              };
+    auto const get_sorted_results
+            = [](std::vector<clp_s::VectorOutputHandler::QueryResult> const& results) {
+                  std::vector<std::tuple<std::string, int64_t, std::string>> sorted_results;
+                  for (auto const& result : results) {
+                      sorted_results.emplace_back(
+                              result.archive_id,
+                              result.log_event_idx,
+                              result.message
+                      );
+                  }
+                  std::sort(sorted_results.begin(), sorted_results.end());
+                  return sorted_results;
+              };
+
+    SECTION("Concurrent search returns the same results as sequential search") {
+        auto const sequential_results = run_search(expr, false, create_vector_output_handler);
+        REQUIRE((cNumArchives * cNumRecords == sequential_results.size()));
+
+        std::vector<clp_s::VectorOutputHandler::QueryResult> concurrent_results;
+        REQUIRE(clp_s::search::search_archives_concurrently(
+                archive_paths,
+                cNumThreads,
+                std::make_shared<clp_s::VectorOutputHandler>(concurrent_results),
+                open_archive,
+                search_archive
+        ));
+        REQUIRE((cNumArchives == num_searched_archives));
+        REQUIRE((get_sorted_results(sequential_results) == get_sorted_results(concurrent_results))
+        );
+    }
+
+    SECTION("A limit stops every worker") {
+        std::vector<clp_s::VectorOutputHandler::QueryResult> results;
+        REQUIRE(clp_s::search::search_archives_concurrently(
+                archive_paths,
+                cNumThreads,
+                std::make_shared<clp_s::VectorOutputHandler>(results, cMaxNumResults),
+                open_archive,
+                search_archive
+        ));
+
+        // Every archive has results, so once any search completes, the limit has been reached and
+        // no worker starts searching another archive. Each worker may write one result after the
+        // limit is reached, before it sees that the search should stop.
+        REQUIRE((num_searched_archives <= cNumThreads));
+        REQUIRE((results.size() >= cMaxNumResults));
+        REQUIRE((results.size() < cMaxNumResults + cNumThreads));
+    }
+
+    SECTION("An archive that fails to open stops the search") {
+        archive_paths.insert(
+                archive_paths.begin(),
+                clp_s::Path{
+                        .source{clp_s::InputSource::Filesystem},
+                        .path{std::string{cMissingArchivePath}}
+                }
+        );
+        std::vector<clp_s::VectorOutputHandler::QueryResult> results;
+        auto const output_handler = std::make_shared<clp_s::VectorOutputHandler>(results);
+
+        // The other workers' searches wait for the failed open to stop the search, so that the
+        // failure stops them before they take another archive.
+        auto const search_archive_after_stop
+                = [&](std::shared_ptr<clp_s::ArchiveReader> const& archive_reader,
+                      clp_s::search::OutputHandlerFactory const& output_handler_factory) {
+                      auto const deadline{std::chrono::steady_clock::now() + cMaxStopWaitTime};
+                      while (false == output_handler->should_stop()
+                             && std::chrono::steady_clock::now() < deadline)
+                      {
+                          std::this_thread::yield();
+                      }
+                      return search_archive(archive_reader, output_handler_factory);
+                  };
+        REQUIRE((false
+                 == clp_s::search::search_archives_concurrently(
+                         archive_paths,
+                         cNumThreads,
+                         output_handler,
+                         open_archive,
+                         search_archive_after_stop
+                 )));
+        REQUIRE((num_searched_archives < cNumThreads));
+        REQUIRE(results.empty());
+    }
+}
+
+TEST_CASE("clp-s-search-count", "[clp-s][search]") {
+    auto single_file_archive = GENERATE(true, false);
+
+    TestOutputCleaner const test_cleanup{{std::string{cTestSearchArchiveDirectory}}};
+
+    // Every record is in its own table, and `idx` is used as the timestamp so that each table's
+    // timestamp range is known.
+    REQUIRE_NOTHROW(
+            std::ignore = compress_archive(
+                    get_test_input_local_path(),
+                    std::string{cTestSearchArchiveDirectory},
+                    single_file_archive,
+                    false,
+                    clp_s::FileType::Json,
+                    std::string{cTestIdxKey}
+            )
+    );
+
+    // Queries that only filter on the timestamp match every record in a table or none of them, so
+    // the matching tables can be counted without being read.
+    std::vector<std::tuple<std::string, uint64_t, uint64_t>> queries_and_counts{
+            {"idx >= 3", 0, 7},
+            {"idx >= 3 AND idx < 5", 0, 2},
+            {"NOT idx: 4", 0, 9},
+            {R"aa(msg: "*Abc123*")aa", 5, 0},
+            {R"aa(idx > 2 AND msg: "*Abc123*")aa", 3, 0}
+    };
+    for (auto const& [query, expected_num_written, expected_num_counted] : queries_and_counts) {
+        CAPTURE(query);
+        uint64_t num_written{0};
+        uint64_t num_counted{0};
+        auto query_stream = std::istringstream{query};
+        auto expr = clp_s::search::kql::parse_kql_expression(query_stream);
+        std::ignore = run_search(
+                expr,
+                false,
+                [&](std::vector<clp_s::VectorOutputHandler::QueryResult>&)
+                        -> std::unique_ptr<clp_s::search::OutputHandler> {
+                    return std::make_unique<CountingOutputHandler>(num_written, num_counted);
+                }
+        );
+        REQUIRE((expected_num_written == num_written));
+        REQUIRE((expected_num_counted == num_counted));
+    }
+}
+
+TEST_CASE("clp-s-search-aggregated-column", "[clp-s][search]") {
+    auto single_file_archive = GENERATE(true, false);
+
+    TestOutputCleaner const test_cleanup{{std::string{cTestSearchArchiveDirectory}}};
+
+    REQUIRE_NOTHROW(
+            std::ignore = compress_archive(
+                    get_test_input_local_path(),
+                    std::string{cTestSearchArchiveDirectory},
+                    single_file_archive,
+                    false,
+                    clp_s::FileType::Json
+            )
+    );
+
+    auto const run_aggregation = [](std::string const& query,
+                                    std::vector<std::string> const& column_keys,
+                                    std::vector<std::string>& column_values,
+                                    std::vector<std::string>& marshalled_records) {
+        auto query_stream = std::istringstream{query};
+        auto expr = clp_s::search::kql::parse_kql_expression(query_stream);
+        std::ignore = run_search(
+                expr,
+                false,
+                [&](std::vector<clp_s::VectorOutputHandler::QueryResult>&)
+                        -> std::unique_ptr<clp_s::search::OutputHandler> {
+                    return std::make_unique<ColumnValueOutputHandler>(
+                            column_keys,
+                            column_values,
+                            marshalled_records
+                    );
+                }
+        );
+        std::sort(column_values.begin(), column_values.end());
+    };
+
+    SECTION("Values stored in column readers are read without marshalling records") {
+        std::vector<std::string> column_values;
+        std::vector<std::string> marshalled_records;
+        run_aggregation("idx >= 0", {std::string{cTestIdxKey}}, column_values, marshalled_records);
+        REQUIRE((std::vector<std::string>{"0", "1", "2", "3", "4", "5", "6", "7", "8", "9"}
+                 == column_values));
+        REQUIRE(marshalled_records.empty());
+
+        column_values.clear();
+        run_aggregation("idx >= 0", {"bool"}, column_values, marshalled_records);
+        REQUIRE((std::vector<std::string>{"true"} == column_values));
+        REQUIRE(marshalled_records.empty());
+
+        column_values.clear();
+        run_aggregation("idx >= 0", {"missing"}, column_values, marshalled_records);
+        REQUIRE(column_values.empty());
+        REQUIRE(marshalled_records.empty());
+    }
+
+    SECTION("Records are marshalled when the column's values are objects") {
+        std::vector<std::string> column_values;
+        std::vector<std::string> marshalled_records;
+        run_aggregation("idx >= 7", {"arr"}, column_values, marshalled_records);
+        // The array in record 7 is stored in a column reader, while the object in record 8 isn't
+        REQUIRE((1 == column_values.size()));
+        REQUIRE((1 == marshalled_records.size()));
+        auto const marshalled_record = nlohmann::json::parse(marshalled_records.front());
+        REQUIRE((8 == marshalled_record[cTestIdxKey].get<int64_t>()));
+    }
+}
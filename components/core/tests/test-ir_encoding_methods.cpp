@@ -1,8 +1,10 @@
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <map>
 #include <memory>
 #include <optional>
+#include <span>
 #include <sstream>
 #include <string>
 #include <string_view>
@@ -15,6 +17,7 @@
 #include <catch2/catch.hpp>
 #include <msgpack.hpp>
 #include <nlohmann/json.hpp>
+#include <simdjson.h>
 
 #include "../src/clp/BufferReader.hpp"
 #include "../src/clp/ErrorCode.hpp"
@@ -240,6 +243,22 @@ template <typename encoded_variable_t>
         Serializer<encoded_variable_t>& serializer
 ) -> bool;
 
+/**
+ * Parses the given JSON strings using simdjson's on-demand API and serializes them as a key-value
+ * pair log event using `Serializer::serialize_json_object`.
+ * @tparam encoded_variable_t
+ * @param auto_gen_json The auto-generated kv-pairs, given as a JSON object string.
+ * @param user_gen_json The user-generated kv-pairs, given as a JSON object string.
+ * @param serializer
+ * @return Whether serialization succeeded.
+ */
+template <typename encoded_variable_t>
+[[nodiscard]] auto parse_and_serialize_json_object(
+        simdjson::padded_string_view auto_gen_json,
+        simdjson::padded_string_view user_gen_json,
+        Serializer<encoded_variable_t>& serializer
+) -> bool;
+
 template <typename encoded_variable_t>
 [[nodiscard]] auto serialize_log_events(
         vector<UnstructuredLogEvent> const& log_events,
@@ -412,6 +431,28 @@ auto unpack_and_assert_serialization_failure(
     }
     return true;
 }
+
+template <typename encoded_variable_t>
+auto parse_and_serialize_json_object(
+        simdjson::padded_string_view auto_gen_json,
+        simdjson::padded_string_view user_gen_json,
+        Serializer<encoded_variable_t>& serializer
+) -> bool {
+    simdjson::ondemand::parser auto_gen_parser;
+    simdjson::ondemand::parser user_gen_parser;
+    simdjson::ondemand::document auto_gen_doc;
+    simdjson::ondemand::document user_gen_doc;
+    simdjson::ondemand::object auto_gen_obj;
+    simdjson::ondemand::object user_gen_obj;
+    if (simdjson::SUCCESS != auto_gen_parser.iterate(auto_gen_json).get(auto_gen_doc)
+        || simdjson::SUCCESS != auto_gen_doc.get_object().get(auto_gen_obj)
+        || simdjson::SUCCESS != user_gen_parser.iterate(user_gen_json).get(user_gen_doc)
+        || simdjson::SUCCESS != user_gen_doc.get_object().get(user_gen_obj))
+    {
+        return false;
+    }
+    return serializer.serialize_json_object(auto_gen_obj, user_gen_obj);
+}
 }  // namespace
 
 /**
@@ -1491,3 +1532,292 @@ TEMPLATE_TEST_CASE(
     REQUIRE(serializer_result.has_error());
     REQUIRE((std::errc::protocol_not_supported == serializer_result.error()));
 }
+
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+TEMPLATE_TEST_CASE(
+        "ffi_ir_stream_Serializer_serialize_msgpack_map_batch",
+        "[clp][ffi][ir_stream][Serializer]",
+        four_byte_encoded_variable_t,
+        eight_byte_encoded_variable_t
+) {
+    using MsgpackMapPair = typename Serializer<TestType>::MsgpackMapPair;
+    using BatchStats = typename Serializer<TestType>::BatchStats;
+
+    auto single_serializer_result{Serializer<TestType>::create()};
+    REQUIRE_FALSE(single_serializer_result.has_error());
+    auto& single_serializer{single_serializer_result.value()};
+    single_serializer.clear_ir_buf();
+
+    auto batch_serializer_result{Serializer<TestType>::create()};
+    REQUIRE_FALSE(batch_serializer_result.has_error());
+    auto& batch_serializer{batch_serializer_result.value()};
+    batch_serializer.clear_ir_buf();
+
+    // Create log events with two distinct shapes. Some values change type (e.g., null vs. map, int
+    // vs. float) to ensure shapes are distinguished by their value types as well as their keys.
+    constexpr size_t cNumLogEvents{100};
+    vector<msgpack::object_handle> msgpack_obj_handles;
+    vector<MsgpackMapPair> log_events;
+    auto const empty_map_obj_handle{create_msgpack_empty_map_obj_handle()};
+    auto const empty_map{empty_map_obj_handle.get().via.map};
+    for (size_t i{0}; i < cNumLogEvents; ++i) {
+        nlohmann::json auto_gen_obj = {{"ts", i}};
+        nlohmann::json user_gen_obj
+                = {{"message", "Log event " + std::to_string(i) + " with value 0x1234"},
+                   {"ctx", {{"thread", i % 4}, {"empty", nlohmann::json::object()}}}};
+        if (0 == i % 2) {
+            user_gen_obj["value"] = nullptr;
+            user_gen_obj["ctx"]["cost"] = 0.5;
+        } else {
+            user_gen_obj["value"] = {{"inner", i}};
+            user_gen_obj["ctx"]["cost"] = 1;
+        }
+
+        auto const auto_gen_bytes{nlohmann::json::to_msgpack(auto_gen_obj)};
+        auto const user_gen_bytes{nlohmann::json::to_msgpack(user_gen_obj)};
+        REQUIRE(unpack_and_serialize_msgpack_bytes(
+                auto_gen_bytes,
+                user_gen_bytes,
+                single_serializer
+        ));
+
+        auto const& auto_gen_handle{msgpack_obj_handles.emplace_back(msgpack::unpack(
+                size_checked_pointer_cast<char const>(auto_gen_bytes.data()),
+                auto_gen_bytes.size()
+        ))};
+        auto const auto_gen_map{auto_gen_handle.get().via.map};
+        auto const& user_gen_handle{msgpack_obj_handles.emplace_back(msgpack::unpack(
+                size_checked_pointer_cast<char const>(user_gen_bytes.data()),
+                user_gen_bytes.size()
+        ))};
+        auto const user_gen_map{user_gen_handle.get().via.map};
+        log_events.emplace_back(auto_gen_map, user_gen_map);
+    }
+    log_events.emplace_back(empty_map, empty_map);
+    REQUIRE(single_serializer.serialize_msgpack_map(empty_map, empty_map));
+
+    // Serialize in two batches to ensure the cache persists across batches
+    constexpr size_t cFirstBatchSize{10};
+    BatchStats stats;
+    std::span<MsgpackMapPair const> const log_events_span{log_events};
+    REQUIRE(batch_serializer.serialize_msgpack_map_batch(
+            log_events_span.subspan(0, cFirstBatchSize),
+            stats
+    ));
+    REQUIRE((cFirstBatchSize == stats.num_serialized_log_events));
+    REQUIRE((2 == stats.num_shape_cache_misses));
+    REQUIRE((cFirstBatchSize - 2 == stats.num_shape_cache_hits));
+    REQUIRE((batch_serializer.get_ir_buf_view().size() == stats.num_serialized_bytes));
+
+    REQUIRE(batch_serializer.serialize_msgpack_map_batch(
+            log_events_span.subspan(cFirstBatchSize),
+            stats
+    ));
+    REQUIRE((log_events.size() - cFirstBatchSize == stats.num_serialized_log_events));
+    REQUIRE((1 == stats.num_shape_cache_misses));
+    REQUIRE((log_events.size() - cFirstBatchSize - 1 == stats.num_shape_cache_hits));
+
+    auto const single_ir_buf_view{single_serializer.get_ir_buf_view()};
+    auto const batch_ir_buf_view{batch_serializer.get_ir_buf_view()};
+    REQUIRE(std::equal(
+            single_ir_buf_view.begin(),
+            single_ir_buf_view.end(),
+            batch_ir_buf_view.begin(),
+            batch_ir_buf_view.end()
+    ));
+    batch_serializer.clear_ir_buf();
+
+    // A log event that matches a cached shape but has an unserializable value should stop the
+    // batch after the preceding log events.
+    auto const invalid_bytes{nlohmann::json::to_msgpack(nlohmann::json{{"ts", UINT64_MAX}})};
+    auto const invalid_handle{msgpack::unpack(
+            size_checked_pointer_cast<char const>(invalid_bytes.data()),
+            invalid_bytes.size()
+    )};
+    vector<MsgpackMapPair> const batch_with_invalid_log_event{
+            log_events.front(),
+            {invalid_handle.get().via.map, log_events.front().second},
+            log_events.front()
+    };
+    REQUIRE_FALSE(
+            batch_serializer.serialize_msgpack_map_batch(batch_with_invalid_log_event, stats)
+    );
+    REQUIRE((1 == stats.num_serialized_log_events));
+    REQUIRE((batch_serializer.get_ir_buf_view().size() == stats.num_serialized_bytes));
+}
+
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+TEMPLATE_TEST_CASE(
+        "ffi_ir_stream_Serializer_serialize_json_object",
+        "[clp][ffi][ir_stream][Serializer]",
+        four_byte_encoded_variable_t,
+        eight_byte_encoded_variable_t
+) {
+    auto msgpack_serializer_result{Serializer<TestType>::create()};
+    REQUIRE_FALSE(msgpack_serializer_result.has_error());
+    auto& msgpack_serializer{msgpack_serializer_result.value()};
+    msgpack_serializer.clear_ir_buf();
+
+    auto json_serializer_result{Serializer<TestType>::create()};
+    REQUIRE_FALSE(json_serializer_result.has_error());
+    auto& json_serializer{json_serializer_result.value()};
+    json_serializer.clear_ir_buf();
+
+    auto const empty_obj = nlohmann::json::parse("{}");
+    nlohmann::json const basic_obj
+            = {{"int8_max", INT8_MAX},
+               {"int16_min", INT16_MIN},
+               {"int32_max", INT32_MAX},
+               {"int64_max", INT64_MAX},
+               {"int64_min", INT64_MIN},
+               {"float_pos", 1.01},
+               {"float_neg", -1.01},
+               {"true", true},
+               {"false", false},
+               {"string", "short_string"},
+               {"clp_string", "uid=0, CPU usage: 99.99%, \"user_name\"=YScope"},
+               {"escaped_key\t", "escaped\nvalue"},
+               {"null", nullptr},
+               {"empty_object", empty_obj}};
+    auto nested_obj = basic_obj;
+    nested_obj.emplace("obj", basic_obj);
+    nested_obj.emplace("obj_with_empty_obj", nlohmann::json{{"inner", empty_obj}});
+
+    vector<std::pair<nlohmann::json, nlohmann::json>> const auto_gen_and_user_gen_object_pairs{
+            {empty_obj, empty_obj},
+            {basic_obj, empty_obj},
+            {empty_obj, basic_obj},
+            {basic_obj, nested_obj},
+            {nested_obj, nested_obj}
+    };
+
+    // Without arrays, the JSON path must be byte-identical to the msgpack path
+    for (auto const& [auto_gen_json_obj, user_gen_json_obj] : auto_gen_and_user_gen_object_pairs) {
+        REQUIRE(unpack_and_serialize_msgpack_bytes(
+                nlohmann::json::to_msgpack(auto_gen_json_obj),
+                nlohmann::json::to_msgpack(user_gen_json_obj),
+                msgpack_serializer
+        ));
+        simdjson::padded_string const auto_gen_json{auto_gen_json_obj.dump()};
+        simdjson::padded_string const user_gen_json{user_gen_json_obj.dump()};
+        REQUIRE(parse_and_serialize_json_object(auto_gen_json, user_gen_json, json_serializer));
+
+        auto const msgpack_ir_buf_view{msgpack_serializer.get_ir_buf_view()};
+        auto const json_ir_buf_view{json_serializer.get_ir_buf_view()};
+        REQUIRE(std::equal(
+                msgpack_ir_buf_view.begin(),
+                msgpack_ir_buf_view.end(),
+                json_ir_buf_view.begin(),
+                json_ir_buf_view.end()
+        ));
+        msgpack_serializer.clear_ir_buf();
+        json_serializer.clear_ir_buf();
+    }
+
+    // Arrays are serialized from their raw JSON text, so check them by deserializing the stream
+    vector<int8_t> ir_buf;
+    flush_and_clear_serializer_buffer(json_serializer, ir_buf);
+    nlohmann::json const obj_with_arrays
+            = {{"empty_array", nlohmann::json::array()},
+               {"array", {1, 1.5, true, "short_string", "clp string", nullptr, basic_obj}},
+               {"obj", {{"nested_array", {{1, 2}, {3, 4}}}}}};
+    simdjson::padded_string const obj_with_arrays_json{obj_with_arrays.dump()};
+    simdjson::padded_string const empty_obj_json{empty_obj.dump()};
+    REQUIRE(parse_and_serialize_json_object(empty_obj_json, obj_with_arrays_json, json_serializer));
+    flush_and_clear_serializer_buffer(json_serializer, ir_buf);
+    ir_buf.push_back(clp::ffi::ir_stream::cProtocol::Eof);
+
+    BufferReader reader{size_checked_pointer_cast<char>(ir_buf.data()), ir_buf.size()};
+    auto deserializer_result{Deserializer<IrUnitHandler>::create(reader, IrUnitHandler{})};
+    REQUIRE_FALSE(deserializer_result.has_error());
+    auto& deserializer = deserializer_result.value();
+    while (true) {
+        auto const result{deserializer.deserialize_next_ir_unit(reader)};
+        REQUIRE_FALSE(result.has_error());
+        if (result.value() == clp::ffi::ir_stream::IrUnitType::EndOfStream) {
+            break;
+        }
+    }
+    auto const& deserialized_log_events{
+            deserializer.get_ir_unit_handler().get_deserialized_log_events()
+    };
+    REQUIRE((1 == deserialized_log_events.size()));
+    auto const serialized_json_result{deserialized_log_events.front().serialize_to_json()};
+    REQUIRE_FALSE(serialized_json_result.has_error());
+    auto const& [actual_auto_gen_json_obj, actual_user_gen_json_obj]{
+            serialized_json_result.value()
+    };
+    REQUIRE((empty_obj == actual_auto_gen_json_obj));
+    REQUIRE((obj_with_arrays == actual_user_gen_json_obj));
+
+    // Invalid inputs must fail without modifying the IR buffer
+    auto const invalid_json_obj = GENERATE(
+            std::string{R"({"uint64": 18446744073709551615})"},
+            std::string{R"({"big_int": 123456789012345678901234567890})"},
+            std::string{R"({"obj": {"truncated": )"}
+    );
+    simdjson::padded_string const invalid_json{invalid_json_obj};
+    REQUIRE_FALSE(parse_and_serialize_json_object(empty_obj_json, invalid_json, json_serializer));
+    REQUIRE_FALSE(parse_and_serialize_json_object(invalid_json, empty_obj_json, json_serializer));
+    REQUIRE(json_serializer.get_ir_buf_view().empty());
+}
+
+TEMPLATE_TEST_CASE(
+        "ffi_ir_stream_Serializer_serialize_json_object_throughput",
+        "[.][benchmark][clp][ffi][ir_stream][Serializer]",
+        four_byte_encoded_variable_t,
+        eight_byte_encoded_variable_t
+) {
+    constexpr size_t cNumLogEvents{10'000};
+
+    vector<string> json_log_events;
+    for (size_t i{0}; i < cNumLogEvents; ++i) {
+        nlohmann::json const log_event
+                = {{"timestamp", 1'700'000'000'000 + static_cast<int64_t>(i)},
+                   {"level", (0 == i % 10) ? "WARN" : "INFO"},
+                   {"message", "Task " + std::to_string(i) + " completed in 0.25 seconds"},
+                   {"context",
+                    {{"thread_id", static_cast<int64_t>(i % 16)},
+                     {"latency", 0.25 * static_cast<double>(i % 100)},
+                     {"success", 0 != i % 7},
+                     {"host", "worker-" + std::to_string(i % 8)}}}};
+        json_log_events.emplace_back(log_event.dump());
+    }
+    simdjson::padded_string const empty_obj_json{string_view{"{}"}};
+
+    auto serializer_result{Serializer<TestType>::create()};
+    REQUIRE_FALSE(serializer_result.has_error());
+    auto& serializer{serializer_result.value()};
+
+    // The msgpack path includes the JSON-to-msgpack conversion that producers holding JSON text
+    // have to pay for.
+    BENCHMARK("JSON -> msgpack -> KV-pair IR") {
+        auto const empty_map_bytes{nlohmann::json::to_msgpack(nlohmann::json::object())};
+        for (auto const& json_log_event : json_log_events) {
+            REQUIRE(unpack_and_serialize_msgpack_bytes(
+                    empty_map_bytes,
+                    nlohmann::json::to_msgpack(nlohmann::json::parse(json_log_event)),
+                    serializer
+            ));
+        }
+        auto const num_bytes{serializer.get_ir_buf_view().size()};
+        serializer.clear_ir_buf();
+        return num_bytes;
+    };
+
+    BENCHMARK("JSON -> KV-pair IR") {
+        simdjson::ondemand::parser auto_gen_parser;
+        simdjson::ondemand::parser user_gen_parser;
+        for (auto const& json_log_event : json_log_events) {
+            simdjson::padded_string const padded_json_log_event{json_log_event};
+            auto auto_gen_doc{auto_gen_parser.iterate(empty_obj_json)};
+            auto user_gen_doc{user_gen_parser.iterate(padded_json_log_event)};
+            simdjson::ondemand::object auto_gen_obj{auto_gen_doc.get_object()};
+            simdjson::ondemand::object user_gen_obj{user_gen_doc.get_object()};
+            REQUIRE(serializer.serialize_json_object(auto_gen_obj, user_gen_obj));
+        }
+        auto const num_bytes{serializer.get_ir_buf_view().size()};
+        serializer.clear_ir_buf();
+        return num_bytes;
+    };
+}
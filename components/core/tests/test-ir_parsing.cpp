@@ -1,14 +1,52 @@
+#include <cstddef>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
 #include <catch2/catch.hpp>
 
+#include "../src/clp/ir/char_classification.hpp"
 #include "../src/clp/ir/parsing.hpp"
 #include "../src/clp/ir/types.hpp"
 #include "../src/clp/type_utils.hpp"
 
+using clp::ir::CharClassMasks;
+using clp::ir::classify_chars_portable;
 using clp::ir::get_bounds_of_next_var;
+using clp::ir::get_bounds_of_next_var_scalar;
+using clp::ir::get_bounds_of_next_var_using_char_classes;
 using std::string;
 using std::string_view;
 using std::vector;
 
+namespace {
+/**
+ * Finds all variable bounds in the given string using the given method.
+ * @tparam VarBoundsMethod
+ * @param str
+ * @param get_bounds
+ * @return The begin and end positions of every variable found, followed by the final values of
+ * `begin_pos` and `end_pos`.
+ */
+template <typename VarBoundsMethod>
+auto get_all_var_bounds(string_view str, VarBoundsMethod get_bounds) -> vector<size_t>;
+
+template <typename VarBoundsMethod>
+auto get_all_var_bounds(string_view str, VarBoundsMethod get_bounds) -> vector<size_t> {
+    vector<size_t> bounds;
+    size_t begin_pos{0};
+    size_t end_pos{0};
+    while (get_bounds(str, begin_pos, end_pos)) {
+        bounds.push_back(begin_pos);
+        bounds.push_back(end_pos);
+    }
+    bounds.push_back(begin_pos);
+    bounds.push_back(end_pos);
+    return bounds;
+}
+}  // namespace
+
 TEST_CASE("ir::get_bounds_of_next_var", "[ir][get_bounds_of_next_var]") {
     string str;
     size_t begin_pos;
@@ -100,3 +138,87 @@ TEST_CASE("ir::get_bounds_of_next_var", "[ir][get_bounds_of_next_var]") {
     REQUIRE(get_bounds_of_next_var(str, begin_pos, end_pos) == true);
     REQUIRE("var123" == str.substr(begin_pos, end_pos - begin_pos));
 }
+
+TEST_CASE("ir::get_bounds_of_next_var_using_char_classes", "[ir][get_bounds_of_next_var]") {
+    constexpr size_t cNumStrings{10'000};
+    constexpr size_t cMaxStringLength{300};
+    constexpr size_t cRandomByteFrequency{50};
+    // Fixed so that failures are reproducible
+    constexpr std::mt19937::result_type cSeed{42};
+    constexpr string_view cChars{"abcdefxyzABCFXZ0123456789 =:,.-+_\\/[]{}\t"};
+
+    auto const scalar_method = [](string_view str, size_t& begin_pos, size_t& end_pos) {
+        return get_bounds_of_next_var_scalar(str, begin_pos, end_pos);
+    };
+    auto const portable_method = [](string_view str, size_t& begin_pos, size_t& end_pos) {
+        return get_bounds_of_next_var_using_char_classes(
+                str,
+                begin_pos,
+                end_pos,
+                classify_chars_portable
+        );
+    };
+
+    // Strings longer than a block, with tokens spanning block boundaries
+    string str(clp::ir::cCharClassificationBlockSize - 1, ' ');
+    str += "abc123 ";
+    str += string(2 * clp::ir::cCharClassificationBlockSize, '9');
+    str += " ff";
+    REQUIRE(get_all_var_bounds(str, scalar_method) == get_all_var_bounds(str, portable_method));
+
+    std::mt19937 generator{cSeed};
+    for (size_t i{0}; i < cNumStrings; ++i) {
+        str.clear();
+        auto const length{generator() % cMaxStringLength};
+        for (size_t j{0}; j < length; ++j) {
+            if (0 == generator() % cRandomByteFrequency) {
+                str += static_cast<char>(generator() % 256);
+            } else {
+                str += cChars[generator() % cChars.length()];
+            }
+        }
+
+        auto const expected_bounds{get_all_var_bounds(str, scalar_method)};
+        REQUIRE(expected_bounds == get_all_var_bounds(str, portable_method));
+        REQUIRE(expected_bounds == get_all_var_bounds(str, get_bounds_of_next_var));
+#if CLP_IR_CHAR_CLASSIFICATION_AVX2_SUPPORTED
+        if (clp::ir::is_avx2_supported()) {
+            auto const avx2_method = [](string_view str, size_t& begin_pos, size_t& end_pos) {
+                return get_bounds_of_next_var_using_char_classes(
+                        str,
+                        begin_pos,
+                        end_pos,
+                        [](string_view str, size_t pos) -> CharClassMasks {
+                            return clp::ir::classify_chars_avx2(str, pos);
+                        }
+                );
+            };
+            REQUIRE(expected_bounds == get_all_var_bounds(str, avx2_method));
+        }
+#endif
+    }
+}
+
+TEST_CASE(
+        "ir::get_bounds_of_next_var_throughput",
+        "[.][benchmark][ir][get_bounds_of_next_var]"
+) {
+    constexpr size_t cNumLines{10'000};
+    string_view const line{
+            "2023-01-01 12:00:00.123 INFO [worker-3] Task 12345 completed in 0.25 seconds,"
+            " user=alice id=0xdeadbeef path=/var/log/app.log\n"
+    };
+    string logs;
+    for (size_t i{0}; i < cNumLines; ++i) {
+        logs += line;
+    }
+
+    BENCHMARK("get_bounds_of_next_var_scalar") {
+        return get_all_var_bounds(logs, [](string_view str, size_t& begin_pos, size_t& end_pos) {
+            return get_bounds_of_next_var_scalar(str, begin_pos, end_pos);
+        });
+    };
+    BENCHMARK("get_bounds_of_next_var") {
+        return get_all_var_bounds(logs, get_bounds_of_next_var);
+    };
+}
@@ -0,0 +1,235 @@
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "../src/reducer/ColumnarRecordGroup.hpp"
+#include "../src/reducer/ConstRecordIterator.hpp"
+#include "../src/reducer/DeserializedRecordGroup.hpp"
+#include "../src/reducer/GroupTags.hpp"
+#include "../src/reducer/Record.hpp"
+#include "../src/reducer/RecordGroupIterator.hpp"
+#include "../src/reducer/RecordTypedKeyIterator.hpp"
+
+using reducer::ColumnarRecordGroup;
+using reducer::ConstRecordIterator;
+using reducer::GroupTags;
+using reducer::Record;
+using reducer::RecordTypedKeyIterator;
+using reducer::TypedRecordKey;
+using reducer::ValueType;
+using std::string;
+using std::string_view;
+using std::vector;
+
+namespace {
+using Value = std::variant<string, int64_t, double>;
+
+/**
+ * A RecordTypedKeyIterator over a vector of typed keys.
+ */
+class VectorTypedKeyIterator : public RecordTypedKeyIterator {
+public:
+    explicit VectorTypedKeyIterator(vector<TypedRecordKey> typed_keys)
+            : m_typed_keys{std::move(typed_keys)} {}
+
+    TypedRecordKey get() override { return m_typed_keys[m_idx]; }
+
+    void next() override { ++m_idx; }
+
+    bool done() override { return m_idx >= m_typed_keys.size(); }
+
+private:
+    vector<TypedRecordKey> m_typed_keys;
+    size_t m_idx{0};
+};
+
+/**
+ * A Record backed by a map of keys to values.
+ */
+class MapRecord : public Record {
+public:
+    explicit MapRecord(std::map<string, Value> values) : m_values{std::move(values)} {}
+
+    [[nodiscard]] string_view get_string_view(string_view key) const override {
+        auto const it = m_values.find(string{key});
+        return m_values.end() == it ? string_view{} : string_view{std::get<string>(it->second)};
+    }
+
+    [[nodiscard]] int64_t get_int64_value(string_view key) const override {
+        auto const it = m_values.find(string{key});
+        return m_values.end() == it ? 0 : std::get<int64_t>(it->second);
+    }
+
+    [[nodiscard]] double get_double_value(string_view key) const override {
+        auto const it = m_values.find(string{key});
+        return m_values.end() == it ? 0.0 : std::get<double>(it->second);
+    }
+
+    [[nodiscard]] std::unique_ptr<RecordTypedKeyIterator> typed_key_iter() const override {
+        vector<TypedRecordKey> typed_keys;
+        for (auto const& [key, value] : m_values) {
+            ValueType type{ValueType::String};
+            if (std::holds_alternative<int64_t>(value)) {
+                type = ValueType::Int64;
+            } else if (std::holds_alternative<double>(value)) {
+                type = ValueType::Double;
+            }
+            typed_keys.emplace_back(key, type);
+        }
+        return std::make_unique<VectorTypedKeyIterator>(std::move(typed_keys));
+    }
+
+private:
+    std::map<string, Value> m_values;
+};
+
+/**
+ * A ConstRecordIterator over a vector of MapRecords.
+ */
+class MapRecordIterator : public ConstRecordIterator {
+public:
+    explicit MapRecordIterator(vector<MapRecord> const& records) : m_records{&records} {}
+
+    [[nodiscard]] Record const& get() const override { return (*m_records)[m_idx]; }
+
+    void next() override { ++m_idx; }
+
+    bool done() override { return m_idx >= m_records->size(); }
+
+private:
+    vector<MapRecord> const* m_records;
+    size_t m_idx{0};
+};
+
+/**
+ * @param record_it
+ * @return The values of every record in the given iterator, read using the record's typed keys.
+ */
+auto read_records(ConstRecordIterator& record_it) -> vector<std::map<string, Value>>;
+
+auto read_records(ConstRecordIterator& record_it) -> vector<std::map<string, Value>> {
+    vector<std::map<string, Value>> records;
+    for (; false == record_it.done(); record_it.next()) {
+        auto const& record = record_it.get();
+        auto& values = records.emplace_back();
+        for (auto typed_key_it = record.typed_key_iter(); false == typed_key_it->done();
+             typed_key_it->next())
+        {
+            auto const typed_key = typed_key_it->get();
+            string const key{typed_key.get_key()};
+            switch (typed_key.get_type()) {
+                case ValueType::String:
+                    values.emplace(key, string{record.get_string_view(key)});
+                    break;
+                case ValueType::Int64:
+                    values.emplace(key, record.get_int64_value(key));
+                    break;
+                case ValueType::Double:
+                    values.emplace(key, record.get_double_value(key));
+                    break;
+            }
+        }
+    }
+    return records;
+}
+}  // namespace
+
+TEST_CASE("reducer_ColumnarRecordGroup_round_trip", "[reducer][ColumnarRecordGroup]") {
+    GroupTags const tags{"tag0", "", "tag2"};
+    vector<std::map<string, Value>> const expected_records{
+            {{"count", int64_t{1}}, {"name", string{"a"}}, {"ratio", 0.5}},
+            {{"count", int64_t{-2}}},
+            {},
+            {{"name", string{}}, {"ratio", -1.25}},
+            {{"name", string{"a longer string value"}}, {"count", int64_t{INT64_MAX}}}
+    };
+    vector<MapRecord> records;
+    for (auto const& values : expected_records) {
+        records.emplace_back(values);
+    }
+
+    MapRecordIterator record_it{records};
+    auto serialized_record_group = reducer::serialize_columnar(tags, record_it);
+    auto const* buf = reinterpret_cast<char const*>(serialized_record_group.data());
+    auto const len = serialized_record_group.size();
+    REQUIRE(ColumnarRecordGroup::is_columnar(buf, len));
+
+    ColumnarRecordGroup record_group{buf, len};
+    REQUIRE((tags == record_group.get_tags()));
+    REQUIRE((expected_records == read_records(record_group.record_iter())));
+
+    // Missing keys and mismatched types should behave as if the key doesn't exist
+    ColumnarRecordGroup record_group_for_lookups{buf, len};
+    auto& lookup_record_it = record_group_for_lookups.record_iter();
+    lookup_record_it.next();
+    auto const& record = lookup_record_it.get();
+    REQUIRE((-2 == record.get_int64_value("count")));
+    REQUIRE(record.get_string_view("name").empty());
+    REQUIRE((0.0 == record.get_double_value("count")));
+    REQUIRE((0 == record.get_int64_value("nonexistent")));
+
+    // Truncated and corrupted buffers should be rejected
+    for (size_t truncated_len = 0; truncated_len < len; ++truncated_len) {
+        REQUIRE_THROWS_AS(
+                ColumnarRecordGroup(buf, truncated_len),
+                ColumnarRecordGroup::OperationFailed
+        );
+    }
+    serialized_record_group[1] = ColumnarRecordGroup::cVersion + 1;
+    REQUIRE_THROWS_AS(ColumnarRecordGroup(buf, len), ColumnarRecordGroup::OperationFailed);
+}
+
+TEST_CASE("reducer_ColumnarRecordGroup_count_by_time", "[reducer][ColumnarRecordGroup]") {
+    constexpr int64_t cNumBuckets{1000};
+    constexpr int64_t cBucketSize{60'000};
+    constexpr char cCountKey[] = "count";
+
+    std::map<int64_t, int64_t> bucket_counts;
+    for (int64_t i = 0; i < cNumBuckets; ++i) {
+        bucket_counts.emplace(i * cBucketSize, i + 1);
+    }
+
+    size_t num_groups{0};
+    for (reducer::Int64Int64MapRecordGroupIterator group_it{bucket_counts, cCountKey};
+         false == group_it.done();
+         group_it.next())
+    {
+        auto& group = group_it.get();
+        auto const tags = group.get_tags();
+        auto const columnar_data = reducer::serialize_columnar(tags, group.record_iter());
+        // Getting the group again resets its record iterator
+        auto msgpack_data = reducer::serialize(tags, group_it.get().record_iter());
+        REQUIRE(false
+                == ColumnarRecordGroup::is_columnar(
+                        reinterpret_cast<char const*>(msgpack_data.data()),
+                        msgpack_data.size()
+                ));
+
+        ColumnarRecordGroup columnar_group{
+                reinterpret_cast<char const*>(columnar_data.data()),
+                columnar_data.size()
+        };
+        reducer::DeserializedRecordGroup msgpack_group{msgpack_data};
+        REQUIRE((msgpack_group.get_tags() == columnar_group.get_tags()));
+
+        auto& columnar_record_it = columnar_group.record_iter();
+        auto& msgpack_record_it = msgpack_group.record_iter();
+        for (; false == msgpack_record_it.done(); msgpack_record_it.next()) {
+            REQUIRE(false == columnar_record_it.done());
+            REQUIRE((msgpack_record_it.get().get_int64_value(cCountKey)
+                     == columnar_record_it.get().get_int64_value(cCountKey)));
+            columnar_record_it.next();
+        }
+        REQUIRE(columnar_record_it.done());
+        ++num_groups;
+    }
+    REQUIRE((static_cast<size_t>(cNumBuckets) == num_groups));
+}
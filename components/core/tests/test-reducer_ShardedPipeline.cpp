@@ -0,0 +1,135 @@
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "../src/reducer/ConstRecordIterator.hpp"
+#include "../src/reducer/CountOperator.hpp"
+#include "../src/reducer/GroupTags.hpp"
+#include "../src/reducer/Operator.hpp"
+#include "../src/reducer/Record.hpp"
+#include "../src/reducer/RecordGroup.hpp"
+#include "../src/reducer/ShardedPipeline.hpp"
+
+using reducer::CountOperator;
+using reducer::GroupTags;
+using reducer::RecordGroup;
+using reducer::ShardedPipeline;
+
+namespace {
+constexpr size_t cNumGroups{64};
+
+/**
+ * @param group_idx
+ * @return The tags for the group with the given index.
+ */
+auto get_group_tags(size_t group_idx) -> GroupTags;
+
+/**
+ * Collects the count of every visited record group.
+ * @param counts Returns the count of each group by its tags.
+ * @return A visitor for `ShardedPipeline`.
+ */
+auto collect_counts(std::map<GroupTags, int64_t>& counts) -> ShardedPipeline::RecordGroupVisitor;
+
+auto get_group_tags(size_t group_idx) -> GroupTags {
+    return {"bucket", std::to_string(group_idx)};
+}
+
+auto collect_counts(std::map<GroupTags, int64_t>& counts) -> ShardedPipeline::RecordGroupVisitor {
+    return [&counts](RecordGroup& group) {
+        auto& record_it = group.record_iter();
+        for (; false == record_it.done(); record_it.next()) {
+            counts[group.get_tags()]
+                    += record_it.get().get_int64_value(CountOperator::cRecordElementKey);
+        }
+    };
+}
+}  // namespace
+
+TEST_CASE("reducer_ShardedPipeline_concurrent_senders", "[reducer]") {
+    // Simulates many search tasks concurrently sending partial counts to the reducer
+    constexpr size_t cNumShards{4};
+    auto const num_senders = GENERATE(static_cast<size_t>(1), static_cast<size_t>(16));
+    constexpr size_t cNumRecordGroupsPerSender{10'000};
+
+    ShardedPipeline pipeline{
+            cNumShards,
+            []() { return std::make_shared<CountOperator>(); },
+            false
+    };
+    REQUIRE((cNumShards == pipeline.get_num_shards()));
+
+    std::vector<std::thread> senders;
+    for (size_t sender_idx = 0; sender_idx < num_senders; ++sender_idx) {
+        senders.emplace_back([&pipeline, sender_idx]() {
+            reducer::SingleInt64RecordAdapter record{CountOperator::cRecordElementKey};
+            for (size_t i = 0; i < cNumRecordGroupsPerSender; ++i) {
+                auto const group_idx = (sender_idx + i) % cNumGroups;
+                record.set_record_value(static_cast<int64_t>(group_idx + 1));
+                reducer::SingleRecordIterator record_it{record};
+                pipeline.push_record_group(get_group_tags(group_idx), record_it);
+            }
+        });
+    }
+    for (auto& sender : senders) {
+        sender.join();
+    }
+
+    std::map<GroupTags, int64_t> counts;
+    pipeline.visit_results(collect_counts(counts));
+    REQUIRE((cNumGroups == counts.size()));
+    int64_t total_count{0};
+    for (size_t group_idx = 0; group_idx < cNumGroups; ++group_idx) {
+        auto const count = counts.at(get_group_tags(group_idx));
+        // Every group receives the same number of record groups from all senders
+        REQUIRE((0 == count % static_cast<int64_t>(group_idx + 1)));
+        total_count += count / static_cast<int64_t>(group_idx + 1);
+    }
+    REQUIRE((static_cast<int64_t>(num_senders * cNumRecordGroupsPerSender) == total_count));
+}
+
+TEST_CASE("reducer_ShardedPipeline_updated_results", "[reducer]") {
+    constexpr size_t cNumShards{3};
+    ShardedPipeline pipeline{
+            cNumShards,
+            []() { return std::make_shared<CountOperator>(); },
+            true
+    };
+
+    reducer::SingleInt64RecordAdapter record{CountOperator::cRecordElementKey};
+    record.set_record_value(1);
+    auto push_group = [&](size_t group_idx) {
+        reducer::SingleRecordIterator record_it{record};
+        pipeline.push_record_group(get_group_tags(group_idx), record_it);
+    };
+
+    for (size_t group_idx = 0; group_idx < cNumGroups; ++group_idx) {
+        push_group(group_idx);
+    }
+    std::map<GroupTags, int64_t> counts;
+    pipeline.visit_updated_results(collect_counts(counts));
+    REQUIRE((cNumGroups == counts.size()));
+
+    // Only groups updated since the last visit should be visited again
+    std::set<size_t> const updated_group_idxs{1, 7, 42};
+    for (auto const group_idx : updated_group_idxs) {
+        push_group(group_idx);
+    }
+    counts.clear();
+    pipeline.visit_updated_results(collect_counts(counts));
+    REQUIRE((updated_group_idxs.size() == counts.size()));
+    for (auto const group_idx : updated_group_idxs) {
+        REQUIRE((2 == counts.at(get_group_tags(group_idx))));
+    }
+
+    counts.clear();
+    pipeline.visit_updated_results(collect_counts(counts));
+    REQUIRE(counts.empty());
+}
@@ -0,0 +1,252 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "../src/reducer/DDSketch.hpp"
+#include "../src/reducer/DistinctCountOperator.hpp"
+#include "../src/reducer/HyperLogLog.hpp"
+#include "../src/reducer/NumericAggregationOperator.hpp"
+#include "../src/reducer/Operator.hpp"
+#include "../src/reducer/PercentileOperator.hpp"
+#include "../src/reducer/Pipeline.hpp"
+#include "../src/reducer/Record.hpp"
+#include "../src/reducer/RecordGroupIterator.hpp"
+
+using reducer::DDSketch;
+using reducer::HyperLogLog;
+using reducer::Pipeline;
+using reducer::PipelineInputMode;
+using std::string;
+using std::vector;
+
+namespace {
+constexpr char cElementKey[] = "value";
+
+/**
+ * Merges the results of the given worker pipelines in a reducer pipeline, mimicking how workers
+ * send partial aggregates to the reducer.
+ * @param worker_pipelines
+ * @param reducer_op The operator used by the reducer, which must outlive the returned iterator.
+ * @return The reducer's results.
+ */
+auto merge_in_reducer(
+        vector<Pipeline>& worker_pipelines,
+        std::shared_ptr<reducer::Operator> const& reducer_op
+) -> std::unique_ptr<reducer::RecordGroupIterator>;
+
+auto merge_in_reducer(
+        vector<Pipeline>& worker_pipelines,
+        std::shared_ptr<reducer::Operator> const& reducer_op
+) -> std::unique_ptr<reducer::RecordGroupIterator> {
+    Pipeline reducer_pipeline{PipelineInputMode::IntraStage};
+    reducer_pipeline.add_pipeline_stage(reducer_op);
+    for (auto& worker_pipeline : worker_pipelines) {
+        for (auto group_it = worker_pipeline.finish(); false == group_it->done(); group_it->next())
+        {
+            auto& group = group_it->get();
+            reducer_pipeline.push_record_group(group.get_tags(), group.record_iter());
+        }
+    }
+    return reducer_pipeline.finish();
+}
+}  // namespace
+
+TEST_CASE("reducer_HyperLogLog", "[reducer][aggregation]") {
+    constexpr size_t cNumValues{100'000};
+    constexpr size_t cNumSketches{4};
+    // ~4 standard errors for the default precision
+    constexpr double cMaxRelativeError{0.065};
+
+    vector<HyperLogLog> sketches(cNumSketches);
+    HyperLogLog combined_sketch;
+    for (size_t i = 0; i < cNumValues; ++i) {
+        auto const value = "value" + std::to_string(i);
+        // Values are duplicated across sketches so that merging must deduplicate them
+        sketches[i % cNumSketches].add(value);
+        sketches[(i + 1) % cNumSketches].add(value);
+        combined_sketch.add(value);
+    }
+
+    HyperLogLog merged_sketch;
+    for (auto const& sketch : sketches) {
+        auto const deserialized_sketch = HyperLogLog::deserialize(sketch.serialize());
+        REQUIRE(deserialized_sketch.has_value());
+        REQUIRE(merged_sketch.merge(deserialized_sketch.value()));
+    }
+    // Merging is lossless
+    REQUIRE((combined_sketch.serialize() == merged_sketch.serialize()));
+    auto const relative_error
+            = std::fabs(merged_sketch.estimate() - static_cast<double>(cNumValues)) / cNumValues;
+    REQUIRE((relative_error < cMaxRelativeError));
+
+    // Small cardinalities should be (nearly) exact
+    HyperLogLog small_sketch;
+    for (size_t i = 0; i < 10; ++i) {
+        small_sketch.add(std::to_string(i));
+        small_sketch.add(std::to_string(i));
+    }
+    REQUIRE((10 == std::llround(small_sketch.estimate())));
+
+    HyperLogLog other_precision_sketch{HyperLogLog::cDefaultPrecision - 1};
+    REQUIRE(false == merged_sketch.merge(other_precision_sketch));
+    REQUIRE(false == HyperLogLog::deserialize("").has_value());
+    REQUIRE(false == HyperLogLog::deserialize(merged_sketch.serialize().substr(1)).has_value());
+}
+
+TEST_CASE("reducer_DDSketch", "[reducer][aggregation]") {
+    constexpr size_t cNumValues{100'000};
+    constexpr double cRelativeAccuracy{0.01};
+
+    std::mt19937_64 prng{42};
+    std::lognormal_distribution<double> distribution{0.0, 2.0};
+    vector<double> values;
+    DDSketch first_half_sketch{cRelativeAccuracy};
+    DDSketch second_half_sketch{cRelativeAccuracy};
+    for (size_t i = 0; i < cNumValues; ++i) {
+        // Include negative values and zeros
+        auto value = distribution(prng);
+        if (0 == i % 10) {
+            value = -value;
+        } else if (0 == i % 101) {
+            value = 0.0;
+        }
+        values.push_back(value);
+        (i < cNumValues / 2 ? first_half_sketch : second_half_sketch).add(value);
+    }
+    std::sort(values.begin(), values.end());
+
+    auto sketch = DDSketch::deserialize(first_half_sketch.serialize());
+    REQUIRE(sketch.has_value());
+    auto const other_sketch = DDSketch::deserialize(second_half_sketch.serialize());
+    REQUIRE(other_sketch.has_value());
+    REQUIRE(sketch->merge(other_sketch.value()));
+    REQUIRE((cNumValues == sketch->get_count()));
+
+    // Non-finite values are ignored
+    for (auto const value :
+         {std::numeric_limits<double>::infinity(),
+          -std::numeric_limits<double>::infinity(),
+          std::numeric_limits<double>::quiet_NaN()})
+    {
+        sketch->add(value);
+    }
+    REQUIRE((cNumValues == sketch->get_count()));
+
+    for (auto const quantile : {0.0, 0.01, 0.05, 0.25, 0.5, 0.75, 0.9, 0.99, 0.999, 1.0}) {
+        auto const expected
+                = values[static_cast<size_t>(quantile * static_cast<double>(cNumValues - 1))];
+        auto const estimate = sketch->get_quantile(quantile);
+        REQUIRE(estimate.has_value());
+        REQUIRE((std::fabs(estimate.value() - expected)
+                 <= cRelativeAccuracy * std::fabs(expected) + DDSketch::cMinIndexableValue));
+    }
+
+    REQUIRE(false == DDSketch{}.get_quantile(0.5).has_value());
+    REQUIRE(false == sketch->merge(DDSketch{cRelativeAccuracy / 2}));
+    REQUIRE(false == DDSketch::deserialize("").has_value());
+    REQUIRE(false == DDSketch::deserialize("0.01;1;1:").has_value());
+    REQUIRE(false == DDSketch::deserialize("2;0;;").has_value());
+}
+
+TEST_CASE("reducer_NumericAggregationOperator", "[reducer][aggregation]") {
+    constexpr size_t cNumWorkers{3};
+    vector<double> const values{3.5, -2.0, 10.0, 0.25, 7.0, 1.0, 4.0};
+
+    vector<Pipeline> worker_pipelines;
+    for (size_t i = 0; i < cNumWorkers; ++i) {
+        auto& pipeline = worker_pipelines.emplace_back(PipelineInputMode::InterStage);
+        pipeline.add_pipeline_stage(
+                std::make_shared<reducer::NumericAggregationOperator>(cElementKey)
+        );
+    }
+    reducer::SingleDoubleRecordAdapter record{cElementKey};
+    for (size_t i = 0; i < values.size(); ++i) {
+        record.set_record_value(values[i]);
+        // The last worker receives no values, so its partial aggregate is empty
+        worker_pipelines[i % (cNumWorkers - 1)].push_record(record);
+    }
+
+    auto const reducer_op = std::make_shared<reducer::NumericAggregationOperator>(cElementKey);
+    auto result_it = merge_in_reducer(worker_pipelines, reducer_op);
+    REQUIRE(false == result_it->done());
+    auto& group = result_it->get();
+    auto& record_it = group.record_iter();
+    auto const& result = record_it.get();
+    using reducer::NumericAggregationOperator;
+    REQUIRE((static_cast<int64_t>(values.size())
+             == result.get_int64_value(NumericAggregationOperator::cCountKey)));
+    REQUIRE((23.75 == result.get_double_value(NumericAggregationOperator::cSumKey)));
+    REQUIRE((-2.0 == result.get_double_value(NumericAggregationOperator::cMinKey)));
+    REQUIRE((10.0 == result.get_double_value(NumericAggregationOperator::cMaxKey)));
+    REQUIRE((23.75 / 7 == result.get_double_value(NumericAggregationOperator::cAvgKey)));
+    record_it.next();
+    REQUIRE(record_it.done());
+    result_it->next();
+    REQUIRE(result_it->done());
+}
+
+TEST_CASE("reducer_DistinctCountOperator", "[reducer][aggregation]") {
+    constexpr size_t cNumWorkers{4};
+    constexpr size_t cNumDistinctValues{1000};
+
+    vector<Pipeline> worker_pipelines;
+    for (size_t i = 0; i < cNumWorkers; ++i) {
+        auto& pipeline = worker_pipelines.emplace_back(PipelineInputMode::InterStage);
+        pipeline.add_pipeline_stage(std::make_shared<reducer::DistinctCountOperator>(cElementKey));
+    }
+    reducer::SingleStringRecordAdapter record{cElementKey};
+    for (size_t i = 0; i < cNumDistinctValues * cNumWorkers; ++i) {
+        auto const value = std::to_string(i % cNumDistinctValues);
+        record.set_record_value(value);
+        worker_pipelines[i % cNumWorkers].push_record(record);
+    }
+
+    auto const reducer_op = std::make_shared<reducer::DistinctCountOperator>(cElementKey);
+    auto result_it = merge_in_reducer(worker_pipelines, reducer_op);
+    REQUIRE(false == result_it->done());
+    auto const& result = result_it->get().record_iter().get();
+    auto const distinct_count = result.get_int64_value(
+            static_cast<char const*>(reducer::DistinctCountOperator::cDistinctCountKey)
+    );
+    REQUIRE((std::abs(distinct_count - static_cast<int64_t>(cNumDistinctValues)) < 20));
+}
+
+TEST_CASE("reducer_PercentileOperator", "[reducer][aggregation]") {
+    constexpr size_t cNumWorkers{2};
+    constexpr int64_t cNumValues{1000};
+    vector<double> const percentiles{50, 99.9};
+
+    vector<Pipeline> worker_pipelines;
+    for (size_t i = 0; i < cNumWorkers; ++i) {
+        auto& pipeline = worker_pipelines.emplace_back(PipelineInputMode::InterStage);
+        pipeline.add_pipeline_stage(
+                std::make_shared<reducer::PercentileOperator>(cElementKey, percentiles)
+        );
+    }
+    reducer::SingleDoubleRecordAdapter record{cElementKey};
+    for (int64_t i = 1; i <= cNumValues; ++i) {
+        record.set_record_value(static_cast<double>(i));
+        worker_pipelines[i % cNumWorkers].push_record(record);
+    }
+
+    auto const reducer_op = std::make_shared<reducer::PercentileOperator>(cElementKey, percentiles);
+    auto result_it = merge_in_reducer(worker_pipelines, reducer_op);
+    REQUIRE(false == result_it->done());
+    auto const& result = result_it->get().record_iter().get();
+    REQUIRE((cNumValues
+             == result.get_int64_value(
+                     static_cast<char const*>(reducer::PercentileOperator::cCountKey)
+             )));
+    REQUIRE(("p50" == reducer::PercentileOperator::get_percentile_key(50)));
+    REQUIRE(("p99.9" == reducer::PercentileOperator::get_percentile_key(99.9)));
+    REQUIRE((std::fabs(result.get_double_value("p50") - 500.0) <= 500.0 * 0.01));
+    REQUIRE((std::fabs(result.get_double_value("p99.9") - 999.0) <= 999.0 * 0.01));
+}
@@ -143,6 +143,8 @@ def _make_command_and_env_vars(
             "--job-id", str(aggregation_config.job_id)
         ))
         # fmt: on
+        if aggregation_config.reducer_supports_columnar_record_groups:
+            command.append("--columnar-record-groups")
     elif search_config.network_address is not None:
         # fmt: off
         command.extend((
@@ -52,6 +52,7 @@ class AggregationConfig(BaseModel):
     job_id: typing.Optional[int] = None
     reducer_host: typing.Optional[str] = None
     reducer_port: typing.Optional[int] = None
+    reducer_supports_columnar_record_groups: typing.Optional[bool] = None
     do_count_aggregation: typing.Optional[bool] = None
     count_by_time_bucket_size: typing.Optional[int] = None  # Milliseconds
 
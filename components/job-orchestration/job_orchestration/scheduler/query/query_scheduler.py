@@ -548,11 +548,15 @@ def dispatch_query_job(
 async def acquire_reducer_for_job(job: SearchJob):
     reducer_host: Optional[str] = None
     reducer_port: Optional[int] = None
+    reducer_supports_columnar_record_groups = False
     reducer_handler_msg_queues: Optional[ReducerHandlerMessageQueues] = None
     while True:
-        reducer_host, reducer_port, reducer_handler_msg_queues = (
-            await reducer_connection_queue.get()
-        )
+        (
+            reducer_host,
+            reducer_port,
+            reducer_supports_columnar_record_groups,
+            reducer_handler_msg_queues,
+        ) = await reducer_connection_queue.get()
         """
         Below, the task can either be cancelled before sending the job config to the reducer or
         before the reducer acknowledges the job. If the task is cancelled before we send the job
@@ -584,6 +588,9 @@ async def acquire_reducer_for_job(job: SearchJob):
     job.reducer_handler_msg_queues = reducer_handler_msg_queues
     job.search_config.aggregation_config.reducer_host = reducer_host
     job.search_config.aggregation_config.reducer_port = reducer_port
+    job.search_config.aggregation_config.reducer_supports_columnar_record_groups = (
+        reducer_supports_columnar_record_groups
+    )
     job.state = InternalJobState.WAITING_FOR_DISPATCH
     job.reducer_acquisition_task = None
 
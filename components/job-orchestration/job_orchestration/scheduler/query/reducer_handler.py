@@ -112,7 +112,13 @@ async def handle_reducer_connection(
 
         msg_queues = ReducerHandlerMessageQueues()
         await reducer_connection_queue.put(
-            (reducer_addr_info["host"], reducer_addr_info["port"], msg_queues)
+            (
+                reducer_addr_info["host"],
+                reducer_addr_info["port"],
+                # Older reducers don't advertise whether they support columnar record groups
+                reducer_addr_info.get("supports_columnar_record_groups", False),
+                msg_queues,
+            )
         )
 
         """